@@ -41,24 +41,26 @@ export class InferenceSession implements InferenceSessionInterface {
   }
 
   async run(inputFeed: InputType, options?: RunOptions): Promise<OutputType> {
+    const outputNames = options ? options.outputNames : undefined;
     let output = new Map<string, InternalTensor>();
     if (inputFeed instanceof Map) {
       const modelInputFeed = new Map<string, InternalTensor>();
       inputFeed.forEach((value: ApiTensor, key: string) => {
         modelInputFeed.set(key, value.internalTensor);
       });
-      output = await this.session.run(modelInputFeed);
+      output = await this.session.run(modelInputFeed, outputNames);
     } else if (Array.isArray(inputFeed)) {
       const modelInputFeed: InternalTensor[] = [];
       inputFeed.forEach((value) => {
         modelInputFeed.push(value.internalTensor);
       });
-      output = await this.session.run(modelInputFeed);
+      output = await this.session.run(modelInputFeed, outputNames);
     } else {
       const modelInputFeed = new Map<string, InternalTensor>();
       for (const name in inputFeed) {
         modelInputFeed.set(name, (inputFeed as {readonly [name: string]: ApiTensor})[name].internalTensor);
       }
+      output = await this.session.run(modelInputFeed, outputNames);
     }
     const convertedOutput: Map<string, TensorInterface.Tensor> = new Map<string, TensorInterface.Tensor>();
     output.forEach((value, key) => {
@@ -72,4 +74,10 @@ export class InferenceSession implements InferenceSessionInterface {
   endProfiling(): void {
     this.session.endProfiling();
   }
+  resetState(): void {
+    this.session.resetState();
+  }
+  dispose(): void {
+    this.session.dispose();
+  }
 }
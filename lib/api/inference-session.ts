@@ -51,6 +51,18 @@ export interface InferenceSession {
    * end profiling for the session and flush data
    */
   endProfiling(): void;
+
+  /**
+   * start the next run of the recurrent operators (LSTM, GRU) of a session in streaming mode from their initial
+   * state, e.g. to feed a new sequence
+   */
+  resetState(): void;
+
+  /**
+   * release the resources held by the session (e.g. the memory of the WebAssembly backend and the weights it shares
+   * with other sessions). the session cannot run after it is disposed
+   */
+  dispose(): void;
 }
 
 export declare namespace InferenceSession {
@@ -78,6 +90,24 @@ export declare namespace InferenceSession {
        */
       flushIntervalInMilliseconds?: number;
     }
+
+    /**
+     * represent the configuration of merging concurrent inference requests into one batched run
+     */
+    export interface Batching {
+      /**
+       * the maximum batch size (the sum of the first dimension of the inputs) of a merged run
+       */
+      maxBatchSize: number;
+      /**
+       * the maximum time in milliseconds a request waits for other requests to merge with
+       */
+      maxWaitTime: number;
+      /**
+       * declare that the model computes every sample of the batch axis independently of the others. it must be true
+       */
+      independentSamples: boolean;
+    }
   }
 
   /**
@@ -94,6 +124,18 @@ export declare namespace InferenceSession {
      * specify the configuration of the profiler that used in an inference session
      */
     profiler?: Config.Profiler;
+
+    /**
+     * specify the configuration of merging concurrent inference requests. If not set, every request runs alone.
+     */
+    batching?: Config.Batching;
+
+    /**
+     * specify if the recurrent operators (LSTM, GRU) of the session keep their hidden and cell state between runs when
+     * no initial state is given, so that a sequence can be fed chunk by chunk (see resetState()). Only supported by
+     * the WebAssembly backend. If not set, the `streaming` option of the backend applies.
+     */
+    streaming?: boolean;
   }
 
   /**
@@ -3,7 +3,7 @@
 
 import {Environment} from './env';
 import {InferenceSessionConstructor} from './inference-session';
-import {TensorConstructor} from './tensor';
+import {Tensor, TensorConstructor} from './tensor';
 
 //#region Backends
 
@@ -49,13 +49,220 @@ export declare namespace Backend {
      */
     worker?: number;
     /**
-     * set or get a flag specifying if the fallback cpu implementations can be used in case of missing ops
+     * set or get a flag specifying if the fallback cpu implementations can be used in case of missing ops, or of
+     * input types the wasm kernels do not support
      */
     cpuFallback?: boolean;
     /**
      * set or get a number specifying the timeout for initialization of WebAssembly backend, in milliseconds.
      */
     initTimeout?: number;
+    /**
+     * set or get a flag specifying if recurrent operators (LSTM, GRU) keep their hidden and cell state between runs
+     * when no initial state is given, so that a sequence can be fed chunk by chunk. it is the default of the sessions
+     * whose configuration does not set `streaming`
+     */
+    streaming?: boolean;
+    /**
+     * set or get a flag specifying if whole inference requests are sent to the workers (throughput mode). every worker
+     * then holds its own copy of the model, and concurrent requests run in parallel instead of one after another
+     */
+    throughput?: boolean;
+    /**
+     * get the latency and queue depth metrics of the requests run in throughput mode
+     */
+    readonly throughputMetrics?: WasmThroughputMetrics;
+    /**
+     * set or get a flag specifying if the operators measure their candidate implementations (e.g. the splits among the
+     * workers) the first time they run with a shape, and keep the fastest one
+     */
+    autotune?: boolean;
+    /**
+     * set or get the decisions of the autotuner. the cache can be serialized to JSON and set in later sessions
+     */
+    tuningCache?: WasmTuningCache;
+    /**
+     * set or get the number of channels per block (4, 8 or 16) of the blocked NCHWc layout kept by the activations of
+     * the chains of Conv, pooling and BatchNormalization operators, or 0 to keep the NCHW layout
+     */
+    channelBlock?: number;
+    /**
+     * set or get the fraction of zeros (between 0 and 1) above which the constant weights of the Gemm, MatMul and
+     * pointwise Conv operators are packed in a sparse format when the model loads, or 0 to keep them dense
+     */
+    sparsity?: number;
+    /**
+     * get the layers of the sessions not disposed yet whose weights were packed in a sparse format, and the speedup
+     * of their sparse kernel
+     */
+    readonly sparseReport?: WasmSparseLayer[];
+    /**
+     * set or get a flag specifying if the sessions share their identical constant weights (e.g. the fine-tuned variants
+     * of a base model), which are then stored once until the last session using them is disposed
+     */
+    shareWeights?: boolean;
+    /**
+     * get the number and the size of the weights shared by the sessions
+     */
+    readonly sharedWeights?: WasmSharedWeights;
+    /**
+     * convert the pixels of an image (e.g. the data of an ImageData) to the normalized float tensor
+     * [1, 3, height, width] of a vision model in one pass of a WebAssembly kernel, optionally resizing it. the backend
+     * is initialized first if no session has initialized it yet
+     */
+    preprocessImage?(pixels: Uint8Array|Uint8ClampedArray, options: WasmImageOptions): Promise<Tensor>;
+  }
+
+  /**
+   * represent the layout of an image and the preprocessing of its pixels by the WebAssembly backend
+   */
+  interface WasmImageOptions {
+    /**
+     * the width of the image, in pixels
+     */
+    width: number;
+    /**
+     * the height of the image, in pixels
+     */
+    height: number;
+    /**
+     * the layout of the pixels: 4 bytes per pixel (RGBA, the alpha channel is dropped) or 3 (RGB). default is 'RGBA'
+     */
+    format?: 'RGBA'|'RGB';
+    /**
+     * the width of the tensor. the image is resized by bilinear interpolation when it differs. default is the width
+     * of the image
+     */
+    outputWidth?: number;
+    /**
+     * the height of the tensor. default is the height of the image
+     */
+    outputHeight?: number;
+    /**
+     * the order of the channels of the tensor. default is 'RGB'
+     */
+    channelOrder?: 'RGB'|'BGR';
+    /**
+     * the values of the tensor are (scale * pixel - mean[c]) / std[c], e.g. a scale of 1 / 255 for values between
+     * 0 and 1. default is 1
+     */
+    scale?: number;
+    /**
+     * the mean of every channel of the tensor, in the order of the channels of the tensor. default is 0
+     */
+    mean?: number[];
+    /**
+     * the standard deviation of every channel of the tensor, in the order of the channels of the tensor. default is 1
+     */
+    std?: number[];
+  }
+
+  /**
+   * represent the decisions of the autotuner of the WebAssembly backend
+   */
+  interface WasmTuningCache {
+    /**
+     * the version of the cache format. a cache of another version is ignored
+     */
+    version: number;
+    /**
+     * the fastest candidate of every operator, shape and attributes, serialized as JSON
+     */
+    decisions: {[key: string]: string};
+  }
+
+  /**
+   * represent a layer of the WebAssembly backend whose weights were packed in a sparse format
+   */
+  interface WasmSparseLayer {
+    /**
+     * the name of the node
+     */
+    name: string;
+    /**
+     * the type of the operator
+     */
+    opType: string;
+    /**
+     * the dims of the weights
+     */
+    dims: number[];
+    /**
+     * the fraction of zeros of the weights
+     */
+    sparsity: number;
+    /**
+     * the number of columns of the blocks the weights are stored by: 1 (CSR) or 4
+     */
+    blockSize: number;
+    /**
+     * the time of a run with the dense kernel, in milliseconds, or 0 if the layer has not run yet
+     */
+    denseTime: number;
+    /**
+     * the time of a run with the sparse kernel, in milliseconds, or 0 if the layer has not run yet
+     */
+    sparseTime: number;
+    /**
+     * the ratio of the dense time to the sparse time
+     */
+    speedup: number;
+    /**
+     * whether the layer keeps running with the sparse kernel, the dense kernel being kept if it is faster
+     */
+    sparse: boolean;
+  }
+
+  /**
+   * represent the weights shared by the sessions of the WebAssembly backend
+   */
+  interface WasmSharedWeights {
+    /**
+     * the number of distinct tensors stored
+     */
+    tensors: number;
+    /**
+     * the number of references of the sessions to the tensors
+     */
+    references: number;
+    /**
+     * the size of the distinct tensors, in bytes
+     */
+    bytes: number;
+    /**
+     * the size the tensors would take if every session held its own copy, in bytes
+     */
+    unsharedBytes: number;
+  }
+
+  /**
+   * represent the metrics of the requests run in the throughput mode of the WebAssembly backend
+   */
+  interface WasmThroughputMetrics {
+    /**
+     * the number of completed requests
+     */
+    completedRequests: number;
+    /**
+     * the number of requests waiting for an idle worker
+     */
+    queueDepth: number;
+    /**
+     * the largest number of requests that have been waiting for an idle worker at once
+     */
+    maxQueueDepth: number;
+    /**
+     * the average time from the submission to the completion of a request, in milliseconds
+     */
+    averageLatency: number;
+    /**
+     * the longest time from the submission to the completion of a request, in milliseconds
+     */
+    maxLatency: number;
+    /**
+     * the average time a request waits for an idle worker, in milliseconds
+     */
+    averageQueueTime: number;
   }
 
   /**
@@ -51,6 +51,13 @@ export class Attribute {
   delete(key: string): void {
     this._attributes.delete(key);
   }
+  /**
+   * call the function with the name, the type and the value of every attribute
+   */
+  forEach(callback: (key: string, type: Attribute.DataType, value: Attribute.DataTypeMap[Attribute.DataType]) => void):
+      void {
+    this._attributes.forEach(([value, type], key) => callback(key, type, value));
+  }
   getFloat(key: string, defaultValue?: Attribute.DataTypeMap['float']) {
     return this.get(key, 'float', defaultValue);
   }
@@ -4,7 +4,9 @@
 import {Graph} from './graph';
 import {Operator} from './operators';
 import {OpSet} from './opset';
+import {PrepackedGraph} from './prepacked-model';
 import {Session} from './session';
+import {Tensor} from './tensor';
 
 export interface InferenceHandler {
   /**
@@ -38,12 +40,34 @@ export interface SessionHandler {
    */
   resolve(node: Graph.Node, opsets: ReadonlyArray<OpSet>, graph: Graph): Operator;
 
+  /**
+   * let the session handler use what was prepared ahead of time in a prepacked model (e.g. the packed weights of the
+   * operators). it is called before the operators are resolved
+   * @param model the prepacked model
+   * @param graph the graph read from the prepacked model
+   */
+  loadPrepackedModel?(model: PrepackedGraph, graph: Graph): void;
+
   /**
    * This method let's the sessionHandler know that the graph initialization is complete
    * @param graph the completely initialized graph
    */
   onGraphInitialized?(graph: Graph): void;
 
+  /**
+   * let the session handler run whole inference requests instead of the execution plan of the session, e.g. on other
+   * threads holding their own copy of the model. it is called with the serialized model once the graph is initialized
+   * @param model the serialized model
+   * @returns the executor of the inference requests, or undefined to use the execution plan
+   */
+  createModelExecutor?(model: Uint8Array): ModelExecutor|undefined;
+
+  /**
+   * start the next run of the operators keeping a state between runs (e.g. the recurrent operators in streaming mode)
+   * from their initial state
+   */
+  resetState?(): void;
+
   /**
    * a reference to the corresponding backend
    */
@@ -55,6 +79,18 @@ export interface SessionHandler {
   readonly context: Session.Context;
 }
 
+export interface ModelExecutor {
+  /**
+   * run the model for the given inputs, resolving to the outputs in the order of the graph outputs
+   */
+  execute(inputs: Tensor[]): Promise<Tensor[]>;
+
+  /**
+   * dispose the executor, along with the copies of the model it holds
+   */
+  dispose(): void;
+}
+
 export interface Backend {
   /**
    * initialize the backend. will be called only once, when the first time the
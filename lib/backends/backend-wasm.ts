@@ -4,12 +4,19 @@
 import * as platform from 'platform';
 
 import {Backend as BackendInterface} from '../api/onnx';
+import {Tensor as ApiTensor} from '../api/tensor-impl';
+import {fromInternalTensor} from '../api/tensor-impl-utils';
 import {Backend, SessionHandler} from '../backend';
 import {Logger} from '../instrument';
 import {Session} from '../session';
 import * as wasmBinding from '../wasm-binding';
 
+import {getTuningCache, setTuningCache} from './wasm/autotuner';
+import {preprocessImage} from './wasm/image-preprocess';
 import {WasmSessionHandler} from './wasm/session-handler';
+import {getThroughputMetrics, WasmPooledSessionHandler} from './wasm/session-pool';
+import {getSharedWeights} from './wasm/shared-weights';
+import {getSparseReport} from './wasm/sparse';
 
 export let bindingInitPromise: Promise<void>|undefined;
 
@@ -20,6 +27,13 @@ export class WasmBackend implements Backend, WasmOptions {
   worker: number;
   cpuFallback: boolean;
   initTimeout: number;
+  streaming: boolean;
+  throughput: boolean;
+  autotune: boolean;
+  channelBlock: number;
+  sparsity: number;
+  shareWeights: boolean;
+  private initialization?: Promise<boolean>;
   constructor() {
     // default parameters that users can override using the onnx global object
 
@@ -29,19 +43,72 @@ export class WasmBackend implements Backend, WasmOptions {
     this.worker = defaultNumWorkers();
 
     this.initTimeout = 5000;
+
+    this.streaming = false;
+
+    this.throughput = false;
+
+    this.autotune = false;
+
+    this.channelBlock = 0;
+
+    this.sparsity = 0;
+
+    this.shareWeights = false;
   }
   async initialize(): Promise<boolean> {
     checkIfNumWorkersIsValid(this.worker);
-    const init = await this.isWasmSupported();
+    // the sessions and preprocessImage() may initialize the backend concurrently, so they share a pending
+    // initialization. a failed one is attempted again by the next caller
+    if (!this.initialization) {
+      this.initialization = this.isWasmSupported();
+    }
+    const init = await this.initialization;
     if (!init) {
+      this.initialization = undefined;
       return false;
     }
     return true;
   }
   createSessionHandler(context: Session.Context): SessionHandler {
-    return new WasmSessionHandler(this, context, this.cpuFallback);
+    checkIfChannelBlockIsValid(this.channelBlock);
+    checkIfSparsityIsValid(this.sparsity);
+    // in throughput mode every worker holds a copy of the model and runs whole requests
+    const handler = this.throughput ? WasmPooledSessionHandler : WasmSessionHandler;
+    const options = {
+      cpuFallback: this.cpuFallback,
+      streaming: context.streaming !== undefined ? context.streaming : this.streaming,
+      autotune: this.autotune,
+      channelBlock: this.channelBlock,
+      sparsity: this.sparsity,
+      shareWeights: this.shareWeights
+    };
+    return new handler(this, context, options, wasmBinding.WasmBinding.create());
   }
   dispose(): void {}
+  get throughputMetrics(): BackendInterface.WasmThroughputMetrics {
+    return getThroughputMetrics();
+  }
+  get tuningCache(): BackendInterface.WasmTuningCache {
+    return getTuningCache();
+  }
+  set tuningCache(cache: BackendInterface.WasmTuningCache) {
+    setTuningCache(cache);
+  }
+  get sparseReport(): BackendInterface.WasmSparseLayer[] {
+    return getSparseReport();
+  }
+  get sharedWeights(): BackendInterface.WasmSharedWeights {
+    return getSharedWeights();
+  }
+  async preprocessImage(pixels: Uint8Array|Uint8ClampedArray, options: BackendInterface.WasmImageOptions):
+      Promise<ApiTensor> {
+    // the image may be preprocessed before any session has initialized the backend
+    if (!await this.initialize()) {
+      throw new Error('unable to initialize the WebAssembly backend to preprocess the image');
+    }
+    return fromInternalTensor(preprocessImage(wasmBinding.WasmBinding.getInstance(), pixels, options));
+  }
 
   async isWasmSupported(): Promise<boolean> {
     try {
@@ -74,6 +141,18 @@ function defaultNumWorkers(): number {
   return 0;
 }
 
+function checkIfChannelBlockIsValid(channelBlock: number) {
+  if ([0, 4, 8, 16].indexOf(channelBlock) === -1) {
+    throw new Error(`${channelBlock} is not a valid number of channels per block, expecting 0, 4, 8 or 16`);
+  }
+}
+
+function checkIfSparsityIsValid(sparsity: number) {
+  if (!(sparsity >= 0 && sparsity <= 1)) {
+    throw new Error(`${sparsity} is not a valid fraction of zeros, expecting a number between 0 and 1`);
+  }
+}
+
 function checkIfNumWorkersIsValid(worker: number) {
   if (!Number.isFinite(worker) || Number.isNaN(worker)) {
     throw new Error(`${worker} is not valid number of workers`);
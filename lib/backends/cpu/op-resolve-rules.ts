@@ -4,7 +4,7 @@
 import {FLOAT_TYPES, NUMBER_TYPES} from '../../operators';
 import {OpSet} from '../../opset';
 
-import {CpuArgMax} from './ops/argMax';
+import {CpuArgMax, CpuArgMin} from './ops/argMax';
 import {CpuBatchNormalization} from './ops/batch-normalization';
 import {CpuBinaryOp} from './ops/binary-op';
 import {CpuCast} from './ops/cast';
@@ -42,6 +42,7 @@ export const CPU_OP_RESOLVE_RULES: ReadonlyArray<OpSet.ResolveRule> = [
   ['Add', '', '7+', () => new CpuBinaryOp(NUMBER_TYPES, (e1, e2) => (e1 + e2))],
   ['And', '', '7+', () => new CpuBinaryOp(['bool'], (e1, e2) => (e1 && e2))],
   ['ArgMax', '', '1-11', () => new CpuArgMax()],
+  ['ArgMin', '', '1-11', () => new CpuArgMin()],
   ['Asin', '', '7+', () => new CpuUnaryOp(FLOAT_TYPES, unaryOps.asin)],
   ['Asinh', '', '9+', () => new CpuUnaryOp(FLOAT_TYPES, unaryOps.asinh)],
   ['Atan', '', '7+', () => new CpuUnaryOp(FLOAT_TYPES, unaryOps.atan)],
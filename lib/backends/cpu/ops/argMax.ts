@@ -10,7 +10,16 @@ export class CpuArgMax extends ArgMax {
   }
 }
 
-export function argMax(x: Tensor, axis: number, keepdims: boolean): Tensor {
+// ArgMin shares its attributes and input checks with ArgMax
+export class CpuArgMin extends ArgMax {
+  run(inferenceHandler: CpuInferenceHandler, inputs: Tensor[]): Tensor[]|Promise<Tensor[]> {
+    const output = argMax(inputs[0], this.axis, this.keepDims, true);
+    return [output];
+  }
+}
+
+// the index of the maximum (or of the minimum) along the axis, the first one of equal values
+export function argMax(x: Tensor, axis: number, keepdims: boolean, min = false): Tensor {
   const rank = x.dims ? x.dims.length : 1;
   axis = ShapeUtil.normalizeAxis(axis, rank);
   const outputDims = ReduceUtil.calcReduceShape(x.dims, [axis], true);
@@ -25,12 +34,12 @@ export function argMax(x: Tensor, axis: number, keepdims: boolean): Tensor {
     // map index
     BroadcastUtil.fillIndex(indices, x.dims, indicesY);
     const offset = ShapeUtil.indicesToOffset(indicesY, inputStrides);
-    let max = x.data[offset];
+    let best = x.data[offset];
     let index = 0;
     for (let j = 0; j < x.dims[axis]; ++j) {
       const value = X[offset + j * blockSize];
-      if (value > max) {
-        max = value;
+      if (min ? value < best : value > best) {
+        best = value;
         index = j;
       }
     }
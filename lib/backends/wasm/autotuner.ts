@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {Backend as BackendInterface} from '../../api/onnx';
+import {Logger, now} from '../../instrument';
+import {getWorkerNumber} from '../../wasm-binding-core';
+
+type TuningCache = BackendInterface.WasmTuningCache;
+
+// the version of the tuning cache format. caches of other versions are ignored
+const TUNING_CACHE_VERSION = 1;
+
+/**
+ * the maximum number of decisions kept. the oldest ones are dropped first, e.g. the ones of the shapes of the inputs of
+ * a model that are not seen any more
+ */
+export const MAX_TUNING_DECISIONS = 4096;
+
+// the fastest candidate of every tuned (operator, shape, attributes) key, serialized as JSON, in the order they were
+// made
+let decisions = new Map<string, string>();
+
+/**
+ * get the tuning decisions made so far, in a form that can be serialized and loaded in later sessions
+ */
+export function getTuningCache(): TuningCache {
+  const cache: TuningCache = {version: TUNING_CACHE_VERSION, decisions: {}};
+  decisions.forEach((choice, key) => {
+    cache.decisions[key] = choice;
+  });
+  return cache;
+}
+
+/**
+ * load the tuning decisions of a previous session. the decisions made so far are replaced
+ */
+export function setTuningCache(cache: TuningCache): void {
+  decisions = new Map<string, string>();
+  if (!cache || cache.version !== TUNING_CACHE_VERSION) {
+    Logger.warning('Autotuner', 'ignoring a tuning cache of an unknown version');
+    return;
+  }
+  Object.keys(cache.decisions).forEach(key => addDecision(key, cache.decisions[key]));
+}
+
+/**
+ * build the key of a tuning decision. the decisions depend on the number of workers as well
+ */
+export function tuningKey(op: string, dims: Array<ReadonlyArray<number>>, attributes: unknown[] = []): string {
+  return `${op}(${dims.map(d => d.join('x')).join(',')})${JSON.stringify(attributes)}@${getWorkerNumber()}`;
+}
+
+/**
+ * run an operator with the fastest of the candidate implementations or parameters.
+ *
+ * without autotuning, or with a single candidate, the first candidate runs. otherwise, the first time a key is seen
+ * every candidate runs once (each one computes the whole output) and the fastest one is kept for the later runs. the
+ * candidates must be serializable to JSON.
+ * @param key the key of the decision, built by tuningKey()
+ * @param candidates the candidates, starting with the default one
+ * @param run run the operator with a candidate
+ */
+export async function runTuned<T>(
+    enabled: boolean, key: () => string, candidates: T[], run: (candidate: T) => Promise<void>): Promise<void> {
+  if (!enabled || candidates.length === 1) {
+    return run(candidates[0]);
+  }
+
+  const decisionKey = key();
+  const choices = candidates.map(candidate => JSON.stringify(candidate));
+  const cached = decisions.get(decisionKey);
+  // a cached decision that is not a candidate any more (e.g. made with another number of workers) is tuned again
+  if (cached !== undefined && choices.indexOf(cached) !== -1) {
+    return run(candidates[choices.indexOf(cached)]);
+  }
+
+  // the first run warms up the caches and the workers, and is not measured
+  await run(candidates[0]);
+  let best = 0;
+  let bestTime = Infinity;
+  for (let i = 0; i < candidates.length; i++) {
+    const start = now();
+    await run(candidates[i]);
+    const time = now() - start;
+    if (time < bestTime) {
+      best = i;
+      bestTime = time;
+    }
+  }
+  Logger.verbose('Autotuner', `${decisionKey}: chose ${choices[best]} (${bestTime.toFixed(3)}ms)`);
+  addDecision(decisionKey, choices[best]);
+}
+
+function addDecision(key: string, choice: string) {
+  decisions.delete(key);
+  if (decisions.size >= MAX_TUNING_DECISIONS) {
+    decisions.delete(decisions.keys().next().value);
+  }
+  decisions.set(key, choice);
+}
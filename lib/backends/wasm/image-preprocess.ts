@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {Backend as BackendInterface} from '../../api/onnx';
+import {Tensor} from '../../tensor';
+import {WasmSessionBinding} from '../../wasm-binding-core';
+
+type ImageOptions = BackendInterface.WasmImageOptions;
+
+// the bytes of a pixel of every format, and the byte of every channel in the pixel
+const PIXEL_SIZES: {[format: string]: number} = {RGBA: 4, RGB: 3};
+const CHANNEL_ORDERS: {[order: string]: number[]} = {RGB: [0, 1, 2], BGR: [2, 1, 0]};
+
+/**
+ * convert the pixels of an image to the normalized float tensor [1, 3, outputHeight, outputWidth] of a vision model,
+ * in one pass of the wasm kernel that drops the alpha channel, reorders the channels to NCHW, normalizes them and
+ * resizes the image by bilinear interpolation when the size of the tensor differs from the one of the image
+ * @param binding the binding whose argument buffer holds the pixels and the tensor during the call
+ * @param pixels the pixels of the image, row by row (e.g. the data of an ImageData)
+ */
+export function preprocessImage(
+    binding: WasmSessionBinding, pixels: Uint8Array|Uint8ClampedArray, options: ImageOptions): Tensor {
+  const {width, height} = options;
+  const outputWidth = options.outputWidth ?? width;
+  const outputHeight = options.outputHeight ?? height;
+  [width, height, outputWidth, outputHeight].forEach(size => {
+    if (!Number.isInteger(size) || size <= 0) {
+      throw new Error(`${size} is not a valid size of image, expecting a positive integer`);
+    }
+  });
+  const format = options.format ?? 'RGBA';
+  const pixelSize = PIXEL_SIZES[format];
+  if (pixelSize === undefined) {
+    throw new Error(`${format} is not a valid format of pixels, expecting 'RGBA' or 'RGB'`);
+  }
+  if (pixels.length !== width * height * pixelSize) {
+    throw new Error(`expecting ${width * height * pixelSize} bytes of pixels for an image of ${width}x${
+        height} pixels in ${format}, got ${pixels.length}`);
+  }
+  const channelOrder = options.channelOrder ?? 'RGB';
+  const channels = CHANNEL_ORDERS[channelOrder];
+  if (channels === undefined) {
+    throw new Error(`${channelOrder} is not a valid order of channels, expecting 'RGB' or 'BGR'`);
+  }
+  const scale = options.scale ?? 1;
+  const mean = options.mean ?? [0, 0, 0];
+  const std = options.std ?? [1, 1, 1];
+  if (mean.length !== 3 || std.length !== 3 || std.some(s => s === 0)) {
+    throw new Error('expecting a mean and a non-zero standard deviation for each of the 3 channels');
+  }
+
+  // (scale * value - mean) / std, as one multiply-add per value
+  const multipliers = std.map(s => scale / s);
+  const biases = mean.map((m, c) => -m / std[c]);
+  const y = new Tensor([1, 3, outputHeight, outputWidth], 'float32');
+  binding.ccall(
+      '_image_to_nchw_f32', [new Uint8Array(pixels.buffer, pixels.byteOffset, pixels.byteLength), 'boolptr'],
+      [height, 'int32'], [width, 'int32'], [pixelSize, 'int32'], [channels, 'int32ptr'], [3, 'int32'],
+      [multipliers, 'float32ptr'], [biases, 'float32ptr'], [y.floatData, 'float32ptr', 'out'], [outputHeight, 'int32'],
+      [outputWidth, 'int32']);
+  return y;
+}
@@ -3,11 +3,19 @@
 
 import {InferenceHandler} from '../../backend';
 import {Profiler} from '../../instrument';
+import {WasmSessionBinding} from '../../wasm-binding-core';
 
 import {WasmSessionHandler} from './session-handler';
 
 export class WasmInferenceHandler implements InferenceHandler {
   constructor(public readonly session: WasmSessionHandler, public readonly profiler?: Readonly<Profiler>) {}
 
+  /**
+   * the binding of the session, whose argument buffer is the arena of the calls of its operators
+   */
+  get binding(): WasmSessionBinding {
+    return this.session.binding;
+  }
+
   dispose(): void {}
 }
@@ -3,37 +3,91 @@
 
 import {OpSet} from '../../opset';
 
+import {WasmArgMax, WasmArgMin} from './ops/argMax';
+import {WasmFusedAttention} from './ops/attention';
 import {WasmBatchNormalization} from './ops/batch-normalization';
-import {WasmBinaryOp} from './ops/binary-op';
+import {WasmBinaryOp, WasmVariadicBinaryOp, WasmWhere} from './ops/binary-op';
 import {WasmClip} from './ops/clip';
+import {WasmConcat} from './ops/concat';
 import {WasmConv} from './ops/conv';
+import {WasmConvTranspose} from './ops/conv-transpose';
+import {WasmExpand} from './ops/expand';
+import {WasmGather} from './ops/gather';
 import {WasmGemm} from './ops/gemm';
 import {WasmInstanceNormalization} from './ops/instance-normalization';
 import {WasmMatMul} from './ops/matmul';
+import * as wasmNCHWc from './ops/nchwc';
+import {WasmPad} from './ops/pad';
 import {WasmAveragePool, WasmGlobalAveragePool, WasmGlobalMaxPool, WasmMaxPool} from './ops/pool';
+import * as wasmReduce from './ops/reduce';
+import {WasmGRU, WasmLSTM} from './ops/rnn';
+import {WasmSlice, WasmSliceV10} from './ops/slice';
 import {WasmSoftmax} from './ops/softmax';
 import {WasmSum} from './ops/sum';
+import {WasmTile} from './ops/tile';
+import {WasmTranspose} from './ops/transpose';
+import {WasmUpsample} from './ops/upsample';
 
 export const WASM_OP_RESOLVE_RULES: ReadonlyArray<OpSet.ResolveRule> = [
   ['Add', '', '7+', () => new WasmBinaryOp(['float32', 'int32'], 'Add')],
   ['And', '', '7+', () => new WasmBinaryOp(['bool'], 'And')],
+  ['ArgMax', '', '1-11', () => new WasmArgMax()],
+  ['ArgMin', '', '1-11', () => new WasmArgMin()],
   ['AveragePool', '', '7-10', () => new WasmAveragePool()],  // TODO: support new attributes for AveragePool-10
+  ['AveragePoolNCHWc', '', '1+', () => new wasmNCHWc.WasmAveragePoolNCHWc()],
   ['BatchNormalization', '', '7+', () => new WasmBatchNormalization()],
+  ['BatchNormalizationNCHWc', '', '1+', () => new wasmNCHWc.WasmBatchNormalizationNCHWc()],
   ['Clip', '', '6-10', () => new WasmClip()],
+  ['Concat', '', '4+', () => new WasmConcat()],
   ['Conv', '', '1+', () => new WasmConv()],
-  ['Div', '', '7+', () => new WasmBinaryOp(['float32'], 'Div')],
+  ['ConvNCHWc', '', '1+', () => new wasmNCHWc.WasmConvNCHWc()],
+  ['ConvTranspose', '', '1+', () => new WasmConvTranspose()],
+  ['Div', '', '7+', () => new WasmBinaryOp(['float32', 'int32'], 'Div')],
+  ['Equal', '', '7+', () => new WasmBinaryOp(['float32', 'int32', 'bool'], 'Equal', 'bool')],
+  ['Expand', '', '8+', () => new WasmExpand()],
+  ['FusedAttention', '', '1+', () => new WasmFusedAttention()],  // created by Graph.Transformer.fuseAttentionNodes()
+  ['Gather', '', '1+', () => new WasmGather()],
   ['Gemm', '', '7-10', () => new WasmGemm(false)],
   ['Gemm', '', '11+', () => new WasmGemm(true)],
+  ['GRU', '', '7+', () => new WasmGRU()],
+  ['Greater', '', '7+', () => new WasmBinaryOp(['float32', 'int32'], 'Greater', 'bool')],
   ['GlobalAveragePool', '', '1+', () => new WasmGlobalAveragePool()],
+  ['GlobalAveragePoolNCHWc', '', '1+', () => new wasmNCHWc.WasmGlobalAveragePoolNCHWc()],
   ['GlobalMaxPool', '', '1+', () => new WasmGlobalMaxPool()],
+  ['GlobalMaxPoolNCHWc', '', '1+', () => new wasmNCHWc.WasmGlobalMaxPoolNCHWc()],
   ['InstanceNormalization', '', '6+', () => new WasmInstanceNormalization()],
+  ['LSTM', '', '7+', () => new WasmLSTM()],
+  ['Less', '', '7+', () => new WasmBinaryOp(['float32', 'int32'], 'Less', 'bool')],
   ['MatMul', '', '1+', () => new WasmMatMul()],
+  ['Max', '', '6+', () => new WasmVariadicBinaryOp(['float32', 'int32'], 'Max')],
   ['MaxPool', '', '1-9', () => new WasmMaxPool()],  // TODO: support new attributes for MaxPool-8 and MaxPool-10
+  ['MaxPoolNCHWc', '', '1+', () => new wasmNCHWc.WasmMaxPoolNCHWc()],
+  ['Min', '', '6+', () => new WasmVariadicBinaryOp(['float32', 'int32'], 'Min')],
   ['Mul', '', '7+', () => new WasmBinaryOp(['float32', 'int32'], 'Mul')],
   ['Or', '', '7+', () => new WasmBinaryOp(['bool'], 'Or')],
   ['PRelu', '', '7+', () => new WasmBinaryOp(['float32'], 'PRelu')],
+  ['Pad', '', '2-10', () => new WasmPad()],
+  ['Pow', '', '7+', () => new WasmBinaryOp(['float32', 'int32'], 'Pow')],
+  ['ReduceLogSum', '', '1+', () => new wasmReduce.WasmReduceLogSum()],
+  ['ReduceLogSumExp', '', '1+', () => new wasmReduce.WasmReduceLogSumExp()],
+  ['ReduceMax', '', '1+', () => new wasmReduce.WasmReduceMax()],
+  ['ReduceMean', '', '1+', () => new wasmReduce.WasmReduceMean()],
+  ['ReduceMin', '', '1+', () => new wasmReduce.WasmReduceMin()],
+  ['ReduceProd', '', '1+', () => new wasmReduce.WasmReduceProd()],
+  ['ReduceSum', '', '1+', () => new wasmReduce.WasmReduceSum()],
+  ['ReduceSumSquare', '', '1+', () => new wasmReduce.WasmReduceSumSquare()],
+  ['ReorderFromNCHWc', '', '1+', () => new wasmNCHWc.WasmReorderFromNCHWc()],
+  ['ReorderToNCHWc', '', '1+', () => new wasmNCHWc.WasmReorderToNCHWc()],
+  ['Resize', '', '11+', () => new WasmUpsample(11)],
+  ['Slice', '', '10+', () => new WasmSliceV10()],  // TODO: support 'steps' for Slice-10
+  ['Slice', '', '1-9', () => new WasmSlice()],
   ['Softmax', '', '1+', () => new WasmSoftmax()],
   ['Sub', '', '7+', () => new WasmBinaryOp(['float32', 'int32'], 'Sub')],
   ['Sum', '', '6+', () => new WasmSum()],  // TODO: support multidirectional broadcast for Sum-8
+  ['Tile', '', '6+', () => new WasmTile()],
+  ['Transpose', '', '1+', () => new WasmTranspose()],
+  ['Upsample', '', '7-8', () => new WasmUpsample(7)],
+  ['Upsample', '', '9', () => new WasmUpsample(9)],
+  ['Where', '', '9+', () => new WasmWhere()],
   ['Xor', '', '7+', () => new WasmBinaryOp(['bool'], 'Xor')],
 ];
@@ -0,0 +1,41 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {ArgMax} from '../../../ops/argMax';
+import {Tensor} from '../../../tensor';
+import {ReduceUtil, ShapeUtil} from '../../../util';
+import {WasmSessionBinding} from '../../../wasm-binding-core';
+import {WasmInferenceHandler} from '../inference-handler';
+
+export class WasmArgMax extends ArgMax {
+  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+    return [argReduce(inferenceHandler.binding, '_arg_max_f32', inputs[0], this.axis, this.keepDims)];
+  }
+
+  // overriding the checkInputTypes() in the base class because Wasm backend has special type limitations
+  checkInputTypes(inputs: Tensor[]): boolean {
+    // currently Wasm backend only supports 'float32' input type
+    if (inputs[0].type !== 'float32') {
+      return false;
+    }
+
+    return true;
+  }
+}
+
+// ArgMin shares its attributes and input checks with ArgMax
+export class WasmArgMin extends WasmArgMax {
+  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+    return [argReduce(inferenceHandler.binding, '_arg_min_f32', inputs[0], this.axis, this.keepDims)];
+  }
+}
+
+function argReduce(binding: WasmSessionBinding, func: string, x: Tensor, axis: number, keepDims: boolean): Tensor {
+  const rank = x.dims.length;
+  axis = ShapeUtil.normalizeAxis(axis, rank);
+  const y = new Tensor(ReduceUtil.calcReduceShape(x.dims, [axis], keepDims), 'int32');
+  binding.ccall(
+      func, [x.floatData, 'float32ptr'], [x.dims, 'int32ptr'], [rank, 'int32'], [axis, 'int32'],
+      [y.integerData as Int32Array, 'int32ptr', 'out']);
+  return y;
+}
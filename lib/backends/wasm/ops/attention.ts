@@ -0,0 +1,86 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {Attribute} from '../../../attribute';
+import {Operator} from '../../../operators';
+import {Tensor} from '../../../tensor';
+import {BroadcastUtil, ShapeUtil} from '../../../util';
+import {WasmInferenceHandler} from '../inference-handler';
+
+import {WasmBinaryOp} from './binary-op';
+import {WasmMatMul} from './matmul';
+import {WasmSoftmax} from './softmax';
+
+// scaled dot-product attention, the 'FusedAttention' node created by Graph.Transformer.fuseAttentionNodes() from the
+// MatMul -> Div -> Add -> Softmax -> MatMul nodes. the inputs are [Q, K_t, divisor, mask, V].
+// the fused kernel never holds the whole score matrix. shapes the kernel does not handle (broadcasting batch
+// dimensions, a non-scalar divisor or a softmax that is not over the last axis) run the original nodes one by one.
+export class WasmFusedAttention implements Operator {
+  initialize(attributes: Attribute): void {
+    this.softmax.initialize(attributes);
+    this.axis = attributes.getInt('axis', 1);
+  }
+
+  checkInputs(inputs: Tensor[]): boolean {
+    if (!inputs || inputs.length !== 5) {
+      return false;
+    }
+
+    // currently Wasm backend only supports 'float32' input type
+    return inputs.every(input => input.type === 'float32');
+  }
+
+  async run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Promise<Tensor[]> {
+    const [q, kT, divisor, mask, v] = inputs;
+    const rank = q.dims.length;
+    if (rank < 2 || kT.dims.length !== rank || v.dims.length !== rank) {
+      return this.runUnfused(inferenceHandler, inputs);
+    }
+    const batchDims = q.dims.slice(0, rank - 2);
+    const [seqQ, depth] = q.dims.slice(rank - 2);
+    const seqK = kT.dims[rank - 1];
+    const depthV = v.dims[rank - 1];
+    const scoresDims = batchDims.concat([seqQ, seqK]);
+    if (divisor.size !== 1 || ShapeUtil.normalizeAxis(this.axis, rank) !== rank - 1 ||
+        !ShapeUtil.areEqual(kT.dims, batchDims.concat([depth, seqK])) ||
+        !ShapeUtil.areEqual(v.dims, batchDims.concat([seqK, depthV])) ||
+        !BroadcastUtil.isValidBroadcast(mask.dims, scoresDims)) {
+      return this.runUnfused(inferenceHandler, inputs);
+    }
+
+    // offsets of the mask of every batch entry, and the strides of the mask along the queries and the keys
+    const maskDims = new Array<number>(rank - mask.dims.length).fill(1).concat(mask.dims);
+    const maskStrides = ShapeUtil.computeStrides(maskDims).map((stride, i) => maskDims[i] === 1 ? 0 : stride);
+    const batchSize = ShapeUtil.size(batchDims);
+    const maskOffsets = new Int32Array(batchSize);
+    const batchStrides = ShapeUtil.computeStrides(batchDims);
+    for (let b = 0; b < batchSize; b++) {
+      const indices = ShapeUtil.offsetToIndices(b, batchStrides);
+      maskOffsets[b] = indices.reduce((offset, index, i) => offset + index * maskStrides[i], 0);
+    }
+
+    const y = new Tensor(batchDims.concat([seqQ, depthV]), 'float32');
+    inferenceHandler.binding.ccall(
+        '_attention_f32', [q.floatData, 'float32ptr'], [kT.floatData, 'float32ptr'], [v.floatData, 'float32ptr'],
+        [mask.floatData, 'float32ptr'], [maskOffsets, 'int32ptr'], [maskStrides[rank - 2], 'int32'],
+        [maskStrides[rank - 1], 'int32'], [batchSize, 'int32'], [seqQ, 'int32'], [seqK, 'int32'], [depth, 'int32'],
+        [depthV, 'int32'], [divisor.floatData[0], 'float32'], [y.floatData, 'float32ptr', 'out']);
+
+    return [y];
+  }
+
+  private async runUnfused(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Promise<Tensor[]> {
+    const [q, kT, divisor, mask, v] = inputs;
+    const scores = (await this.matmul.run(inferenceHandler, [q, kT]))[0];
+    const scaled = this.div.run(inferenceHandler, [scores, divisor])[0];
+    const masked = this.add.run(inferenceHandler, [scaled, mask])[0];
+    const probs = this.softmax.run(inferenceHandler, [masked])[0];
+    return this.matmul.run(inferenceHandler, [probs, v]);
+  }
+
+  private axis: number;
+  private matmul = new WasmMatMul();
+  private div = new WasmBinaryOp(['float32'], 'Div');
+  private add = new WasmBinaryOp(['float32'], 'Add');
+  private softmax = new WasmSoftmax();
+}
@@ -3,7 +3,6 @@
 
 import {BatchNormalization} from '../../../ops/batch-normalization';
 import {Tensor} from '../../../tensor';
-import {WasmBinding} from '../../../wasm-binding';
 import {WasmInferenceHandler} from '../inference-handler';
 
 export class WasmBatchNormalization extends BatchNormalization {
@@ -22,7 +21,7 @@ export class WasmBatchNormalization extends BatchNormalization {
 
     // create output Tensor after determining output size
     const y = new Tensor(x.dims, x.type);
-    WasmBinding.getInstance().ccall(
+    inferenceHandler.binding.ccall(
         '_batch_normalization_f32', [x.floatData, 'float32ptr'], [y.floatData, 'float32ptr', 'out'],
         [x.dims[0], 'int32'], [x.dims[1], 'int32'], [channelSize, 'int32'], [scale.floatData, 'float32ptr'],
         [b.floatData, 'float32ptr'], [mean.floatData, 'float32ptr'], [variance.floatData, 'float32ptr'],
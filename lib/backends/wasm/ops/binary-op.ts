@@ -1,107 +1,123 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT license.
 
+import {Attribute} from '../../../attribute';
 import {BinaryOp} from '../../../ops/binary-op';
+import {Operator} from '../../../operators';
 import {Tensor} from '../../../tensor';
 import {BroadcastUtil} from '../../../util';
-import {WasmBinding} from '../../../wasm-binding';
+import {WasmCallArgument, WasmCallArgumentPass, WasmSessionBinding} from '../../../wasm-binding-core';
 import {WasmInferenceHandler} from '../inference-handler';
 
+// the wasm functions of the binary operators, without the suffix of the type of their inputs
+const BINARY_OP_FUNCTIONS: {[opType: string]: string} = {
+  Add: '_add',
+  And: '_and',
+  Div: '_div',
+  Equal: '_equal',
+  Greater: '_greater',
+  Less: '_less',
+  Max: '_max',
+  Min: '_min',
+  Mul: '_mul',
+  Or: '_or',
+  Pow: '_pow',
+  PRelu: '_prelu',
+  Sub: '_sub',
+  Xor: '_xor',
+};
+
+// the suffixes of the wasm functions for the types of their inputs
+const TYPE_SUFFIXES: {[type: string]: string} = {
+  bool: '_u8',
+  float32: '_f32',
+  int32: '_i32',
+};
+
+// the argument of a wasm call for the data of a tensor
+function dataArgument(tensor: Tensor, pass: WasmCallArgumentPass = 'in'): WasmCallArgument {
+  switch (tensor.type) {
+    case 'float32':
+      return [tensor.floatData, 'float32ptr', pass];
+    case 'int32':
+      return [tensor.integerData as Int32Array, 'int32ptr', pass];
+    case 'bool':
+      return [tensor.integerData as Uint8Array, 'boolptr', pass];
+    default:
+      throw new Error(`unsupported data type by the Wasm backend: ${tensor.type}`);
+  }
+}
+
 export class WasmBinaryOp extends BinaryOp {
   constructor(typeConstraint: ReadonlyArray<Tensor.DataType>, opType: string, resultType?: Tensor.DataType) {
     super(typeConstraint, opType, resultType);
   }
 
   run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
-    const outputShape = BroadcastUtil.calcShape(inputs[0].dims, inputs[1].dims, false);
+    return [this.compute(inferenceHandler.binding, inputs[0], inputs[1])];
+  }
+
+  protected compute(binding: WasmSessionBinding, a: Tensor, b: Tensor): Tensor {
+    const outputShape = BroadcastUtil.calcShape(a.dims, b.dims, false);
     if (!outputShape) {
       throw new Error('not broadcastable');
     }
-    let fun = '';
-    // TODO: Explore better ways to deal with types than current `binaryOpType` approach
-    let binaryOpType = '';
-    switch (this.opType) {
-      case 'Add':
-        if (inputs[0].type === 'float32') {
-          fun = '_add_f32';
-          binaryOpType = 'float32InFloat32Out';
-        } else if (inputs[0].type === 'int32') {
-          fun = '_add_i32';
-          binaryOpType = 'int32InInt32Out';
-        }
-        break;
-      case 'Sub':
-        if (inputs[0].type === 'float32') {
-          fun = '_sub_f32';
-          binaryOpType = 'float32InFloat32Out';
-        } else if (inputs[0].type === 'int32') {
-          fun = '_sub_i32';
-          binaryOpType = 'int32InInt32Out';
-        }
-        break;
-      case 'Mul':
-        if (inputs[0].type === 'float32') {
-          fun = '_mul_f32';
-          binaryOpType = 'float32InFloat32Out';
-        } else if (inputs[0].type === 'int32') {
-          fun = '_mul_i32';
-          binaryOpType = 'int32InInt32Out';
-        }
-        break;
-      case 'Div':
-        if (inputs[0].type === 'float32') {
-          fun = '_div_f32';
-          binaryOpType = 'float32InFloat32Out';
-        }
-        break;
-      case 'PRelu':
-        if (inputs[0].type === 'float32') {
-          fun = '_prelu_f32';
-          binaryOpType = 'float32InFloat32Out';
-        }
-        break;
-      case 'Xor':
-        fun = '_xor_u8';
-        binaryOpType = 'boolInBoolOut';
-        break;
-      case 'Or':
-        fun = '_or_u8';
-        binaryOpType = 'boolInBoolOut';
-        break;
-      case 'And':
-        fun = '_and_u8';
-        binaryOpType = 'boolInBoolOut';
-        break;
-      default:
-        throw Error(`unsupported binary op by the Wasm backend`);
+    if (!BINARY_OP_FUNCTIONS[this.opType!] || !TYPE_SUFFIXES[a.type]) {
+      throw Error(`unsupported binary op by the Wasm backend`);
+    }
+    // the comparison operators have a bool output, the other ones an output of the type of their inputs
+    const result = new Tensor(outputShape, this.resultType || a.type);
+    binding.ccall(
+        BINARY_OP_FUNCTIONS[this.opType!] + TYPE_SUFFIXES[a.type], dataArgument(a), [a.dims.length, 'int32'],
+        [a.dims, 'int32ptr'], dataArgument(b), [b.dims.length, 'int32'], [b.dims, 'int32ptr'],
+        dataArgument(result, 'out'), [result.size, 'int32'], [outputShape.length, 'int32'], [outputShape, 'int32ptr']);
+    return result;
+  }
+}
+
+// Min and Max take any number of inputs (all broadcast together), which are reduced two by two
+export class WasmVariadicBinaryOp extends WasmBinaryOp {
+  checkInputs(inputs: Tensor[]): boolean {
+    if (!inputs || inputs.length === 0) {
+      return false;
+    }
+    return inputs.every(input => input.type === inputs[0].type) &&
+        this.typeConstraint.indexOf(inputs[0].type) !== -1;
+  }
+
+  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+    // a single input is copied by comparing it with itself
+    let result = this.compute(inferenceHandler.binding, inputs[0], inputs.length > 1 ? inputs[1] : inputs[0]);
+    for (let i = 2; i < inputs.length; i++) {
+      result = this.compute(inferenceHandler.binding, result, inputs[i]);
+    }
+    return [result];
+  }
+}
+
+export class WasmWhere implements Operator {
+  initialize(attributes: Attribute): void {}
+
+  checkInputs(inputs: Tensor[]): boolean {
+    if (!inputs || inputs.length !== 3 || inputs[0].type !== 'bool') {
+      return false;
     }
-    let result: Tensor;
-    if (binaryOpType === 'float32InFloat32Out') {
-      result = new Tensor(outputShape, 'float32');
-      WasmBinding.getInstance().ccall(
-          fun, [inputs[0].floatData, 'float32ptr'], [inputs[0].dims.length, 'int32'], [inputs[0].dims, 'int32ptr'],
-          [inputs[1].floatData, 'float32ptr'], [inputs[1].dims.length, 'int32'], [inputs[1].dims, 'int32ptr'],
-          [result.floatData, 'float32ptr', 'out'], [result.floatData.length, 'int32'], [outputShape.length, 'int32'],
-          [outputShape, 'int32ptr']);
-    } else if (binaryOpType === 'int32InInt32Out') {
-      result = new Tensor(outputShape, 'int32');
-      WasmBinding.getInstance().ccall(
-          fun, [inputs[0].integerData as Int32Array, 'int32ptr'], [inputs[0].dims.length, 'int32'],
-          [inputs[0].dims, 'int32ptr'], [inputs[1].integerData as Int32Array, 'int32ptr'],
-          [inputs[1].dims.length, 'int32'], [inputs[1].dims, 'int32ptr'],
-          [result.integerData as Int32Array, 'int32ptr', 'out'], [result.integerData.length, 'int32'],
-          [outputShape.length, 'int32'], [outputShape, 'int32ptr']);
-    } else if (binaryOpType === 'boolInBoolOut') {
-      result = new Tensor(outputShape, 'bool');
-      WasmBinding.getInstance().ccall(
-          fun, [inputs[0].integerData as Uint8Array, 'boolptr'], [inputs[0].dims.length, 'int32'],
-          [inputs[0].dims, 'int32ptr'], [inputs[1].integerData as Uint8Array, 'boolptr'],
-          [inputs[1].dims.length, 'int32'], [inputs[1].dims, 'int32ptr'],
-          [result.integerData as Uint8Array, 'boolptr', 'out'], [result.integerData.length, 'int32'],
-          [outputShape.length, 'int32'], [outputShape, 'int32ptr']);
-    } else {
-      throw new Error(`Unsupported binary op format. Probably unsupported data types.`);
+    return (inputs[1].type === 'float32' || inputs[1].type === 'int32') && inputs[1].type === inputs[2].type;
+  }
+
+  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+    const [condition, x, y] = inputs;
+    const valuesShape = BroadcastUtil.calcShape(x.dims, y.dims, false);
+    const outputShape = valuesShape && BroadcastUtil.calcShape(condition.dims, valuesShape, false);
+    if (!outputShape) {
+      throw new Error('not broadcastable');
     }
+    const result = new Tensor(outputShape, x.type);
+    inferenceHandler.binding.ccall(
+        `_where${TYPE_SUFFIXES[x.type]}`, dataArgument(condition), [condition.dims.length, 'int32'],
+        [condition.dims, 'int32ptr'], dataArgument(x), [x.dims.length, 'int32'], [x.dims, 'int32ptr'],
+        dataArgument(y), [y.dims.length, 'int32'], [y.dims, 'int32ptr'], dataArgument(result, 'out'),
+        [result.size, 'int32'], [outputShape.length, 'int32'], [outputShape, 'int32ptr']);
     return [result];
   }
 }
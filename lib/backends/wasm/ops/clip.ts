@@ -3,7 +3,6 @@
 
 import {Clip} from '../../../ops/clip';
 import {Tensor} from '../../../tensor';
-import {WasmBinding} from '../../../wasm-binding';
 import {WasmInferenceHandler} from '../inference-handler';
 
 export class WasmClip extends Clip {
@@ -11,7 +10,7 @@ export class WasmClip extends Clip {
     const result = new Tensor(inputs[0].dims, inputs[0].type);
     const size = result.floatData.length;
     if (inputs[0].type === 'float32') {
-      WasmBinding.getInstance().ccall(
+      inferenceHandler.binding.ccall(
           '_clip_f32', [inputs[0].floatData, 'float32ptr'], [result.floatData, 'float32ptr', 'out'], [size, 'int32'],
           [this.min, 'float32'], [this.max, 'float32']);
     }
@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {Concat} from '../../../ops/concat';
+import {Tensor} from '../../../tensor';
+import {ShapeUtil} from '../../../util';
+import {WasmCallArgument} from '../../../wasm-binding-core';
+import {WasmInferenceHandler} from '../inference-handler';
+
+export class WasmConcat extends Concat {
+  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+    const inputShape = inputs[0].dims;
+    const axis = ShapeUtil.normalizeAxis(this.axis, inputShape.length);
+
+    // ensure all of the non-concatenated axes match each other
+    const outputShape = inputShape.slice(0);
+    for (let i = 1; i < inputs.length; i++) {
+      const dims = inputs[i].dims;
+      for (let axisIndex = 0; axisIndex < inputShape.length; axisIndex++) {
+        if (axisIndex === axis) {
+          outputShape[axis] += dims[axisIndex];
+        } else if (inputShape[axisIndex] !== dims[axisIndex]) {
+          throw new Error(`non concat dimensions must match`);
+        }
+      }
+    }
+
+    const y = new Tensor(outputShape, inputs[0].type);
+
+    // every input contributes one contiguous run of 'inputAxisPitch' elements per index of the outer axes
+    const outerSize = ShapeUtil.sizeToDimension(outputShape, axis);
+    const outputAxisPitch = ShapeUtil.sizeFromDimension(outputShape, axis);
+    const input = new Array<WasmCallArgument>(2 * inputs.length);
+    for (let i = 0; i < inputs.length; i++) {
+      input[2 * i] = [inputs[i].floatData, 'float32ptr'];
+      input[2 * i + 1] = [ShapeUtil.sizeFromDimension(inputs[i].dims, axis), 'int32'];
+    }
+    inferenceHandler.binding.ccall(
+        '_concat_f32', [inputs.length, 'int32'], [outerSize, 'int32'], [outputAxisPitch, 'int32'],
+        [y.floatData, 'float32ptr', 'out'], ...input);
+
+    return [y];
+  }
+
+  // overriding the checkInputTypes() in the base class because Wasm backend has special type limitations
+  checkInputTypes(inputs: Tensor[]): boolean {
+    // currently Wasm backend only supports 'float32' input type
+    if (inputs[0].type !== 'float32') {
+      return false;
+    }
+
+    return super.checkInputTypes(inputs);
+  }
+}
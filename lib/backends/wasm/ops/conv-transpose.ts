@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {ConvTranspose} from '../../../ops/conv-transpose';
+import {Tensor} from '../../../tensor';
+import {PoolConvUtil, ShapeUtil} from '../../../util';
+import {runTuned, tuningKey} from '../autotuner';
+import {WasmInferenceHandler} from '../inference-handler';
+import {callPartitions, Partition, partition, partitionCandidates, PartitionAxis} from '../partitioner';
+
+// the algorithms of conv_transpose_f32: 0 lets the kernel choose (the sub-pixel convolutions for a stride of 2, the
+// GEMM plus col2im otherwise), 1 forces the GEMM plus col2im and 2 the sub-pixel convolutions
+const ALGORITHM_DEFAULT = 0;
+const ALGORITHM_COL2IM = 1;
+const ALGORITHM_SUB_PIXEL = 2;
+
+// a partition of a transposed convolution, and its algorithm
+interface ConvTransposeCandidate {
+  parts: Partition;
+  algorithm: number;
+}
+
+export class WasmConvTranspose extends ConvTranspose {
+  async run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Promise<Tensor[]> {
+    const x = inputs[0];
+    const w = inputs[1];
+    const b = inputs.length === 3 ? inputs[2] : undefined;
+
+    // if kernelShape is not specified in the attributes of this op, infer it from the weight tensor dims
+    if (this.kernelShape.length === 0) {
+      const wDims = inputs[1].dims;
+      for (let i = 2; i < wDims.length; ++i) {
+        this.kernelShape.push(wDims[i]);
+      }
+    }
+
+    // create output Tensor after determining output size (after adjusting pads based on 'outputShape' and 'autoPad')
+    const outputDims = PoolConvUtil.computeConvTransposeOutputShape(
+        x.dims, w.dims, this.group, this.strides, this.dilations, this.kernelShape, this.pads, this.outputPadding,
+        this.outputShape, this.autoPad);
+    const y = new Tensor(outputDims, x.type);
+
+    // the images of the batch are split among the workers, each one getting the whole weights
+    const imageSize = ShapeUtil.size(x.dims.slice(1));
+    const outputImageSize = ShapeUtil.size(y.dims.slice(1));
+    const axes: PartitionAxis[] = [{
+      name: 'batch',
+      extent: x.dims[0],
+      flopsPerUnit: 2 * imageSize * w.dims[1] * w.dims[2] * w.dims[3],
+      fixedBytes: 4 * (w.size + (b ? b.size : 0)),
+      bytesPerUnit: 4 * (imageSize + outputImageSize)
+    }];
+
+    // the autotuner also measures both algorithms, which the sub-pixel convolutions only support without dilation
+    const binding = inferenceHandler.binding;
+    const autotune = inferenceHandler.session.autotune;
+    const partitions = autotune ? partitionCandidates(axes) : [partition(axes)];
+    const candidates: ConvTransposeCandidate[] = partitions.map(parts => ({parts, algorithm: ALGORITHM_DEFAULT}));
+    if (autotune && this.dilations.every(d => d === 1) && this.strides.some(s => s > 1)) {
+      candidates.push(
+          {parts: partitions[0], algorithm: ALGORITHM_COL2IM}, {parts: partitions[0], algorithm: ALGORITHM_SUB_PIXEL});
+    }
+    const key = () => tuningKey(
+        'ConvTranspose', [x.dims, w.dims, y.dims],
+        [this.dilations, this.group, this.pads, this.strides, b !== undefined]);
+
+    await runTuned(
+        autotune, key, candidates, c => callPartitions(binding, c.parts, '_conv_transpose_f32', (start, end) => {
+          const xDims = [end - start].concat(x.dims.slice(1));
+          const yDims = [end - start].concat(y.dims.slice(1));
+          return [
+            [x.floatData.subarray(start * imageSize, end * imageSize), 'float32ptr'], [xDims, 'int32ptr'],
+            [w.floatData, 'float32ptr'], [w.dims, 'int32ptr'],
+            [y.floatData.subarray(start * outputImageSize, end * outputImageSize), 'float32ptr', 'out'],
+            [yDims, 'int32ptr'], [b ? b.floatData : null, 'float32ptr'], [this.dilations, 'int32ptr'],
+            [this.group, 'int32'], [this.pads, 'int32ptr'], [this.strides, 'int32ptr'], [c.algorithm, 'int32']
+          ];
+        }));
+    return [y];
+  }
+}
@@ -1,14 +1,48 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT license.
 
+import {Attribute} from '../../../attribute';
+import {Graph} from '../../../graph';
 import {Conv} from '../../../ops/conv';
 import {Tensor} from '../../../tensor';
-import {PoolConvUtil} from '../../../util';
-import {WasmBinding} from '../../../wasm-binding';
-import {PerformanceData} from '../../../wasm-binding-core';
+import {PoolConvUtil, ShapeUtil} from '../../../util';
+import {WasmSessionBinding} from '../../../wasm-binding-core';
+import {runTuned, tuningKey} from '../autotuner';
 import {WasmInferenceHandler} from '../inference-handler';
+import {callPartitions, getInputRows, Partition, partition, partitionCandidates, PartitionAxis} from '../partitioner';
+import {getInitializer, packSparseWeights, runSparse, SparseOperator, SparseWeights} from '../sparse';
+
+// a partition of a convolution, and the number of images merged into one GEMM
+interface ConvCandidate {
+  parts: Partition;
+  batchChunk: number;
+}
+
+export class WasmConv extends Conv implements SparseOperator {
+  initialize(attributes: Attribute): void {
+    super.initialize(attributes);
+    // the defaults of the base class are those of a 2-D convolution: the attributes left out are filled in
+    // checkInputs() instead, once the rank of the input is known
+    this.dilations = attributes.getInts('dilations', []);
+    this.pads = attributes.getInts('pads', []);
+    this.strides = attributes.getInts('strides', []);
+  }
+
+  checkInputs(inputs: Tensor[]): boolean {
+    if (inputs && inputs.length > 0 && inputs[0].dims.length > 2) {
+      const spatialRank = inputs[0].dims.length - 2;
+      this.dilations = this.dilations.length > 0 ? this.dilations : filledArray(spatialRank, 1);
+      this.pads = this.pads.length > 0 ? this.pads : filledArray(spatialRank * 2, 0);
+      this.strides = this.strides.length > 0 ? this.strides : filledArray(spatialRank, 1);
+    }
+    return super.checkInputs(inputs);
+  }
+
+  // conv_f32 runs the 1-D and 2-D convolutions with their own kernels, and the others with the N-d im2col
+  protected isSupportedSpatialRank(spatialRank: number): boolean {
+    return spatialRank >= 1;
+  }
 
-export class WasmConv extends Conv {
   async run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Promise<Tensor[]> {
     const x = inputs[0];
     const w = inputs[1];
@@ -27,68 +61,155 @@ export class WasmConv extends Conv {
         x.dims, w.dims, this.strides, this.dilations, this.kernelShape, this.pads, this.autoPad);
     const y = new Tensor(outputDims, x.type);
 
-    // determine number of threads needed to process
-    const numThreads = determineNumThreads(x.dims[0], this.group, w.dims[0], WasmBinding.workerNumber);
-
-    // no multi-threading
-    if (numThreads === 1) {
-      WasmBinding.getInstance().ccall(
-          '_conv_f32', [x.floatData, 'float32ptr'], [x.dims, 'int32ptr'], [w.floatData, 'float32ptr'],
-          [w.dims, 'int32ptr'], [y.floatData, 'float32ptr', 'out'], [y.dims, 'int32ptr'],
-          [b ? b.floatData : null, 'float32ptr'], [this.dilations, 'int32ptr'], [this.group, 'int32'],
-          [this.pads, 'int32ptr'], [this.strides, 'int32ptr']);
-      return [y];
+    const spatialRank = x.dims.length - 2;
+    const [batchSize, channels] = x.dims;
+    const filters = w.dims[0];
+    const imageSize = ShapeUtil.size(x.dims.slice(1));
+    const outputImageSize = ShapeUtil.size(outputDims.slice(1));
+    const outputChannelSize = outputImageSize / filters;
+    // floating point operations of one output element
+    const flops = 2 * ShapeUtil.size(w.dims.slice(1));
+    const weightBytes = 4 * (w.size + (b ? b.size : 0));
+
+    // the images of the batch get the whole weights each. the output channels (without groups) get the whole input
+    // each. the output rows of a 2-D convolution get the input rows they read, including the halo of the kernel
+    const axes: PartitionAxis[] = [{
+      name: 'batch',
+      extent: batchSize,
+      flopsPerUnit: flops * outputImageSize,
+      fixedBytes: weightBytes,
+      bytesPerUnit: 4 * (imageSize + outputImageSize)
+    }];
+    if (batchSize === 1 && this.group === 1) {
+      axes.push({
+        name: 'channels',
+        extent: filters,
+        flopsPerUnit: flops * outputChannelSize,
+        fixedBytes: 4 * imageSize,
+        bytesPerUnit: 4 * (w.size / filters + 1 + outputChannelSize)
+      });
+    }
+    if (spatialRank === 2 && batchSize === 1) {
+      const width = x.dims[3];
+      const [, , outputHeight, outputWidth] = outputDims;
+      const dilatedKernelHeight = this.dilations[0] * (w.dims[2] - 1) + 1;
+      // every output row must read at least one input row
+      if (this.pads[0] < dilatedKernelHeight && this.pads[2] < dilatedKernelHeight) {
+        axes.push({
+          name: 'rows',
+          extent: outputHeight,
+          flopsPerUnit: flops * filters * outputWidth,
+          fixedBytes: weightBytes + 4 * channels * Math.max(0, dilatedKernelHeight - this.strides[0]) * width,
+          bytesPerUnit: 4 * (channels * this.strides[0] * width + filters * outputWidth)
+        });
+      }
+    }
+    // the autotuner also measures the number of images merged into one GEMM of a 2-D convolution (see
+    // conv2D_f32_imp), 0 leaving the choice to the heuristic of the kernel
+    const binding = inferenceHandler.binding;
+    const partitions = inferenceHandler.session.autotune ? partitionCandidates(axes) : [partition(axes)];
+    const candidates: ConvCandidate[] = partitions.map(parts => ({parts, batchChunk: 0}));
+    if (inferenceHandler.session.autotune && spatialRank === 2 && batchSize > 1) {
+      candidates.push({parts: partitions[0], batchChunk: 1}, {parts: partitions[0], batchChunk: batchSize});
+    }
+    const key = () => tuningKey(
+        'Conv', [x.dims, w.dims], [this.dilations, this.group, this.pads, this.strides, b !== undefined]);
+    const runDense = () =>
+        runTuned(inferenceHandler.session.autotune, key, candidates, c => this.runParts(binding, x, w, b, y, c));
+
+    // the packed weights of a pointwise convolution multiply the images directly
+    const pointwise = spatialRank === 2 && this.strides.every(s => s === 1) && this.pads.every(p => p === 0);
+    const sparse = pointwise && this.sparseWeights && this.sparseWeights.source === w ? this.sparseWeights : undefined;
+    if (sparse) {
+      const sparseParts = partition([{
+        name: 'batch',
+        extent: batchSize,
+        flopsPerUnit: 2 * sparse.values.length * outputChannelSize,
+        fixedBytes: 4 * (sparse.rowPointers.length + sparse.blockColumns.length + sparse.values.length),
+        bytesPerUnit: 4 * (imageSize + outputImageSize)
+      }]);
+      const runSparseKernel = () => callPartitions(binding, sparseParts, '_sparse_conv_f32', (start, end) => [
+        [x.floatData.subarray(start * imageSize, end * imageSize), 'float32ptr'],
+        [[end - start].concat(x.dims.slice(1)), 'int32ptr'], [sparse.blockSize, 'int32'],
+        [sparse.rowPointers, 'int32ptr'], [sparse.blockColumns, 'int32ptr'], [sparse.values, 'float32ptr'],
+        [y.floatData.subarray(start * outputImageSize, end * outputImageSize), 'float32ptr', 'out'],
+        [[end - start].concat(y.dims.slice(1)), 'int32ptr'], [b ? b.floatData : null, 'float32ptr']
+      ]);
+      await runSparse(sparse, runDense, runSparseKernel);
+    } else {
+      await runDense();
     }
+    return [y];
+  }
 
-    // multi-threaded using web-workers
-    else {
-      // data pre-processing
-      const wDimsSp = w.dims.slice(0);
-      wDimsSp[0] = Math.floor(w.dims[0] / numThreads);
-      const wSizeSp = wDimsSp[0] * wDimsSp[1] * wDimsSp[2] * wDimsSp[3];
-
-      const wDimsFinal = w.dims.slice(0);
-      wDimsFinal[0] = w.dims[0] - (numThreads - 1) * wDimsSp[0];
-
-      const yDimsSp = [1, wDimsSp[0], outputDims[2], outputDims[3]];
-      const ySizeSp = wDimsSp[0] * outputDims[2] * outputDims[3];
-
-      const yDimsFinal = [1, wDimsFinal[0], outputDims[2], outputDims[3]];
-
-      const wArray = new Array<Float32Array>(numThreads);
-      const yArray = new Array<Float32Array>(numThreads);
-      const bArray = new Array<Float32Array>(numThreads);
-      const workerTasks = new Array<Promise<PerformanceData>>(numThreads - 1);
-
-      // function calls
-      for (let i = 0; i < numThreads; ++i) {
-        if (i !== numThreads - 1) {
-          wArray[i] = w.floatData.subarray(i * wSizeSp, (i + 1) * wSizeSp) as Float32Array;
-          yArray[i] = y.floatData.subarray(i * ySizeSp, (i + 1) * ySizeSp) as Float32Array;
-          if (b) {
-            bArray[i] = b.floatData.subarray(i * wDimsSp[0], (i + 1) * wDimsSp[0]) as Float32Array;
-          }
-          workerTasks[i] = WasmBinding.getInstance().ccallRemote(
-              i, '_conv_f32', [x.floatData, 'float32ptr'], [x.dims, 'int32ptr'], [wArray[i], 'float32ptr'],
-              [wDimsSp, 'int32ptr'], [yArray[i], 'float32ptr', 'out'], [yDimsSp, 'int32ptr'],
-              [bArray.length > 0 ? bArray[i] : null, 'float32ptr'], [this.dilations, 'int32ptr'], [this.group, 'int32'],
-              [this.pads, 'int32ptr'], [this.strides, 'int32ptr']);
-        } else {
-          wArray[i] = w.floatData.subarray(i * wSizeSp) as Float32Array;
-          yArray[i] = y.floatData.subarray(i * ySizeSp) as Float32Array;
-          if (b) {
-            bArray[i] = b.floatData.subarray(i * wDimsSp[0]) as Float32Array;
-          }
-          WasmBinding.getInstance().ccall(
-              '_conv_f32', [x.floatData, 'float32ptr'], [x.dims, 'int32ptr'], [wArray[i], 'float32ptr'],
-              [wDimsFinal, 'int32ptr'], [yArray[i], 'float32ptr', 'out'], [yDimsFinal, 'int32ptr'],
-              [bArray.length > 0 ? bArray[i] : null, 'float32ptr'], [this.dilations, 'int32ptr'], [this.group, 'int32'],
-              [this.pads, 'int32ptr'], [this.strides, 'int32ptr']);
-        }
+  private async runParts(
+      binding: WasmSessionBinding, x: Tensor, w: Tensor, b: Tensor|undefined, y: Tensor, candidate: ConvCandidate) {
+    const {parts, batchChunk} = candidate;
+    const spatialRank = x.dims.length - 2;
+    const channels = x.dims[1];
+    const filters = w.dims[0];
+    const imageSize = ShapeUtil.size(x.dims.slice(1));
+    const outputImageSize = ShapeUtil.size(y.dims.slice(1));
+    const outputChannelSize = outputImageSize / filters;
+
+    const rowOutputs: Array<[number, number, Float32Array]> = [];
+    await callPartitions(binding, parts, '_conv_f32', (start, end) => {
+      let xData = x.floatData;
+      let xDims = x.dims;
+      let wData = w.floatData;
+      let wDims = w.dims;
+      let yData = y.floatData;
+      let yDims = y.dims;
+      let bData = b ? b.floatData : null;
+      let pads = this.pads;
+      if (parts.axis === 'batch') {
+        xData = xData.subarray(start * imageSize, end * imageSize);
+        xDims = [end - start].concat(x.dims.slice(1));
+        yData = yData.subarray(start * outputImageSize, end * outputImageSize);
+        yDims = [end - start].concat(y.dims.slice(1));
+      } else if (parts.axis === 'channels') {
+        const filterSize = w.size / filters;
+        wData = wData.subarray(start * filterSize, end * filterSize);
+        wDims = [end - start].concat(w.dims.slice(1));
+        yData = yData.subarray(start * outputChannelSize, end * outputChannelSize);
+        yDims = [1, end - start].concat(y.dims.slice(2));
+        bData = bData ? bData.subarray(start, end) : null;
+      } else if (parts.axis === 'rows') {
+        // the input rows read by the output rows [start, end), and the padding left at their top and bottom
+        const [, , height, width] = x.dims;
+        const outputWidth = y.dims[3];
+        const dilatedKernelHeight = this.dilations[0] * (w.dims[2] - 1) + 1;
+        const [inputStart, inputEnd, padTop, padBottom] =
+            getInputRows(start, end, height, this.strides[0], this.pads[0], dilatedKernelHeight);
+        xData = gatherRows(xData, channels, height, width, inputStart, inputEnd);
+        xDims = [1, channels, inputEnd - inputStart, width];
+        yData = new Float32Array(filters * (end - start) * outputWidth);
+        yDims = [1, filters, end - start, outputWidth];
+        pads = [padTop, this.pads[1], padBottom, this.pads[3]];
+        rowOutputs.push([start, end, yData]);
+      }
+      return [
+        [spatialRank, 'int32'], [xData, 'float32ptr'], [xDims, 'int32ptr'], [wData, 'float32ptr'], [wDims, 'int32ptr'],
+        [yData, 'float32ptr', 'out'], [yDims, 'int32ptr'], [bData, 'float32ptr'], [this.dilations, 'int32ptr'],
+        [this.group, 'int32'], [pads, 'int32ptr'], [this.strides, 'int32ptr'], [batchChunk, 'int32']
+      ];
+    });
+
+    // the outputs of a split along the rows are scattered back to the rows of each output channel
+    const [, , outputHeight, outputWidth] = y.dims;
+    for (const [start, end, part] of rowOutputs) {
+      const rowsSize = (end - start) * outputWidth;
+      for (let f = 0; f < filters; f++) {
+        y.floatData.set(part.subarray(f * rowsSize, (f + 1) * rowsSize), (f * outputHeight + start) * outputWidth);
       }
+    }
+  }
 
-      await Promise.all(workerTasks);
-      return [y];
+  prepareSparseWeights(node: Graph.Node, graph: Graph, threshold: number): void {
+    // the weights [M, C, 1, 1] of a pointwise convolution without groups are a matrix [M, C]
+    const w = getInitializer(node, graph, 1);
+    if (w && w.type === 'float32' && w.dims.length === 4 && w.dims[2] === 1 && w.dims[3] === 1 && this.group === 1) {
+      this.sparseWeights = packSparseWeights(node, w, w.floatData, w.dims[0], w.dims[1], threshold);
     }
   }
 
@@ -105,22 +226,25 @@ export class WasmConv extends Conv {
 
     return true;
   }
+
+  sparseWeights?: SparseWeights;
 }
 
-// This function will determine the number of threads
-// The strategy to parallelize is to parallelize on number of filter maps in the kernel
-// (i.e.) number of output channels
-function determineNumThreads(batchSize: number, group: number, numFilterMaps: number, numWebWorkers: number): number {
-  // single threaded if:
-  // 1) batch size is not 1 (data splitting logic across threads is specific to batch size being 1)
-  // 2) multi-threading not supported yet for mulitple groups
-  // 3) if number of filter maps is 1
-  // 4) number of web workers is 0
-  if (batchSize !== 1 || group !== 1 || numFilterMaps === 1 || numWebWorkers <= 0) {
-    return 1;
+// copy the rows [start, end) of every channel of an image
+function gatherRows(
+    x: Tensor.FloatType, channels: number, height: number, width: number, start: number, end: number): Float32Array {
+  const rows = new Float32Array(channels * (end - start) * width);
+  for (let c = 0; c < channels; c++) {
+    rows.set(x.subarray((c * height + start) * width, (c * height + end) * width), c * (end - start) * width);
   }
+  return rows;
+}
 
-  // multi-threaded:
-  // determine number of threads
-  return Math.min(numFilterMaps, numWebWorkers + 1);
+// an array of length copies of value
+function filledArray(length: number, value: number): number[] {
+  const array: number[] = [];
+  for (let i = 0; i < length; i++) {
+    array.push(value);
+  }
+  return array;
 }
@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {Expand} from '../../../ops/expand';
+import {Tensor} from '../../../tensor';
+import {BroadcastUtil} from '../../../util';
+import {WasmInferenceHandler} from '../inference-handler';
+
+export class WasmExpand extends Expand {
+  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+    const x = inputs[0];
+    const outputDims = BroadcastUtil.calcShape(x.dims, Array.from(inputs[1].integerData), false);
+    if (!outputDims) {
+      throw new Error('not broadcastable');
+    }
+
+    // broadcasting a dimension of size 1 is the same as repeating it, so Expand is a Tile of the input
+    // left-padded with 1s to the output rank
+    const rank = outputDims.length;
+    const xDims = new Array<number>(rank - x.dims.length).fill(1).concat(x.dims);
+    const repeats = outputDims.map((dim, i) => dim / xDims[i]);
+    const y = new Tensor(outputDims, x.type);
+    inferenceHandler.binding.ccall(
+        '_tile_f32', [x.floatData, 'float32ptr'], [xDims, 'int32ptr'], [rank, 'int32'], [repeats, 'int32ptr'],
+        [y.floatData, 'float32ptr', 'out']);
+
+    return [y];
+  }
+
+  // overriding the checkInputTypes() in the base class because Wasm backend has special type limitations
+  checkInputTypes(inputs: Tensor[]): boolean {
+    // currently Wasm backend only supports 'float32' input type
+    if (inputs[0].type !== 'float32') {
+      return false;
+    }
+
+    return super.checkInputTypes(inputs);
+  }
+}
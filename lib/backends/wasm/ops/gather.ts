@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {Gather} from '../../../ops/gather';
+import {Tensor} from '../../../tensor';
+import {ShapeUtil} from '../../../util';
+import {WasmInferenceHandler} from '../inference-handler';
+
+export class WasmGather extends Gather {
+  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+    const x = inputs[0];
+    const indices = inputs[1];
+    const axis = ShapeUtil.normalizeAxis(this.axis, x.dims.length);
+
+    // the gathered axis is replaced by the dimensions of 'indices'
+    const outputDims = x.dims.slice(0, axis).concat(indices.dims).concat(x.dims.slice(axis + 1));
+    const y = new Tensor(outputDims, x.type);
+    inferenceHandler.binding.ccall(
+        '_gather_f32', [x.floatData, 'float32ptr'], [x.dims, 'int32ptr'], [x.dims.length, 'int32'], [axis, 'int32'],
+        [indices.integerData as Int32Array, 'int32ptr'], [indices.integerData.length, 'int32'],
+        [y.floatData, 'float32ptr', 'out']);
+
+    return [y];
+  }
+
+  // overriding the checkInputTypes() in the base class because Wasm backend has special type limitations
+  checkInputTypes(inputs: Tensor[]): boolean {
+    // currently Wasm backend only supports 'float32' data and 'int32' indices
+    if (inputs[0].type !== 'float32' || inputs[1].type !== 'int32') {
+      return false;
+    }
+
+    return true;
+  }
+}
@@ -1,32 +1,93 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT license.
 
+import {Graph} from '../../../graph';
 import {Gemm} from '../../../ops/gemm';
 import {Tensor} from '../../../tensor';
 import {BroadcastUtil, GemmUtil} from '../../../util';
-import {WasmBinding} from '../../../wasm-binding';
+import {runTuned, tuningKey} from '../autotuner';
 import {WasmInferenceHandler} from '../inference-handler';
+import {callPartitions, partition, partitionCandidates, PartitionAxis} from '../partitioner';
+import {getInitializer, packSparseWeights, runSparse, SparseOperator, SparseWeights, transposeMatrix} from '../sparse';
 
-export class WasmGemm extends Gemm {
-  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+export class WasmGemm extends Gemm implements SparseOperator {
+  async run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Promise<Tensor[]> {
     const a = inputs[0];
     const b = inputs[1];
     const c = inputs[2];
 
     const [M, N] = GemmUtil.getShapeOfGemmResult(a.dims, this.transA, b.dims, this.transB, c?.dims);
+    const K = this.transA ? a.dims[0] : a.dims[1];
     const y = new Tensor([M, N], a.type);
-    if (c && !BroadcastUtil.calc(y, c, (a, b) => (b), true)) {
-      throw new Error(`c is not broadcastable to the shape of the result of the Gemm operator`);
+
+    // the rows of the result are split among the workers, each one gets the whole B
+    const axes: PartitionAxis[] =
+        [{name: 'rows', extent: M, flopsPerUnit: 2 * K * N, fixedBytes: 4 * b.size, bytesPerUnit: 4 * (K + 2 * N)}];
+    const binding = inferenceHandler.binding;
+    const autotune = inferenceHandler.session.autotune;
+    const sparse = this.sparseWeights && this.sparseWeights.source === b ? this.sparseWeights : undefined;
+    // the result is accumulated to C, so it starts from C again for every run of the autotuner or of the sparse
+    // weights measurement
+    const initializeResult = () => {
+      if (c && !BroadcastUtil.calc(y, c, (a, b) => (b), true)) {
+        throw new Error(`c is not broadcastable to the shape of the result of the Gemm operator`);
+      } else if (!c && (autotune || sparse)) {
+        y.floatData.fill(0);
+      }
+    };
+    // the rows of a transposed A are its columns
+    const getRows = (start: number, end: number) =>
+        this.transA ? gatherColumns(a.floatData, K, M, start, end) : a.floatData.subarray(start * K, end * K);
+
+    const candidates = autotune ? partitionCandidates(axes) : [partition(axes)];
+    const key = () => tuningKey('Gemm', [a.dims, b.dims], [this.transA, this.transB]);
+    const runDense = () => runTuned(autotune, key, candidates, parts => {
+      initializeResult();
+      return callPartitions(binding, parts, '_gemm_f32', (start, end) => [
+        [this.transA, 'bool'], [this.transB, 'bool'], [end - start, 'int32'], [N, 'int32'], [K, 'int32'],
+        [this.alpha, 'float32'], [getRows(start, end), 'float32ptr'], [b.floatData, 'float32ptr'],
+        [this.beta, 'float32'], [y.floatData.subarray(start * N, end * N), 'float32ptr', 'inout']
+      ]);
+    });
+    if (!sparse) {
+      await runDense();
+      return [y];
     }
-    WasmBinding.getInstance().ccall(
-        '_gemm_f32', [this.transA, 'bool'], [this.transB, 'bool'], [this.transA ? a.dims[1] : a.dims[0], 'int32'],
-        [this.transB ? b.dims[0] : b.dims[1], 'int32'], [this.transA ? a.dims[0] : a.dims[1], 'int32'],
-        [this.alpha, 'float32'], [a.floatData, 'float32ptr'], [b.floatData, 'float32ptr'], [this.beta, 'float32'],
-        [y.floatData, 'float32ptr', 'inout']);
+
+    // the sparse kernel multiplies the rows of A with the packed B (or the packed transpose of B)
+    const sparseBytes = 4 * (sparse.rowPointers.length + sparse.blockColumns.length + sparse.values.length);
+    const sparseParts = partition([{
+      name: 'rows',
+      extent: M,
+      flopsPerUnit: 2 * sparse.values.length,
+      fixedBytes: sparseBytes,
+      bytesPerUnit: 4 * (K + 2 * N)
+    }]);
+    await runSparse(sparse, runDense, () => {
+      initializeResult();
+      return callPartitions(binding, sparseParts, '_sparse_gemm_f32', (start, end) => [
+        [end - start, 'int32'], [N, 'int32'], [K, 'int32'], [this.alpha, 'float32'],
+        [getRows(start, end), 'float32ptr'], [sparse.blockSize, 'int32'], [sparse.rowPointers, 'int32ptr'],
+        [sparse.blockColumns, 'int32ptr'], [sparse.values, 'float32ptr'], [this.beta, 'float32'],
+        [y.floatData.subarray(start * N, end * N), 'float32ptr', 'inout']
+      ]);
+    });
 
     return [y];
   }
 
+  prepareSparseWeights(node: Graph.Node, graph: Graph, threshold: number): void {
+    // the sparse kernel takes A as [M, K], so a transposed A keeps the dense kernel
+    const b = getInitializer(node, graph, 1);
+    if (this.transA || !b || b.type !== 'float32' || b.dims.length !== 2) {
+      return;
+    }
+    // the sparse kernel takes B as [K, N]
+    const [K, N] = this.transB ? [b.dims[1], b.dims[0]] : b.dims;
+    const data = this.transB ? transposeMatrix(b.floatData, N, K) : b.floatData;
+    this.sparseWeights = packSparseWeights(node, b, data, K, N, threshold);
+  }
+
   // overriding the checkInputTypes() in the base class because Wasm backend has special type limitations
   checkInputTypes(inputs: Tensor[]): boolean {
     // currently Wasm backend only supports 'float32' input type
@@ -40,4 +101,19 @@ export class WasmGemm extends Gemm {
 
     return true;
   }
+
+  sparseWeights?: SparseWeights;
+}
+
+// copy the columns [start, end) of a matrix
+function gatherColumns(
+    data: Tensor.FloatType, rows: number, cols: number, start: number, end: number): Tensor.FloatType {
+  if (start === 0 && end === cols) {
+    return data;
+  }
+  const columns = new Float32Array(rows * (end - start));
+  for (let r = 0; r < rows; r++) {
+    columns.set(data.subarray(r * cols + start, r * cols + end), r * (end - start));
+  }
+  return columns;
 }
@@ -1,15 +1,19 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT license.
 
+import {Graph} from '../../../graph';
 import {MatMul} from '../../../ops/matmul';
 import {Tensor} from '../../../tensor';
 import {BroadcastUtil, MatMulUtil, ShapeUtil} from '../../../util';
-import {WasmBinding} from '../../../wasm-binding';
+import {runTuned, tuningKey} from '../autotuner';
 import {WasmInferenceHandler} from '../inference-handler';
+import {callPartitions, Partition, partition, partitionCandidates, PartitionAxis} from '../partitioner';
+import {getInitializer, packSparseWeights, runSparse, SparseOperator, SparseWeights} from '../sparse';
 
-export class WasmMatMul extends MatMul {
-  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
-    const [dimsA, dimsB] = MatMulUtil.preprocessInputShapes(inputs[0].dims, inputs[1].dims);
+export class WasmMatMul extends MatMul implements SparseOperator {
+  async run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Promise<Tensor[]> {
+    const [a, b] = inputs;
+    const [dimsA, dimsB] = MatMulUtil.preprocessInputShapes(a.dims, b.dims);
     const outputShape = BroadcastUtil.calcShape(dimsA, dimsB, true);
     if (!outputShape) {
       // the inputs cannot broadcast or cannot multiply
@@ -18,17 +22,95 @@ export class WasmMatMul extends MatMul {
 
     const outputSize = ShapeUtil.size(outputShape);
     const resultData = new Float32Array(outputSize);
-    WasmBinding.getInstance().ccall(
-        '_matmul_f32', [inputs[0].floatData, 'float32ptr'], [inputs[0].dims, 'int32ptr'],
-        [inputs[0].dims.length, 'int32'], [inputs[1].floatData, 'float32ptr'], [inputs[1].dims, 'int32ptr'],
-        [inputs[1].dims.length, 'int32'], [resultData, 'float32ptr', 'out'], [resultData.length, 'int32'],
-        [outputShape, 'int32ptr'], [outputShape.length, 'int32']);
-    MatMulUtil.postprocessOutputShape(outputShape as number[], inputs[0].dims.length, inputs[1].dims.length);
-    const result = new Tensor(outputShape, inputs[0].type);
+    const [M, K] = dimsA.slice(-2);
+    const N = dimsB[dimsB.length - 1];
+    // a 2-D B is shared by all the rows of A, whatever the rank of A. otherwise the matrices of A and B are paired one
+    // to one if they have the same batch dimensions
+    const axes: PartitionAxis[] = [];
+    if (a.dims.length >= 2 && b.dims.length === 2) {
+      axes.push({
+        name: 'rows',
+        extent: a.size / K,
+        flopsPerUnit: 2 * K * N,
+        fixedBytes: 4 * b.size,
+        bytesPerUnit: 4 * (K + N)
+      });
+    } else if (
+        a.dims.length > 2 && b.dims.length === a.dims.length &&
+        ShapeUtil.areEqual(a.dims.slice(0, -2), b.dims.slice(0, -2))) {
+      axes.push({
+        name: 'batch',
+        extent: ShapeUtil.size(a.dims.slice(0, -2)),
+        flopsPerUnit: 2 * M * K * N,
+        fixedBytes: 0,
+        bytesPerUnit: 4 * (M * K + K * N + M * N)
+      });
+    }
+    const binding = inferenceHandler.binding;
+    const autotune = inferenceHandler.session.autotune;
+    const candidates = autotune ? partitionCandidates(axes) : [partition(axes)];
+    const key = () => tuningKey('MatMul', [a.dims, b.dims]);
+    const runPartitions = (parts: Partition) => callPartitions(binding, parts, '_matmul_f32', (start, end) => {
+      let aPart = a.floatData;
+      let aDims = a.dims;
+      let bPart = b.floatData;
+      let bDims = b.dims;
+      let resultPart = resultData;
+      let resultDims = outputShape;
+      if (parts.axis === 'rows') {
+        aPart = aPart.subarray(start * K, end * K);
+        aDims = [end - start, K];
+        resultPart = resultPart.subarray(start * N, end * N);
+        resultDims = [end - start, N];
+      } else if (parts.axis === 'batch') {
+        aPart = aPart.subarray(start * M * K, end * M * K);
+        aDims = [end - start, M, K];
+        bPart = bPart.subarray(start * K * N, end * K * N);
+        bDims = [end - start, K, N];
+        resultPart = resultPart.subarray(start * M * N, end * M * N);
+        resultDims = [end - start, M, N];
+      }
+      return [
+        [aPart, 'float32ptr'], [aDims, 'int32ptr'], [aDims.length, 'int32'], [bPart, 'float32ptr'],
+        [bDims, 'int32ptr'], [bDims.length, 'int32'], [resultPart, 'float32ptr', 'out'], [resultPart.length, 'int32'],
+        [resultDims, 'int32ptr'], [resultDims.length, 'int32']
+      ];
+    });
+    const runDense = () => runTuned(autotune, key, candidates, runPartitions);
+
+    // the sparse kernel multiplies every row of A, whatever its rank, with the packed 2-D B
+    const sparse = this.sparseWeights && this.sparseWeights.source === b ? this.sparseWeights : undefined;
+    if (sparse) {
+      const sparseParts = partition([{
+        name: 'rows',
+        extent: a.size / K,
+        flopsPerUnit: 2 * sparse.values.length,
+        fixedBytes: 4 * (sparse.rowPointers.length + sparse.blockColumns.length + sparse.values.length),
+        bytesPerUnit: 4 * (K + N)
+      }]);
+      const runSparseKernel = () => callPartitions(binding, sparseParts, '_sparse_gemm_f32', (start, end) => [
+        [end - start, 'int32'], [N, 'int32'], [K, 'int32'], [1, 'float32'],
+        [a.floatData.subarray(start * K, end * K), 'float32ptr'], [sparse.blockSize, 'int32'],
+        [sparse.rowPointers, 'int32ptr'], [sparse.blockColumns, 'int32ptr'], [sparse.values, 'float32ptr'],
+        [0, 'float32'], [resultData.subarray(start * N, end * N), 'float32ptr', 'out']
+      ]);
+      await runSparse(sparse, runDense, runSparseKernel);
+    } else {
+      await runDense();
+    }
+    MatMulUtil.postprocessOutputShape(outputShape as number[], a.dims.length, b.dims.length);
+    const result = new Tensor(outputShape, a.type);
     result.floatData.set(resultData);
     return [result];
   }
 
+  prepareSparseWeights(node: Graph.Node, graph: Graph, threshold: number): void {
+    const b = getInitializer(node, graph, 1);
+    if (b && b.type === 'float32' && b.dims.length === 2) {
+      this.sparseWeights = packSparseWeights(node, b, b.floatData, b.dims[0], b.dims[1], threshold);
+    }
+  }
+
   // overriding the checkInputTypes() in the base class because Wasm backend has special type limitations
   checkInputTypes(inputs: Tensor[]): boolean {
     // currently Wasm backend only supports 'float32' input type
@@ -42,4 +124,6 @@ export class WasmMatMul extends MatMul {
 
     return true;
   }
+
+  sparseWeights?: SparseWeights;
 }
@@ -0,0 +1,274 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {Attribute} from '../../../attribute';
+import {BatchNormalization} from '../../../ops/batch-normalization';
+import {Conv} from '../../../ops/conv';
+import {AveragePool, GlobalAveragePool, GlobalMaxPool, MaxPool} from '../../../ops/pool';
+import {Operator} from '../../../operators';
+import {Tensor} from '../../../tensor';
+import {PoolConvUtil, ShapeUtil} from '../../../util';
+import {runTuned, tuningKey} from '../autotuner';
+import {WasmInferenceHandler} from '../inference-handler';
+import {callPartitions, partition, partitionCandidates, PartitionAxis} from '../partitioner';
+
+// the operators of this file work on tensors in the blocked NCHWc layout [N, ceil(C / c), H, W, c], created by
+// Graph.Transformer.convertToBlockedLayout(). the channels padding the last block hold unspecified (but finite) values
+
+// the dims [N, ceil(C / block), H, W, block] of a tensor of dims [N, C, H, W] in the blocked layout
+function blockedDims(dims: ReadonlyArray<number>, block: number): number[] {
+  return [dims[0], Math.ceil(dims[1] / block), dims[2], dims[3], block];
+}
+
+// the dims [N, C, H, W] of a blocked tensor, including the padding channels
+function paddedDims(dims: ReadonlyArray<number>): number[] {
+  return [dims[0], dims[1] * dims[4], dims[2], dims[3]];
+}
+
+function isBlocked(input: Tensor): boolean {
+  return input.type === 'float32' && input.dims.length === 5;
+}
+
+// the weights [M, C, kH, kW] of a convolution, packed in blocks [ceil(M / c), ceil(C / c), kH, kW, c (input channel),
+// c (output channel)] padded with zeros, so that the padding channels of the input do not contribute to the output
+function packWeights(w: Tensor, block: number): Float32Array {
+  const [filters, channels, kernelHeight, kernelWidth] = w.dims;
+  const kernelSize = kernelHeight * kernelWidth;
+  const channelBlocks = Math.ceil(channels / block);
+  const packed = new Float32Array(Math.ceil(filters / block) * channelBlocks * kernelSize * block * block);
+  const data = w.floatData;
+  for (let f = 0; f < filters; f++) {
+    for (let c = 0; c < channels; c++) {
+      const offset = (Math.floor(f / block) * channelBlocks + Math.floor(c / block)) * kernelSize * block * block +
+          c % block * block + f % block;
+      for (let k = 0; k < kernelSize; k++) {
+        packed[offset + k * block * block] = data[(f * channels + c) * kernelSize + k];
+      }
+    }
+  }
+  return packed;
+}
+
+export class WasmReorderToNCHWc implements Operator {
+  initialize(attributes: Attribute): void {
+    this.block = attributes.getInt('block');
+  }
+
+  checkInputs(inputs: Tensor[]): boolean {
+    return inputs.length === 1 && inputs[0].type === 'float32' && inputs[0].dims.length === 4;
+  }
+
+  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+    const x = inputs[0];
+    const y = new Tensor(blockedDims(x.dims, this.block), x.type);
+    inferenceHandler.binding.ccall(
+        '_reorder_to_nchwc_f32', [x.floatData, 'float32ptr'], [x.dims, 'int32ptr'], [this.block, 'int32'],
+        [y.floatData, 'float32ptr', 'out']);
+    return [y];
+  }
+
+  private block: number;
+}
+
+export class WasmReorderFromNCHWc implements Operator {
+  initialize(attributes: Attribute): void {
+    this.channels = attributes.getInt('channels');
+  }
+
+  checkInputs(inputs: Tensor[]): boolean {
+    return inputs.length === 1 && isBlocked(inputs[0]) && this.channels <= inputs[0].dims[1] * inputs[0].dims[4];
+  }
+
+  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+    const x = inputs[0];
+    const y = new Tensor([x.dims[0], this.channels, x.dims[2], x.dims[3]], x.type);
+    inferenceHandler.binding.ccall(
+        '_reorder_from_nchwc_f32', [x.floatData, 'float32ptr'], [x.dims, 'int32ptr'], [this.channels, 'int32'],
+        [y.floatData, 'float32ptr', 'out']);
+    return [y];
+  }
+
+  private channels: number;
+}
+
+export class WasmConvNCHWc extends Conv {
+  checkInputs(inputs: Tensor[]): boolean {
+    if (!inputs || (inputs.length !== 2 && inputs.length !== 3) || !isBlocked(inputs[0]) ||
+        inputs[1].dims.length !== 4 || this.group !== 1) {
+      return false;
+    }
+    // the input channels must fill all the blocks but the last one
+    const [, blocks, , , block] = inputs[0].dims;
+    const channels = inputs[1].dims[1];
+    if (channels > blocks * block || channels <= (blocks - 1) * block) {
+      return false;
+    }
+    if (inputs.length === 3 && (inputs[2].dims.length !== 1 || inputs[1].dims[0] !== inputs[2].dims[0])) {
+      return false;
+    }
+    if (this.dilations.length !== 2 || this.strides.length !== 2 || this.pads.length !== 4 ||
+        (this.kernelShape.length !== 0 && this.kernelShape.length !== 2)) {
+      return false;
+    }
+    return this.checkInputTypes(inputs);
+  }
+
+  async run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Promise<Tensor[]> {
+    const x = inputs[0];
+    const w = inputs[1];
+    const b = inputs.length === 3 ? inputs[2] : undefined;
+    const block = x.dims[4];
+
+    if (this.kernelShape.length === 0) {
+      this.kernelShape.push(w.dims[2], w.dims[3]);
+    }
+    const outputDims = PoolConvUtil.computeConvOutputShape(
+        paddedDims(x.dims), w.dims, this.strides, this.dilations, this.kernelShape, this.pads, this.autoPad);
+    const y = new Tensor(blockedDims(outputDims, block), x.type);
+
+    // the weights are packed the first time they are seen, constant weights are packed once
+    if (!this.packedWeights || this.packedWeights.source !== w || this.packedWeights.block !== block) {
+      this.packedWeights = {source: w, block, data: packWeights(w, block)};
+    }
+    const packed = this.packedWeights.data;
+
+    // the images of the batch are split among the workers, each one getting the whole weights
+    const imageSize = ShapeUtil.size(x.dims.slice(1));
+    const outputImageSize = ShapeUtil.size(y.dims.slice(1));
+    const axes: PartitionAxis[] = [{
+      name: 'batch',
+      extent: x.dims[0],
+      flopsPerUnit: 2 * outputImageSize * x.dims[1] * block * w.dims[2] * w.dims[3],
+      fixedBytes: 4 * (packed.length + (b ? b.size : 0)),
+      bytesPerUnit: 4 * (imageSize + outputImageSize)
+    }];
+    const binding = inferenceHandler.binding;
+    const autotune = inferenceHandler.session.autotune;
+    const candidates = autotune ? partitionCandidates(axes) : [partition(axes)];
+    const key = () => tuningKey('ConvNCHWc', [x.dims, w.dims], [this.dilations, this.pads, this.strides]);
+
+    await runTuned(
+        autotune, key, candidates, parts => callPartitions(binding, parts, '_conv_nchwc_f32', (start, end) => {
+          const xDims = [end - start].concat(x.dims.slice(1));
+          const yDims = [end - start].concat(y.dims.slice(1));
+          return [
+            [x.floatData.subarray(start * imageSize, end * imageSize), 'float32ptr'], [xDims, 'int32ptr'],
+            [packed, 'float32ptr'], [w.dims, 'int32ptr'], [b ? b.floatData : null, 'float32ptr'],
+            [y.floatData.subarray(start * outputImageSize, end * outputImageSize), 'float32ptr', 'out'],
+            [yDims, 'int32ptr'], [this.dilations, 'int32ptr'], [this.pads, 'int32ptr'], [this.strides, 'int32ptr']
+          ];
+        }));
+    return [y];
+  }
+
+  private packedWeights?: {source: Tensor; block: number; data: Float32Array};
+}
+
+export class WasmAveragePoolNCHWc extends AveragePool {
+  checkInputs(inputs: Tensor[]): boolean {
+    return inputs.length === 1 && isBlocked(inputs[0]);
+  }
+
+  async run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Promise<Tensor[]> {
+    return poolNCHWc(
+        inferenceHandler, false, '_average_pool_nchwc_f32', inputs[0], this.autoPad,
+        this.countIncludePad, this.kernelShape, this.pads, this.strides);
+  }
+}
+
+export class WasmGlobalAveragePoolNCHWc extends GlobalAveragePool {
+  checkInputs(inputs: Tensor[]): boolean {
+    return inputs.length === 1 && isBlocked(inputs[0]);
+  }
+
+  async run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Promise<Tensor[]> {
+    return poolNCHWc(
+        inferenceHandler, true, '_average_pool_nchwc_f32', inputs[0], 'NOTSET', false, [], [], []);
+  }
+}
+
+export class WasmMaxPoolNCHWc extends MaxPool {
+  checkInputs(inputs: Tensor[]): boolean {
+    return inputs.length === 1 && isBlocked(inputs[0]);
+  }
+
+  async run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Promise<Tensor[]> {
+    return poolNCHWc(
+        inferenceHandler, false, '_max_pool_nchwc_f32', inputs[0], this.autoPad, false,
+        this.kernelShape, this.pads, this.strides);
+  }
+}
+
+export class WasmGlobalMaxPoolNCHWc extends GlobalMaxPool {
+  checkInputs(inputs: Tensor[]): boolean {
+    return inputs.length === 1 && isBlocked(inputs[0]);
+  }
+
+  async run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Promise<Tensor[]> {
+    return poolNCHWc(
+        inferenceHandler, true, '_max_pool_nchwc_f32', inputs[0], 'NOTSET', false, [], [], []);
+  }
+}
+
+export class WasmBatchNormalizationNCHWc extends BatchNormalization {
+  checkInputs(inputs: Tensor[]): boolean {
+    if (!inputs || inputs.length !== 5 || !isBlocked(inputs[0])) {
+      return false;
+    }
+    const channels = inputs[1].dims[0];
+    return inputs.slice(1).every(input => input.type === 'float32' && ShapeUtil.areEqual(input.dims, [channels])) &&
+        channels <= inputs[0].dims[1] * inputs[0].dims[4];
+  }
+
+  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+    const x = inputs[0];
+    const y = new Tensor(x.dims, x.type);
+    inferenceHandler.binding.ccall(
+        '_batch_normalization_nchwc_f32', [x.floatData, 'float32ptr'], [x.dims, 'int32ptr'],
+        [inputs[1].dims[0], 'int32'], [inputs[1].floatData, 'float32ptr'], [inputs[2].floatData, 'float32ptr'],
+        [inputs[3].floatData, 'float32ptr'], [inputs[4].floatData, 'float32ptr'], [this.epsilon, 'float32'],
+        [y.floatData, 'float32ptr', 'out']);
+    return [y];
+  }
+}
+
+// the planes (the blocks of channels of every image) are pooled independently, so they are split among the workers
+async function poolNCHWc(
+    inferenceHandler: WasmInferenceHandler, isGlobalOperator: boolean, poolFunc: string, input: Tensor, autoPad: string,
+    countIncludePad: boolean, kernelShape: number[], pads: number[], strides: number[]): Promise<Tensor[]> {
+  const inputDims = paddedDims(input.dims);
+  PoolConvUtil.adjustPoolAttributes(isGlobalOperator, inputDims, kernelShape, strides, pads);
+  const outputDims =
+      PoolConvUtil.computePoolOutputShape(isGlobalOperator, inputDims, strides, kernelShape, pads, autoPad);
+  const y = new Tensor(blockedDims(outputDims, input.dims[4]), input.type);
+
+  const planes = input.dims[0] * input.dims[1];
+  const inputPlaneSize = ShapeUtil.size(input.dims.slice(2));
+  const outputPlaneSize = ShapeUtil.size(y.dims.slice(2));
+  const axes: PartitionAxis[] = [{
+    name: 'planes',
+    extent: planes,
+    flopsPerUnit: outputPlaneSize * ShapeUtil.size(kernelShape),
+    fixedBytes: 0,
+    bytesPerUnit: 4 * (inputPlaneSize + outputPlaneSize)
+  }];
+  const binding = inferenceHandler.binding;
+  const autotune = inferenceHandler.session.autotune;
+  const candidates = autotune ? partitionCandidates(axes) : [partition(axes)];
+  const key = () => tuningKey(poolFunc, [input.dims], [isGlobalOperator, kernelShape, pads, strides]);
+
+  const X = input.floatData;
+  const Y = y.floatData;
+  await runTuned(autotune, key, candidates, parts => callPartitions(binding, parts, poolFunc, (start, end) => {
+    const xDims = [1, end - start].concat(input.dims.slice(2));
+    const yDims = [1, end - start].concat(y.dims.slice(2));
+    return [
+      [isGlobalOperator, 'bool'], [X.subarray(start * inputPlaneSize, end * inputPlaneSize), 'float32ptr'],
+      [xDims, 'int32ptr'], [Y.subarray(start * outputPlaneSize, end * outputPlaneSize), 'float32ptr', 'out'],
+      [yDims, 'int32ptr'], [kernelShape, 'int32ptr'], [pads, 'int32ptr'], [strides, 'int32ptr'],
+      [countIncludePad, 'bool']
+    ];
+  }));
+
+  return [y];
+}
@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {Pad} from '../../../ops/pad';
+import {Tensor} from '../../../tensor';
+import {ShapeUtil} from '../../../util';
+import {WasmInferenceHandler} from '../inference-handler';
+
+export class WasmPad extends Pad {
+  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+    const x = inputs[0];
+    const y = new Tensor(ShapeUtil.padShape(x.dims, this.pads), x.type);
+    inferenceHandler.binding.ccall(
+        '_pad_f32', [x.floatData, 'float32ptr'], [x.dims, 'int32ptr'], [x.dims.length, 'int32'],
+        [y.floatData, 'float32ptr', 'out'], [y.dims, 'int32ptr'], [this.pads, 'int32ptr'],
+        [getPadMode(this.mode), 'int32'], [this.value, 'float32']);
+
+    return [y];
+  }
+
+  // overriding the checkInputTypes() in the base class because Wasm backend has special type limitations
+  checkInputTypes(inputs: Tensor[]): boolean {
+    // currently Wasm backend only supports 'float32' input type
+    if (inputs[0].type !== 'float32') {
+      return false;
+    }
+
+    return true;
+  }
+}
+
+// pad mode as understood by the Wasm kernel
+function getPadMode(mode: string): number {
+  switch (mode) {
+    case 'constant':
+      return 0;
+    case 'reflect':
+      return 1;
+    case 'edge':
+      return 2;
+    default:
+      throw new Error('Illegal pad mode.');
+  }
+}
@@ -4,9 +4,9 @@
 import {AveragePool, GlobalAveragePool, GlobalMaxPool, MaxPool} from '../../../ops/pool';
 import {Tensor} from '../../../tensor';
 import {PoolConvUtil, ShapeUtil} from '../../../util';
-import {WasmBinding} from '../../../wasm-binding';
-import {PerformanceData} from '../../../wasm-binding-core';
+import {runTuned, tuningKey} from '../autotuner';
 import {WasmInferenceHandler} from '../inference-handler';
+import {callPartitions, partition, partitionCandidates, PartitionAxis} from '../partitioner';
 
 export class WasmAveragePool extends AveragePool {
   // overriding the checkInputTypes() in the base class because Wasm backend has special type limitations
@@ -15,7 +15,9 @@ export class WasmAveragePool extends AveragePool {
   }
 
   async run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Promise<Tensor[]> {
-    return averagePool(inputs[0], this.autoPad, this.countIncludePad, this.kernelShape, this.pads, this.strides);
+    return averagePool(
+        inferenceHandler, inputs[0], this.autoPad, this.countIncludePad, this.kernelShape, this.pads,
+        this.strides);
   }
 }
 
@@ -26,7 +28,7 @@ export class WasmGlobalAveragePool extends GlobalAveragePool {
   }
 
   async run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Promise<Tensor[]> {
-    return globalAveragePool(inputs[0]);
+    return globalAveragePool(inferenceHandler, inputs[0]);
   }
 }
 
@@ -37,7 +39,8 @@ export class WasmMaxPool extends MaxPool {
   }
 
   async run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Promise<Tensor[]> {
-    return maxPool(inputs[0], this.autoPad, this.kernelShape, this.pads, this.strides);
+    return maxPool(
+        inferenceHandler, inputs[0], this.autoPad, this.kernelShape, this.pads, this.strides);
   }
 }
 
@@ -48,7 +51,7 @@ export class WasmGlobalMaxPool extends GlobalMaxPool {
   }
 
   async run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Promise<Tensor[]> {
-    return globalMaxPool(inputs[0]);
+    return globalMaxPool(inferenceHandler, inputs[0]);
   }
 }
 
@@ -64,26 +67,29 @@ function checkInputTypes(inputs: Tensor[]): boolean {
 
 // functions implementing specific pooling operations
 async function averagePool(
-    input: Tensor, autoPad: string, countIncludePad: boolean, kernelShape: number[], pads: number[],
-    strides: number[]): Promise<Tensor[]> {
-  return pool(false, 1, input, autoPad, countIncludePad, kernelShape, pads, strides);
+    inferenceHandler: WasmInferenceHandler, input: Tensor, autoPad: string, countIncludePad: boolean,
+    kernelShape: number[], pads: number[], strides: number[]): Promise<Tensor[]> {
+  return pool(inferenceHandler, false, 1, input, autoPad, countIncludePad, kernelShape, pads, strides);
 }
 
-async function globalAveragePool(input: Tensor): Promise<Tensor[]> {
-  return pool(true, 1, input, 'NOTSET', false, [], [], []);
+async function globalAveragePool(inferenceHandler: WasmInferenceHandler, input: Tensor): Promise<Tensor[]> {
+  return pool(inferenceHandler, true, 1, input, 'NOTSET', false, [], [], []);
 }
 
 async function maxPool(
-    input: Tensor, autoPad: string, kernelShape: number[], pads: number[], strides: number[]): Promise<Tensor[]> {
-  return pool(false, 2, input, autoPad, false, kernelShape, pads, strides);
+    inferenceHandler: WasmInferenceHandler, input: Tensor, autoPad: string, kernelShape: number[], pads: number[],
+    strides: number[]): Promise<Tensor[]> {
+  return pool(inferenceHandler, false, 2, input, autoPad, false, kernelShape, pads, strides);
 }
 
-async function globalMaxPool(input: Tensor): Promise<Tensor[]> {
-  return pool(true, 2, input, 'NOTSET', false, [], [], []);
+async function globalMaxPool(inferenceHandler: WasmInferenceHandler, input: Tensor): Promise<Tensor[]> {
+  return pool(inferenceHandler, true, 2, input, 'NOTSET', false, [], [], []);
 }
 
 /**
  * Perform pooling operations based on input
+ * @param inferenceHandler The inference handler of the session. The splits among the workers are measured the first
+ *     time a shape is seen if the session autotunes.
  * @param isGlobalOperator If true, perform global pooling.
  * @param poolType 1 if averagepool, 2 for maxpool.
  * @param input The input tensor.
@@ -97,8 +103,10 @@ async function globalMaxPool(input: Tensor): Promise<Tensor[]> {
  * @param strides Stride along each axis.
  */
 async function pool(
-    isGlobalOperator: boolean, poolType: number, input: Tensor, autoPad: string, countIncludePad: boolean,
-    kernelShape: number[], pads: number[], strides: number[]): Promise<Tensor[]> {
+    inferenceHandler: WasmInferenceHandler, isGlobalOperator: boolean, poolType: number, input: Tensor, autoPad: string,
+    countIncludePad: boolean, kernelShape: number[], pads: number[], strides: number[]): Promise<Tensor[]> {
+  const binding = inferenceHandler.binding;
+  const autotune = inferenceHandler.session.autotune;
   // determine pool function name in wasm
   let poolFunc = '';
   switch (poolType) {
@@ -121,74 +129,33 @@ async function pool(
   // create output
   const y = new Tensor(outputDims, input.type);
 
-  // determine number of threads needed to process
-  const numThreads = determineNumThreads(input.dims[0], input.dims[1], WasmBinding.workerNumber);
-
-  // no multi-threading
-  if (numThreads === 1) {
-    WasmBinding.getInstance().ccall(
-        poolFunc, [kernelShape.length, 'int32'], [isGlobalOperator, 'bool'], [input.floatData, 'float32ptr'],
-        [input.dims, 'int32ptr'], [y.floatData, 'float32ptr', 'out'], [y.dims, 'int32ptr'], [kernelShape, 'int32ptr'],
-        [pads, 'int32ptr'], [strides, 'int32ptr'], [countIncludePad, 'bool']);
-  }
-
-  // multi-threaded using web-workers
-  else {
-    // data pre-processing
-    const xDimsSp = input.dims.slice(0);
-    xDimsSp[1] = Math.floor(input.dims[1] / numThreads);
-    const xSizeSp = ShapeUtil.size(xDimsSp);
-
-    const xDimsFinal = input.dims.slice(0);
-    xDimsFinal[1] = input.dims[1] - (numThreads - 1) * xDimsSp[1];
-
-    const yDimsSp = outputDims.slice(0);
-    yDimsSp[1] = xDimsSp[1];
-    const ySizeSp = ShapeUtil.size(yDimsSp);
-
-    const yDimsFinal = outputDims.slice(0);
-    yDimsFinal[1] = xDimsFinal[1];
-
-    const workerTasks = new Array<Promise<PerformanceData>>(numThreads - 1);
-
-    const X = input.floatData;
-    const Y = y.floatData;
-
-    // function calls
-    for (let i = 0; i < numThreads; ++i) {
-      if (i !== numThreads - 1) {
-        workerTasks[i] = WasmBinding.getInstance().ccallRemote(
-            i, poolFunc, [kernelShape.length, 'int32'], [isGlobalOperator, 'bool'],
-            [X.subarray(i * xSizeSp, (i + 1) * xSizeSp), 'float32ptr'], [xDimsSp, 'int32ptr'],
-            [Y.subarray(i * ySizeSp, (i + 1) * ySizeSp), 'float32ptr', 'out'], [yDimsSp, 'int32ptr'],
-            [kernelShape, 'int32ptr'], [pads, 'int32ptr'], [strides, 'int32ptr'], [countIncludePad, 'bool']);
-      } else {
-        WasmBinding.getInstance().ccall(
-            poolFunc, [kernelShape.length, 'int32'], [isGlobalOperator, 'bool'],
-            [X.subarray((numThreads - 1) * xSizeSp), 'float32ptr'], [xDimsFinal, 'int32ptr'],
-            [Y.subarray((numThreads - 1) * ySizeSp), 'float32ptr', 'out'], [yDimsFinal, 'int32ptr'],
-            [kernelShape, 'int32ptr'], [pads, 'int32ptr'], [strides, 'int32ptr'], [countIncludePad, 'bool']);
-      }
-    }
-
-    await Promise.all(workerTasks);
-  }
+  // the planes (the channels of every image) are pooled independently, so they are split among the workers
+  const planes = input.dims[0] * input.dims[1];
+  const inputPlaneSize = ShapeUtil.size(input.dims.slice(2));
+  const outputPlaneSize = ShapeUtil.size(outputDims.slice(2));
+  const windowSize = isGlobalOperator ? inputPlaneSize : ShapeUtil.size(kernelShape);
+  const axes: PartitionAxis[] = [{
+    name: 'planes',
+    extent: planes,
+    flopsPerUnit: outputPlaneSize * windowSize,
+    fixedBytes: 0,
+    bytesPerUnit: 4 * (inputPlaneSize + outputPlaneSize)
+  }];
+  const candidates = autotune ? partitionCandidates(axes) : [partition(axes)];
+  const key = () => tuningKey(poolFunc, [input.dims], [isGlobalOperator, kernelShape, pads, strides]);
+
+  const X = input.floatData;
+  const Y = y.floatData;
+  await runTuned(autotune, key, candidates, parts => callPartitions(binding, parts, poolFunc, (start, end) => {
+    const xDims = [1, end - start].concat(input.dims.slice(2));
+    const yDims = [1, end - start].concat(outputDims.slice(2));
+    return [
+      [kernelShape.length, 'int32'], [isGlobalOperator, 'bool'],
+      [X.subarray(start * inputPlaneSize, end * inputPlaneSize), 'float32ptr'], [xDims, 'int32ptr'],
+      [Y.subarray(start * outputPlaneSize, end * outputPlaneSize), 'float32ptr', 'out'], [yDims, 'int32ptr'],
+      [kernelShape, 'int32ptr'], [pads, 'int32ptr'], [strides, 'int32ptr'], [countIncludePad, 'bool']
+    ];
+  }));
 
   return [y];
 }
-
-// this function will determine the number of threads
-// the strategy to parallelize is to parallelize on number of data channels
-function determineNumThreads(batchSize: number, numChannels: number, numWebWorkers: number): number {
-  // single threaded if:
-  // 1) batch size is not 1 (data splitting logic across threads is specific to batch size being 1)
-  // 2) if number of channels is 1
-  // 3) number of web workers is 0
-  if (batchSize !== 1 || numChannels === 1 || numWebWorkers <= 0) {
-    return 1;
-  }
-
-  // multi-threaded:
-  // determine number of threads
-  return Math.min(numChannels, numWebWorkers + 1);
-}
@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {ReduceBase} from '../../../ops/reduce-op';
+import {Tensor} from '../../../tensor';
+import {ReduceUtil, ShapeUtil} from '../../../util';
+import {WasmSessionBinding} from '../../../wasm-binding-core';
+import {WasmInferenceHandler} from '../inference-handler';
+
+abstract class WasmReduceBase extends ReduceBase {
+  // overriding the checkInputTypes() in the base class because Wasm backend has special type limitations
+  protected checkInputTypes(inputs: Tensor[]): boolean {
+    // currently Wasm backend only supports 'float32' input type
+    if (inputs[0].type !== 'float32') {
+      return false;
+    }
+
+    return true;
+  }
+}
+
+export class WasmReduceSum extends WasmReduceBase {
+  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+    return [reduce(inferenceHandler.binding, '_reduce_sum_f32', inputs[0], this.axes, this.keepDims)];
+  }
+}
+
+export class WasmReduceSumSquare extends WasmReduceBase {
+  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+    return [reduce(inferenceHandler.binding, '_reduce_sum_square_f32', inputs[0], this.axes, this.keepDims)];
+  }
+}
+
+export class WasmReduceLogSum extends WasmReduceBase {
+  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+    return [reduce(inferenceHandler.binding, '_reduce_log_sum_f32', inputs[0], this.axes, this.keepDims)];
+  }
+}
+
+export class WasmReduceLogSumExp extends WasmReduceBase {
+  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+    return [reduce(inferenceHandler.binding, '_reduce_log_sum_exp_f32', inputs[0], this.axes, this.keepDims)];
+  }
+}
+
+export class WasmReduceMax extends WasmReduceBase {
+  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+    return [reduce(inferenceHandler.binding, '_reduce_max_f32', inputs[0], this.axes, this.keepDims)];
+  }
+}
+
+export class WasmReduceMin extends WasmReduceBase {
+  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+    return [reduce(inferenceHandler.binding, '_reduce_min_f32', inputs[0], this.axes, this.keepDims)];
+  }
+}
+
+export class WasmReduceMean extends WasmReduceBase {
+  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+    return [reduce(inferenceHandler.binding, '_reduce_mean_f32', inputs[0], this.axes, this.keepDims)];
+  }
+}
+
+export class WasmReduceProd extends WasmReduceBase {
+  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+    return [reduce(inferenceHandler.binding, '_reduce_prod_f32', inputs[0], this.axes, this.keepDims)];
+  }
+}
+
+function reduce(binding: WasmSessionBinding, func: string, x: Tensor, axes: number[], keepDims: boolean): Tensor {
+  const rank = x.dims.length;
+  // if axes is not set, perform reduce on all axes
+  const reducedAxes = axes.length === 0 ? x.dims.map((d, i) => i) : ShapeUtil.normalizeAxes(axes, rank);
+  const y = new Tensor(ReduceUtil.calcReduceShape(x.dims, reducedAxes, keepDims), x.type);
+  // the reduce kernels merge the reduced axes into a single (outer, reduce, inner) loop nest, transposing the
+  // input first only when the reduced axes are not adjacent
+  binding.ccall(
+      func, [x.floatData, 'float32ptr'], [x.dims, 'int32ptr'], [rank, 'int32'], [reducedAxes, 'int32ptr'],
+      [reducedAxes.length, 'int32'], [y.floatData, 'float32ptr', 'out']);
+  return y;
+}
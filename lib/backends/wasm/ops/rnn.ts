@@ -0,0 +1,123 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {GRU} from '../../../ops/gru';
+import {LSTM} from '../../../ops/lstm';
+import {Tensor} from '../../../tensor';
+import {WasmInferenceHandler} from '../inference-handler';
+
+// The recurrent operators keep a kernel in the wasm heap that owns the prepacked weights and the hidden (and cell)
+// state. The kernel is created on the first run and recreated only if the weights change. In streaming mode the
+// state is carried over to the next run when no initial state is given, so a sequence can be fed chunk by chunk,
+// until the state of the session is reset.
+
+export class WasmLSTM extends LSTM {
+  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+    const [x, w, r] = inputs;
+    const b = getOptionalInput(inputs, 3);
+    const p = getOptionalInput(inputs, 7);
+    if (this.kernel === undefined || this.weights.some((t, i) => t !== [w, r, b, p][i])) {
+      const handle = new Int32Array(1);
+      inferenceHandler.binding.ccall(
+          '_lstm_create_f32', [w.floatData, 'float32ptr'], [r.floatData, 'float32ptr'],
+          [b ? b.floatData : null, 'float32ptr'], [p ? p.floatData : null, 'float32ptr'],
+          [getDirection(this.direction), 'int32'], [this.hiddenSize, 'int32'], [x.dims[2], 'int32'],
+          [this.clip, 'float32'], [this.inputForget, 'bool'], [handle, 'int32ptr', 'out']);
+      this.kernel = replaceKernel(inferenceHandler, this.kernel, handle[0]);
+      this.weights = [w, r, b, p];
+    }
+
+    const [seqLength, batchSize] = x.dims;
+    const numDirections = w.dims[0];
+    const sequenceLens = getOptionalInput(inputs, 4);
+    const initialH = getOptionalInput(inputs, 5);
+    const initialC = getOptionalInput(inputs, 6);
+    const y = new Tensor([seqLength, numDirections, batchSize, this.hiddenSize], 'float32');
+    const yH = new Tensor([numDirections, batchSize, this.hiddenSize], 'float32');
+    const yC = new Tensor([numDirections, batchSize, this.hiddenSize], 'float32');
+    inferenceHandler.binding.ccall(
+        '_lstm_run_f32', [this.kernel, 'int32'], [x.floatData, 'float32ptr'], [seqLength, 'int32'],
+        [batchSize, 'int32'], [sequenceLens ? sequenceLens.integerData as Int32Array : null, 'int32ptr'],
+        [initialH ? initialH.floatData : null, 'float32ptr'], [initialC ? initialC.floatData : null, 'float32ptr'],
+        [keepsState(inferenceHandler, this.stateGeneration), 'bool'], [y.floatData, 'float32ptr', 'out'],
+        [yH.floatData, 'float32ptr', 'out'], [yC.floatData, 'float32ptr', 'out']);
+
+    this.stateGeneration = inferenceHandler.session.stateGeneration;
+
+    return [y, yH, yC].slice(0, this.numOutputs);
+  }
+
+  private kernel?: number;
+  private weights: Array<Tensor|undefined> = [];
+  // the generation of the state of the session at the previous run
+  private stateGeneration?: number;
+}
+
+export class WasmGRU extends GRU {
+  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+    const [x, w, r] = inputs;
+    const b = getOptionalInput(inputs, 3);
+    if (this.kernel === undefined || this.weights.some((t, i) => t !== [w, r, b][i])) {
+      const handle = new Int32Array(1);
+      inferenceHandler.binding.ccall(
+          '_gru_create_f32', [w.floatData, 'float32ptr'], [r.floatData, 'float32ptr'],
+          [b ? b.floatData : null, 'float32ptr'], [getDirection(this.direction), 'int32'],
+          [this.hiddenSize, 'int32'], [x.dims[2], 'int32'], [this.clip, 'float32'],
+          [this.linearBeforeReset, 'bool'], [handle, 'int32ptr', 'out']);
+      this.kernel = replaceKernel(inferenceHandler, this.kernel, handle[0]);
+      this.weights = [w, r, b];
+    }
+
+    const [seqLength, batchSize] = x.dims;
+    const numDirections = w.dims[0];
+    const sequenceLens = getOptionalInput(inputs, 4);
+    const initialH = getOptionalInput(inputs, 5);
+    const y = new Tensor([seqLength, numDirections, batchSize, this.hiddenSize], 'float32');
+    const yH = new Tensor([numDirections, batchSize, this.hiddenSize], 'float32');
+    inferenceHandler.binding.ccall(
+        '_gru_run_f32', [this.kernel, 'int32'], [x.floatData, 'float32ptr'], [seqLength, 'int32'],
+        [batchSize, 'int32'], [sequenceLens ? sequenceLens.integerData as Int32Array : null, 'int32ptr'],
+        [initialH ? initialH.floatData : null, 'float32ptr'],
+        [keepsState(inferenceHandler, this.stateGeneration), 'bool'], [y.floatData, 'float32ptr', 'out'],
+        [yH.floatData, 'float32ptr', 'out']);
+
+    this.stateGeneration = inferenceHandler.session.stateGeneration;
+
+    return [y, yH].slice(0, this.numOutputs);
+  }
+
+  private kernel?: number;
+  private weights: Array<Tensor|undefined> = [];
+  // the generation of the state of the session at the previous run
+  private stateGeneration?: number;
+}
+
+// in streaming mode a kernel carries its state over from its previous run, unless the state of the session was reset
+function keepsState(inferenceHandler: WasmInferenceHandler, stateGeneration: number|undefined): boolean {
+  return inferenceHandler.session.streaming && stateGeneration === inferenceHandler.session.stateGeneration;
+}
+
+// optional inputs can be omitted at the end of the input list, or given as empty tensors
+function getOptionalInput(inputs: Tensor[], index: number): Tensor|undefined {
+  return inputs.length > index && inputs[index].size > 0 ? inputs[index] : undefined;
+}
+
+// matches RecurrentDirection in src/wasm-ops/rnn.h
+function getDirection(direction: string): number {
+  switch (direction) {
+    case 'reverse':
+      return 1;
+    case 'bidirectional':
+      return 2;
+    default:  // 'forward'
+      return 0;
+  }
+}
+
+function replaceKernel(inferenceHandler: WasmInferenceHandler, previous: number|undefined, kernel: number): number {
+  if (previous !== undefined) {
+    inferenceHandler.session.releaseRecurrentKernel(previous);
+  }
+  inferenceHandler.session.addRecurrentKernel(kernel);
+  return kernel;
+}
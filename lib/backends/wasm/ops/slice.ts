@@ -0,0 +1,73 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {Slice, SliceV10} from '../../../ops/slice';
+import {Tensor} from '../../../tensor';
+import {ShapeUtil} from '../../../util';
+import {WasmSessionBinding} from '../../../wasm-binding-core';
+import {WasmInferenceHandler} from '../inference-handler';
+
+export class WasmSlice extends Slice {
+  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+    return [slice(inferenceHandler.binding, inputs[0], this.starts, this.ends, this.axes)];
+  }
+
+  // overriding the checkInputTypes() in the base class because Wasm backend has special type limitations
+  checkInputTypes(inputs: Tensor[]): boolean {
+    // currently Wasm backend only supports 'float32' input type
+    if (inputs[0].type !== 'float32') {
+      return false;
+    }
+
+    return true;
+  }
+}
+
+export class WasmSliceV10 extends SliceV10 {
+  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+    if (inputs.length >= 5 && inputs[4].integerData.some((i: number) => i !== 1)) {
+      throw new Error(`currently non-1 steps is not supported for Slice`);
+    }
+    const starts = Array.from(inputs[1].integerData);
+    const ends = Array.from(inputs[2].integerData);
+    const axes = inputs.length >= 4 ? Array.from(inputs[3].integerData) : [];
+    return [slice(inferenceHandler.binding, inputs[0], starts, ends, axes)];
+  }
+
+  // overriding the checkInputTypes() in the base class because Wasm backend has special type limitations
+  checkInputTypes(inputs: Tensor[]): boolean {
+    // currently Wasm backend only supports 'float32' input type
+    if (inputs[0].type !== 'float32') {
+      return false;
+    }
+
+    return super.checkInputTypes(inputs);
+  }
+}
+
+function slice(
+    binding: WasmSessionBinding, x: Tensor, starts: ReadonlyArray<number>, ends: ReadonlyArray<number>,
+    axes: ReadonlyArray<number>): Tensor {
+  const rank = x.dims.length;
+  if (axes.length === 0) {
+    axes = x.dims.map((val, ind) => ind);
+  }
+  axes = ShapeUtil.normalizeAxes(axes, rank);
+
+  // one clamped start and one output size for every axis
+  const adjustedStarts = new Array<number>(rank).fill(0);
+  const outputDims = x.dims.slice(0);
+  axes.forEach((axis, ind) => {
+    const dim = x.dims[axis];
+    const start = Math.min(Math.max(starts[ind] < 0 ? starts[ind] + dim : starts[ind], 0), dim);
+    const end = Math.min(Math.max(ends[ind] < 0 ? ends[ind] + dim : ends[ind], 0), dim);
+    adjustedStarts[axis] = start;
+    outputDims[axis] = Math.max(end - start, 0);
+  });
+
+  const y = new Tensor(outputDims, x.type);
+  binding.ccall(
+      '_slice_f32', [x.floatData, 'float32ptr'], [x.dims, 'int32ptr'], [rank, 'int32'], [adjustedStarts, 'int32ptr'],
+      [y.floatData, 'float32ptr', 'out'], [outputDims, 'int32ptr']);
+  return y;
+}
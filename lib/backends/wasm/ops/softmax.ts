@@ -4,7 +4,6 @@
 import {Softmax} from '../../../ops/softmax';
 import {Tensor} from '../../../tensor';
 import {ShapeUtil} from '../../../util';
-import {WasmBinding} from '../../../wasm-binding';
 import {WasmInferenceHandler} from '../inference-handler';
 
 export class WasmSoftmax extends Softmax {
@@ -14,7 +13,7 @@ export class WasmSoftmax extends Softmax {
     const N = ShapeUtil.sizeToDimension(x.dims, axis);
     const D = ShapeUtil.sizeFromDimension(x.dims, axis);
     const y = new Tensor(x.dims, x.type);
-    WasmBinding.getInstance().ccall(
+    inferenceHandler.binding.ccall(
         '_softmax_f32', [x.floatData, 'float32ptr'], [y.floatData, 'float32ptr', 'out'], [N, 'int32'], [D, 'int32']);
 
     return [y];
@@ -3,7 +3,7 @@
 
 import {Sum} from '../../../ops/sum';
 import {Tensor} from '../../../tensor';
-import {WasmBinding, WasmCallArgument} from '../../../wasm-binding';
+import {WasmCallArgument} from '../../../wasm-binding-core';
 import {WasmInferenceHandler} from '../inference-handler';
 
 export class WasmSum extends Sum {
@@ -14,7 +14,7 @@ export class WasmSum extends Sum {
     for (let i = 0; i < inputs.length; i++) {
       input[i] = [inputs[i].floatData, 'float32ptr'];
     }
-    WasmBinding.getInstance().ccall(
+    inferenceHandler.binding.ccall(
         '_sum_f32', [inputs.length, 'int32'], [size, 'int32'], [y.floatData, 'float32ptr', 'inout'], ...input);
 
     return [y];
@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {Tile} from '../../../ops/tile';
+import {Tensor} from '../../../tensor';
+import {WasmInferenceHandler} from '../inference-handler';
+
+export class WasmTile extends Tile {
+  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+    const x = inputs[0];
+    const repeats = Array.from(inputs[1].integerData);
+    const y = new Tensor(x.dims.map((dim, i) => dim * repeats[i]), x.type);
+    inferenceHandler.binding.ccall(
+        '_tile_f32', [x.floatData, 'float32ptr'], [x.dims, 'int32ptr'], [x.dims.length, 'int32'],
+        [repeats, 'int32ptr'], [y.floatData, 'float32ptr', 'out']);
+
+    return [y];
+  }
+
+  // overriding the checkInputTypes() in the base class because Wasm backend has special type limitations
+  checkInputTypes(inputs: Tensor[]): boolean {
+    // currently Wasm backend only supports 'float32' data and 'int32' repeats
+    if (inputs[0].type !== 'float32' || inputs[1].type !== 'int32') {
+      return false;
+    }
+
+    return true;
+  }
+}
@@ -0,0 +1,33 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {Transpose} from '../../../ops/transpose';
+import {Tensor} from '../../../tensor';
+import {ShapeUtil} from '../../../util';
+import {WasmInferenceHandler} from '../inference-handler';
+
+export class WasmTranspose extends Transpose {
+  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+    const x = inputs[0];
+    const rank = x.dims.length;
+
+    // if no permutation was specified in the attributes, the default is [rank-1, ..., 0]
+    const perm = this.perm.length === rank ? this.perm : ShapeUtil.transpose(x.dims.map((v, i) => i));
+    const y = new Tensor(ShapeUtil.sortBasedOnPerm(x.dims, perm), x.type);
+    inferenceHandler.binding.ccall(
+        '_transpose_f32', [x.floatData, 'float32ptr'], [x.dims, 'int32ptr'], [rank, 'int32'], [perm, 'int32ptr'],
+        [y.floatData, 'float32ptr', 'out']);
+
+    return [y];
+  }
+
+  // overriding the checkInputTypes() in the base class because Wasm backend has special type limitations
+  checkInputTypes(inputs: Tensor[]): boolean {
+    // currently Wasm backend only supports 'float32' input type
+    if (inputs[0].type !== 'float32') {
+      return false;
+    }
+
+    return true;
+  }
+}
@@ -0,0 +1,142 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {Tensor} from '../../../tensor';
+import {ShapeUtil} from '../../../util';
+import {CpuUpsample} from '../../cpu/ops/upsample';
+import {WasmInferenceHandler} from '../inference-handler';
+
+interface UpsampleTables {
+  // nearest: per-axis source offsets
+  // linear: source row offsets and column indices, 2 per output row/column
+  indices: Int32Array;
+  xIndices?: Int32Array;
+  // linear: weights matching 'indices' and 'xIndices'
+  weights?: Float32Array;
+  xWeights?: Float32Array;
+}
+
+// the coordinate transformation and nearest pixel functions are shared with the CPU implementation, which also
+// handles the 'cubic' mode
+export class WasmUpsample extends CpuUpsample {
+  run(inferenceHandler: WasmInferenceHandler, inputs: Tensor[]): Tensor[] {
+    const [roi, scales, yDims] = this.prepareInputs(inputs);
+    const x = inputs[0];
+    const y = new Tensor(yDims, x.type);
+    if (this.mode === 'cubic' || x.dims.every((d, i) => yDims[i] === d)) {
+      this.compute(x, y, roi, scales);
+      return [y];
+    }
+    if (roi.length !== 2 * x.dims.length) {
+      throw new Error('size of roi array should be 2 * N where N is the rank of input tensor X.');
+    }
+
+    // source indices and weights only depend on the shapes, scales and roi. only the tables of the last ones are kept,
+    // so that inputs of varying shapes do not accumulate tables
+    const key = `${x.dims}|${yDims}|${scales}|${roi}`;
+    let tables = this.tablesKey === key ? this.tables : undefined;
+
+    if (this.mode === 'nearest') {
+      if (!tables) {
+        tables = this.createNearestTables(x.dims, yDims, scales, roi);
+        this.tablesKey = key;
+        this.tables = tables;
+      }
+      inferenceHandler.binding.ccall(
+          '_upsample_nearest_f32', [x.floatData, 'float32ptr'], [x.dims, 'int32ptr'], [x.dims.length, 'int32'],
+          [y.floatData, 'float32ptr', 'out'], [yDims, 'int32ptr'], [tables.indices, 'int32ptr'],
+          [this.extrapolationValue, 'float32']);
+    } else {
+      if (x.dims.length !== 2 && x.dims.length !== 4) {
+        throw new Error('\'Linear\' mode only support 2-D inputs or 4-D inputs');
+      }
+      const rank = x.dims.length;
+      if (!tables) {
+        tables = this.createLinearTables(x.dims, yDims, scales, roi);
+        this.tablesKey = key;
+        this.tables = tables;
+      }
+      inferenceHandler.binding.ccall(
+          '_upsample_bilinear_f32', [x.floatData, 'float32ptr'], [ShapeUtil.sizeToDimension(x.dims, rank - 2), 'int32'],
+          [x.dims[rank - 2], 'int32'], [x.dims[rank - 1], 'int32'], [y.floatData, 'float32ptr', 'out'],
+          [yDims[rank - 2], 'int32'], [yDims[rank - 1], 'int32'], [tables.indices, 'int32ptr'],
+          [tables.weights!, 'float32ptr'], [tables.xIndices!, 'int32ptr'], [tables.xWeights!, 'float32ptr'],
+          [this.extrapolationValue, 'float32']);
+    }
+
+    return [y];
+  }
+
+  // overriding the checkInputTypes() in the base class because Wasm backend has special type limitations
+  checkInputTypes(inputs: Tensor[]): boolean {
+    // currently Wasm backend only supports 'float32' input type
+    if (inputs[0].type !== 'float32') {
+      return false;
+    }
+
+    return true;
+  }
+
+  private createNearestTables(
+      xDims: ReadonlyArray<number>, yDims: ReadonlyArray<number>, scales: ReadonlyArray<number>,
+      roi: ReadonlyArray<number>): UpsampleTables {
+    const rank = xDims.length;
+    const strides = ShapeUtil.computeStrides(xDims);
+    const indices = new Int32Array(yDims.reduce((a, b) => a + b, 0));
+    let offset = 0;
+    for (let d = 0; d < rank; d++) {
+      for (let i = 0; i < yDims[d]; i++) {
+        const original = this.getOriginalCoordinate(i, scales[d], yDims[d], xDims[d], roi[d], roi[rank + d]);
+        if (this.useExtrapolation && (original < 0 || original > xDims[d] - 1)) {
+          indices[offset++] = -1;
+          continue;
+        }
+        const nearest = this.getNearestPixel(original, scales[d] < 1);
+        indices[offset++] = Math.max(0, Math.min(nearest, xDims[d] - 1)) * strides[d];
+      }
+    }
+    return {indices};
+  }
+
+  private createLinearTables(
+      xDims: ReadonlyArray<number>, yDims: ReadonlyArray<number>, scales: ReadonlyArray<number>,
+      roi: ReadonlyArray<number>): UpsampleTables {
+    const rank = xDims.length;
+    const inputWidth = xDims[rank - 1];
+    const [indices, weights] = this.createLinearAxisTable(
+        xDims[rank - 2], yDims[rank - 2], scales[rank - 2], roi[rank - 2], roi[2 * rank - 2], inputWidth);
+    const [xIndices, xWeights] = this.createLinearAxisTable(
+        inputWidth, yDims[rank - 1], scales[rank - 1], roi[rank - 1], roi[2 * rank - 1], 1);
+    return {indices, weights, xIndices, xWeights};
+  }
+
+  // for every output position: the 2 neighbouring source positions (times 'stride') and their weights
+  private createLinearAxisTable(
+      inputLength: number, outputLength: number, scale: number, roiStart: number, roiEnd: number,
+      stride: number): [Int32Array, Float32Array] {
+    const indices = new Int32Array(2 * outputLength);
+    const weights = new Float32Array(2 * outputLength);
+    for (let i = 0; i < outputLength; i++) {
+      let original = this.getOriginalCoordinate(i, scale, outputLength, inputLength, roiStart, roiEnd);
+      if (this.useExtrapolation && (original < 0 || original > inputLength - 1)) {
+        indices[2 * i] = indices[2 * i + 1] = -1;
+        continue;
+      }
+      original = Math.max(0, Math.min(original, inputLength - 1));
+      const in1 = Math.min(Math.floor(original), inputLength - 1);
+      const in2 = Math.min(in1 + 1, inputLength - 1);
+      indices[2 * i] = in1 * stride;
+      indices[2 * i + 1] = in2 * stride;
+      if (in1 === in2) {
+        weights[2 * i] = weights[2 * i + 1] = 0.5;
+      } else {
+        weights[2 * i] = Math.abs(original - in2);
+        weights[2 * i + 1] = Math.abs(original - in1);
+      }
+    }
+    return [indices, weights];
+  }
+
+  private tablesKey?: string;
+  private tables?: UpsampleTables;
+}
@@ -0,0 +1,157 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {Logger} from '../../instrument';
+import {getWorkerNumber, PerformanceData, WasmCallArgument, WasmSessionBinding} from '../../wasm-binding-core';
+
+/**
+ * an axis along which an operator can be split into independent parts, e.g. the images of a batch, the output
+ * channels of a convolution or the rows of a matrix product
+ */
+export interface PartitionAxis {
+  /**
+   * the name of the axis, for logging
+   */
+  name: string;
+  /**
+   * the number of units along the axis
+   */
+  extent: number;
+  /**
+   * the arithmetic cost of one unit, in floating point operations
+   */
+  flopsPerUnit: number;
+  /**
+   * the bytes sent to and received from a worker for any part, whatever its size (e.g. the weights)
+   */
+  fixedBytes: number;
+  /**
+   * the bytes sent to and received from a worker for each unit of its part (including the halo of the unit)
+   */
+  bytesPerUnit: number;
+}
+
+/**
+ * the parts of an operator. every range [start, end) but the last one runs on a worker, the last one runs in the
+ * calling thread
+ */
+export interface Partition {
+  axis: string;
+  ranges: Array<[number, number]>;
+}
+
+// the cost of moving a byte to or from a worker, in floating point operations. a byte is copied when it is
+// serialized, when it is copied into the heap of the worker and back again
+const FLOPS_PER_BYTE = 2;
+// the fixed cost of a call on a worker (posting the message and waking up the worker), in floating point operations
+const FLOPS_PER_CALL = 500000;
+
+/**
+ * choose the axis and the number of parts that minimize the estimated time of an operator, given the candidate axes.
+ * the estimated time of a split is the time of its slowest part: the calling thread serializes the arguments of every
+ * worker before running its own part, and a worker waits for its arguments before running its part.
+ */
+export function partition(axes: PartitionAxis[], numWorkers = getWorkerNumber()): Partition {
+  // without a candidate axis (or with an empty one) the operator runs in one part
+  let best: Partition = {axis: '', ranges: [[0, axes.length > 0 ? axes[0].extent : 1]]};
+  let bestCost = Infinity;
+  for (const axis of axes) {
+    for (let parts = 1; parts <= Math.min(axis.extent, numWorkers + 1); parts++) {
+      const cost = estimateCost(axis, parts);
+      if (cost < bestCost) {
+        bestCost = cost;
+        best = {axis: axis.name, ranges: splitRange(axis.extent, parts)};
+      }
+    }
+  }
+  if (best.ranges.length > 1) {
+    Logger.verbose('Partitioner', `split along '${best.axis}' in ${best.ranges.length} parts`);
+  }
+  return best;
+}
+
+/**
+ * the partitions worth measuring by the autotuner, starting with the one chosen by the cost model: the operator in one
+ * part, and for every axis the best split along it by the cost model and the split in as many parts as possible
+ */
+export function partitionCandidates(axes: PartitionAxis[], numWorkers = getWorkerNumber()): Partition[] {
+  const candidates = [partition(axes, numWorkers)];
+  // all the partitions in one part are equivalent
+  const add = (axis: PartitionAxis, parts: number) => {
+    if (!candidates.some(c => c.ranges.length === parts && (parts === 1 || c.axis === axis.name))) {
+      candidates.push({axis: axis.name, ranges: splitRange(axis.extent, parts)});
+    }
+  };
+  for (const axis of axes) {
+    const maxParts = Math.min(axis.extent, numWorkers + 1);
+    add(axis, 1);
+    if (maxParts > 1) {
+      add(axis, partition([axis], numWorkers).ranges.length);
+      add(axis, maxParts);
+    }
+  }
+  return candidates;
+}
+
+/**
+ * call a wasm function for every part of a partition, on the workers and in the calling thread
+ * @param binding the binding of the session, whose argument buffer holds the arguments of the call in the calling
+ * thread
+ * @param getParams the arguments of the call for the part [start, end)
+ */
+export async function callPartitions(
+    binding: WasmSessionBinding, parts: Partition, functionName: string,
+    getParams: (start: number, end: number) => WasmCallArgument[]): Promise<void> {
+  const last = parts.ranges.length - 1;
+  const workerTasks: Array<Promise<PerformanceData>> = [];
+  for (let i = 0; i < last; i++) {
+    const [start, end] = parts.ranges[i];
+    workerTasks.push(binding.ccallRemote(i, functionName, ...getParams(start, end)));
+  }
+  const [start, end] = parts.ranges[last];
+  binding.ccall(functionName, ...getParams(start, end));
+  await Promise.all(workerTasks);
+}
+
+/**
+ * the input rows read by the output rows [start, end) of a sliding window along the rows (e.g. a 2-D convolution),
+ * including the halo of the window, and the padding left above and below them
+ * @param height the number of input rows
+ * @param windowHeight the height of the window, dilated
+ * @returns the input rows [inputStart, inputEnd), and the padding above and below them
+ */
+export function getInputRows(
+    start: number, end: number, height: number, stride: number, padTop: number,
+    windowHeight: number): [number, number, number, number] {
+  const first = start * stride - padTop;
+  const last = (end - 1) * stride - padTop + windowHeight - 1;
+  const inputStart = Math.max(first, 0);
+  const inputEnd = Math.min(last + 1, height);
+  return [inputStart, inputEnd, inputStart - first, last + 1 - inputEnd];
+}
+
+// the estimated time of an operator split in the given number of parts along an axis, in floating point operations
+function estimateCost(axis: PartitionAxis, parts: number): number {
+  const ranges = splitRange(axis.extent, parts);
+  let transferred = 0;
+  let cost = 0;
+  ranges.forEach(([start, end], i) => {
+    const compute = axis.flopsPerUnit * (end - start);
+    if (i === ranges.length - 1) {
+      cost = Math.max(cost, transferred * FLOPS_PER_BYTE + compute);
+    } else {
+      transferred += axis.fixedBytes + axis.bytesPerUnit * (end - start);
+      cost = Math.max(cost, transferred * FLOPS_PER_BYTE + FLOPS_PER_CALL + compute);
+    }
+  });
+  return cost;
+}
+
+// split [0, extent) into the given number of ranges, whose sizes differ by 1 at most
+function splitRange(extent: number, parts: number): Array<[number, number]> {
+  const ranges: Array<[number, number]> = [];
+  for (let i = 0; i < parts; i++) {
+    ranges.push([Math.floor(i * extent / parts), Math.floor((i + 1) * extent / parts)]);
+  }
+  return ranges;
+}
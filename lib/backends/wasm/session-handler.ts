@@ -1,31 +1,227 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT license.
 
+import {Attribute} from '../../attribute';
 import {Backend, InferenceHandler, SessionHandler} from '../../backend';
 import {Graph} from '../../graph';
+import {Logger} from '../../instrument';
 import {Operator} from '../../operators';
 import {OpSet, resolveOperator} from '../../opset';
+import {PrepackedGraph} from '../../prepacked-model';
 import {Session} from '../../session';
+import {Tensor} from '../../tensor';
+import {WasmSessionBinding} from '../../wasm-binding-core';
 import {CPU_OP_RESOLVE_RULES} from '../cpu/op-resolve-rules';
 
 import {WasmInferenceHandler} from './inference-handler';
 import {WASM_OP_RESOLVE_RULES} from './op-resolve-rules';
+import {acquireSharedTensor, releaseSharedTensor} from './shared-weights';
+import {createSparseWeights, isSparseOperator, releaseSparseWeights, SparseWeights} from './sparse';
+
+export declare namespace WasmSessionHandler {
+  /**
+   * the options of the WebAssembly backend for a session (see Backend.WasmOptions in lib/api/onnx.ts)
+   */
+  export interface Options {
+    cpuFallback: boolean;
+    streaming: boolean;
+    autotune: boolean;
+    channelBlock: number;
+    sparsity: number;
+    shareWeights: boolean;
+  }
+}
 
 export class WasmSessionHandler implements SessionHandler {
+  readonly streaming: boolean;
+  readonly autotune: boolean;
+  protected fallbackToCpuOps: boolean;
+  protected channelBlock: number;
+  protected sparsity: number;
+  protected shareWeights: boolean;
   private opResolveRules: ReadonlyArray<OpSet.ResolveRule>;
-  constructor(readonly backend: Backend, readonly context: Session.Context, fallbackToCpuOps: boolean) {
-    this.opResolveRules = fallbackToCpuOps ? WASM_OP_RESOLVE_RULES.concat(CPU_OP_RESOLVE_RULES) : WASM_OP_RESOLVE_RULES;
+  private recurrentKernels: number[] = [];
+  // the packed weights of the nodes of a prepacked model, which replace packing them at load time
+  private prepackedSparseWeights?: Map<Graph.Node, SparseWeights>;
+  // the initializers of the session shared with the other sessions, released with the session
+  private sharedTensors: Tensor[] = [];
+  // the packed weights of the operators of the session, removed from the sparse report with the session
+  private sparseWeights: SparseWeights[] = [];
+  private generation = 0;
+  /**
+   * @param binding the binding of the session, whose argument buffer in the wasm heap is the arena of the activations
+   * passed to the kernels of the session, apart from the ones of the other sessions. it is disposed with the session
+   */
+  constructor(
+      readonly backend: Backend, readonly context: Session.Context, options: WasmSessionHandler.Options,
+      readonly binding: WasmSessionBinding) {
+    this.fallbackToCpuOps = options.cpuFallback;
+    this.streaming = options.streaming;
+    this.autotune = options.autotune;
+    this.channelBlock = options.channelBlock;
+    this.sparsity = options.sparsity;
+    this.shareWeights = options.shareWeights;
+    this.opResolveRules = getOpResolveRules(this.fallbackToCpuOps);
+  }
+
+  /**
+   * the number of times the state of the recurrent operators was reset. in streaming mode, a recurrent operator
+   * carries its state over from its previous run only if the state was not reset since
+   */
+  get stateGeneration(): number {
+    return this.generation;
   }
 
   createInferenceHandler(): InferenceHandler {
     return new WasmInferenceHandler(this, this.context.profiler);
   }
 
-  dispose(): void {}
+  dispose(): void {
+    for (const kernel of this.recurrentKernels) {
+      this.binding.ccall('_recurrent_release', [kernel, 'int32']);
+    }
+    this.recurrentKernels = [];
+    this.sharedTensors.forEach(releaseSharedTensor);
+    this.sharedTensors = [];
+    this.sparseWeights.forEach(releaseSparseWeights);
+    this.sparseWeights = [];
+    this.binding.dispose();
+  }
+
+  resetState(): void {
+    this.generation++;
+  }
+
+  /**
+   * keep track of a recurrent kernel created in the wasm heap, so that it is released with the session
+   */
+  addRecurrentKernel(kernel: number): void {
+    this.recurrentKernels.push(kernel);
+  }
+
+  releaseRecurrentKernel(kernel: number): void {
+    const index = this.recurrentKernels.indexOf(kernel);
+    if (index !== -1) {
+      this.recurrentKernels.splice(index, 1);
+      this.binding.ccall('_recurrent_release', [kernel, 'int32']);
+    }
+  }
+
+  transformGraph(graphTransformer: Graph.Transformer): void {
+    graphTransformer.fuseAttentionNodes();
+    if (this.channelBlock > 0) {
+      graphTransformer.convertToBlockedLayout(this.channelBlock);
+    }
+    if (this.shareWeights) {
+      graphTransformer.shareInitializers(tensor => {
+        const shared = acquireSharedTensor(tensor);
+        this.sharedTensors.push(shared);
+        return shared;
+      });
+    }
+  }
+
+  loadPrepackedModel(model: PrepackedGraph, graph: Graph): void {
+    // the graph was transformed, and its operators are resolved, for the options the model was prepared with
+    const options = model.header.options;
+    const differences: string[] = [];
+    if (options.cpuFallback !== this.fallbackToCpuOps) {
+      differences.push(`cpuFallback=${options.cpuFallback}`);
+    }
+    if (options.channelBlock !== this.channelBlock) {
+      differences.push(`channelBlock=${options.channelBlock}`);
+    }
+    if (options.sparsity !== this.sparsity) {
+      differences.push(`sparsity=${options.sparsity}`);
+    }
+    if (differences.length > 0) {
+      Logger.warning(
+          'WasmSessionHandler',
+          `the prepacked model was prepared with other options of the backend, using its ${differences.join(', ')}`);
+    }
+    this.fallbackToCpuOps = options.cpuFallback;
+    this.channelBlock = options.channelBlock;
+    this.sparsity = options.sparsity;
+    this.opResolveRules = getOpResolveRules(this.fallbackToCpuOps);
+
+    const nodes = graph.getNodes();
+    const values = graph.getValues();
+    this.prepackedSparseWeights = new Map();
+    for (const info of model.header.sparseWeights) {
+      const node = nodes[info.node];
+      const source = values[node.inputs[info.input]].tensor!;
+      const weights = createSparseWeights(
+          node, source, info.blockSize, info.sparsity, model.readTensor(info.rowPointers).data as Int32Array,
+          model.readTensor(info.blockColumns).data as Int32Array, model.readTensor(info.values).data as Float32Array);
+      this.prepackedSparseWeights.set(node, weights);
+      this.sparseWeights.push(weights);
+    }
+  }
 
   resolve(node: Graph.Node, opsets: ReadonlyArray<OpSet>, graph: Graph): Operator {
     const op = resolveOperator(node, opsets, this.opResolveRules);
     op.initialize(node.attributes, node, graph);
+    if (this.prepackedSparseWeights) {
+      if (isSparseOperator(op)) {
+        op.sparseWeights = this.prepackedSparseWeights.get(node);
+      }
+    } else if (this.sparsity > 0 && isSparseOperator(op)) {
+      op.prepareSparseWeights(node, graph, this.sparsity);
+      if (op.sparseWeights) {
+        this.sparseWeights.push(op.sparseWeights);
+      }
+    }
+    // the kernels of an operator may support fewer types than the CPU operator it shadows, e.g. the int32 tensors of
+    // the shape computations. the packed weights of a sparse operator are float32, as its inputs
+    if (this.fallbackToCpuOps && !(isSparseOperator(op) && op.sparseWeights)) {
+      const cpuOp = resolveCpuOperator(node, opsets);
+      if (cpuOp && cpuOp.constructor !== op.constructor) {
+        return new CpuFallbackOp(op, cpuOp, node, graph);
+      }
+    }
     return op;
   }
 }
+
+// the operator of the CPU backend for a node, if any
+function resolveCpuOperator(node: Graph.Node, opsets: ReadonlyArray<OpSet>): Operator|undefined {
+  try {
+    return resolveOperator(node, opsets, CPU_OP_RESOLVE_RULES);
+  } catch (e) {
+    return undefined;
+  }
+}
+
+/**
+ * an operator of the wasm backend running the inputs its kernels do not support with the operator of the CPU
+ * backend. the CPU operator is initialized when it first runs
+ */
+class CpuFallbackOp implements Operator {
+  private cpuOpInitialized = false;
+
+  constructor(
+      readonly wasmOp: Operator, readonly cpuOp: Operator, private node: Graph.Node, private graph: Graph) {}
+
+  initialize(attributes: Attribute): void {}
+
+  checkInputs(inputs: Tensor[]): boolean {
+    return this.wasmOp.checkInputs(inputs) || this.getCpuOp().checkInputs(inputs);
+  }
+
+  run(inferenceHandler: InferenceHandler, inputs: Tensor[]): Tensor[]|Promise<Tensor[]> {
+    return this.wasmOp.checkInputs(inputs) ? this.wasmOp.run(inferenceHandler, inputs) :
+                                             this.getCpuOp().run(inferenceHandler, inputs);
+  }
+
+  private getCpuOp(): Operator {
+    if (!this.cpuOpInitialized) {
+      this.cpuOp.initialize(this.node.attributes, this.node, this.graph);
+      this.cpuOpInitialized = true;
+    }
+    return this.cpuOp;
+  }
+}
+
+function getOpResolveRules(fallbackToCpuOps: boolean): ReadonlyArray<OpSet.ResolveRule> {
+  return fallbackToCpuOps ? WASM_OP_RESOLVE_RULES.concat(CPU_OP_RESOLVE_RULES) : WASM_OP_RESOLVE_RULES;
+}
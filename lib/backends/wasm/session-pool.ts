@@ -0,0 +1,170 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {Backend as BackendInterface} from '../../api/onnx';
+import {ModelExecutor} from '../../backend';
+import {Logger, now} from '../../instrument';
+import {Tensor} from '../../tensor';
+import {WasmBinding} from '../../wasm-binding';
+import {deserializeTensor, SerializedTensor, serializeTensor, WorkerSessionOptions, WorkerSessionRequest, WorkerSessionResponse} from '../../worker/session-messages';
+
+import {WasmSessionHandler} from './session-handler';
+
+type ThroughputMetrics = BackendInterface.WasmThroughputMetrics;
+
+/**
+ * the workers holding the copies of the pooled sessions
+ */
+export interface SessionWorkers {
+  readonly workerNumber: number;
+  sessionRemote(workerId: number, request: WorkerSessionRequest): Promise<WorkerSessionResponse>;
+}
+
+// the workers of the binding
+const bindingWorkers: SessionWorkers = {
+  get workerNumber() {
+    return WasmBinding.workerNumber;
+  },
+  sessionRemote: (workerId, request) => WasmBinding.getInstance().sessionRemote(workerId, request)
+};
+
+interface PendingRequest {
+  workers: SessionWorkers;
+  sessionId: number;
+  inputs: SerializedTensor[];
+  submitTime: number;
+  resolve: (outputs: Tensor[]) => void;
+  reject: (reason: unknown) => void;
+}
+
+// the requests of all the pooled sessions wait in a single queue, and each one goes to the first idle worker. a
+// worker serves one request at a time, so the queue holds the requests that no worker can start yet
+const queue: PendingRequest[] = [];
+let busyWorkers: boolean[] = [];
+let nextSessionId = 0;
+
+const metrics: ThroughputMetrics = {
+  completedRequests: 0,
+  queueDepth: 0,
+  maxQueueDepth: 0,
+  averageLatency: 0,
+  maxLatency: 0,
+  averageQueueTime: 0
+};
+
+/**
+ * get the latency and queue depth metrics of the throughput mode
+ */
+export function getThroughputMetrics(): ThroughputMetrics {
+  return {...metrics, queueDepth: queue.length};
+}
+
+/**
+ * a session with a copy held by every worker, to run whole inference requests on them
+ */
+export class WasmPooledSession implements ModelExecutor {
+  constructor(model: Uint8Array, options: WorkerSessionOptions, private readonly workers = bindingWorkers) {
+    this.sessionId = nextSessionId++;
+    const numWorkers = workers.workerNumber;
+    if (busyWorkers.length !== numWorkers) {
+      busyWorkers = new Array<boolean>(numWorkers).fill(false);
+    }
+    for (let workerId = 0; workerId < numWorkers; workerId++) {
+      const request: WorkerSessionRequest = {command: 'create', sessionId: this.sessionId, model, options};
+      this.creations.push(workers.sessionRemote(workerId, request));
+    }
+    this.ready = Promise.all(this.creations);
+    // a worker failing to create its copy fails the requests (see execute()), even when there are none
+    this.ready.catch(() => {});
+  }
+
+  async execute(inputs: Tensor[]): Promise<Tensor[]> {
+    await this.ready;
+    const serialized = inputs.map(input => serializeTensor(input));
+    return new Promise<Tensor[]>((resolve, reject) => {
+      queue.push(
+          {workers: this.workers, sessionId: this.sessionId, inputs: serialized, submitTime: now(), resolve, reject});
+      metrics.maxQueueDepth = Math.max(metrics.maxQueueDepth, queue.length);
+      dispatch();
+    });
+  }
+
+  dispose(): void {
+    // each copy is released once it is created, the workers which failed to create theirs have none to release
+    this.creations.forEach((creation, workerId) => creation.then(() => {
+      this.workers.sessionRemote(workerId, {command: 'release', sessionId: this.sessionId}).catch(err => {
+        Logger.warning('WasmPooledSession', `worker-${workerId} failed to release a session. ${err}`);
+      });
+    }, () => {}));
+  }
+
+  private readonly sessionId: number;
+  private readonly creations: Array<Promise<unknown>> = [];
+  private readonly ready: Promise<unknown>;
+}
+
+/**
+ * the session handler of the throughput mode, where every worker holds a copy of the model and runs whole requests
+ */
+export class WasmPooledSessionHandler extends WasmSessionHandler {
+  private pooledSession?: WasmPooledSession;
+
+  createModelExecutor(model: Uint8Array): ModelExecutor|undefined {
+    if (WasmBinding.workerNumber > 0) {
+      if (this.streaming) {
+        Logger.warning(
+            'WasmPooledSessionHandler',
+            'the recurrent operators do not keep their state in throughput mode, a request may run on any worker');
+      }
+      const options = {
+        cpuFallback: this.fallbackToCpuOps,
+        streaming: false,
+        autotune: this.autotune,
+        channelBlock: this.channelBlock,
+        sparsity: this.sparsity,
+        shareWeights: this.shareWeights
+      };
+      this.pooledSession = new WasmPooledSession(model, options);
+    }
+    return this.pooledSession;
+  }
+
+  dispose(): void {
+    if (this.pooledSession) {
+      this.pooledSession.dispose();
+      this.pooledSession = undefined;
+    }
+    super.dispose();
+  }
+}
+
+function dispatch() {
+  for (let workerId = 0; workerId < busyWorkers.length && queue.length > 0; workerId++) {
+    if (busyWorkers[workerId]) {
+      continue;
+    }
+    const request = queue.shift()!;
+    const startTime = now();
+    busyWorkers[workerId] = true;
+    Logger.verbose('WasmPooledSession', `worker-${workerId} starts a request, ${queue.length} request(s) waiting`);
+
+    request.workers.sessionRemote(workerId, {command: 'run', sessionId: request.sessionId, inputs: request.inputs})
+        .then(
+            response => {
+              recordLatency(startTime - request.submitTime, now() - request.submitTime);
+              request.resolve(response.outputs!.map(deserializeTensor));
+            },
+            request.reject)
+        .then(() => {
+          busyWorkers[workerId] = false;
+          dispatch();
+        });
+  }
+}
+
+function recordLatency(queueTime: number, latency: number) {
+  const count = ++metrics.completedRequests;
+  metrics.averageLatency += (latency - metrics.averageLatency) / count;
+  metrics.averageQueueTime += (queueTime - metrics.averageQueueTime) / count;
+  metrics.maxLatency = Math.max(metrics.maxLatency, latency);
+}
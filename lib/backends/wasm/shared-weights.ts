@@ -0,0 +1,113 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {Backend as BackendInterface} from '../../api/onnx';
+import {Tensor} from '../../tensor';
+
+type SharedWeights = BackendInterface.WasmSharedWeights;
+
+// the constant tensors shared by the sessions of the WebAssembly backend. identical initializers of several models
+// (e.g. the fine-tuned variants of a base model) are stored once, found by the hash of their type, dims and content.
+// every session holds a reference to the tensors it uses, and a tensor is dropped when its last session is disposed
+
+interface SharedTensor {
+  readonly key: string;
+  readonly tensor: Tensor;
+  references: number;
+}
+
+// the shared tensors by key. tensors of the same key whose content differs (hash collisions) are kept apart
+const sharedTensors = new Map<string, SharedTensor[]>();
+// the entries of the shared tensors, to find them when they are acquired again or released
+const entries = new Map<Tensor, SharedTensor>();
+
+const FNV_OFFSET_BASIS = 0x811c9dc5;
+const FNV_PRIME = 0x01000193;
+
+/**
+ * get the tensor shared by the sessions which is identical to the given one, storing the given one if there is none.
+ * the caller holds a reference to the returned tensor until it calls releaseSharedTensor(). string tensors are not
+ * shared
+ */
+export function acquireSharedTensor(tensor: Tensor): Tensor {
+  if (tensor.type === 'string') {
+    return tensor;
+  }
+  let entry = entries.get(tensor);
+  if (!entry) {
+    const words = getWords(tensor.numberData);
+    const key = `${tensor.type}[${tensor.dims.join(',')}]${hashWords(words)}`;
+    const candidates = sharedTensors.get(key) || [];
+    entry = candidates.find(candidate => areEqual(getWords(candidate.tensor.numberData), words));
+    if (!entry) {
+      // a view on a larger buffer (e.g. the file of the model) is copied, so that the buffer is not kept alive
+      const data = tensor.numberData;
+      const own =
+          data.byteLength === data.buffer.byteLength ? tensor : Tensor.fromData(data.slice(), tensor.dims, tensor.type);
+      entry = {key, tensor: own, references: 0};
+      candidates.push(entry);
+      sharedTensors.set(key, candidates);
+      entries.set(own, entry);
+    }
+  }
+  entry.references++;
+  return entry.tensor;
+}
+
+/**
+ * release a reference to a tensor returned by acquireSharedTensor()
+ */
+export function releaseSharedTensor(tensor: Tensor): void {
+  const entry = entries.get(tensor);
+  if (!entry || --entry.references > 0) {
+    return;
+  }
+  entries.delete(tensor);
+  const candidates = sharedTensors.get(entry.key)!;
+  candidates.splice(candidates.indexOf(entry), 1);
+  if (candidates.length === 0) {
+    sharedTensors.delete(entry.key);
+  }
+}
+
+/**
+ * get the number and the size of the tensors shared by the sessions, and the size they would take without sharing
+ */
+export function getSharedWeights(): SharedWeights {
+  const report: SharedWeights = {tensors: 0, references: 0, bytes: 0, unsharedBytes: 0};
+  entries.forEach(entry => {
+    const bytes = entry.tensor.numberData.byteLength;
+    report.tensors++;
+    report.references += entry.references;
+    report.bytes += bytes;
+    report.unsharedBytes += bytes * entry.references;
+  });
+  return report;
+}
+
+// the content of a typed array as 32-bit words when its elements are at least as large, so that it is hashed and
+// compared a word at a time. the elements of a typed array are aligned to their size
+function getWords(data: Tensor.NumberType): Tensor.NumberType {
+  return data.BYTES_PER_ELEMENT >= 4 ? new Int32Array(data.buffer, data.byteOffset, data.byteLength / 4) : data;
+}
+
+// the 32-bit FNV-1a hash of the words
+function hashWords(words: Tensor.NumberType): number {
+  let hash = FNV_OFFSET_BASIS;
+  for (let i = 0; i < words.length; i++) {
+    hash = Math.imul(hash ^ words[i], FNV_PRIME);
+  }
+  return hash >>> 0;
+}
+
+function areEqual(a: Tensor.NumberType, b: Tensor.NumberType): boolean {
+  if (a.length !== b.length) {
+    return false;
+  }
+  for (let i = 0; i < a.length; i++) {
+    if (a[i] !== b[i]) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,202 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {Backend as BackendInterface} from '../../api/onnx';
+import {Graph} from '../../graph';
+import {Logger, now} from '../../instrument';
+import {Operator} from '../../operators';
+import {Tensor} from '../../tensor';
+
+type SparseLayer = BackendInterface.WasmSparseLayer;
+
+// the width of the blocks of the weights whose zeros come in groups of 4 columns (e.g. pruned by blocks). the
+// other weights are stored one value at a time (CSR)
+const BLOCK_SIZE = 4;
+
+/**
+ * weights in the block compressed sparse row format with blocks of 1 x blockSize (see src/wasm-ops/sparse-gemm.h)
+ */
+export interface SparseWeights {
+  // the constant tensor the weights were packed from
+  readonly source: Tensor;
+  readonly blockSize: number;
+  readonly rowPointers: Int32Array;
+  readonly blockColumns: Int32Array;
+  readonly values: Float32Array;
+  // the entry of the layer in the report, updated once both kernels are measured
+  readonly layer: SparseLayer;
+  // whether the sparse kernel is faster than the dense one, undefined until they are measured
+  useSparse?: boolean;
+}
+
+/**
+ * an operator whose constant weights can be packed in a sparse format when the model loads
+ */
+export interface SparseOperator {
+  /**
+   * pack the constant weights of the operator if the fraction of their zeros reaches the threshold
+   */
+  prepareSparseWeights(node: Graph.Node, graph: Graph, threshold: number): void;
+  /**
+   * the packed weights of the operator, if any. they are set directly when they were packed ahead of time
+   */
+  sparseWeights?: SparseWeights;
+}
+
+export function isSparseOperator(op: Operator): op is Operator&SparseOperator {
+  return typeof (op as Partial<SparseOperator>).prepareSparseWeights === 'function';
+}
+
+// the layers of the sessions alive whose weights were packed, in the order the models were loaded
+const layers: SparseLayer[] = [];
+
+/**
+ * get the sparsity of the weights of the layers packed by the sessions alive, and the speedup of their sparse kernel
+ */
+export function getSparseReport(): SparseLayer[] {
+  return layers.map(layer => ({...layer, dims: layer.dims.slice()}));
+}
+
+/**
+ * remove the layer of packed weights from the report, when the session holding them is disposed
+ */
+export function releaseSparseWeights(weights: SparseWeights): void {
+  const index = layers.indexOf(weights.layer);
+  if (index !== -1) {
+    layers.splice(index, 1);
+  }
+}
+
+/**
+ * get the tensor of an input of a node if it is an initializer of the graph
+ */
+export function getInitializer(node: Graph.Node, graph: Graph, index: number): Tensor|undefined {
+  const value = index < node.inputs.length ? graph.getValues()[node.inputs[index]] : undefined;
+  return value && value.from === -1 ? value.tensor : undefined;
+}
+
+/**
+ * pack the weights of a layer, a row-major matrix [rows, cols], if at least the fraction threshold of them are zeros.
+ * the blocks of 1 x 4 are used when the zeros fill whole blocks just as often
+ * @param source the tensor holding the weights, which may be laid out differently from data
+ */
+export function packSparseWeights(
+    node: Graph.Node, source: Tensor, data: Tensor.FloatType, rows: number, cols: number,
+    threshold: number): SparseWeights|undefined {
+  let zeros = 0;
+  for (let i = 0; i < data.length; i++) {
+    if (data[i] === 0) {
+      zeros++;
+    }
+  }
+  const sparsity = zeros / data.length;
+  if (data.length === 0 || sparsity < threshold) {
+    return undefined;
+  }
+
+  const blockSize = cols % BLOCK_SIZE === 0 && zeroBlocks(data, BLOCK_SIZE) / (data.length / BLOCK_SIZE) >= threshold ?
+      BLOCK_SIZE :
+      1;
+  const blocksPerRow = cols / blockSize;
+  const rowPointers = new Int32Array(rows + 1);
+  const blockColumns: number[] = [];
+  const values: number[] = [];
+  for (let r = 0; r < rows; r++) {
+    for (let b = 0; b < blocksPerRow; b++) {
+      const start = r * cols + b * blockSize;
+      if (!isZeroBlock(data, start, blockSize)) {
+        blockColumns.push(b);
+        for (let i = 0; i < blockSize; i++) {
+          values.push(data[start + i]);
+        }
+      }
+    }
+    rowPointers[r + 1] = blockColumns.length;
+  }
+
+  return createSparseWeights(
+      node, source, blockSize, sparsity, rowPointers, Int32Array.from(blockColumns), Float32Array.from(values));
+}
+
+/**
+ * create the weights of a layer from their packed arrays, which may have been packed ahead of time (e.g. in a
+ * prepacked model)
+ */
+export function createSparseWeights(
+    node: Graph.Node, source: Tensor, blockSize: number, sparsity: number, rowPointers: Int32Array,
+    blockColumns: Int32Array, values: Float32Array): SparseWeights {
+  const layer: SparseLayer = {
+    name: node.name,
+    opType: node.opType,
+    dims: source.dims.slice(),
+    sparsity,
+    blockSize,
+    denseTime: 0,
+    sparseTime: 0,
+    speedup: 0,
+    sparse: false
+  };
+  layers.push(layer);
+  return {source, blockSize, rowPointers, blockColumns, values, layer};
+}
+
+/**
+ * run a layer with sparse weights. the first time, the dense and the sparse kernels both run once (each one computes
+ * the whole output) after a warm-up run, and the fastest one is kept for the later runs. the dense kernel is the
+ * fallback of the layers that are too small or not sparse enough to benefit from the sparse one.
+ */
+export async function runSparse(
+    weights: SparseWeights, runDense: () => Promise<void>, runSparseKernel: () => Promise<void>): Promise<void> {
+  if (weights.useSparse !== undefined) {
+    return weights.useSparse ? runSparseKernel() : runDense();
+  }
+
+  await runSparseKernel();
+  let start = now();
+  await runDense();
+  const denseTime = now() - start;
+  start = now();
+  await runSparseKernel();
+  const sparseTime = now() - start;
+
+  const layer = weights.layer;
+  layer.denseTime = denseTime;
+  layer.sparseTime = sparseTime;
+  layer.speedup = sparseTime > 0 ? denseTime / sparseTime : 0;
+  layer.sparse = weights.useSparse = sparseTime < denseTime;
+  Logger.verbose(
+      'Sparse',
+      `${layer.opType} '${layer.name}' (${(layer.sparsity * 100).toFixed(1)}% zeros, blocks of ${
+          layer.blockSize}): dense ${denseTime.toFixed(3)}ms, sparse ${sparseTime.toFixed(3)}ms, keeping the ${
+          layer.sparse ? 'sparse' : 'dense'} kernel`);
+}
+
+// copy a row-major matrix [rows, cols] to its transpose [cols, rows]
+export function transposeMatrix(data: Tensor.FloatType, rows: number, cols: number): Float32Array {
+  const transposed = new Float32Array(rows * cols);
+  for (let r = 0; r < rows; r++) {
+    for (let c = 0; c < cols; c++) {
+      transposed[c * rows + r] = data[r * cols + c];
+    }
+  }
+  return transposed;
+}
+
+function isZeroBlock(data: Tensor.FloatType, start: number, blockSize: number): boolean {
+  for (let i = 0; i < blockSize; i++) {
+    if (data[start + i] !== 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+function zeroBlocks(data: Tensor.FloatType, blockSize: number): number {
+  let count = 0;
+  for (let start = 0; start < data.length; start += blockSize) {
+    if (isZeroBlock(data, start, blockSize)) {
+      count++;
+    }
+  }
+  return count;
+}
@@ -9,13 +9,30 @@ import {Logger, Profiler} from './instrument';
 import {Operator} from './operators';
 import {Tensor} from './tensor';
 
+export declare namespace ExecutionPlan {
+  /**
+   * a static order of the nodes, and the values released after every node, e.g. computed ahead of time for a
+   * prepacked model
+   */
+  export interface Schedule {
+    // the indices of the nodes in the order they run
+    readonly order: ReadonlyArray<number>;
+    // the indices of the intermediate values whose last consumer is the node at the same position in the order
+    readonly releases: ReadonlyArray<ReadonlyArray<number>>;
+  }
+}
+
 class KernelOp {
   constructor(public op: Operator, public node: Graph.Node) {}
 }
 
 export class ExecutionPlan {
-  constructor(private graph: Graph, ops: Operator[], private profiler: Readonly<Profiler>) {
+  constructor(
+      private graph: Graph, ops: Operator[], private profiler: Readonly<Profiler>, schedule?: ExecutionPlan.Schedule) {
     this.initialize(ops);
+    if (schedule) {
+      this.schedules.set(scheduleKey(graph.getOutputIndices()), schedule);
+    }
   }
 
   initialize(ops: Operator[]) {
@@ -27,24 +44,6 @@ export class ExecutionPlan {
 
       this._ops = ops.map((op, i) => new KernelOp(op, graphNodes[i]));
       this.reset();
-
-      // look for starter node(s)
-      this._starter = [];
-      this._ops.forEach((op, i) => {
-        let resolved = true;
-        for (const input of op.node.inputs) {
-          if (
-              !this._values[input]                                   // not an initialized input
-              && this.graph.getInputIndices().indexOf(input) === -1  // not model input
-          ) {
-            resolved = false;
-            break;
-          }
-        }
-        if (resolved) {
-          this._starter.push(i);
-        }
-      });
     });
   }
 
@@ -52,12 +51,17 @@ export class ExecutionPlan {
     this._values = this.graph.getValues().map(i => i.tensor);
   }
 
-  execute(sessionHandler: SessionHandler, modelInputs: Tensor[]): Promise<Tensor[]> {
-    const isWebGLBackend = sessionHandler.backend instanceof WebGLBackend;
-    let glCtx: WebGLContext|undefined;
-    if (isWebGLBackend) {
-      glCtx = (sessionHandler.backend as WebGLBackend).glContext;
-    }
+  /**
+   * run the nodes the given outputs depend on, and only them
+   * @param outputs the indices of the values of the requested outputs, all the outputs of the graph by default
+   */
+  execute(
+      sessionHandler: SessionHandler, modelInputs: Tensor[],
+      outputs: ReadonlyArray<number> = this.graph.getOutputIndices()): Promise<Tensor[]> {
+    // the backend is recognized by its context rather than by its class, so that the execution plan does not load the
+    // webgl backend (and the modules it depends on) in a worker running a session of the wasm backend
+    const glCtx: WebGLContext|undefined = (sessionHandler.backend as Partial<WebGLBackend>).glContext;
+    const isWebGLBackend = glCtx !== undefined;
 
     return this.profiler.event('session', 'ExecutionPlan.execute', async () => {
       // reset mediem result
@@ -79,15 +83,11 @@ export class ExecutionPlan {
       });
 
       // prepare running sequence
-      const sequence: number[] = this._starter.slice(0);
+      const schedule = this.getSchedule(outputs);
 
       // execution iterations
-      const graphValues = this.graph.getValues();
-      const graphNodes = this.graph.getNodes();
-
-      let rear = 0;
-      while (rear < sequence.length) {
-        const thisOpIndex = sequence[rear++];
+      for (let position = 0; position < schedule.order.length; position++) {
+        const thisOpIndex = schedule.order[position];
         const thisOp = this._ops[thisOpIndex];
 
         // check input
@@ -131,29 +131,14 @@ export class ExecutionPlan {
           this._values[j] = output;
         });
 
-        // resolve downstream nodes
-        const downstreamNodes = new Set<number>();
-        outputList.forEach((output, i) => {
-          const j = thisOp.node.outputs[i];
-          for (const currentDownstreamNodeIndex of graphValues[j].to) {
-            const currentDownstreamNode = graphNodes[currentDownstreamNodeIndex];
-            let resolved = true;
-            for (const k of currentDownstreamNode.inputs) {
-              if (!this._values[k]) {
-                resolved = false;
-                break;
-              }
-            }
-            if (resolved) {
-              downstreamNodes.add(currentDownstreamNodeIndex);
-            }
-          }
-        });
-        sequence.push(...downstreamNodes);
+        // free the intermediate values no other node uses
+        for (const value of schedule.releases[position]) {
+          this._values[value] = undefined;
+        }
       }
 
       const output: Tensor[] = [];
-      this.graph.getOutputIndices().forEach((outputIndex, i) => {
+      outputs.forEach(outputIndex => {
         const thisValue = this._values[outputIndex];
         if (thisValue === undefined) {
           throw new Error(`required output [${outputIndex}] does not have value`);
@@ -168,7 +153,95 @@ export class ExecutionPlan {
     });
   }
 
+  /**
+   * get the schedule of the nodes computing the given outputs, computed the first time they are requested
+   */
+  private getSchedule(outputs: ReadonlyArray<number>): ExecutionPlan.Schedule {
+    const key = scheduleKey(outputs);
+    let schedule = this.schedules.get(key);
+    if (!schedule) {
+      schedule = computeSchedule(this.graph, outputs);
+      this.schedules.set(key, schedule);
+    }
+    return schedule;
+  }
+
   _values: Array<Tensor|undefined>;
   _ops: KernelOp[];
-  _starter: number[];
+  // the schedules of the sets of requested outputs, by key
+  private schedules = new Map<string, ExecutionPlan.Schedule>();
+}
+
+// the key of a set of outputs, whatever their order
+function scheduleKey(outputs: ReadonlyArray<number>): string {
+  return outputs.slice().sort((a, b) => a - b).join(',');
+}
+
+/**
+ * compute the order in which the execution plan runs the nodes of a graph, and the intermediate values that can be
+ * released after every node
+ * @param outputs the indices of the values of the requested outputs. only the nodes they depend on are scheduled
+ */
+export function computeSchedule(
+    graph: Graph, outputs: ReadonlyArray<number> = graph.getOutputIndices()): ExecutionPlan.Schedule {
+  const values = graph.getValues();
+  const nodes = graph.getNodes();
+  const resolved = values.map(value => value.tensor !== undefined);
+  for (const input of graph.getInputIndices()) {
+    resolved[input] = true;
+  }
+
+  // walk the graph backward from the outputs to the nodes they depend on. the initializers and the inputs of the
+  // graph come from no node
+  const required = nodes.map(() => false);
+  const pending = outputs.slice();
+  while (pending.length > 0) {
+    const from = values[pending.pop()!].from;
+    if (from >= 0 && !required[from]) {
+      required[from] = true;
+      pending.push(...nodes[from].inputs);
+    }
+  }
+  const isReady = (i: number) => required[i] && nodes[i].inputs.every(input => resolved[input]);
+
+  // a node runs once all its inputs are computed, after the node computing the last one
+  const order: number[] = [];
+  nodes.forEach((node, i) => {
+    if (isReady(i)) {
+      order.push(i);
+    }
+  });
+  for (let position = 0; position < order.length; position++) {
+    const node = nodes[order[position]];
+    for (const output of node.outputs) {
+      resolved[output] = true;
+    }
+    const downstreamNodes = new Set<number>();
+    for (const output of node.outputs) {
+      for (const next of values[output].to) {
+        if (isReady(next)) {
+          downstreamNodes.add(next);
+        }
+      }
+    }
+    order.push(...downstreamNodes);
+  }
+  if (order.length !== required.filter(r => r).length) {
+    throw new Error('cannot schedule all the nodes the outputs depend on');
+  }
+
+  // a value is released after the last node using it, or after the node computing it when no node consumes it. the
+  // initializers and the requested outputs are never released
+  const lastConsumers = new Map<number, number>();
+  order.forEach((nodeIndex, position) => {
+    const node = nodes[nodeIndex];
+    for (const value of node.inputs.concat(node.outputs)) {
+      if (values[value].tensor === undefined && outputs.indexOf(value) === -1) {
+        lastConsumers.set(value, position);
+      }
+    }
+  });
+  const releases: number[][] = order.map(() => []);
+  lastConsumers.forEach((position, value) => releases[position].push(value));
+  return {order, releases};
 }
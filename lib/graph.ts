@@ -6,6 +6,7 @@ import {onnx} from 'onnx-proto';
 import {Attribute} from './attribute';
 import {onnxruntime} from './ortSchema/ort_generated';
 import ortFbs = onnxruntime.experimental.fbs;
+import {PrepackedGraph} from './prepacked-model';
 import {Tensor} from './tensor';
 import {LongUtil, ProtoUtil} from './util';
 
@@ -53,6 +54,9 @@ export declare namespace Graph {
   export interface Transformer {
     removeAllIdentityNodes(): void;
     removeAllDropoutNodes(): void;
+    fuseAttentionNodes(): void;
+    convertToBlockedLayout(block: number): void;
+    shareInitializers(share: (tensor: Tensor) => Tensor): void;
     // TODO: add generic functions to manipulate the graph
   }
 
@@ -76,7 +80,7 @@ export const Graph = {
   /**
    * construct a graph from a graph protobuf type
    */
-  from: (graphProto: onnx.IGraphProto|ortFbs.Graph, initializer?: Graph.Initializer) =>
+  from: (graphProto: onnx.IGraphProto|ortFbs.Graph|PrepackedGraph, initializer?: Graph.Initializer) =>
       new GraphImpl(graphProto, initializer),
 };
 
@@ -140,7 +144,7 @@ class GraphImpl implements Graph, Graph.Transformer {
 
   private _nodes: Node[];
 
-  constructor(graph: onnx.IGraphProto|ortFbs.Graph, graphInitializer?: Graph.Initializer) {
+  constructor(graph: onnx.IGraphProto|ortFbs.Graph|PrepackedGraph, graphInitializer?: Graph.Initializer) {
     if (!graph) {
       throw new TypeError('graph is empty');
     }
@@ -148,8 +152,10 @@ class GraphImpl implements Graph, Graph.Transformer {
     // build the graph - will throw exceptions if something fatal is detected
     this.buildGraph(graph);
 
-    // execute any transformation logic for the graph (if applicable)
-    this.transformGraph(graphInitializer);
+    // execute any transformation logic for the graph (if applicable). a prepacked graph is already transformed
+    if (!(graph instanceof PrepackedGraph)) {
+      this.transformGraph(graphInitializer);
+    }
 
     // check for cycles and other inconsistencies - will throw exceptions if something fatal is detected
     this.checkIsAcyclic();
@@ -179,12 +185,14 @@ class GraphImpl implements Graph, Graph.Transformer {
     return this._nodes;
   }
 
-  private buildGraph(graph: onnx.IGraphProto|ortFbs.Graph) {
+  private buildGraph(graph: onnx.IGraphProto|ortFbs.Graph|PrepackedGraph) {
     // build the graph - will throw exceptions if something fatal is detected
     if (graph instanceof onnx.GraphProto) {
       this.buildGraphFromOnnxFormat(graph);
     } else if (graph instanceof ortFbs.Graph) {
       this.buildGraphFromOrtFormat(graph);
+    } else if (graph instanceof PrepackedGraph) {
+      this.buildGraphFromPrepackedFormat(graph);
     } else {
       throw new TypeError('Graph type is not supported.');
     }
@@ -508,6 +516,42 @@ class GraphImpl implements Graph, Graph.Transformer {
     }
   }
 
+  private buildGraphFromPrepackedFormat(graph: PrepackedGraph) {
+    const header = graph.header;
+    this._allData = header.values.map(info => {
+      const value = new Value();
+      if (info.type) {
+        value.type = {tensorType: info.type.tensorType, shape: {dims: info.type.dims}};
+      }
+      if (info.tensor) {
+        value._from = -1;
+        value.tensor = graph.readTensor(info.tensor);
+      }
+      return value;
+    });
+
+    this._allInputIndices = header.inputs;
+    this._allInputNames = header.inputNames;
+    this._allOutputIndices = header.outputs;
+    this._allOutputNames = header.outputNames;
+
+    this._nodes = header.nodes.map((info, i) => {
+      const node = new Node(new onnx.NodeProto({name: info.name, opType: info.opType}));
+      for (const attribute of info.attributes) {
+        node.attributes.set(attribute.name, attribute.type, graph.readAttribute(attribute));
+      }
+      for (const input of info.inputs) {
+        node.inputs.push(input);
+        this._allData[input]._to.push(i);
+      }
+      for (const output of info.outputs) {
+        node.outputs.push(output);
+        this._allData[output]._from = i;
+      }
+      return node;
+    });
+  }
+
   private checkIsAcyclic() {
     // go through the graph and check for cycles or other fatal inconsistencies
     const starters: Set<number> = new Set<number>();
@@ -726,6 +770,250 @@ class GraphImpl implements Graph, Graph.Transformer {
     }
   }
 
+  /**
+   * Fuse the MatMul -> Div -> Add -> Softmax -> MatMul pattern of scaled dot-product attention into a single
+   * 'FusedAttention' node. The fused node takes the inputs [Q, K_t, divisor, mask, V] and the attributes of the Softmax
+   * node, and replaces the last MatMul node.
+   */
+  fuseAttentionNodes() {
+    for (const softmax of this._nodes) {
+      if (softmax.opType !== 'Softmax' || !softmax.executeNode) {
+        continue;
+      }
+      const add = this.getFusableProducer(softmax.inputs[0], 'Add');
+      if (!add) {
+        continue;
+      }
+      // the mask can be either input of the 'Add' node
+      let div = this.getFusableProducer(add.inputs[0], 'Div');
+      let mask = add.inputs[1];
+      if (!div) {
+        div = this.getFusableProducer(add.inputs[1], 'Div');
+        mask = add.inputs[0];
+      }
+      const matmul = div ? this.getFusableProducer(div.inputs[0], 'MatMul') : undefined;
+      const scores = this._allData[softmax.outputs[0]];
+      if (!div || !matmul || scores.to.length !== 1 || this._allOutputIndices.indexOf(softmax.outputs[0]) !== -1) {
+        continue;
+      }
+      // the fused kernel needs a softmax over the last axis and a scalar divisor. when the rank of the scores or the
+      // divisor are only known when the model runs, the kernel checks them and runs the nodes one by one otherwise
+      const axis = softmax.attributes.getInt('axis', 1);
+      const rankQ = this.getRank(matmul.inputs[0]);
+      const rankK = this.getRank(matmul.inputs[1]);
+      const rank = rankQ !== undefined && rankK !== undefined ? Math.max(rankQ, rankK) : undefined;
+      const divisor = this._allData[div.inputs[1]].tensor;
+      if ((rank === undefined ? axis < -1 || axis === 0 : axis !== -1 && axis !== rank - 1) ||
+          (divisor && divisor.size !== 1)) {
+        continue;
+      }
+      const attentionIndex = scores.to[0];
+      const attention = this._nodes[attentionIndex];
+      if (attention.opType !== 'MatMul' || attention.inputs[0] !== softmax.outputs[0]) {
+        continue;
+      }
+
+      // the other inputs of the fused nodes now go to the attention node
+      const inputs: Array<[Node, number]> =
+          [[matmul, matmul.inputs[0]], [matmul, matmul.inputs[1]], [div, div.inputs[1]], [add, mask]];
+      for (const [node, input] of inputs) {
+        const to = this._allData[input]._to;
+        to[to.indexOf(this._nodes.indexOf(node))] = attentionIndex;
+      }
+      matmul.executeNode = false;
+      div.executeNode = false;
+      add.executeNode = false;
+      softmax.executeNode = false;
+
+      attention.opType = 'FusedAttention';
+      attention.inputs = [matmul.inputs[0], matmul.inputs[1], div.inputs[1], mask, attention.inputs[1]];
+      attention.attributes = softmax.attributes;
+    }
+  }
+
+  /**
+   * Replace the tensors of the initializers by the tensors returned by the given function, e.g. identical tensors held
+   * by other graphs.
+   */
+  shareInitializers(share: (tensor: Tensor) => Tensor) {
+    for (const value of this._allData) {
+      if (value._from === -1 && value.tensor) {
+        value.tensor = share(value.tensor);
+      }
+    }
+  }
+
+  /**
+   * Convert the chains of convolutions, pools, normalizations and element-wise operators to the blocked NCHWc layout
+   * [N, ceil(C / block), H, W, block], where the channels of every pixel are grouped in blocks of contiguous values.
+   * The converted nodes get the blocked operator types (e.g. 'ConvNCHWc'), or keep their types if they do not depend
+   * on the layout (e.g. 'Relu'). A 'ReorderToNCHWc' node is inserted before the convolutions whose input is not
+   * blocked, and a 'ReorderFromNCHWc' node after the converted nodes whose output is a graph output or is consumed by
+   * a node that is not converted.
+   */
+  convertToBlockedLayout(block: number) {
+    // the blocked value replacing every converted value, and the number of channels of the converted values
+    const blocked = new Map<number, number>();
+    const channels = new Map<number, number>();
+    // the values reordered to the blocked layout for the convolutions, and the blocked values
+    const reordered = new Map<number, number>();
+
+    const nodeCount = this._nodes.length;
+    for (let nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++) {
+      const node = this._nodes[nodeIndex];
+      const conversion = node.executeNode ? this.getBlockedConversion(node, blocked, channels, block) : undefined;
+      if (!conversion) {
+        continue;
+      }
+
+      for (const input of conversion.inputs) {
+        const value = node.inputs[input];
+        let blockedValue = blocked.get(value) ?? reordered.get(value);
+        if (blockedValue === undefined) {
+          blockedValue = this.addNode('ReorderToNCHWc', value, undefined, ['block', block]);
+          reordered.set(value, blockedValue);
+        }
+        const to = this._allData[value]._to;
+        to.splice(to.indexOf(nodeIndex), 1);
+        this._allData[blockedValue]._to.push(nodeIndex);
+        node.inputs[input] = blockedValue;
+      }
+
+      const output = node.outputs[0];
+      const blockedOutput = this._allData.push(new Value()) - 1;
+      this._allData[blockedOutput]._from = nodeIndex;
+      node.outputs[0] = blockedOutput;
+      node.opType = conversion.opType;
+      blocked.set(output, blockedOutput);
+      channels.set(output, conversion.channels);
+    }
+
+    // the original values are computed again from the blocked values if they are still used, or deleted
+    blocked.forEach((blockedValue, value) => {
+      if (this._allData[value]._to.length > 0 || this._allOutputIndices.indexOf(value) !== -1) {
+        this.addNode('ReorderFromNCHWc', blockedValue, value, ['channels', channels.get(value)!]);
+      } else {
+        this._allData[value]._from = -2;
+      }
+    });
+  }
+
+  /**
+   * Get the blocked operator type of a node, the indices of its inputs in the blocked layout and the number of
+   * channels of its output, if the node can be converted to the blocked layout
+   */
+  private getBlockedConversion(node: Node, blocked: Map<number, number>, channels: Map<number, number>, block: number):
+      {opType: string; inputs: number[]; channels: number}|undefined {
+    if (node.outputs.length !== 1) {
+      return undefined;
+    }
+    const firstChannels = channels.get(node.inputs[0]);
+    switch (node.opType) {
+      case 'Conv':
+        // the number of output channels is known from the weights
+        const weights = this._allData[node.inputs[1]].tensor;
+        if (!weights || weights.dims.length !== 4 || node.attributes.getInt('group', 1) !== 1 ||
+            (firstChannels !== undefined && firstChannels !== weights.dims[1])) {
+          return undefined;
+        }
+        return {opType: 'ConvNCHWc', inputs: [0], channels: weights.dims[0]};
+      case 'AveragePool':
+      case 'MaxPool':
+        if (firstChannels === undefined || node.attributes.getInts('kernel_shape').length !== 2 ||
+            node.attributes.getInt('ceil_mode', 0) !== 0 || node.attributes.getInts('dilations', []).length > 0 ||
+            node.attributes.getInt('storage_order', 0) !== 0) {
+          return undefined;
+        }
+        return {opType: `${node.opType}NCHWc`, inputs: [0], channels: firstChannels};
+      case 'GlobalAveragePool':
+      case 'GlobalMaxPool':
+      case 'BatchNormalization':
+        return firstChannels === undefined ? undefined :
+                                             {opType: `${node.opType}NCHWc`, inputs: [0], channels: firstChannels};
+      case 'Relu':
+      case 'LeakyRelu':
+      case 'Sigmoid':
+      case 'Tanh':
+      case 'Clip':
+        // the padding channels stay finite
+        return firstChannels === undefined ? undefined : {opType: node.opType, inputs: [0], channels: firstChannels};
+      case 'Add':
+      case 'Sub':
+      case 'Mul':
+      case 'Sum':
+        // the blocked inputs must have the same channels, the other inputs must be scalar initializers
+        const inputs: number[] = [];
+        let outputChannels: number|undefined;
+        for (let i = 0; i < node.inputs.length; i++) {
+          const inputChannels = channels.get(node.inputs[i]);
+          const tensor = this._allData[node.inputs[i]].tensor;
+          if (inputChannels !== undefined && (outputChannels === undefined || inputChannels === outputChannels)) {
+            inputs.push(i);
+            outputChannels = inputChannels;
+          } else if (!tensor || tensor.size !== 1) {
+            return undefined;
+          }
+        }
+        return outputChannels === undefined ? undefined : {opType: node.opType, inputs, channels: outputChannels};
+      case 'Concat':
+        // the blocks of the inputs are concatenated if they are all full
+        let concatChannels = 0;
+        for (const input of node.inputs) {
+          const inputChannels = channels.get(input);
+          if (inputChannels === undefined || inputChannels % block !== 0) {
+            return undefined;
+          }
+          concatChannels += inputChannels;
+        }
+        return node.attributes.getInt('axis') !== 1 ?
+            undefined :
+            {opType: node.opType, inputs: node.inputs.map((_, i) => i), channels: concatChannels};
+      default:
+        return undefined;
+    }
+  }
+
+  /**
+   * Add a node of the given type with a single input, a single output and a single integer attribute. The output is a
+   * new value if not specified. Returns the index of the output value
+   */
+  private addNode(opType: string, input: number, output: number|undefined, attribute: [string, number]): number {
+    const nodeIndex = this._nodes.length;
+    const node = new Node(new onnx.NodeProto({name: `${opType}_${nodeIndex}`, opType}));
+    node.attributes.set(attribute[0], 'int', attribute[1]);
+    this._nodes.push(node);
+    if (output === undefined) {
+      output = this._allData.push(new Value()) - 1;
+    }
+    node.inputs.push(input);
+    node.outputs.push(output);
+    this._allData[input]._to.push(nodeIndex);
+    this._allData[output]._from = nodeIndex;
+    return output;
+  }
+
+  /**
+   * Get the rank of a value, if it is known before the model runs (an initializer or a typed input)
+   */
+  private getRank(valueIndex: number): number|undefined {
+    const value = this._allData[valueIndex];
+    return value.tensor ? value.tensor.dims.length : value.type ? value.type.shape.dims.length : undefined;
+  }
+
+  /**
+   * Get the node of the given type producing the specified value, if that value is only consumed by a single node and
+   * is not a graph output
+   */
+  private getFusableProducer(valueIndex: number, opType: string): Node|undefined {
+    const value = this._allData[valueIndex];
+    if (value.from === undefined || value.from < 0 || value.to.length !== 1 ||
+        this._allOutputIndices.indexOf(valueIndex) !== -1) {
+      return undefined;
+    }
+    const node = this._nodes[value.from];
+    return node.opType === opType && node.executeNode ? node : undefined;
+  }
+
   removeAllIdentityNodes() {
     let nodeIndex = 0;
     for (const node of this._nodes) {
@@ -236,6 +236,54 @@ export declare namespace Profiler {
   export interface Event {
     end(): void|Promise<void>;
   }
+
+  /**
+   * the phases of a call to a WebAssembly function. a call in the calling thread serializes its arguments to the Wasm
+   * heap, computes and deserializes the outputs. a call on a worker also transfers the arguments to the worker, which
+   * copies them in and out of its heap, and returns them
+   */
+  export type WasmCallPhaseName = 'serialize'|'transfer'|'copy-in'|'compute'|'copy-out'|'return'|'deserialize';
+
+  export interface WasmCallPhase {
+    name: WasmCallPhaseName;
+    startTime: number;
+    endTime: number;
+  }
+
+  /**
+   * a call to a WebAssembly function. all the times are on the clock of the calling thread
+   */
+  export interface WasmCall {
+    name: string;
+    // the worker running the function, or -1 for the calling thread
+    worker: number;
+    // the bytes of the serialized input and output arguments
+    bytesIn: number;
+    bytesOut: number;
+    startTime: number;
+    endTime: number;
+    phases: WasmCallPhase[];
+  }
+
+  /**
+   * an event of the Chrome trace event format (see chrome://tracing or https://ui.perfetto.dev). the times are in
+   * microseconds
+   */
+  export interface TraceEvent {
+    name: string;
+    cat?: string;
+    ph: 'X'|'M';
+    ts?: number;
+    dur?: number;
+    pid: number;
+    tid: number;
+    args?: {[name: string]: string|number};
+  }
+
+  export interface Trace {
+    traceEvents: TraceEvent[];
+    displayTimeUnit: 'ms';
+  }
 }
 // TODO
 // class WebGLEvent implements Profiler.Event {}
@@ -264,6 +312,16 @@ class EventRecord {
       public category: Profiler.EventCategory, public name: string, public startTime: number, public endTime: number) {}
 }
 
+// the phases of the calls to WebAssembly functions that run on the worker, as opposed to the calling thread
+const WORKER_PHASES: Profiler.WasmCallPhaseName[] = ['copy-in', 'compute', 'copy-out'];
+
+interface TraceArgs {
+  [name: string]: string|number;
+}
+
+// the profilers started, which record the calls to WebAssembly functions
+const startedProfilers: Profiler[] = [];
+
 export class Profiler {
   static create(config?: Profiler.Config): Profiler {
     if (config === undefined) {
@@ -285,6 +343,9 @@ export class Profiler {
     this._timingEvents = [];
     this._flushTime = now();
     this._flushPointer = 0;
+    if (startedProfilers.indexOf(this) === -1) {
+      startedProfilers.push(this);
+    }
   }
 
   // stop profiling
@@ -293,6 +354,22 @@ export class Profiler {
     for (; this._flushPointer < this._timingEvents.length; this._flushPointer++) {
       this.logOneEvent(this._timingEvents[this._flushPointer]);
     }
+    const index = startedProfilers.indexOf(this);
+    if (index !== -1) {
+      startedProfilers.splice(index, 1);
+    }
+  }
+
+  // whether any profiler is started, in which case the calls to WebAssembly functions should be recorded
+  static get recordingWasmCalls() {
+    return startedProfilers.length > 0;
+  }
+
+  // log a call to a WebAssembly function in all the started profilers, for tools/parse-profiler.ts to trace
+  static recordWasmCall(call: Profiler.WasmCall) {
+    for (const profiler of startedProfilers) {
+      profiler.logWasmCall(call);
+    }
   }
 
   // create an event scope for the specific function
@@ -385,6 +462,16 @@ export class Profiler {
         `${(event.endTime - event.startTime).toFixed(2)}ms on event '${event.name}' at ${event.endTime.toFixed(2)}`);
   }
 
+  // the calls are logged with the start and end times of their phases, which tools/parse-profiler.ts reads
+  private logWasmCall(call: Profiler.WasmCall) {
+    Logger.verbose(
+        'Profiler.wasm',
+        `${(call.endTime - call.startTime).toFixed(3)}ms on call '${call.name}' on ${
+            call.worker === -1 ? 'main' : `worker-${call.worker}`} (${call.bytesIn} bytes in, ${
+            call.bytesOut} bytes out) at ${call.endTime.toFixed(3)}: ${
+            call.phases.map(p => `${p.name} ${p.startTime.toFixed(3)}-${p.endTime.toFixed(3)}`).join(', ')}`);
+  }
+
   private flush(currentTime: number) {
     if (this._timingEvents.length - this._flushPointer >= this._flushBatchSize ||
         currentTime - this._flushTime >= this._flushIntervalInMilliseconds) {
@@ -415,6 +502,64 @@ export class Profiler {
   private _flushPointer = 0;
 }
 
+/**
+ * create a trace in the Chrome trace event format, with one track for the calling thread and one per worker. the
+ * events are nested on the track of the calling thread. a call to a WebAssembly function is a slice on the track of the
+ * thread running it, with its phases as nested slices: the serialization and the deserialization of the arguments of
+ * the calls on the workers stay on the track of the calling thread
+ */
+export function createChromeTrace(
+    events: ReadonlyArray<{category: string, name: string, startTime: number, endTime: number}>,
+    calls: ReadonlyArray<Profiler.WasmCall>): Profiler.Trace {
+  const traceEvents: Profiler.TraceEvent[] = [];
+  const threads: number[] = [0];
+  const slice = (name: string, cat: string, tid: number, startTime: number, endTime: number, args?: TraceArgs) => {
+    traceEvents.push({name, cat, ph: 'X', ts: startTime * 1000, dur: (endTime - startTime) * 1000, pid: 0, tid, args});
+  };
+
+  for (const event of events) {
+    // the events timed by WebGL only have a duration
+    if (event.startTime > 0) {
+      slice(event.name, event.category, 0, event.startTime, event.endTime);
+    }
+  }
+  for (const call of calls) {
+    const tid = call.worker + 1;
+    if (threads.indexOf(tid) === -1) {
+      threads.push(tid);
+    }
+    const args = {bytesIn: call.bytesIn, bytesOut: call.bytesOut};
+    // the messages between the threads do not run on either thread, their times are arguments of the call
+    const callArgs: TraceArgs = {...args, totalMs: call.endTime - call.startTime};
+    const phases: Profiler.WasmCallPhase[] = [];
+    for (const phase of call.phases) {
+      if (phase.name === 'transfer' || phase.name === 'return') {
+        callArgs[`${phase.name}Ms`] = phase.endTime - phase.startTime;
+      } else {
+        phases.push(phase);
+      }
+    }
+
+    const workerPhases = phases.filter(p => call.worker === -1 || WORKER_PHASES.indexOf(p.name) !== -1);
+    if (workerPhases.length > 0) {
+      slice(
+          call.name, 'wasm', tid, workerPhases[0].startTime, workerPhases[workerPhases.length - 1].endTime, callArgs);
+    }
+    for (const phase of phases) {
+      const onWorker = call.worker !== -1 && WORKER_PHASES.indexOf(phase.name) !== -1;
+      slice(phase.name, 'wasm', onWorker ? tid : 0, phase.startTime, phase.endTime, {function: call.name, ...args});
+    }
+  }
+
+  // the tracks are named after the threads, and sorted by ID in the viewer
+  for (const tid of threads) {
+    traceEvents.push(
+        {name: 'thread_name', ph: 'M', pid: 0, tid, args: {name: tid === 0 ? 'main' : `worker-${tid - 1}`}});
+    traceEvents.push({name: 'thread_sort_index', ph: 'M', pid: 0, tid, args: {sort_index: tid}});
+  }
+  return {traceEvents, displayTimeUnit: 'ms'};
+}
+
 /**
  * returns a number to represent the current timestamp in a resolution as high as possible.
  */
@@ -8,6 +8,7 @@ import {Graph} from './graph';
 import {OpSet} from './opset';
 import {onnxruntime} from './ortSchema/ort_generated';
 import ortFbs = onnxruntime.experimental.fbs;
+import {isPrepackedModel, PrepackedGraph} from './prepacked-model';
 import {LongUtil} from './util';
 
 export class Model {
@@ -15,7 +16,9 @@ export class Model {
   constructor() {}
 
   load(buf: Buffer, graphInitializer?: Graph.Initializer, isOrtFormat?: boolean): void {
-    if (!isOrtFormat) {
+    if (isPrepackedModel(buf)) {
+      this.loadFromPrepackedFormat(buf);
+    } else if (!isOrtFormat) {
       this.loadFromOnnxFormat(buf, graphInitializer);
     } else {
       this.loadFromOrtFormat(buf, graphInitializer);
@@ -52,6 +55,14 @@ export class Model {
     this._graph = Graph.from(ortModel.graph()!, graphInitializer);
   }
 
+  // the graph of a prepacked model is already transformed, so the graph initializer is not used
+  private loadFromPrepackedFormat(buf: Buffer): void {
+    const prepacked = new PrepackedGraph(buf);
+    this._opsets = prepacked.header.opsets;
+    this._graph = Graph.from(prepacked);
+    this._prepacked = prepacked;
+  }
+
   private _graph: Graph;
   get graph(): Graph {
     return this._graph;
@@ -61,4 +72,12 @@ export class Model {
   get opsets(): ReadonlyArray<OpSet> {
     return this._opsets;
   }
+
+  private _prepacked?: PrepackedGraph;
+  /**
+   * the prepacked model the graph was read from, if any
+   */
+  get prepacked(): PrepackedGraph|undefined {
+    return this._prepacked;
+  }
 }
@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {Attribute} from '../attribute';
+import {InferenceHandler} from '../backend';
+import {Operator} from '../operators';
+import {Tensor} from '../tensor';
+
+export abstract class ConvTranspose implements Operator {
+  abstract run(inferenceHandler: InferenceHandler, inputs: Tensor[]): Tensor[]|Promise<Tensor[]>;
+
+  initialize(attributes: Attribute): void {
+    this.autoPad = attributes.getString('auto_pad', 'NOTSET');
+    this.dilations = attributes.getInts('dilations', [1, 1]);
+    this.group = attributes.getInt('group', 1);
+    this.kernelShape = attributes.getInts('kernel_shape', []);
+    this.outputPadding = attributes.getInts('output_padding', [0, 0]);
+    this.outputShape = attributes.getInts('output_shape', []);
+    this.pads = attributes.getInts('pads', [0, 0, 0, 0]);
+    this.strides = attributes.getInts('strides', [1, 1]);
+  }
+
+  checkInputs(inputs: Tensor[]): boolean {
+    // Refer to the below link for all input checks
+    // https://github.com/onnx/onnx/blob/master/docs/Operators.md#ConvTranspose
+    if (!inputs || (inputs.length !== 2 && inputs.length !== 3)) {
+      return false;
+    }
+
+    // only the 2-D transposed convolutions are supported: the input and the weights have rank 4, and the attributes
+    // one value per spatial axis
+    const spatialRank = inputs[0].dims.length - 2;
+    if (spatialRank !== 2 || inputs[1].dims.length !== inputs[0].dims.length || this.dilations.length !== spatialRank ||
+        this.strides.length !== spatialRank || this.pads.length !== spatialRank * 2 ||
+        this.outputPadding.length !== spatialRank) {
+      return false;
+    }
+
+    // the weights have the shape [DATA_CHANNEL, FILTER_OUT_CHANNEL / group, ...]
+    const dataChannel = inputs[0].dims[1];
+    if (dataChannel !== inputs[1].dims[0] || dataChannel % this.group !== 0) {
+      return false;
+    }
+
+    // if bias is provided it should be 1D and the number of elements should be equal to the number of feature maps
+    if (inputs.length === 3 &&
+        (inputs[2].dims.length !== 1 || inputs[1].dims[1] * this.group !== inputs[2].dims[0])) {
+      return false;
+    }
+
+    // output_shape may be given with or without the batch size and the channels
+    if (this.outputShape.length !== 0 && this.outputShape.length !== spatialRank &&
+        this.outputShape.length !== spatialRank + 2) {
+      return false;
+    }
+
+    // if kernelShape is specified, it's data length must be 2 less than dims length of the weights tensor
+    if (this.kernelShape.length !== 0 && this.kernelShape.length !== inputs[1].dims.length - 2) {
+      return false;
+    }
+
+    return this.checkInputTypes(inputs);
+  }
+
+  protected checkInputTypes(inputs: Tensor[]): boolean {
+    if (inputs[0].type !== 'float32' || inputs[1].type !== 'float32') {
+      return false;
+    }
+
+    if (inputs.length === 3 && inputs[2].type !== 'float32') {
+      return false;
+    }
+
+    return true;
+  }
+
+  protected autoPad: string;
+  protected dilations: number[];
+  protected group: number;
+  protected kernelShape: number[];
+  protected outputPadding: number[];
+  protected outputShape: number[];
+  protected pads: number[];
+  protected strides: number[];
+}
@@ -26,9 +26,8 @@ export abstract class Conv implements Operator {
       return false;
     }
 
-    // TODO : Need to add support for multi-dimensional conv
-    // currently only support 2-dimensional conv
-    if (inputs[0].dims.length !== 4 || inputs[1].dims.length !== 4) {
+    // the input and the weights have the same rank, whose spatial part must be supported by the backend
+    if (inputs[0].dims.length !== inputs[1].dims.length || !this.isSupportedSpatialRank(inputs[0].dims.length - 2)) {
       return false;
     }
 
@@ -69,6 +68,11 @@ export abstract class Conv implements Operator {
     return this.checkInputTypes(inputs);
   }
 
+  // the spatial ranks the kernels of the backend support. 2-D by default, backends supporting others override this
+  protected isSupportedSpatialRank(spatialRank: number): boolean {
+    return spatialRank === 2;
+  }
+
   protected checkInputTypes(inputs: Tensor[]): boolean {
     // TODO : Need to add support for float64
     if (inputs[0].type !== 'float32' || inputs[1].type !== 'float32') {
@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {Attribute} from '../attribute';
+import {InferenceHandler} from '../backend';
+import {Graph} from '../graph';
+import {Operator} from '../operators';
+import {Tensor} from '../tensor';
+
+export abstract class LSTM implements Operator {
+  abstract run(inferenceHandler: InferenceHandler, inputs: Tensor[]): Tensor[]|Promise<Tensor[]>;
+
+  initialize(attributes: Attribute, node: Graph.Node): void {
+    this.hiddenSize = attributes.getInt('hidden_size');
+    this.direction = attributes.getString('direction', 'forward');
+    if (this.direction !== 'forward' && this.direction !== 'reverse' && this.direction !== 'bidirectional') {
+      throw new Error(`unrecognized direction: ${this.direction}`);
+    }
+    this.clip = attributes.getFloat('clip', 0);
+    this.inputForget = attributes.getInt('input_forget', 0) !== 0;
+
+    // only the default activations (f=Sigmoid, g=Tanh, h=Tanh) are supported
+    const activations = attributes.getStrings('activations', []);
+    for (let i = 0; i < activations.length; i++) {
+      if (activations[i] !== (i % 3 === 0 ? 'Sigmoid' : 'Tanh')) {
+        throw new Error(`unsupported activations: ${activations}`);
+      }
+    }
+
+    // Y, Y_h and Y_c are all optional outputs. produce all of them for a node without outputs
+    this.numOutputs = node.outputs.length > 0 ? node.outputs.length : 3;
+  }
+
+  checkInputs(inputs: Tensor[]): boolean {
+    if (!inputs || inputs.length < 3 || inputs.length > 8) {
+      return false;
+    }
+
+    const numDirections = this.direction === 'bidirectional' ? 2 : 1;
+    const [x, w, r] = inputs;
+    if (x.dims.length !== 3 || w.dims.length !== 3 || r.dims.length !== 3 || w.dims[0] !== numDirections ||
+        w.dims[1] !== 4 * this.hiddenSize || w.dims[2] !== x.dims[2] || r.dims[0] !== numDirections ||
+        r.dims[1] !== 4 * this.hiddenSize || r.dims[2] !== this.hiddenSize) {
+      return false;
+    }
+
+    return this.checkInputTypes(inputs);
+  }
+
+  protected checkInputTypes(inputs: Tensor[]): boolean {
+    for (let i = 0; i < inputs.length; i++) {
+      // sequence_lens is the only integer input
+      if (inputs[i].type !== (i === 4 ? 'int32' : 'float32')) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  protected hiddenSize: number;
+  protected direction: string;
+  protected clip: number;
+  protected inputForget: boolean;
+  protected numOutputs: number;
+}
@@ -0,0 +1,304 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {Attribute} from './attribute';
+import {SparseWeights} from './backends/wasm/sparse';
+import {ExecutionPlan} from './execution-plan';
+import {Graph} from './graph';
+import {OpSet} from './opset';
+import {Tensor} from './tensor';
+import {ShapeUtil} from './util';
+
+// a prepacked model is a model prepared ahead of time for the WebAssembly backend by tools/prepack-model.ts: its graph
+// is already transformed, the weights of its operators are already packed and its nodes are already scheduled, so
+// loading it only reads the graph and takes the weights in place.
+//
+// layout of the file:
+//   the magic 'ONNXJSPK' (8 bytes), the version of the format and the length of the header (uint32 in little endian)
+//   the header (JSON in UTF-8)
+//   the weights, from the next multiple of WEIGHTS_ALIGNMENT bytes. the data of every tensor starts at a multiple of
+//   WEIGHTS_ALIGNMENT bytes and is stored in little endian, so that the tensors are views on the file
+export declare namespace PrepackedModel {
+  // a tensor of the weights. the strings of a string tensor are in the header
+  export interface TensorInfo {
+    type: Tensor.DataType;
+    dims: number[];
+    // the offset of the data of the tensor in the weights, in bytes
+    offset?: number;
+    strings?: string[];
+  }
+
+  // the non-finite floats are stored as strings, which JSON does not support
+  export type FloatInfo = number|string;
+
+  export interface AttributeInfo {
+    name: string;
+    type: Attribute.DataType;
+    value?: FloatInfo|string|FloatInfo[]|string[];
+    tensors?: TensorInfo[];
+  }
+
+  export interface ValueInfo {
+    type?: {tensorType: Tensor.DataType; dims: number[]};
+    // the data of an initializer
+    tensor?: TensorInfo;
+  }
+
+  export interface NodeInfo {
+    name: string;
+    opType: string;
+    inputs: number[];
+    outputs: number[];
+    attributes: AttributeInfo[];
+  }
+
+  // the weights of an input of a node packed in the block compressed sparse row format (see lib/backends/wasm/sparse)
+  export interface SparseWeightsInfo {
+    node: number;
+    input: number;
+    blockSize: number;
+    sparsity: number;
+    rowPointers: TensorInfo;
+    blockColumns: TensorInfo;
+    values: TensorInfo;
+  }
+
+  // the options of the WebAssembly backend the model was prepared for
+  export interface Options {
+    cpuFallback: boolean;
+    channelBlock: number;
+    sparsity: number;
+  }
+
+  export interface Header {
+    opsets: OpSet[];
+    options: Options;
+    inputs: number[];
+    inputNames: string[];
+    outputs: number[];
+    outputNames: string[];
+    values: ValueInfo[];
+    nodes: NodeInfo[];
+    sparseWeights: SparseWeightsInfo[];
+    schedule: ExecutionPlan.Schedule;
+  }
+}
+
+const MAGIC = 'ONNXJSPK';
+const VERSION = 1;
+// the magic, the version and the length of the header
+const PREAMBLE_SIZE = 16;
+export const WEIGHTS_ALIGNMENT = 16;
+
+/**
+ * check whether a buffer holds a prepacked model
+ */
+export function isPrepackedModel(buf: Uint8Array): boolean {
+  if (buf.byteLength < PREAMBLE_SIZE) {
+    return false;
+  }
+  for (let i = 0; i < MAGIC.length; i++) {
+    if (buf[i] !== MAGIC.charCodeAt(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * a prepacked model read from a buffer. its tensors are views on the buffer when they are aligned in memory
+ */
+export class PrepackedGraph {
+  constructor(buf: Uint8Array) {
+    if (!isPrepackedModel(buf)) {
+      throw new Error('not a prepacked model');
+    }
+    const view = new DataView(buf.buffer, buf.byteOffset, buf.byteLength);
+    const version = view.getUint32(MAGIC.length, true);
+    if (version !== VERSION) {
+      throw new Error(`unsupported version of the prepacked model format: ${version}`);
+    }
+    const headerLength = view.getUint32(MAGIC.length + 4, true);
+    if (PREAMBLE_SIZE + headerLength > buf.byteLength) {
+      throw new Error('invalid prepacked model: truncated header');
+    }
+    this.header =
+        JSON.parse(Buffer.from(buf.buffer, buf.byteOffset + PREAMBLE_SIZE, headerLength).toString('utf8')) as
+        PrepackedModel.Header;
+    this.weights = buf.subarray(align(PREAMBLE_SIZE + headerLength));
+  }
+
+  readonly header: PrepackedModel.Header;
+
+  /**
+   * get a tensor of the weights
+   */
+  readTensor(info: PrepackedModel.TensorInfo): Tensor {
+    if (info.type === 'string') {
+      return Tensor.fromData(info.strings!, info.dims, 'string');
+    }
+    const byteLength = tensorByteLength(info);
+    if (info.offset === undefined || info.offset + byteLength > this.weights.byteLength) {
+      throw new Error('invalid prepacked model: tensor out of the weights');
+    }
+    return Tensor.fromRawData(this.weights.subarray(info.offset, info.offset + byteLength), info.dims, info.type);
+  }
+
+  /**
+   * get the value of an attribute
+   */
+  readAttribute(info: PrepackedModel.AttributeInfo): Attribute.DataTypeMap[Attribute.DataType] {
+    switch (info.type) {
+      case 'float':
+        return Number(info.value);
+      case 'floats':
+        return (info.value as PrepackedModel.FloatInfo[]).map(Number);
+      case 'tensor':
+        return this.readTensor(info.tensors![0]);
+      case 'tensors':
+        return info.tensors!.map(tensor => this.readTensor(tensor));
+      default:
+        return info.value as Attribute.DataTypeMap[Attribute.DataType];
+    }
+  }
+
+  private weights: Uint8Array;
+}
+
+/**
+ * write a graph transformed for the WebAssembly backend, with the weights packed by its operators, as a prepacked model
+ * @param graph the transformed graph
+ * @param opsets the opsets of the model
+ * @param options the options of the backend the graph was transformed for
+ * @param schedule the order of the nodes and the values released after them
+ * @param sparseWeights the packed weights of the nodes, by index of the node
+ */
+export function encodePrepackedModel(
+    graph: Graph, opsets: ReadonlyArray<OpSet>, options: PrepackedModel.Options, schedule: ExecutionPlan.Schedule,
+    sparseWeights: ReadonlyMap<number, SparseWeights>): Uint8Array {
+  const writer = new WeightsWriter();
+  const values = graph.getValues();
+  const nodes = graph.getNodes();
+
+  const header: PrepackedModel.Header = {
+    opsets: opsets.map(opset => ({domain: opset.domain, version: opset.version})),
+    options,
+    inputs: graph.getInputIndices().slice(),
+    inputNames: graph.getInputNames().slice(),
+    outputs: graph.getOutputIndices().slice(),
+    outputNames: graph.getOutputNames().slice(),
+    values: values.map(value => {
+      const info: PrepackedModel.ValueInfo = {};
+      if (value.type) {
+        info.type = {tensorType: value.type.tensorType, dims: value.type.shape.dims.slice()};
+      }
+      if (value.tensor) {
+        info.tensor = writer.write(value.tensor);
+      }
+      return info;
+    }),
+    nodes: nodes.map(node => {
+      const attributes: PrepackedModel.AttributeInfo[] = [];
+      node.attributes.forEach((name, type, value) => attributes.push(encodeAttribute(writer, name, type, value)));
+      const inputs = node.inputs.slice();
+      const outputs = node.outputs.slice();
+      return {name: node.name, opType: node.opType, inputs, outputs, attributes};
+    }),
+    sparseWeights: [],
+    schedule: {order: schedule.order.slice(), releases: schedule.releases.map(release => release.slice())}
+  };
+
+  sparseWeights.forEach((weights, nodeIndex) => {
+    const input = nodes[nodeIndex].inputs.findIndex(i => values[i].tensor === weights.source);
+    if (input === -1) {
+      throw new Error(`the packed weights of node '${nodes[nodeIndex].name}' are not an input of the node`);
+    }
+    header.sparseWeights.push({
+      node: nodeIndex,
+      input,
+      blockSize: weights.blockSize,
+      sparsity: weights.layer.sparsity,
+      rowPointers: writer.write(Tensor.fromData(weights.rowPointers, [weights.rowPointers.length], 'int32')),
+      blockColumns: writer.write(Tensor.fromData(weights.blockColumns, [weights.blockColumns.length], 'int32')),
+      values: writer.write(Tensor.fromData(weights.values, [weights.values.length], 'float32'))
+    });
+  });
+
+  const headerBytes = Buffer.from(JSON.stringify(header), 'utf8');
+  const weightsOffset = align(PREAMBLE_SIZE + headerBytes.byteLength);
+  const buf = new Uint8Array(weightsOffset + writer.byteLength);
+  for (let i = 0; i < MAGIC.length; i++) {
+    buf[i] = MAGIC.charCodeAt(i);
+  }
+  const view = new DataView(buf.buffer);
+  view.setUint32(MAGIC.length, VERSION, true);
+  view.setUint32(MAGIC.length + 4, headerBytes.byteLength, true);
+  buf.set(headerBytes, PREAMBLE_SIZE);
+  writer.copyTo(buf.subarray(weightsOffset));
+  return buf;
+}
+
+// collects the data of the tensors of the weights, each one at a multiple of WEIGHTS_ALIGNMENT bytes
+class WeightsWriter {
+  write(tensor: Tensor): PrepackedModel.TensorInfo {
+    if (tensor.type === 'string') {
+      return {type: tensor.type, dims: tensor.dims.slice(), strings: (tensor.data as string[]).slice()};
+    }
+    const data = tensor.numberData;
+    const offset = this.byteLength;
+    this.chunks.push([offset, new Uint8Array(data.buffer, data.byteOffset, data.byteLength)]);
+    this.byteLength = align(offset + data.byteLength);
+    return {type: tensor.type, dims: tensor.dims.slice(), offset};
+  }
+
+  copyTo(buf: Uint8Array) {
+    for (const [offset, chunk] of this.chunks) {
+      buf.set(chunk, offset);
+    }
+  }
+
+  byteLength = 0;
+  private chunks: Array<[number, Uint8Array]> = [];
+}
+
+function encodeAttribute(
+    writer: WeightsWriter, name: string, type: Attribute.DataType,
+    value: Attribute.DataTypeMap[Attribute.DataType]): PrepackedModel.AttributeInfo {
+  switch (type) {
+    case 'float':
+      return {name, type, value: encodeFloat(value as number)};
+    case 'floats':
+      return {name, type, value: (value as number[]).map(encodeFloat)};
+    case 'tensor':
+      return {name, type, tensors: [writer.write(value as Tensor)]};
+    case 'tensors':
+      return {name, type, tensors: (value as Tensor[]).map(tensor => writer.write(tensor))};
+    default:
+      return {name, type, value: value as number | string | number[] | string[]};
+  }
+}
+
+function encodeFloat(value: number): PrepackedModel.FloatInfo {
+  return isFinite(value) ? value : value.toString();
+}
+
+function tensorByteLength(info: PrepackedModel.TensorInfo): number {
+  const size = ShapeUtil.size(info.dims);
+  switch (info.type) {
+    case 'bool':
+    case 'int8':
+    case 'uint8':
+      return size;
+    case 'int16':
+    case 'uint16':
+      return size * 2;
+    case 'float64':
+      return size * 8;
+    default:
+      return size * 4;
+  }
+}
+
+function align(offset: number): number {
+  return Math.ceil(offset / WEIGHTS_ALIGNMENT) * WEIGHTS_ALIGNMENT;
+}
@@ -0,0 +1,163 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {Logger} from './instrument';
+import {Tensor} from './tensor';
+
+export declare namespace RequestBatcher {
+  export interface Config {
+    /**
+     * the maximum sum of the batch sizes (the first dimension of the inputs) of the requests merged into one run
+     */
+    maxBatchSize: number;
+    /**
+     * the maximum time in milliseconds the first request of a batch waits for other requests to join it
+     */
+    maxWaitTime: number;
+    /**
+     * declare that the model computes every sample along the first dimension independently of the others, i.e. that no
+     * operator mixes the samples (e.g. a reduction, a reshape or a transpose of the first dimension). it must be true,
+     * as merging the requests would otherwise change their outputs without any error
+     */
+    independentSamples: boolean;
+  }
+}
+
+interface PendingRequest {
+  inputs: Tensor[];
+  batchSize: number;
+  resolve: (outputs: Tensor[]) => void;
+  reject: (reason: unknown) => void;
+}
+
+/**
+ * merge the inputs of concurrent requests along the batch axis (the first dimension), run them at once and split the
+ * outputs back to each request.
+ *
+ * requests are compatible if all their inputs have the same types and the same dimensions except the first one. the
+ * outputs of a merged run must all have the merged batch size as their first dimension, otherwise the requests run
+ * again one by one, as they also do if the merged run fails. only the dimensions are checked: the model must compute
+ * the samples independently of each other, which the configuration declares (see Config.independentSamples).
+ *
+ * a batch is run as soon as it is flushed, while the previous ones may still be running: the given function must
+ * support concurrent calls, or wait for the previous ones (see Session.execute()).
+ */
+export class RequestBatcher {
+  constructor(private execute: (inputs: Tensor[]) => Promise<Tensor[]>, private config: RequestBatcher.Config) {
+    if (!(config.maxBatchSize >= 1) || !(config.maxWaitTime >= 0)) {
+      throw new RangeError(`invalid batching configuration: maxBatchSize ${config.maxBatchSize}, maxWaitTime ${
+          config.maxWaitTime}`);
+    }
+    if (config.independentSamples !== true) {
+      throw new TypeError(
+          'batching requires a model computing the samples of the first dimension independently, ' +
+          'which batching.independentSamples must declare');
+    }
+  }
+
+  run(inputs: Tensor[]): Promise<Tensor[]> {
+    const batchSize = getBatchSize(inputs);
+    if (batchSize === undefined || batchSize >= this.config.maxBatchSize) {
+      return this.execute(inputs);
+    }
+
+    const signature = getSignature(inputs);
+    if (this.pending.length > 0 &&
+        (signature !== this.signature || this.pendingBatchSize + batchSize > this.config.maxBatchSize)) {
+      this.flush();
+    }
+
+    return new Promise<Tensor[]>((resolve, reject) => {
+      this.pending.push({inputs, batchSize, resolve, reject});
+      this.pendingBatchSize += batchSize;
+      this.signature = signature;
+      if (this.pendingBatchSize >= this.config.maxBatchSize) {
+        this.flush();
+      } else if (this.pending.length === 1) {
+        this.timeoutId = setTimeout(() => this.flush(), this.config.maxWaitTime);
+      }
+    });
+  }
+
+  private flush(): void {
+    if (this.timeoutId !== undefined) {
+      // tslint:disable-next-line:no-any
+      clearTimeout(this.timeoutId as any);
+      this.timeoutId = undefined;
+    }
+    const requests = this.pending;
+    this.pending = [];
+    this.pendingBatchSize = 0;
+
+    if (requests.length === 1) {
+      this.execute(requests[0].inputs).then(requests[0].resolve, requests[0].reject);
+    } else if (requests.length > 1) {
+      this.runBatch(requests);
+    }
+  }
+
+  private async runBatch(requests: PendingRequest[]): Promise<void> {
+    const batchSize = requests.reduce((sum, request) => sum + request.batchSize, 0);
+    let outputs: Tensor[]|undefined;
+    try {
+      const inputs = requests[0].inputs.map((_, i) => concat(requests.map(request => request.inputs[i]), batchSize));
+      outputs = await this.execute(inputs);
+      if (!outputs.every(output => output.dims.length > 0 && output.dims[0] === batchSize)) {
+        Logger.warning('RequestBatcher', 'the outputs of a merged run are not batched, running the requests alone');
+        outputs = undefined;
+      }
+    } catch (e) {
+      Logger.warning('RequestBatcher', `a merged run failed, running the requests one by one. ERR: ${e}`);
+    }
+
+    if (!outputs) {
+      for (const request of requests) {
+        await this.execute(request.inputs).then(request.resolve, request.reject);
+      }
+      return;
+    }
+
+    let offset = 0;
+    for (const request of requests) {
+      request.resolve(outputs.map(output => split(output, offset, request.batchSize)));
+      offset += request.batchSize;
+    }
+  }
+
+  private pending: PendingRequest[] = [];
+  private pendingBatchSize = 0;
+  private signature = '';
+  // the type of the return value of setTimeout is different in node.js (type Timeout) and browser (number)
+  private timeoutId: unknown;
+}
+
+// the common first dimension of all the inputs, or undefined if the inputs cannot be merged with other requests
+function getBatchSize(inputs: Tensor[]): number|undefined {
+  if (inputs.length === 0 || inputs.some(input => input.type === 'string' || input.dims.length === 0)) {
+    return undefined;
+  }
+  const batchSize = inputs[0].dims[0];
+  return batchSize > 0 && inputs.every(input => input.dims[0] === batchSize) ? batchSize : undefined;
+}
+
+function getSignature(inputs: Tensor[]): string {
+  return inputs.map(input => `${input.type}[${input.dims.slice(1)}]`).join();
+}
+
+function concat(tensors: Tensor[], batchSize: number): Tensor {
+  const result = new Tensor([batchSize].concat(tensors[0].dims.slice(1)), tensors[0].type);
+  const data = result.numberData;
+  let offset = 0;
+  for (const tensor of tensors) {
+    data.set(tensor.numberData, offset);
+    offset += tensor.size;
+  }
+  return result;
+}
+
+function split(tensor: Tensor, start: number, batchSize: number): Tensor {
+  const dims = [batchSize].concat(tensor.dims.slice(1));
+  const rowSize = tensor.size / tensor.dims[0];
+  return new Tensor(
+      dims, tensor.type, undefined, undefined, tensor.data.slice(start * rowSize, (start + batchSize) * rowSize));
+}
@@ -4,22 +4,29 @@
 import {readFile} from 'fs';
 import {promisify} from 'util';
 
-import {Backend, SessionHandlerType} from './backend';
+import {Backend, ModelExecutor, SessionHandlerType} from './backend';
 import {ExecutionPlan} from './execution-plan';
 import {Graph} from './graph';
 import {Profiler} from './instrument';
 import {Model} from './model';
 import {Operator} from './operators';
+import {RequestBatcher} from './request-batcher';
 import {Tensor} from './tensor';
 
 export declare namespace Session {
   export interface Config {
     backendHint?: string;
+    // the backend of the session, instead of the one resolved from the hint (e.g. the backend of a worker)
+    backend?: Backend;
     profiler?: Profiler.Config;
+    batching?: RequestBatcher.Config;
+    streaming?: boolean;
   }
 
   export interface Context {
     profiler: Readonly<Profiler>;
+    // whether the recurrent operators keep their state between runs, the option of the backend if undefined
+    streaming?: boolean;
     graphInputTypes?: Tensor.DataType[];
     graphInputDims?: Array<ReadonlyArray<number>>;
   }
@@ -29,8 +36,12 @@ export class Session {
   constructor(config: Session.Config = {}) {
     this._initialized = false;
     this.backendHint = config.backendHint;
+    this.backend = config.backend;
     this.profiler = Profiler.create(config.profiler);
-    this.context = {profiler: this.profiler, graphInputTypes: [], graphInputDims: []};
+    this.context = {profiler: this.profiler, graphInputTypes: [], graphInputDims: [], streaming: config.streaming};
+    if (config.batching) {
+      this.batcher = new RequestBatcher(inputs => this.execute(inputs), config.batching);
+    }
   }
 
   startProfiling() {
@@ -47,7 +58,7 @@ export class Session {
   async loadModel(arg: string|ArrayBuffer|Uint8Array, byteOffset?: number, length?: number): Promise<void> {
     await this.profiler.event('session', 'Session.loadModel', async () => {
       // resolve backend and session handler
-      const backend = await Backend(this.backendHint);
+      const backend = this.backend || await Backend(this.backendHint);
       this.sessionHandler = backend.createSessionHandler(this.context);
 
       this._model = new Model();
@@ -89,30 +100,85 @@ export class Session {
       if (this.sessionHandler.onGraphInitialized) {
         this.sessionHandler.onGraphInitialized(this._model.graph);
       }
+      // a prepacked model was prepared for a backend that can load it
+      const prepacked = this._model.prepacked;
+      if (prepacked) {
+        if (!this.sessionHandler.loadPrepackedModel) {
+          throw new Error('prepacked models are only supported by the wasm backend');
+        }
+        this.sessionHandler.loadPrepackedModel(prepacked, this._model.graph);
+      }
       // initialize each operator in the graph
       this.initializeOps(this._model.graph);
 
-      // instantiate an ExecutionPlan object to be used by the Session object
-      this._executionPlan = new ExecutionPlan(this._model.graph, this._ops, this.profiler);
+      // instantiate an ExecutionPlan object to be used by the Session object. the nodes of a prepacked model are
+      // already scheduled
+      this._executionPlan = new ExecutionPlan(
+          this._model.graph, this._ops, this.profiler, prepacked ? prepacked.header.schedule : undefined);
+
+      // let the session handler run whole inference requests if it supports it
+      if (this.sessionHandler.createModelExecutor && !isOrtFormat) {
+        this._modelExecutor = this.sessionHandler.createModelExecutor(modelProtoBlob);
+      }
     });
 
     this._initialized = true;
   }
 
-  run(inputs: Map<string, Tensor>|Tensor[]): Promise<Map<string, Tensor>> {
+  /**
+   * run the model
+   * @param outputNames the names of the requested outputs, all the outputs of the model by default. only the nodes
+   * they depend on run, unless the run is batched or run by the model executor of the backend
+   */
+  run(inputs: Map<string, Tensor>|Tensor[], outputNames?: ReadonlyArray<string>): Promise<Map<string, Tensor>> {
     if (!this._initialized) {
       throw new Error('session not initialized yet');
     }
 
     return this.profiler.event('session', 'Session.run', async () => {
       const inputTensors = this.normalizeAndValidateInputs(inputs);
+      const outputs = this.normalizeOutputNames(outputNames);
 
-      const outputTensors = await this._executionPlan.execute(this.sessionHandler, inputTensors);
+      let outputTensors: Tensor[];
+      if (!this.batcher && !this._modelExecutor) {
+        const outputIndices = this._model.graph.getOutputIndices();
+        outputTensors = await this._executionPlan.execute(
+            this.sessionHandler, inputTensors, outputs.map(output => outputIndices[output]));
+      } else {
+        const allOutputTensors = this.batcher ? await this.batcher.run(inputTensors) : await this.execute(inputTensors);
+        outputTensors = outputs.map(output => allOutputTensors[output]);
+      }
 
-      return this.createOutput(outputTensors);
+      return this.createOutput(outputTensors, outputs);
     });
   }
 
+  /**
+   * start the next run of the recurrent operators from their initial state, in streaming mode
+   */
+  resetState(): void {
+    if (this._initialized && this.sessionHandler.resetState) {
+      this.sessionHandler.resetState();
+    }
+  }
+
+  dispose(): void {
+    if (this._initialized) {
+      this._initialized = false;
+      this.sessionHandler.dispose();
+    }
+  }
+
+  private execute(inputTensors: Tensor[]): Promise<Tensor[]> {
+    if (this._modelExecutor) {
+      return this._modelExecutor.execute(inputTensors);
+    }
+    // the execution plan holds the values of a single run, so a run of the batcher starts once the previous one is done
+    const run = this.lastRun.then(() => this._executionPlan.execute(this.sessionHandler, inputTensors));
+    this.lastRun = run.then(() => {}, () => {});
+    return run;
+  }
+
   private normalizeAndValidateInputs(inputs: Map<string, Tensor>|Tensor[]): Tensor[] {
     const modelInputNames = this._model.graph.getInputNames();
 
@@ -176,6 +242,24 @@ export class Session {
     return inputs;
   }
 
+  // the positions of the requested outputs among the outputs of the model, all of them when none is requested
+  private normalizeOutputNames(outputNames?: ReadonlyArray<string>): number[] {
+    const modelOutputNames = this._model.graph.getOutputNames();
+    if (!outputNames || outputNames.length === 0) {
+      return modelOutputNames.map((name, i) => i);
+    }
+    return outputNames.map((name, i) => {
+      const output = modelOutputNames.indexOf(name);
+      if (output === -1) {
+        throw new Error(`'${name}' is not an output of the model`);
+      }
+      if (outputNames.indexOf(name) !== i) {
+        throw new Error(`output '${name}' is requested more than once`);
+      }
+      return output;
+    });
+  }
+
   private validateInputTensorTypes(graphInputTypes: Tensor.DataType[], givenInputs: Tensor[]) {
     for (let i = 0; i < givenInputs.length; i++) {
       const expectedType = graphInputTypes[i];
@@ -214,15 +298,15 @@ export class Session {
     return true;
   }
 
-  private createOutput(outputTensors: Tensor[]): Map<string, Tensor> {
+  private createOutput(outputTensors: Tensor[], outputs: number[]): Map<string, Tensor> {
     const modelOutputNames = this._model.graph.getOutputNames();
-    if (outputTensors.length !== modelOutputNames.length) {
+    if (outputTensors.length !== outputs.length) {
       throw new Error(`expected number of outputs do not match number of generated outputs`);
     }
 
     const output = new Map<string, Tensor>();
-    for (let i = 0; i < modelOutputNames.length; ++i) {
-      output.set(modelOutputNames[i], outputTensors[i]);
+    for (let i = 0; i < outputs.length; ++i) {
+      output.set(modelOutputNames[outputs[i]], outputTensors[i]);
     }
 
     return output;
@@ -242,8 +326,12 @@ export class Session {
 
   private _ops: Operator[];
   private _executionPlan: ExecutionPlan;
+  private _modelExecutor?: ModelExecutor;
+  private batcher?: RequestBatcher;
+  private lastRun: Promise<void> = Promise.resolve();
 
   private backendHint?: string;
+  private backend?: Backend;
 
   private sessionHandler: SessionHandlerType;
   private context: Session.Context;
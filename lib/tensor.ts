@@ -216,6 +216,15 @@ export class Tensor {
     const type = ProtoUtil.tensorDataTypeFromProto(tensorProto.dataType!);
     const dims = ProtoUtil.tensorDimsFromProto(tensorProto.dims!);
 
+    if (type !== 'string' && tensorProto.rawData && tensorProto.rawData.byteLength > 0) {
+      const data = sizeofProto(tensorProto.dataType!) === sizeof(type) ?
+          rawDataToTypedArray(tensorProto.rawData, type, ShapeUtil.size(dims)) :
+          undefined;
+      if (data) {
+        return new Tensor(dims, type, undefined, undefined, data);
+      }
+    }
+
     const value = new Tensor(dims, type);
 
     if (type === 'string') {
@@ -312,6 +321,21 @@ export class Tensor {
     return new Tensor(dims, type, undefined, undefined, data);
   }
 
+  /**
+   * Construct new Tensor from the bytes of its elements in little endian. The bytes are used in place if they are
+   * aligned to the size of the elements
+   * @param rawData the bytes of the elements
+   * @param dims the dimensions of the tensor
+   * @param type the type of the tensor. It cannot be 'string'
+   */
+  static fromRawData(rawData: Uint8Array, dims: ReadonlyArray<number>, type: Tensor.DataType) {
+    const data = rawDataToTypedArray(rawData, type, ShapeUtil.size(dims));
+    if (!data) {
+      throw new Error('cannot read the raw data of a tensor on a big endian platform');
+    }
+    return new Tensor(dims, type, undefined, undefined, data);
+  }
+
   static fromOrtTensor(ortTensor: ortFbs.Tensor) {
     if (!ortTensor) {
       throw new Error('cannot construct Value from an empty tensor');
@@ -319,6 +343,15 @@ export class Tensor {
     const dims = ProtoUtil.tensorDimsFromORTFormat(ortTensor);
     const type = ProtoUtil.tensorDataTypeFromProto(ortTensor.dataType());
 
+    if (type !== 'string' && ortTensor.rawDataLength() > 0) {
+      const data = sizeofProto(ortTensor.dataType()) === sizeof(type) ?
+          rawDataToTypedArray(ortTensor.rawDataArray()!, type, ShapeUtil.size(dims)) :
+          undefined;
+      if (data) {
+        return new Tensor(dims, type, undefined, undefined, data);
+      }
+    }
+
     const value = new Tensor(dims, type);
 
     if (type === 'string') {
@@ -396,6 +429,35 @@ function sizeofProto(type: onnx.TensorProto.DataType|ortFbs.TensorDataType): num
   }
 }
 
+// whether the typed arrays store their elements in little endian, the byte order of the raw data of the tensors
+const IS_LITTLE_ENDIAN = new Uint8Array(new Uint16Array([1]).buffer)[0] === 1;
+
+/**
+ * get the elements of a tensor from their raw data in little endian without decoding them one at a time. the typed
+ * array is a view on the raw data when it is aligned, or a single copy otherwise.
+ * returns undefined when the elements have to be decoded (on a big endian platform)
+ */
+function rawDataToTypedArray(rawData: Uint8Array, type: Tensor.DataType, size: number): Tensor.NumberType|undefined {
+  const elementSize = sizeof(type);
+  if (!IS_LITTLE_ENDIAN) {
+    return undefined;
+  }
+  if (rawData.byteLength % elementSize !== 0) {
+    throw new Error(`invalid buffer length`);
+  }
+  if (rawData.byteLength / elementSize !== size) {
+    throw new Error(`buffer length mismatch`);
+  }
+
+  const constructor = dataviewConstructor(type);
+  if (rawData.byteOffset % elementSize === 0) {
+    return new constructor(rawData.buffer, rawData.byteOffset, size);
+  }
+  const data = new constructor(size);
+  new Uint8Array(data.buffer).set(rawData);
+  return data;
+}
+
 function createView(dataBuffer: ArrayBuffer, type: Tensor.DataType) {
   return new (dataviewConstructor(type))(dataBuffer);
 }
@@ -1152,6 +1152,60 @@ export class PoolConvUtil {
     return outputDims;
   }
 
+  /**
+   * Calculate the output shape for ConvTranspose op based on input attributes, and adjust the pads when they are
+   * implied by 'outputShape' or 'autoPad'. (Should be used only for ConvTranspose op)
+   * @param inputDims The input tensor dimension. (inputs[0].dims)
+   * @param filterDims The filter tensor dimension. (inputs[1].dims)
+   * @param group The number of groups of input and output channels.
+   * @param strides Stride along each axis.
+   * @param dilations Dilation along each axis.
+   * @param kernelShape The size of the kernel along each axis.
+   * @param pads Padding for the beginning and ending along each axis.
+   * @param outputPadding Additional elements added to the end of each axis of the output.
+   * @param outputShape The explicit shape of the output (with or without its first 2 dims), or an empty array.
+   * @param autoPad Specifies how to implicitly calculate pads in each dimension. Can take values NOTSET, SAME_UPPER,
+   *     SAME_LOWER, or VALID.
+   */
+  static computeConvTransposeOutputShape(
+      inputDims: ReadonlyArray<number>, filterDims: ReadonlyArray<number>, group: number, strides: number[],
+      dilations: number[], kernelShape: number[], pads: number[], outputPadding: number[], outputShape: number[],
+      autoPad?: string): number[] {
+    if (inputDims.length <= 0 || filterDims.length <= 0) {
+      throw new Error(`invalid input tensor dims or invalid filter tensor dims`);
+    }
+
+    // Add batch size and number of channels of output
+    const outputDims = [inputDims[0], filterDims[1] * group];
+
+    const spatialRank = inputDims.length - 2;
+    for (let dim = 0; dim < spatialRank; dim++) {
+      const head = dim;
+      const tail = dim + spatialRank;
+      const inSize = inputDims[dim + 2];
+      const fullSize = strides[dim] * (inSize - 1) + outputPadding[dim] + dilations[dim] * (kernelShape[dim] - 1) + 1;
+      const sameAutoPad = autoPad === 'SAME_UPPER' || autoPad === 'SAME_LOWER';
+      if (outputShape.length > 0 || sameAutoPad) {
+        const outSize = outputShape.length > 0 ? outputShape[outputShape.length - spatialRank + dim] :
+                                                 inSize * strides[dim];
+        // an output larger than the full size is padded at its end (as output_padding does). the pads are split as in
+        // the text of the ONNX specification of ConvTranspose (SAME_UPPER puts the smaller half at the beginning), which
+        // is the opposite of the split of onnxruntime
+        const padNeeded = Math.max(0, fullSize - outSize);
+        pads[head] = autoPad === 'SAME_UPPER' ? Math.floor(padNeeded / 2) : padNeeded - Math.floor(padNeeded / 2);
+        pads[tail] = padNeeded - pads[head];
+        outputDims.push(outSize);
+      } else {
+        if (autoPad === 'VALID') {
+          pads[head] = 0;
+          pads[tail] = 0;
+        }
+        outputDims.push(fullSize - pads[head] - pads[tail]);
+      }
+    }
+    return outputDims;
+  }
+
   // will compute output shapes for data dimensions ONLY (i.e.) no batch size and channels
   // called by computePoolOutputShape() and computeConvOutputShape()
   // adjust pads based on 'autoPad' attribute prior to shape computation
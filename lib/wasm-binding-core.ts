@@ -4,6 +4,12 @@
 declare interface OnnxWasmBindingJs {
   (self: OnnxWasmBindingJs): Promise<void>;
 
+  // hooks of the Emscripten glue to locate the .wasm file and to instantiate it
+  locateFile?: (path: string, prefix: string) => string;
+  instantiateWasm?:
+      (imports: WebAssembly.Imports,
+       receiveInstance: (instance: WebAssembly.Instance, module: WebAssembly.Module) => void) => {};
+
   _malloc: (ptr: number) => number;
   _free: (ptr: number) => void;
 
@@ -48,17 +54,81 @@ export interface PerformanceData {
   endTimeFunc?: number;
 }
 
+// the layout of a shared argument buffer used by ccall() on a worker: a header holding the state of the call and the
+// performance data of the worker, followed by the arguments serialized as in the Wasm heap
+export const SHARED_BUFFER_HEADER_SIZE = 64;
+// index of the state of the call in the header, as an Int32Array
+export const SHARED_STATE_INDEX = 0;
+export const SHARED_STATE_PENDING = 1;
+export const SHARED_STATE_DONE = 2;
+export const SHARED_STATE_ERROR = 3;
+// index of the performance data in the header, as a Float64Array: startTime, endTime, startTimeFunc and endTimeFunc
+export const SHARED_PERF_INDEX = 1;
+// index of the length of the error message of a failed call in the header, as an Int32Array. the message replaces the
+// arguments, as UTF-16 code units
+export const SHARED_ERROR_LENGTH_INDEX = 10;
+
+/**
+ * write the message of the error of a call into its shared argument buffer, truncated to the size of the arguments
+ */
+export function writeSharedError(buffer: SharedArrayBuffer, size: number, message: string): void {
+  const length = Math.min(message.length, Math.floor(size / 2));
+  const chars = new Uint16Array(buffer, SHARED_BUFFER_HEADER_SIZE, length);
+  for (let i = 0; i < length; i++) {
+    chars[i] = message.charCodeAt(i);
+  }
+  new Int32Array(buffer, 0, SHARED_ERROR_LENGTH_INDEX + 1)[SHARED_ERROR_LENGTH_INDEX] = length;
+}
+
+/**
+ * read the message of the error of a call written by writeSharedError()
+ */
+export function readSharedError(buffer: SharedArrayBuffer): string {
+  const length = new Int32Array(buffer, 0, SHARED_ERROR_LENGTH_INDEX + 1)[SHARED_ERROR_LENGTH_INDEX];
+  const chars = new Uint16Array(buffer, SHARED_BUFFER_HEADER_SIZE, length);
+  let message = '';
+  for (let i = 0; i < length; i++) {
+    message += String.fromCharCode(chars[i]);
+  }
+  return message;
+}
+
+/**
+ * the calls of the kernels of a session to the binding: in the calling thread, or on one of the workers of the thread
+ */
+export interface WasmSessionBinding {
+  ccall(functionName: string, ...params: WasmCallArgument[]): PerformanceData;
+  ccallRemote(workerId: number, functionName: string, ...params: WasmCallArgument[]): Promise<PerformanceData>;
+  dispose(): void;
+}
+
+// the number of workers the calls of this thread can be split among. it is set when the workers are spawned, and stays
+// 0 in a worker, which has no workers of its own
+let workerNumber = 0;
+
+export function getWorkerNumber(): number {
+  return workerNumber;
+}
+
+export function setWorkerNumber(numWorkers: number): void {
+  workerNumber = numWorkers;
+}
+
 // some global parameters to deal with wasm binding initialization
 let binding: OnnxWasmBindingJs|undefined;
 let initialized = false;
 let initializing = false;
 
+// the compiled module of the binding, which the workers instantiate instead of fetching and compiling it again
+let compiledModule: WebAssembly.Module|undefined;
+
 /**
  * initialize the WASM instance.
  *
  * this function should be called before any other calls to the WASM binding.
+ * @param module the module compiled by another thread, if any
  */
-export function init(): Promise<void> {
+export function init(module?: WebAssembly.Module): Promise<void> {
   if (initialized) {
     return Promise.resolve();
   }
@@ -71,6 +141,10 @@ export function init(): Promise<void> {
   return new Promise<void>((resolve, reject) => {
     // tslint:disable-next-line:no-require-imports
     binding = require('../dist/onnx-wasm') as OnnxWasmBindingJs;
+    setInstantiationHooks(binding, module, err => {
+      initializing = false;
+      reject(err);
+    });
     binding(binding).then(
         () => {
           // resolve init() promise
@@ -85,6 +159,48 @@ export function init(): Promise<void> {
   });
 }
 
+/**
+ * get the compiled module of the binding, once it is initialized. it is undefined if the glue of the binding compiled
+ * the module itself
+ */
+export function getCompiledModule(): WebAssembly.Module|undefined {
+  return compiledModule;
+}
+
+// compile the module while it downloads, or instantiate the module compiled by another thread, and keep the module for
+// the workers. browsers cache the code compiled from a streamed response, so the later page loads skip most of the
+// compilation. without WebAssembly.compileStreaming() (e.g. in Node.js), the glue of the binding loads the module
+function setInstantiationHooks(
+    self: OnnxWasmBindingJs, module: WebAssembly.Module|undefined, onError: (err: unknown) => void) {
+  if (!module && !isStreamingCompilationSupported()) {
+    return;
+  }
+
+  // the glue resolves the URL of the .wasm file before instantiating it
+  let url = '';
+  self.locateFile = (path, prefix) => {
+    if (/\.wasm$/.test(path)) {
+      url = prefix + path;
+    }
+    return prefix + path;
+  };
+  self.instantiateWasm = (imports, receiveInstance) => {
+    const compiled = module ? Promise.resolve(module) :
+                              WebAssembly.compileStreaming(fetch(url, {credentials: 'same-origin'}));
+    compiled.then(m => WebAssembly.instantiate(m, imports).then(instance => {
+      compiledModule = m;
+      receiveInstance(instance, m);
+    })).catch(onError);
+    // the exports are filled in by receiveInstance()
+    return {};
+  };
+}
+
+function isStreamingCompilationSupported(): boolean {
+  return typeof WebAssembly !== 'undefined' && typeof WebAssembly.compileStreaming === 'function' &&
+      typeof fetch === 'function';
+}
+
 // class that deals with Wasm data interop and method calling
 export class WasmBinding {
   protected ptr8: number;
@@ -149,6 +265,77 @@ export class WasmBinding {
     return {startTime, endTime, startTimeFunc, endTimeFunc};
   }
 
+  // ccall method reading its arguments from a shared argument buffer, used by ccallRemote() in the web-worker when
+  // SharedArrayBuffer is available. only the byte ranges [copyIn[2i], copyIn[2i+1]) of the arguments are copied to the
+  // Wasm heap (the inputs), and only the ranges of copyOut are copied back (the outputs)
+  ccallShared(functionName: string, buffer: SharedArrayBuffer, size: number, copyIn: number[], copyOut: number[]):
+      PerformanceData {
+    if (!initialized) {
+      throw new Error(`wasm not initialized. please ensure 'init()' is called.`);
+    }
+    const startTime = now();
+
+    if (size > this.numBytesAllocated) {
+      this.expandMemory(size);
+    }
+    const data = new Uint8Array(buffer, SHARED_BUFFER_HEADER_SIZE, size);
+    let heap = binding!.HEAPU8.subarray(this.ptr8, this.ptr8 + size);
+    for (let i = 0; i < copyIn.length; i += 2) {
+      heap.set(data.subarray(copyIn[i], copyIn[i + 1]), copyIn[i]);
+    }
+
+    const startTimeFunc = now();
+    this.func(functionName, this.ptr8);
+    const endTimeFunc = now();
+
+    // the kernel may have grown the memory, detaching the previous view of the heap
+    heap = binding!.HEAPU8.subarray(this.ptr8, this.ptr8 + size);
+    for (let i = 0; i < copyOut.length; i += 2) {
+      data.set(heap.subarray(copyOut[i], copyOut[i + 1]), copyOut[i]);
+    }
+    const endTime = now();
+
+    return {startTime, endTime, startTimeFunc, endTimeFunc};
+  }
+
+  // the byte ranges of the serialized arguments to copy to the Wasm heap and back, for ccallShared(). the outputs are
+  // not copied in, and only the outputs are copied out
+  static calculateCopyRanges(offset: number[], size: number, params: WasmCallArgument[]): [number[], number[]] {
+    const copyIn: number[] = [];
+    const copyOut: number[] = [];
+    const addRange = (ranges: number[], begin: number, end: number) => {
+      if (ranges.length > 0 && ranges[ranges.length - 1] === begin) {
+        ranges[ranges.length - 1] = end;
+      } else if (begin < end) {
+        ranges.push(begin, end);
+      }
+    };
+
+    // the number of arguments and their offsets
+    addRange(copyIn, 0, 4 + 4 * params.length);
+    for (let i = 0; i < params.length; i++) {
+      if (offset[i] === 0) {
+        // nullptr
+        continue;
+      }
+      let end = size;
+      for (let j = i + 1; j < params.length; j++) {
+        if (offset[j] !== 0) {
+          end = offset[j];
+          break;
+        }
+      }
+      const paramPass = params[i][2];
+      if (paramPass !== 'out') {
+        addRange(copyIn, offset[i], end);
+      }
+      if (paramPass === 'out' || paramPass === 'inout') {
+        addRange(copyOut, offset[i], end);
+      }
+    }
+    return [copyIn, copyOut];
+  }
+
   protected func(functionName: string, ptr8: number): void {
     // tslint:disable-next-line:no-any
     const func = (binding as any)[functionName] as (data: number) => void;
@@ -323,6 +510,8 @@ export class WasmBinding {
     }
     if (this.ptr8 !== 0) {
       binding!._free(this.ptr8);
+      this.ptr8 = 0;
+      this.numBytesAllocated = 0;
     }
   }
 }
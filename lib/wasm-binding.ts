@@ -1,9 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT license.
 
-import {Logger} from './instrument';
+import {Logger, Profiler} from './instrument';
 import * as bindingCore from './wasm-binding-core';
 import {WasmCallArgument} from './wasm-binding-core';
+import {WorkerSessionRequest, WorkerSessionResponse} from './worker/session-messages';
 
 export {WasmCallArgument} from './wasm-binding-core';
 
@@ -13,12 +14,29 @@ interface PerformanceData extends bindingCore.PerformanceData {
 }
 
 let workers: Worker[];
-let WORKER_NUMBER: number;
 
 // complete callback after
 type CompleteCallbackType = (buffer: ArrayBuffer, perfData: PerformanceData) => void;
 let completeCallbacks: CompleteCallbackType[][];
 
+// the differences between the time origins of the clocks of the workers and of the calling thread, to show the times
+// of the calls on the workers on the clock of the calling thread when profiling
+let workerClockOffsets: Array<number|undefined>;
+
+// callbacks of the session requests, by request ID
+type SessionCallbackType = (response: WorkerSessionResponse) => void;
+let sessionCallbacks: Map<number, SessionCallbackType>;
+let nextSessionRequestId = 0;
+
+// the shared transport passes the arguments of ccallRemote() in pooled SharedArrayBuffers instead of transferring a
+// new ArrayBuffer for every call. the completion of a call is awaited with Atomics.waitAsync() when it is available,
+// otherwise the worker posts a message without payload
+let sharedTransport: boolean;
+let sharedBufferPool: SharedArrayBuffer[];
+type SharedCallbackType = () => void;
+let sharedCallbacks: Map<number, SharedCallbackType>;
+let nextSharedCallId = 0;
+
 let initialized = false;
 let initializing = false;
 
@@ -78,29 +96,40 @@ export function init(numWorkers: number, initTimeout: number): Promise<void> {
       if (areWebWorkersSupported()) {
         Logger.verbose(
             'WebAssembly-Workers', `Environment supports usage of Workers. Will spawn ${numWorkers} Workers`);
-        WORKER_NUMBER = numWorkers;
+        bindingCore.setWorkerNumber(numWorkers);
       } else {
         Logger.error('WebAssembly-Workers', 'Environment does not support usage of Workers. Will not spawn workers.');
-        WORKER_NUMBER = 0;
+        bindingCore.setWorkerNumber(0);
       }
     }
 
     // user explicitly disables workers
     else {
       Logger.verbose('WebAssembly-Workers', 'User has disabled usage of Workers. Will not spawn workers.');
-      WORKER_NUMBER = 0;
+      bindingCore.setWorkerNumber(0);
     }
 
-    const workerInitTasks = new Array<Promise<void>>(WORKER_NUMBER);
-    workers = new Array(WORKER_NUMBER);
-    completeCallbacks = new Array(WORKER_NUMBER);
+    const workerInitTasks = new Array<Promise<void>>(bindingCore.getWorkerNumber());
+    workers = new Array(bindingCore.getWorkerNumber());
+    completeCallbacks = new Array(bindingCore.getWorkerNumber());
+    workerClockOffsets = new Array(bindingCore.getWorkerNumber());
+    sessionCallbacks = new Map();
+    sharedTransport = bindingCore.getWorkerNumber() > 0 && isSharedMemorySupported();
+    sharedBufferPool = [];
+    sharedCallbacks = new Map();
+    if (sharedTransport) {
+      Logger.verbose('WebAssembly-Workers', 'Environment supports SharedArrayBuffer. Will share argument buffers.');
+    }
 
-    for (let workerId = 0; workerId < WORKER_NUMBER; workerId++) {
+    for (let workerId = 0; workerId < bindingCore.getWorkerNumber(); workerId++) {
       const workerInitTask = new Promise<void>((resolveWorkerInit, rejectWorkerInit) => {
         // tslint:disable-next-line
         const worker = require('worker-loader?filename=onnx-worker.js!./worker/worker-main').default() as Worker;
         workers[workerId] = worker;
         completeCallbacks[workerId] = [];
+        // the worker instantiates the module compiled by the main thread, once it is compiled
+        const postInit = () => postInitMessage(worker);
+        bindingInitTask.then(postInit, postInit);
         worker.onerror = e => {
           Logger.error('WebAssembly-Workers', `worker-${workerId} ERR: ${e}`);
           if (initialized) {
@@ -112,10 +141,23 @@ export function init(numWorkers: number, initTimeout: number): Promise<void> {
         worker.onmessage = e => {
           if (e && e.data && e.data.type) {
             if (e.data.type === 'init-success') {
+              if (e.data.timeOrigin !== undefined && typeof performance !== 'undefined' &&
+                  performance.timeOrigin !== undefined) {
+                workerClockOffsets[workerId] = (e.data.timeOrigin as number) - performance.timeOrigin;
+              }
               resolveWorkerInit();
             } else if (e.data.type === 'ccall') {
               const perfData = e.data.perfData as PerformanceData;
               completeCallbacks[workerId].shift()!(e.data.buffer as ArrayBuffer, perfData);
+            } else if (e.data.type === 'ccall-shared') {
+              const callback = sharedCallbacks.get(e.data.id as number)!;
+              sharedCallbacks.delete(e.data.id as number);
+              callback();
+            } else if (e.data.type === 'session') {
+              const response = e.data as WorkerSessionResponse;
+              const callback = sessionCallbacks.get(response.id)!;
+              sessionCallbacks.delete(response.id);
+              callback(response);
             } else {
               throw new Error(`unknown message type from worker: ${e.data.type}`);
             }
@@ -146,7 +188,7 @@ export function init(numWorkers: number, initTimeout: number): Promise<void> {
                             `Unable to get all requested workers initialized. Will use Wasm backend with 0 workers. ERR: ${
                                 e}`);
                         // TODO: need house-keeping logic to cull exisitng successfully initialized workers
-                        WORKER_NUMBER = 0;
+                        bindingCore.setWorkerNumber(0);
                         onFulfilled();
                       });
             },
@@ -164,38 +206,222 @@ export class WasmBinding extends bindingCore.WasmBinding {
     }
     return WasmBinding.instance;
   }
+  /**
+   * create a binding with an argument buffer of its own in the wasm heap (e.g. the arena of a session), which is freed
+   * when the binding is disposed. the callers without a binding of their own share the one of getInstance()
+   */
+  static create(): WasmBinding {
+    return new WasmBinding();
+  }
   static get workerNumber() {
-    return WORKER_NUMBER;
+    return bindingCore.getWorkerNumber();
+  }
+  ccall(functionName: string, ...params: WasmCallArgument[]): PerformanceData {
+    const perf = super.ccall(functionName, ...params);
+    if (Profiler.recordingWasmCalls) {
+      const offset: number[] = [];
+      const size = WasmBinding.calculateOffsets(offset, params);
+      recordCall(functionName, -1, WasmBinding.calculateCopyRanges(offset, size, params), [
+        {name: 'serialize', startTime: perf.startTime!, endTime: perf.startTimeFunc!},
+        {name: 'compute', startTime: perf.startTimeFunc!, endTime: perf.endTimeFunc!},
+        {name: 'deserialize', startTime: perf.endTimeFunc!, endTime: perf.endTime!}
+      ]);
+    }
+    return perf;
   }
   ccallRemote(workerId: number, functionName: string, ...params: WasmCallArgument[]): Promise<PerformanceData> {
     if (!initialized) {
       throw new Error(`wasm not initialized. please ensure 'init()' is called.`);
     }
 
-    if (workerId < 0 || workerId >= WORKER_NUMBER) {
-      throw new Error(`invalid worker ID ${workerId}. should be in range [0, ${WORKER_NUMBER})`);
+    if (workerId < 0 || workerId >= bindingCore.getWorkerNumber()) {
+      throw new Error(`invalid worker ID ${workerId}. should be in range [0, ${bindingCore.getWorkerNumber()})`);
     }
 
+    if (sharedTransport) {
+      return this.ccallRemoteShared(workerId, functionName, params);
+    }
+
+    const startTime = bindingCore.now();
     const offset: number[] = [];
     const size = WasmBinding.calculateOffsets(offset, params);
     const buffer = new ArrayBuffer(size);
     WasmBinding.ccallSerialize(new Uint8Array(buffer), offset, params);
 
-    const startTime = bindingCore.now();
+    const postTime = bindingCore.now();
     workers[workerId].postMessage({type: 'ccall', func: functionName, buffer}, [buffer]);
 
     return new Promise<PerformanceData>((resolve, reject) => {
       completeCallbacks[workerId].push((buffer, perf) => {
+        const receiveTime = bindingCore.now();
         perf.startTimeWorker = perf.startTime;
         perf.endTimeWorker = perf.endTime;
         perf.startTime = startTime;
-        perf.endTime = bindingCore.now();
 
         WasmBinding.ccallDeserialize(new Uint8Array(buffer), offset, params);
+        perf.endTime = bindingCore.now();
+        if (Profiler.recordingWasmCalls) {
+          recordCall(
+              functionName, workerId, WasmBinding.calculateCopyRanges(offset, size, params),
+              remoteCallPhases(workerId, perf, postTime, receiveTime));
+        }
         resolve(perf);
       });
     });
   }
+
+  // ccallRemote() through a pooled shared argument buffer: the arguments are serialized once into the buffer, the
+  // worker copies only the inputs to its heap and only the outputs back, and nothing is transferred
+  private async ccallRemoteShared(workerId: number, functionName: string, params: WasmCallArgument[]):
+      Promise<PerformanceData> {
+    const startTime = bindingCore.now();
+    const offset: number[] = [];
+    const size = WasmBinding.calculateOffsets(offset, params);
+    const [copyIn, copyOut] = WasmBinding.calculateCopyRanges(offset, size, params);
+    const buffer = acquireSharedBuffer(bindingCore.SHARED_BUFFER_HEADER_SIZE + size);
+    const data = new Uint8Array(buffer, bindingCore.SHARED_BUFFER_HEADER_SIZE, size);
+    WasmBinding.ccallSerialize(data, offset, params);
+    const state = new Int32Array(buffer, 0, 1);
+    Atomics.store(state, bindingCore.SHARED_STATE_INDEX, bindingCore.SHARED_STATE_PENDING);
+
+    const id = nextSharedCallId++;
+    const waitAsync = getWaitAsync();
+    const postTime = bindingCore.now();
+    workers[workerId].postMessage(
+        {type: 'ccall-shared', id, func: functionName, buffer, size, copyIn, copyOut, notify: !waitAsync});
+    if (waitAsync) {
+      await waitAsync(state, bindingCore.SHARED_STATE_INDEX, bindingCore.SHARED_STATE_PENDING).value;
+    } else {
+      await new Promise<void>(resolve => sharedCallbacks.set(id, resolve));
+    }
+
+    const receiveTime = bindingCore.now();
+    if (Atomics.load(state, bindingCore.SHARED_STATE_INDEX) === bindingCore.SHARED_STATE_ERROR) {
+      const message = bindingCore.readSharedError(buffer);
+      releaseSharedBuffer(buffer);
+      throw new Error(`${functionName} failed on worker ${workerId}: ${message}`);
+    }
+    const [startTimeWorker, endTimeWorker, startTimeFunc, endTimeFunc] =
+        new Float64Array(buffer, 8 * bindingCore.SHARED_PERF_INDEX, 4);
+    WasmBinding.ccallDeserialize(data, offset, params);
+    releaseSharedBuffer(buffer);
+    const perf = {startTime, endTime: bindingCore.now(), startTimeFunc, endTimeFunc, startTimeWorker, endTimeWorker};
+    if (Profiler.recordingWasmCalls) {
+      recordCall(functionName, workerId, [copyIn, copyOut], remoteCallPhases(workerId, perf, postTime, receiveTime));
+    }
+    return perf;
+  }
+
+  /**
+   * send a request to create, run or release a session held by a worker. workers holding a whole session serve
+   * complete inference requests, as opposed to the single operator calls of ccallRemote()
+   */
+  sessionRemote(workerId: number, request: WorkerSessionRequest, transfer: ArrayBuffer[] = []):
+      Promise<WorkerSessionResponse> {
+    if (!initialized) {
+      throw new Error(`wasm not initialized. please ensure 'init()' is called.`);
+    }
+
+    if (workerId < 0 || workerId >= bindingCore.getWorkerNumber()) {
+      throw new Error(`invalid worker ID ${workerId}. should be in range [0, ${bindingCore.getWorkerNumber()})`);
+    }
+
+    const id = nextSessionRequestId++;
+    workers[workerId].postMessage({type: 'session', id, request}, transfer);
+
+    return new Promise<WorkerSessionResponse>((resolve, reject) => {
+      sessionCallbacks.set(id, response => {
+        if (response.error !== undefined) {
+          reject(new Error(`worker-${workerId}: ${response.error}`));
+        } else {
+          resolve(response);
+        }
+      });
+    });
+  }
+}
+
+// record a call in the started profilers, with the sizes of its input and output arguments
+function recordCall(
+    functionName: string, worker: number, [copyIn, copyOut]: [number[], number[]], phases: Profiler.WasmCallPhase[]) {
+  const rangesSize = (ranges: number[]) => {
+    let bytes = 0;
+    for (let i = 0; i < ranges.length; i += 2) {
+      bytes += ranges[i + 1] - ranges[i];
+    }
+    return bytes;
+  };
+  Profiler.recordWasmCall({
+    name: functionName,
+    worker,
+    bytesIn: rangesSize(copyIn),
+    bytesOut: rangesSize(copyOut),
+    startTime: phases[0].startTime,
+    endTime: phases[phases.length - 1].endTime,
+    phases
+  });
+}
+
+const REMOTE_CALL_PHASES: Profiler.WasmCallPhaseName[] =
+    ['serialize', 'transfer', 'copy-in', 'compute', 'copy-out', 'return', 'deserialize'];
+
+// the phases of a call on a worker on the clock of the calling thread. without the time origin of the clock of the
+// worker, the end of the call on the worker is aligned to the time its completion is received
+function remoteCallPhases(workerId: number, perf: PerformanceData, postTime: number, receiveTime: number):
+    Profiler.WasmCallPhase[] {
+  const clockOffset = workerClockOffsets[workerId];
+  const offset = clockOffset !== undefined ? clockOffset : receiveTime - perf.endTimeWorker!;
+  const times = [
+    perf.startTime!, postTime, perf.startTimeWorker! + offset, perf.startTimeFunc! + offset,
+    perf.endTimeFunc! + offset, perf.endTimeWorker! + offset, receiveTime, perf.endTime!
+  ];
+  // the times on the worker are kept between the message and its reply, whatever the precision of the clocks
+  for (let i = 2; i < 6; i++) {
+    times[i] = Math.min(Math.max(times[i], times[i - 1]), receiveTime);
+  }
+  return REMOTE_CALL_PHASES.map((name, i) => ({name, startTime: times[i], endTime: times[i + 1]}));
+}
+
+// send the compiled module to a worker. the module is compiled again by the worker if it cannot be sent
+function postInitMessage(worker: Worker) {
+  const module = bindingCore.getCompiledModule();
+  try {
+    worker.postMessage({type: 'init', module});
+  } catch (e) {
+    Logger.verbose('WebAssembly-Workers', `Unable to share the compiled module with a worker. ERR: ${e}`);
+    worker.postMessage({type: 'init'});
+  }
+}
+
+function isSharedMemorySupported(): boolean {
+  return typeof SharedArrayBuffer !== 'undefined' && typeof Atomics !== 'undefined';
+}
+
+type WaitAsyncType = (typedArray: Int32Array, index: number, value: number) => {value: Promise<string>|string};
+
+// Atomics.waitAsync() is not available in every environment supporting SharedArrayBuffer
+function getWaitAsync(): WaitAsyncType|undefined {
+  return (Atomics as unknown as {waitAsync?: WaitAsyncType}).waitAsync;
+}
+
+// take the smallest pooled shared buffer of at least the given size, or allocate a new one twice as large
+function acquireSharedBuffer(size: number): SharedArrayBuffer {
+  let index = -1;
+  for (let i = 0; i < sharedBufferPool.length; i++) {
+    if (sharedBufferPool[i].byteLength >= size &&
+        (index === -1 || sharedBufferPool[i].byteLength < sharedBufferPool[index].byteLength)) {
+      index = i;
+    }
+  }
+  return index === -1 ? new SharedArrayBuffer(2 * size) : sharedBufferPool.splice(index, 1)[0];
+}
+
+// return a shared buffer to the pool. the pool keeps two buffers per worker at most, dropping the smallest ones
+function releaseSharedBuffer(buffer: SharedArrayBuffer) {
+  sharedBufferPool.push(buffer);
+  if (sharedBufferPool.length > 2 * bindingCore.getWorkerNumber()) {
+    sharedBufferPool.sort((a, b) => b.byteLength - a.byteLength).pop();
+  }
 }
 
 function areWebWorkersSupported(): boolean {
@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {Tensor} from '../tensor';
+
+// the messages exchanged with the workers to run whole inference requests on them (throughput mode)
+
+/**
+ * a tensor as it is passed between the main thread and a worker
+ */
+export interface SerializedTensor {
+  dims: ReadonlyArray<number>;
+  type: Tensor.DataType;
+  data: Tensor.NumberType;
+}
+
+/**
+ * the options of the WebAssembly backend of a session held by a worker
+ */
+export interface WorkerSessionOptions {
+  cpuFallback: boolean;
+  streaming: boolean;
+  // the decisions of the autotuner are made and kept by each worker, apart from the tuning cache of the main thread
+  autotune: boolean;
+  channelBlock: number;
+  sparsity: number;
+  shareWeights: boolean;
+}
+
+/**
+ * a request to create, run or release a session held by a worker
+ */
+export type WorkerSessionRequest = {
+  command: 'create'; sessionId: number; model: Uint8Array; options: WorkerSessionOptions;
+}|{command: 'run'; sessionId: number; inputs: SerializedTensor[]}|{command: 'release'; sessionId: number};
+
+export interface WorkerSessionResponse {
+  id: number;
+  outputs?: SerializedTensor[];
+  error?: string;
+}
+
+/**
+ * serialize a tensor to post it to or from a worker
+ * @param tensor the tensor to serialize
+ * @param copy copy the data even if it has a buffer of its own, so that the buffer can be transferred
+ */
+export function serializeTensor(tensor: Tensor, copy = false): SerializedTensor {
+  if (tensor.type === 'string') {
+    throw new TypeError('string tensors cannot be passed to a worker');
+  }
+  const data = tensor.numberData;
+  // a view on a larger buffer is copied as well, so that only its own elements are cloned
+  return {
+    dims: tensor.dims,
+    type: tensor.type,
+    data: copy || data.byteLength !== data.buffer.byteLength ? data.slice() : data
+  };
+}
+
+export function deserializeTensor(tensor: SerializedTensor): Tensor {
+  return new Tensor(tensor.dims, tensor.type, undefined, undefined, tensor.data);
+}
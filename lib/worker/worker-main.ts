@@ -2,7 +2,9 @@
 // Licensed under the MIT license.
 
 /// <reference lib="webworker" />
-import {init, WasmBinding} from '../wasm-binding-core';
+import {init, SHARED_PERF_INDEX, SHARED_STATE_DONE, SHARED_STATE_ERROR, SHARED_STATE_INDEX, WasmBinding, writeSharedError} from '../wasm-binding-core';
+
+import {handleSessionRequest} from './worker-session';
 
 class WorkerBinding extends WasmBinding {
   static instance: WorkerBinding;
@@ -16,22 +18,48 @@ class WorkerBinding extends WasmBinding {
 
 let instance: WorkerBinding;
 
-init().then(
-    () => {
-      instance = WorkerBinding.getInstance();
-      postMessage({type: 'init-success'});
-    },
-);
-
 onmessage = (e) => {
   if (e && e.data && e.data.type) {
-    if (e.data.type === 'ccall') {
+    if (e.data.type === 'init') {
+      // the main thread passes the module it compiled, if any
+      init(e.data.module as WebAssembly.Module | undefined).then(() => {
+        instance = WorkerBinding.getInstance();
+        // the time origin of the clock of the worker lets the profiler show the calls on the clock of the main thread
+        const timeOrigin = typeof performance !== 'undefined' ? performance.timeOrigin : undefined;
+        postMessage({type: 'init-success', timeOrigin});
+      });
+    } else if (e.data.type === 'ccall') {
       const func: string = e.data.func;
       const buffer: ArrayBuffer = e.data.buffer;
 
       const perfData = instance.ccallRaw(func, new Uint8Array(buffer));
 
       postMessage({type: 'ccall', buffer, perfData}, [buffer]);
+    } else if (e.data.type === 'ccall-shared') {
+      // the arguments live in a shared buffer, the completion is signaled in the header of the buffer
+      const buffer: SharedArrayBuffer = e.data.buffer;
+      const state = new Int32Array(buffer, 0, 1);
+      try {
+        const perfData = instance.ccallShared(e.data.func, buffer, e.data.size, e.data.copyIn, e.data.copyOut);
+        new Float64Array(buffer, 8 * SHARED_PERF_INDEX, 4)
+            .set([perfData.startTime!, perfData.endTime!, perfData.startTimeFunc!, perfData.endTimeFunc!]);
+        Atomics.store(state, SHARED_STATE_INDEX, SHARED_STATE_DONE);
+      } catch (err) {
+        // the main thread waits for the state of the call whatever happens, and raises the error
+        writeSharedError(buffer, e.data.size, `${err}`);
+        Atomics.store(state, SHARED_STATE_INDEX, SHARED_STATE_ERROR);
+      }
+      Atomics.notify(state, SHARED_STATE_INDEX);
+      if (e.data.notify) {
+        postMessage({type: 'ccall-shared', id: e.data.id});
+      }
+    } else if (e.data.type === 'session') {
+      // whole inference requests, for the throughput mode
+      const id: number = e.data.id;
+      handleSessionRequest(e.data.request)
+          .then(
+              ([outputs, transfer]) => postMessage({type: 'session', id, outputs}, transfer),
+              err => postMessage({type: 'session', id, error: `${err}`}));
     } else {
       throw new Error(`unknown message type from main thread: ${e.data.type}`);
     }
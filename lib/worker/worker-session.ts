@@ -0,0 +1,73 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {Backend, SessionHandler} from '../backend';
+import {WasmSessionHandler} from '../backends/wasm/session-handler';
+import {Session} from '../session';
+import {PerformanceData, WasmBinding} from '../wasm-binding-core';
+
+import {deserializeTensor, SerializedTensor, serializeTensor, WorkerSessionOptions, WorkerSessionRequest} from './session-messages';
+
+// the binding of a session held by the worker. the worker has no workers of its own, so the kernels make all their
+// calls in the worker itself
+class WorkerSessionBinding extends WasmBinding {
+  constructor() {
+    super();
+  }
+  ccallRemote(workerId: number): Promise<PerformanceData> {
+    throw new Error(`invalid worker ID ${workerId}. a worker has no workers of its own`);
+  }
+}
+
+// the WebAssembly backend of a session held by the worker, given to the session instead of being registered as the
+// 'wasm' backend. it only depends on the core of the binding, which the worker initializes itself (see worker-main.ts)
+class WorkerBackend implements Backend {
+  constructor(private readonly options: WorkerSessionOptions) {}
+  initialize(): boolean {
+    return true;
+  }
+  createSessionHandler(context: Session.Context): SessionHandler {
+    return new WasmSessionHandler(this, context, this.options, new WorkerSessionBinding());
+  }
+  dispose(): void {}
+}
+
+// the sessions held by this worker, by session ID
+const sessions = new Map<number, Session>();
+
+/**
+ * handle a session request in the worker. returns the outputs of a 'run' request, and the buffers to transfer back
+ */
+export async function handleSessionRequest(request: WorkerSessionRequest):
+    Promise<[SerializedTensor[] | undefined, ArrayBuffer[]]> {
+  switch (request.command) {
+    case 'create':
+      const session = new Session({backend: new WorkerBackend(request.options)});
+      await session.loadModel(request.model);
+      sessions.set(request.sessionId, session);
+      return [undefined, []];
+
+    case 'run':
+      const outputs = await getSession(request.sessionId).run(request.inputs.map(deserializeTensor));
+      const serialized: SerializedTensor[] = [];
+      // outputs may share their data with the session (e.g. initializers), so they are copied before transferring
+      outputs.forEach(output => serialized.push(serializeTensor(output, true)));
+      return [serialized, serialized.map(output => output.data.buffer as ArrayBuffer)];
+
+    case 'release':
+      getSession(request.sessionId).dispose();
+      sessions.delete(request.sessionId);
+      return [undefined, []];
+
+    default:
+      throw new Error(`unknown session request`);
+  }
+}
+
+function getSession(sessionId: number): Session {
+  const session = sessions.get(sessionId);
+  if (!session) {
+    throw new Error(`session ${sessionId} does not exist in this worker`);
+  }
+  return session;
+}
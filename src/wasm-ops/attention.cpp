@@ -0,0 +1,130 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "attention.h"
+#include "common.h"
+#include <algorithm>
+#include <math.h>
+#include <vector>
+
+// Wasm interop method
+void attention_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  attention_f32_imp(
+      PARAM_FLOAT_PTR(data, dataIndex[1]), PARAM_FLOAT_PTR(data, dataIndex[2]),
+      PARAM_FLOAT_PTR(data, dataIndex[3]), PARAM_FLOAT_PTR(data, dataIndex[4]),
+      PARAM_INT32_PTR(data, dataIndex[5]), PARAM_INT32(data, dataIndex[6]),
+      PARAM_INT32(data, dataIndex[7]), PARAM_INT32(data, dataIndex[8]),
+      PARAM_INT32(data, dataIndex[9]), PARAM_INT32(data, dataIndex[10]),
+      PARAM_INT32(data, dataIndex[11]), PARAM_INT32(data, dataIndex[12]),
+      PARAM_FLOAT(data, dataIndex[13]), PARAM_FLOAT_PTR(data, dataIndex[14]));
+}
+
+// Core operator implementation
+// Computes softmax(Q * K_t / divisor + mask) * V for every batch entry, with
+// Q [batch, seq_q, depth], K_t [batch, depth, seq_k], V [batch, seq_k, depth_v]
+// and Y [batch, seq_q, depth_v]. The mask element of query i and key j of
+// batch entry b is mask[mask_offsets[b] + i * mask_row_stride +
+// j * mask_col_stride], so any mask broadcasting to the scores can be used.
+//
+// Queries are processed in blocks against blocks of keys. The softmax is
+// accumulated online: every key block rescales the running sum and output of
+// a query row by exp(previous max - new max), so only a block of scores is
+// ever held in memory instead of the [seq_q, seq_k] score matrix.
+void attention_f32_imp(const float *Q, const float *K_t, const float *V,
+                       const float *mask, const int32_t *mask_offsets,
+                       const int32_t mask_row_stride,
+                       const int32_t mask_col_stride, const int32_t batch,
+                       const int32_t seq_q, const int32_t seq_k,
+                       const int32_t depth, const int32_t depth_v,
+                       const float divisor, float *Y) {
+  const int32_t block_q = 16;
+  const int32_t block_k = 64;
+  std::vector<float> scores(block_q * block_k);
+  std::vector<float> row_max(block_q);
+  std::vector<float> row_sum(block_q);
+  std::vector<float> acc(static_cast<size_t>(block_q) * depth_v);
+
+  for (int32_t b = 0; b < batch; ++b) {
+    const float *q = Q + static_cast<size_t>(b) * seq_q * depth;
+    const float *k_t = K_t + static_cast<size_t>(b) * depth * seq_k;
+    const float *v = V + static_cast<size_t>(b) * seq_k * depth_v;
+    const float *m = mask + mask_offsets[b];
+    float *y = Y + static_cast<size_t>(b) * seq_q * depth_v;
+
+    for (int32_t i0 = 0; i0 < seq_q; i0 += block_q) {
+      const int32_t rows = std::min(block_q, seq_q - i0);
+      std::fill(row_max.begin(), row_max.end(), -INFINITY);
+      std::fill(row_sum.begin(), row_sum.end(), 0.0f);
+      std::fill(acc.begin(), acc.end(), 0.0f);
+
+      for (int32_t j0 = 0; j0 < seq_k; j0 += block_k) {
+        const int32_t cols = std::min(block_k, seq_k - j0);
+
+        // scores of the block, one contiguous row of K_t at a time
+        for (int32_t i = 0; i < rows; ++i) {
+          const float *q_row = q + static_cast<size_t>(i0 + i) * depth;
+          float *s = &scores[i * block_k];
+          std::fill(s, s + cols, 0.0f);
+          for (int32_t d = 0; d < depth; ++d) {
+            const float qd = q_row[d];
+            const float *k_row = k_t + static_cast<size_t>(d) * seq_k + j0;
+            for (int32_t j = 0; j < cols; ++j) {
+              s[j] += qd * k_row[j];
+            }
+          }
+          const float *m_row =
+              m + static_cast<size_t>(i0 + i) * mask_row_stride;
+          for (int32_t j = 0; j < cols; ++j) {
+            s[j] = s[j] / divisor + m_row[(j0 + j) * mask_col_stride];
+          }
+        }
+
+        // fold the block into the running softmax of each row
+        for (int32_t i = 0; i < rows; ++i) {
+          float *s = &scores[i * block_k];
+          const float block_max = *std::max_element(s, s + cols);
+          const float max = std::max(row_max[i], block_max);
+          if (max == -INFINITY) {
+            // every key so far is masked out
+            continue;
+          }
+          float *a = &acc[static_cast<size_t>(i) * depth_v];
+          if (row_max[i] != max) {
+            const float correction = exp(row_max[i] - max);
+            row_sum[i] *= correction;
+            for (int32_t d = 0; d < depth_v; ++d) {
+              a[d] *= correction;
+            }
+            row_max[i] = max;
+          }
+          for (int32_t j = 0; j < cols; ++j) {
+            const float p = exp(s[j] - max);
+            if (p == 0) {
+              continue;
+            }
+            row_sum[i] += p;
+            const float *v_row = v + static_cast<size_t>(j0 + j) * depth_v;
+            for (int32_t d = 0; d < depth_v; ++d) {
+              a[d] += p * v_row[d];
+            }
+          }
+        }
+      }
+
+      // a row whose keys are all masked out (every score is -Infinity) has a
+      // sum of 0 and is written as zeros. this is also what the unfused
+      // operators compute: the Softmax kernels (CPU and wasm) return a row of
+      // zeros when the sum of its exponentials is 0, instead of dividing by it
+      for (int32_t i = 0; i < rows; ++i) {
+        const float *a = &acc[static_cast<size_t>(i) * depth_v];
+        float *y_row = y + static_cast<size_t>(i0 + i) * depth_v;
+        const float scale = row_sum[i] != 0 ? 1.0f / row_sum[i] : 0.0f;
+        for (int32_t d = 0; d < depth_v; ++d) {
+          y_row[d] = a[d] * scale;
+        }
+      }
+    }
+  }
+}
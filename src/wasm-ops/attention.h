@@ -0,0 +1,15 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <stdint.h>
+
+extern "C" {
+void attention_f32(void *);
+void attention_f32_imp(const float *, const float *, const float *,
+                       const float *, const int32_t *, const int32_t,
+                       const int32_t, const int32_t, const int32_t,
+                       const int32_t, const int32_t, const int32_t,
+                       const float, float *);
+}
@@ -40,6 +40,27 @@ void prelu_f32(void *data) {
   float *output = PARAM_FLOAT_PTR(data, dataIndex[7]);
   binary_imp<float, PRelu>(data, input_1, input_2, output);
 }
+void pow_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  const float *input_1 = PARAM_FLOAT_PTR(data, dataIndex[1]);
+  const float *input_2 = PARAM_FLOAT_PTR(data, dataIndex[4]);
+  float *output = PARAM_FLOAT_PTR(data, dataIndex[7]);
+  binary_imp<float, Pow>(data, input_1, input_2, output);
+}
+void min_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  const float *input_1 = PARAM_FLOAT_PTR(data, dataIndex[1]);
+  const float *input_2 = PARAM_FLOAT_PTR(data, dataIndex[4]);
+  float *output = PARAM_FLOAT_PTR(data, dataIndex[7]);
+  binary_imp<float, Min>(data, input_1, input_2, output);
+}
+void max_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  const float *input_1 = PARAM_FLOAT_PTR(data, dataIndex[1]);
+  const float *input_2 = PARAM_FLOAT_PTR(data, dataIndex[4]);
+  float *output = PARAM_FLOAT_PTR(data, dataIndex[7]);
+  binary_imp<float, Max>(data, input_1, input_2, output);
+}
 
 void add_i32(void *data) {
   uint32_t *dataIndex = static_cast<uint32_t *>(data);
@@ -62,6 +83,86 @@ void mul_i32(void *data) {
   int32_t *output = PARAM_INT32_PTR(data, dataIndex[7]);
   binary_imp<int32_t, Mul>(data, input_1, input_2, output);
 }
+void div_i32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  const int32_t *input_1 = PARAM_INT32_PTR(data, dataIndex[1]);
+  const int32_t *input_2 = PARAM_INT32_PTR(data, dataIndex[4]);
+  int32_t *output = PARAM_INT32_PTR(data, dataIndex[7]);
+  binary_imp<int32_t, Div>(data, input_1, input_2, output);
+}
+void pow_i32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  const int32_t *input_1 = PARAM_INT32_PTR(data, dataIndex[1]);
+  const int32_t *input_2 = PARAM_INT32_PTR(data, dataIndex[4]);
+  int32_t *output = PARAM_INT32_PTR(data, dataIndex[7]);
+  binary_imp<int32_t, Pow>(data, input_1, input_2, output);
+}
+void min_i32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  const int32_t *input_1 = PARAM_INT32_PTR(data, dataIndex[1]);
+  const int32_t *input_2 = PARAM_INT32_PTR(data, dataIndex[4]);
+  int32_t *output = PARAM_INT32_PTR(data, dataIndex[7]);
+  binary_imp<int32_t, Min>(data, input_1, input_2, output);
+}
+void max_i32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  const int32_t *input_1 = PARAM_INT32_PTR(data, dataIndex[1]);
+  const int32_t *input_2 = PARAM_INT32_PTR(data, dataIndex[4]);
+  int32_t *output = PARAM_INT32_PTR(data, dataIndex[7]);
+  binary_imp<int32_t, Max>(data, input_1, input_2, output);
+}
+
+void equal_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  const float *input_1 = PARAM_FLOAT_PTR(data, dataIndex[1]);
+  const float *input_2 = PARAM_FLOAT_PTR(data, dataIndex[4]);
+  uint8_t *output = PARAM_BOOL_PTR(data, dataIndex[7]);
+  binary_imp<float, Equal>(data, input_1, input_2, output);
+}
+void less_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  const float *input_1 = PARAM_FLOAT_PTR(data, dataIndex[1]);
+  const float *input_2 = PARAM_FLOAT_PTR(data, dataIndex[4]);
+  uint8_t *output = PARAM_BOOL_PTR(data, dataIndex[7]);
+  binary_imp<float, Less>(data, input_1, input_2, output);
+}
+void greater_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  const float *input_1 = PARAM_FLOAT_PTR(data, dataIndex[1]);
+  const float *input_2 = PARAM_FLOAT_PTR(data, dataIndex[4]);
+  uint8_t *output = PARAM_BOOL_PTR(data, dataIndex[7]);
+  binary_imp<float, Greater>(data, input_1, input_2, output);
+}
+
+void equal_i32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  const int32_t *input_1 = PARAM_INT32_PTR(data, dataIndex[1]);
+  const int32_t *input_2 = PARAM_INT32_PTR(data, dataIndex[4]);
+  uint8_t *output = PARAM_BOOL_PTR(data, dataIndex[7]);
+  binary_imp<int32_t, Equal>(data, input_1, input_2, output);
+}
+void less_i32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  const int32_t *input_1 = PARAM_INT32_PTR(data, dataIndex[1]);
+  const int32_t *input_2 = PARAM_INT32_PTR(data, dataIndex[4]);
+  uint8_t *output = PARAM_BOOL_PTR(data, dataIndex[7]);
+  binary_imp<int32_t, Less>(data, input_1, input_2, output);
+}
+void greater_i32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  const int32_t *input_1 = PARAM_INT32_PTR(data, dataIndex[1]);
+  const int32_t *input_2 = PARAM_INT32_PTR(data, dataIndex[4]);
+  uint8_t *output = PARAM_BOOL_PTR(data, dataIndex[7]);
+  binary_imp<int32_t, Greater>(data, input_1, input_2, output);
+}
+
+void equal_u8(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  const uint8_t *input_1 = PARAM_BOOL_PTR(data, dataIndex[1]);
+  const uint8_t *input_2 = PARAM_BOOL_PTR(data, dataIndex[4]);
+  uint8_t *output = PARAM_BOOL_PTR(data, dataIndex[7]);
+  binary_imp<uint8_t, Equal>(data, input_1, input_2, output);
+}
 
 void xor_u8(void *data) {
   uint32_t *dataIndex = static_cast<uint32_t *>(data);
@@ -84,3 +185,20 @@ void and_u8(void *data) {
   uint8_t *output = PARAM_BOOL_PTR(data, dataIndex[7]);
   binary_imp<uint8_t, And>(data, input_1, input_2, output);
 }
+
+void where_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  const uint8_t *condition = PARAM_BOOL_PTR(data, dataIndex[1]);
+  const float *input_1 = PARAM_FLOAT_PTR(data, dataIndex[4]);
+  const float *input_2 = PARAM_FLOAT_PTR(data, dataIndex[7]);
+  float *output = PARAM_FLOAT_PTR(data, dataIndex[10]);
+  where_imp<float>(data, condition, input_1, input_2, output);
+}
+void where_i32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  const uint8_t *condition = PARAM_BOOL_PTR(data, dataIndex[1]);
+  const int32_t *input_1 = PARAM_INT32_PTR(data, dataIndex[4]);
+  const int32_t *input_2 = PARAM_INT32_PTR(data, dataIndex[7]);
+  int32_t *output = PARAM_INT32_PTR(data, dataIndex[10]);
+  where_imp<int32_t>(data, condition, input_1, input_2, output);
+}
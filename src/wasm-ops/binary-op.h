@@ -6,8 +6,8 @@
 #include "common.h"
 #include "utils/broadcast_utils.h"
 #include "utils/shape_utils.h"
+#include <cmath>
 #include <stdint.h>
-#include <vector>
 
 extern "C" {
 // Arithmetic ops
@@ -17,74 +17,79 @@ void mul_f32(void *);
 void div_f32(void *);
 void prelu_f32(void *);
 
+void pow_f32(void *);
+void min_f32(void *);
+void max_f32(void *);
+
 void add_i32(void *);
 void sub_i32(void *);
 void mul_i32(void *);
+void div_i32(void *);
+void pow_i32(void *);
+void min_i32(void *);
+void max_i32(void *);
+
+// Comparison ops
+void equal_f32(void *);
+void less_f32(void *);
+void greater_f32(void *);
+
+void equal_i32(void *);
+void less_i32(void *);
+void greater_i32(void *);
+
+void equal_u8(void *);
 
 // Logical ops
 void xor_u8(void *);
 void or_u8(void *);
 void and_u8(void *);
+
+// Selection ops
+void where_f32(void *);
+void where_i32(void *);
 }
 
-// Binary operator (with broadcasting)
-template <typename T, typename BinaryOp>
-void binary_imp(void *data, const T *input_1, const T *input_2, T *output) {
+// Binary operator (with broadcasting). The type of the output differs from
+// the type of the inputs for the comparison ops, whose output is bool
+template <typename T, typename BinaryOp, typename TOut = T>
+void binary_imp(void *data, const T *input_1, const T *input_2,
+                TOut *output) {
   uint32_t *dataIndex = static_cast<uint32_t *>(data);
 
   // first input related
   const int32_t rank_1 = PARAM_INT32(data, dataIndex[2]);
   const int32_t *dims_1 = PARAM_INT32_PTR(data, dataIndex[3]);
-  std::vector<int32_t> dims1_vector;
-  if (rank_1 > 0) {
-    dims1_vector.resize(rank_1);
-    for (int32_t i = 0; i < rank_1; ++i) {
-      dims1_vector[i] = dims_1[i];
-    }
-  }
+  const SmallShape dims1_shape(dims_1, dims_1 + rank_1);
 
   // second input related
   const int32_t rank_2 = PARAM_INT32(data, dataIndex[5]);
   const int32_t *dims_2 = PARAM_INT32_PTR(data, dataIndex[6]);
-  std::vector<int32_t> dims2_vector;
-  if (rank_2 > 0) {
-    dims2_vector.resize(rank_2);
-    for (int32_t i = 0; i < rank_2; ++i) {
-      dims2_vector[i] = dims_2[i];
-    }
-  }
+  const SmallShape dims2_shape(dims_2, dims_2 + rank_2);
 
   // output related
   const int32_t output_length = PARAM_INT32(data, dataIndex[8]);
   const int32_t output_rank = PARAM_INT32(data, dataIndex[9]);
   const int32_t *output_dims = PARAM_INT32_PTR(data, dataIndex[10]);
-  std::vector<int32_t> output_dims_vector;
-  if (output_rank != 0) {
-    output_dims_vector.resize(output_rank);
-    for (int32_t i = 0; i < output_rank; ++i) {
-      output_dims_vector[i] = output_dims[i];
-    }
-  }
+  const SmallShape output_dims_shape(output_dims, output_dims + output_rank);
 
   // compute strides and some preprocessing
-  const std::vector<int32_t> strides_1 =
-      ShapeUtils::compute_strides(dims1_vector);
-  const std::vector<int32_t> strides_2 =
-      ShapeUtils::compute_strides(dims2_vector);
-  const std::vector<int32_t> output_strides =
-      ShapeUtils::compute_strides(output_dims_vector);
-  std::vector<int32_t> indices_1(rank_1);
-  std::vector<int32_t> indices_2(rank_2);
-  std::vector<int32_t> broadcasted_indices(output_strides.size());
+  const SmallShape strides_1 = ShapeUtils::compute_strides(dims1_shape);
+  const SmallShape strides_2 = ShapeUtils::compute_strides(dims2_shape);
+  const SmallShape output_strides =
+      ShapeUtils::compute_strides(output_dims_shape);
+  SmallShape indices_1(rank_1);
+  SmallShape indices_2(rank_2);
+  SmallShape broadcasted_indices(output_strides.size());
 
   // core functionality (with broadcasting)
   for (size_t i = 0; i < output_length; ++i) {
     ShapeUtils::offset_to_indices(output_strides, i, broadcasted_indices);
     BroadcastUtils::broadcasted_to_original_indices(broadcasted_indices,
-                                                    dims1_vector, indices_1);
+                                                    dims1_shape, indices_1);
     auto offset1 = ShapeUtils::indices_to_offset(strides_1, indices_1);
     BroadcastUtils::broadcasted_to_original_indices(broadcasted_indices,
-                                                    dims2_vector, indices_2);
+                                                    dims2_shape, indices_2);
     auto offset2 = ShapeUtils::indices_to_offset(strides_2, indices_2);
     output[i] = BinaryOp::calc(input_1[offset1], input_2[offset2]);
   }
@@ -111,6 +116,63 @@ public:
   template <typename T> static T calc(const T &a, const T &b) { return a / b; }
 };
 
+// an integer division by 0 (or of the lowest value by -1) traps in wasm, so
+// these cases get the result of the CPU backend
+template <> inline int32_t Div::calc<int32_t>(const int32_t &a,
+                                              const int32_t &b) {
+  if (b == 0) {
+    return 0;
+  }
+  if (b == -1) {
+    return static_cast<int32_t>(0u - static_cast<uint32_t>(a));
+  }
+  return a / b;
+}
+
+class Pow {
+public:
+  template <typename T> static T calc(const T &a, const T &b) {
+    return std::pow(a, b);
+  }
+};
+
+// the power of integers by repeated squaring, wrapping around as the int32
+// result of the CPU backend does (which is exact while the power fits in a
+// double). a negative exponent gives the truncated reciprocal of the power
+template <> inline int32_t Pow::calc<int32_t>(const int32_t &a,
+                                              const int32_t &b) {
+  if (b < 0) {
+    if (a == 1 || a == -1) {
+      return b % 2 == 0 ? 1 : a;
+    }
+    return 0;
+  }
+  uint32_t result = 1;
+  uint32_t base = static_cast<uint32_t>(a);
+  for (uint32_t exponent = static_cast<uint32_t>(b); exponent != 0;
+       exponent >>= 1) {
+    if (exponent & 1) {
+      result *= base;
+    }
+    base *= base;
+  }
+  return static_cast<int32_t>(result);
+}
+
+class Min {
+public:
+  template <typename T> static T calc(const T &a, const T &b) {
+    return b < a ? b : a;
+  }
+};
+
+class Max {
+public:
+  template <typename T> static T calc(const T &a, const T &b) {
+    return a < b ? b : a;
+  }
+};
+
 class PRelu {
 public:
   template <typename T> static T calc(const T &a, const T &b) {
@@ -132,3 +194,69 @@ class And {
 public:
   template <typename T> static T calc(const T &a, const T &b) { return a && b; }
 };
+
+class Equal {
+public:
+  template <typename T> static uint8_t calc(const T &a, const T &b) {
+    return a == b;
+  }
+};
+
+class Less {
+public:
+  template <typename T> static uint8_t calc(const T &a, const T &b) {
+    return a < b;
+  }
+};
+
+class Greater {
+public:
+  template <typename T> static uint8_t calc(const T &a, const T &b) {
+    return a > b;
+  }
+};
+
+// Where operator (with broadcasting of the condition and of both inputs)
+template <typename T>
+void where_imp(void *data, const uint8_t *condition, const T *input_1,
+               const T *input_2, T *output) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+
+  // the dims of the condition and of both inputs
+  SmallShape dims[3];
+  for (int32_t k = 0; k < 3; ++k) {
+    const int32_t rank = PARAM_INT32(data, dataIndex[3 * k + 2]);
+    const int32_t *dims_k = PARAM_INT32_PTR(data, dataIndex[3 * k + 3]);
+    dims[k].assign(dims_k, dims_k + rank);
+  }
+
+  // output related
+  const int32_t output_length = PARAM_INT32(data, dataIndex[11]);
+  const int32_t output_rank = PARAM_INT32(data, dataIndex[12]);
+  const int32_t *output_dims = PARAM_INT32_PTR(data, dataIndex[13]);
+  const SmallShape output_dims_shape(output_dims, output_dims + output_rank);
+
+  // compute strides and some preprocessing
+  SmallShape strides[3];
+  SmallShape indices[3];
+  for (int32_t k = 0; k < 3; ++k) {
+    strides[k] = ShapeUtils::compute_strides(dims[k]);
+    indices[k].resize(dims[k].size());
+  }
+  const SmallShape output_strides =
+      ShapeUtils::compute_strides(output_dims_shape);
+  SmallShape broadcasted_indices(output_strides.size());
+
+  // core functionality (with broadcasting)
+  size_t offsets[3];
+  for (size_t i = 0; i < output_length; ++i) {
+    ShapeUtils::offset_to_indices(output_strides, i, broadcasted_indices);
+    for (int32_t k = 0; k < 3; ++k) {
+      BroadcastUtils::broadcasted_to_original_indices(broadcasted_indices,
+                                                      dims[k], indices[k]);
+      offsets[k] = ShapeUtils::indices_to_offset(strides[k], indices[k]);
+    }
+    output[i] = condition[offsets[0]] ? input_1[offsets[1]]
+                                      : input_2[offsets[2]];
+  }
+}
@@ -0,0 +1,33 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "concat.h"
+#include "common.h"
+#include <string.h>
+
+// Wasm interop method
+// The inputs are passed after the fixed arguments as (data, axis_pitch) pairs.
+// 'axis_pitch' is the number of contiguous elements an input contributes to
+// the output for every index of the axes before the concat axis.
+void concat_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  const int32_t num_inputs = PARAM_INT32(data, dataIndex[1]);
+  const int32_t outer_size = PARAM_INT32(data, dataIndex[2]);
+  const int32_t output_axis_pitch = PARAM_INT32(data, dataIndex[3]);
+  float *Y = PARAM_FLOAT_PTR(data, dataIndex[4]);
+
+  int32_t output_base = 0;
+  for (int32_t i = 0; i < num_inputs; ++i) {
+    const float *X = PARAM_FLOAT_PTR(data, dataIndex[5 + 2 * i]);
+    const int32_t input_axis_pitch = PARAM_INT32(data, dataIndex[6 + 2 * i]);
+    if (X == nullptr || input_axis_pitch == 0) {
+      continue;
+    }
+    for (int32_t o = 0; o < outer_size; ++o) {
+      memcpy(Y + o * output_axis_pitch + output_base,
+             X + o * input_axis_pitch, sizeof(float) * input_axis_pitch);
+    }
+    output_base += input_axis_pitch;
+  }
+}
@@ -0,0 +1,342 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "conv-transpose.h"
+#include "common.h"
+#include "gemm.h"
+#include <algorithm>
+#include <vector>
+
+// The algorithms of a transposed convolution. The autotuner may force one of
+// them, otherwise the sub-pixel convolutions run for a stride of 2 (along both
+// axes) without dilation, and the GEMM plus col2im runs for the other ones
+enum ConvTransposeAlgorithm {
+  CONV_TRANSPOSE_DEFAULT = 0,
+  CONV_TRANSPOSE_COL2IM = 1,
+  CONV_TRANSPOSE_SUB_PIXEL = 2
+};
+
+// Wasm interop method
+void conv_transpose_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  conv_transpose2D_f32_imp(
+      PARAM_FLOAT_PTR(data, dataIndex[1]), PARAM_INT32_PTR(data, dataIndex[2]),
+      PARAM_FLOAT_PTR(data, dataIndex[3]), PARAM_INT32_PTR(data, dataIndex[4]),
+      PARAM_FLOAT_PTR(data, dataIndex[5]), PARAM_INT32_PTR(data, dataIndex[6]),
+      PARAM_FLOAT_PTR(data, dataIndex[7]), PARAM_INT32_PTR(data, dataIndex[8]),
+      PARAM_INT32(data, dataIndex[9]), PARAM_INT32_PTR(data, dataIndex[10]),
+      PARAM_INT32_PTR(data, dataIndex[11]),
+      argc > 11 ? PARAM_INT32(data, dataIndex[12]) : CONV_TRANSPOSE_DEFAULT);
+}
+
+// Core operator implementation. W has the shape [C, M / group, kH, kW] and
+// only the pads at the beginning of the spatial axes are read: the output
+// shape (with its output_padding or output_shape) gives the other ones
+void conv_transpose2D_f32_imp(float *X, int *X_shape, float *W, int *W_shape,
+                              float *Y, int *Y_shape, float *bias,
+                              int *dilations, int group, int *pads,
+                              int *strides, int algorithm) {
+  const int output_planes = Y_shape[0] * Y_shape[1];
+  const int output_image_size = Y_shape[2] * Y_shape[3];
+
+  // both algorithms accumulate their results on the bias
+  for (int plane = 0; plane < output_planes; ++plane) {
+    std::fill(Y + plane * output_image_size,
+              Y + (plane + 1) * output_image_size,
+              bias != nullptr ? bias[plane % Y_shape[1]] : 0.0f);
+  }
+
+  const bool sub_pixel_capable = dilations[0] == 1 && dilations[1] == 1;
+  const bool sub_pixel =
+      algorithm == CONV_TRANSPOSE_SUB_PIXEL ||
+      (algorithm == CONV_TRANSPOSE_DEFAULT && strides[0] == 2 &&
+       strides[1] == 2);
+  if (sub_pixel && sub_pixel_capable) {
+    conv_transpose2D_sub_pixel_f32_imp(X, X_shape, W, W_shape, Y, Y_shape,
+                                       group, pads, strides);
+  } else {
+    conv_transpose2D_col2im_f32_imp(X, X_shape, W, W_shape, Y, Y_shape,
+                                    dilations, group, pads, strides);
+  }
+}
+
+// Every group of every image runs a GEMM giving the contribution of each input
+// pixel to the kH x kW output pixels it spreads to, which col2im then adds to
+// the output image
+void conv_transpose2D_col2im_f32_imp(float *X, int *X_shape, float *W,
+                                     int *W_shape, float *Y, int *Y_shape,
+                                     int *dilations, int group, int *pads,
+                                     int *strides) {
+  const int input_num = X_shape[0];
+  const int input_channels = X_shape[1];
+  const int input_height = X_shape[2];
+  const int input_width = X_shape[3];
+  const int group_filters = W_shape[1];
+  const int kernel_h = W_shape[2];
+  const int kernel_w = W_shape[3];
+  const int output_height = Y_shape[2];
+  const int output_width = Y_shape[3];
+
+  const int group_channels = input_channels / group;
+  const int input_image_size = input_height * input_width;
+  const int output_image_size = output_height * output_width;
+  const int kernel_dim = group_filters * kernel_h * kernel_w;
+  std::vector<float> col(static_cast<size_t>(kernel_dim) * input_image_size);
+
+  for (int image_id = 0; image_id < input_num; ++image_id) {
+    for (int group_id = 0; group_id < group; ++group_id) {
+      gemm_f32_imp(true, false, kernel_dim, input_image_size, group_channels,
+                   1, W + group_id * group_channels * kernel_dim,
+                   X + group_id * group_channels * input_image_size, 0,
+                   col.data());
+      col2im_f32(col.data(), group_filters, output_height, output_width,
+                 kernel_h, kernel_w, dilations[0], dilations[1], pads[0],
+                 pads[1], strides[0], strides[1], input_height, input_width,
+                 Y + group_id * group_filters * output_image_size);
+    }
+    X += input_channels * input_image_size;
+    Y += group * group_filters * output_image_size;
+  }
+}
+
+// floor(a / b) for a positive b
+static int floor_div(const int a, const int b) {
+  return a >= 0 ? a / b : -((b - 1 - a) / b);
+}
+
+// The columns of a phase of the sub-pixel convolution: the column (i, j) of
+// the row (c, th, tw) holds the input pixel (c, q_h + i - th, q_w + j - tw),
+// or 0 outside of the input
+static void sub_pixel_columns(const float *data_im, const int channels,
+                              const int height, const int width,
+                              const int taps_h, const int taps_w,
+                              const int q_h, const int rows, const int q_w,
+                              const int cols, float *data_col) {
+  for (int c = 0; c < channels; ++c, data_im += height * width) {
+    for (int th = 0; th < taps_h; ++th) {
+      for (int tw = 0; tw < taps_w; ++tw) {
+        // the columns [col_begin, col_end) read inside the image
+        const int first = q_w - tw;
+        const int col_begin = std::min(cols, std::max(0, -first));
+        const int col_end = std::max(col_begin, std::min(cols, width - first));
+        for (int i = 0; i < rows; ++i, data_col += cols) {
+          const int iy = q_h + i - th;
+          if (iy < 0 || iy >= height) {
+            std::fill(data_col, data_col + cols, 0.0f);
+            continue;
+          }
+          const float *src = data_im + iy * width;
+          std::fill(data_col, data_col + col_begin, 0.0f);
+          for (int j = col_begin; j < col_end; ++j) {
+            data_col[j] = src[j + first];
+          }
+          std::fill(data_col + col_end, data_col + cols, 0.0f);
+        }
+      }
+    }
+  }
+}
+
+// With a stride of s (and no dilation), the output pixels whose row is
+// rh - pad_t modulo s only get the contributions of the kernel rows rh,
+// rh + s, ... and similarly for the columns. So the output splits into s x s
+// phases, each one a plain convolution of the input with a sub-kernel. Every
+// output pixel is then computed by one dot product, instead of scattering the
+// kH x kW contributions of every input pixel with col2im
+void conv_transpose2D_sub_pixel_f32_imp(float *X, int *X_shape, float *W,
+                                        int *W_shape, float *Y, int *Y_shape,
+                                        int group, int *pads, int *strides) {
+  const int input_num = X_shape[0];
+  const int input_channels = X_shape[1];
+  const int input_height = X_shape[2];
+  const int input_width = X_shape[3];
+  const int group_filters = W_shape[1];
+  const int kernel_h = W_shape[2];
+  const int kernel_w = W_shape[3];
+  const int output_height = Y_shape[2];
+  const int output_width = Y_shape[3];
+  const int stride_h = strides[0];
+  const int stride_w = strides[1];
+
+  const int group_channels = input_channels / group;
+  const int input_image_size = input_height * input_width;
+  const int output_image_size = output_height * output_width;
+  std::vector<float> weights;
+  std::vector<float> col;
+  std::vector<float> out;
+
+  for (int rh = 0; rh < std::min(stride_h, kernel_h); ++rh) {
+    for (int rw = 0; rw < std::min(stride_w, kernel_w); ++rw) {
+      // the taps of the sub-kernel, and the output pixels of the phase: the
+      // pixel (i, j) of the phase is the output pixel
+      // ((q_h + i) * stride_h + rh - pad_t, (q_w + j) * stride_w + rw - pad_l)
+      const int taps_h = (kernel_h - rh + stride_h - 1) / stride_h;
+      const int taps_w = (kernel_w - rw + stride_w - 1) / stride_w;
+      const int q_h = floor_div(pads[0] - rh + stride_h - 1, stride_h);
+      const int q_w = floor_div(pads[1] - rw + stride_w - 1, stride_w);
+      const int rows =
+          floor_div(output_height - 1 + pads[0] - rh, stride_h) + 1 - q_h;
+      const int cols =
+          floor_div(output_width - 1 + pads[1] - rw, stride_w) + 1 - q_w;
+      if (rows <= 0 || cols <= 0) {
+        continue;
+      }
+      const int phase_size = rows * cols;
+      const int kernel_dim = group_channels * taps_h * taps_w;
+
+      // the sub-kernels of every group, as [group, M / group, kernel_dim]
+      weights.resize(static_cast<size_t>(group) * group_filters * kernel_dim);
+      float *w = weights.data();
+      for (int g = 0; g < group; ++g) {
+        for (int m = 0; m < group_filters; ++m) {
+          for (int c = 0; c < group_channels; ++c) {
+            const float *filter =
+                W + ((g * group_channels + c) * group_filters + m) * kernel_h *
+                        kernel_w;
+            for (int th = 0; th < taps_h; ++th) {
+              for (int tw = 0; tw < taps_w; ++tw) {
+                *(w++) = filter[(rh + th * stride_h) * kernel_w + rw +
+                                tw * stride_w];
+              }
+            }
+          }
+        }
+      }
+
+      col.resize(static_cast<size_t>(kernel_dim) * phase_size);
+      out.resize(static_cast<size_t>(group_filters) * phase_size);
+      const int first_row = q_h * stride_h + rh - pads[0];
+      const int first_col = q_w * stride_w + rw - pads[1];
+      for (int image_id = 0; image_id < input_num; ++image_id) {
+        for (int group_id = 0; group_id < group; ++group_id) {
+          sub_pixel_columns(
+              X + (image_id * input_channels + group_id * group_channels) *
+                      input_image_size,
+              group_channels, input_height, input_width, taps_h, taps_w, q_h,
+              rows, q_w, cols, col.data());
+          gemm_f32_imp(false, false, group_filters, phase_size, kernel_dim, 1,
+                       weights.data() + group_id * group_filters * kernel_dim,
+                       col.data(), 0, out.data());
+
+          float *y = Y + (image_id * group + group_id) * group_filters *
+                             output_image_size;
+          for (int m = 0; m < group_filters; ++m) {
+            for (int i = 0; i < rows; ++i) {
+              const float *src = &out[(static_cast<size_t>(m) * rows + i) *
+                                      cols];
+              float *dst = y + m * output_image_size +
+                           (first_row + i * stride_h) * output_width +
+                           first_col;
+              for (int j = 0; j < cols; ++j) {
+                dst[j * stride_w] += src[j];
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+// col2im for a square kernel of KERNEL x KERNEL, the same STRIDE along both
+// axes and no dilation. It mirrors im2col_f32_specialized(): the columns of
+// every kernel offset are split into the ones falling in the padding and the
+// ones added to the image, so that the inner loop has no branch.
+template <int KERNEL, int STRIDE>
+void col2im_f32_specialized(const float *data_col, const int channels,
+                            const int height, const int width, const int pad_t,
+                            const int pad_l, const int col_h, const int col_w,
+                            float *data_im) {
+  for (int c = 0; c < channels; ++c, data_im += height * width) {
+    for (int kh = 0; kh < KERNEL; ++kh) {
+      for (int kw = 0; kw < KERNEL; ++kw) {
+        // the columns [col_begin, col_end) added inside the image
+        const int first = kw - pad_l;
+        const int col_begin =
+            first >= 0 ? 0 : std::min(col_w, (STRIDE - 1 - first) / STRIDE);
+        const int col_end = std::max(
+            col_begin,
+            std::min(col_w, first >= width ? 0
+                                           : (width - 1 - first) / STRIDE + 1));
+        for (int y = 0; y < col_h; ++y, data_col += col_w) {
+          const int iy = y * STRIDE - pad_t + kh;
+          if (iy < 0 || iy >= height) {
+            continue;
+          }
+          float *dst = data_im + iy * width;
+          for (int x = col_begin; x < col_end; ++x) {
+            dst[x * STRIDE + first] += data_col[x];
+          }
+        }
+      }
+    }
+  }
+}
+
+typedef void (*Col2imFunction)(const float *, const int, const int, const int,
+                               const int, const int, const int, const int,
+                               float *);
+
+struct Col2imSpecialization {
+  int kernel;
+  int stride;
+  Col2imFunction function;
+};
+
+// The col2im instantiated for the most common transposed convolutions (square
+// kernels of 1, 3 and 5 with a stride of 1, and of 2, 3 and 4 with a stride of
+// 2, no dilation), as for im2col_f32() in conv.cpp
+constexpr Col2imSpecialization col2im_specializations[] = {
+#ifndef WASM_NO_KERNEL_SPECIALIZATIONS
+    {1, 1, col2im_f32_specialized<1, 1>}, {3, 1, col2im_f32_specialized<3, 1>},
+    {5, 1, col2im_f32_specialized<5, 1>}, {2, 2, col2im_f32_specialized<2, 2>},
+    {3, 2, col2im_f32_specialized<3, 2>}, {4, 2, col2im_f32_specialized<4, 2>},
+#endif
+    {0, 0, nullptr}};
+
+// Adds the columns of an image of height x width (as produced by im2col_f32()
+// with the same parameters) to the image. col_h x col_w is the number of
+// columns, given explicitly since the image may be larger than the columns
+// cover (output_padding of ConvTranspose).
+void col2im_f32(const float *data_col, const int channels, const int height,
+                const int width, const int kernel_h, const int kernel_w,
+                const int dilation_h, const int dilation_w, const int pad_t,
+                const int pad_l, const int stride_h, const int stride_w,
+                const int col_h, const int col_w, float *data_im) {
+  if (dilation_h == 1 && dilation_w == 1 && kernel_h == kernel_w &&
+      stride_h == stride_w) {
+    for (auto s = col2im_specializations; s->function != nullptr; ++s) {
+      if (s->kernel == kernel_h && s->stride == stride_h) {
+        s->function(data_col, channels, height, width, pad_t, pad_l, col_h,
+                    col_w, data_im);
+        return;
+      }
+    }
+  }
+
+  // Baseline
+  const int channel_size = height * width;
+  for (int channel = channels; channel--; data_im += channel_size) {
+    for (int kernel_row = 0; kernel_row < kernel_h; kernel_row++) {
+      for (int kernel_col = 0; kernel_col < kernel_w; kernel_col++) {
+        int input_row = -pad_t + kernel_row * dilation_h;
+        for (int output_rows = col_h; output_rows; output_rows--) {
+          if (input_row < 0 || input_row >= height) {
+            data_col += col_w;
+          } else {
+            int input_col = -pad_l + kernel_col * dilation_w;
+            for (int output_col = col_w; output_col; output_col--) {
+              if (input_col >= 0 && input_col < width) {
+                data_im[input_row * width + input_col] += *data_col;
+              }
+              data_col++;
+              input_col += stride_w;
+            }
+          }
+          input_row += stride_h;
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <stdint.h>
+
+extern "C" {
+void conv_transpose_f32(void *);
+
+void conv_transpose2D_f32_imp(float *, int32_t *, float *, int32_t *, float *,
+                              int32_t *, float *, int32_t *, int32_t,
+                              int32_t *, int32_t *, int32_t);
+void conv_transpose2D_col2im_f32_imp(float *, int32_t *, float *, int32_t *,
+                                     float *, int32_t *, int32_t *, int32_t,
+                                     int32_t *, int32_t *);
+void conv_transpose2D_sub_pixel_f32_imp(float *, int32_t *, float *,
+                                        int32_t *, float *, int32_t *, int32_t,
+                                        int32_t *, int32_t *);
+void col2im_f32(const float *, const int32_t, const int32_t, const int32_t,
+                const int32_t, const int32_t, const int32_t, const int32_t,
+                const int32_t, const int32_t, const int32_t, const int32_t,
+                const int32_t, const int32_t, float *);
+}
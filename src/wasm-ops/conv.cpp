@@ -4,28 +4,53 @@
 #include "conv.h"
 #include "common.h"
 #include "gemm.h"
+#include "utils/small_shape.h"
 #include <Eigen/Core>
 #include <Eigen/Dense>
+#include <algorithm>
+#include <string.h>
 #include <vector>
 
 // Wasm interop method
 void conv_f32(void *data) {
   uint32_t *dataIndex = static_cast<uint32_t *>(data);
   uint32_t const argc = dataIndex[0];
-  // TODO: Support muti-dimensional convolution (1D and 3D atleast)
-  conv2D_f32_imp(
-      PARAM_FLOAT_PTR(data, dataIndex[1]), PARAM_INT32_PTR(data, dataIndex[2]),
-      PARAM_FLOAT_PTR(data, dataIndex[3]), PARAM_INT32_PTR(data, dataIndex[4]),
-      PARAM_FLOAT_PTR(data, dataIndex[5]), PARAM_INT32_PTR(data, dataIndex[6]),
-      PARAM_FLOAT_PTR(data, dataIndex[7]), PARAM_INT32_PTR(data, dataIndex[8]),
-      PARAM_INT32(data, dataIndex[9]), PARAM_INT32_PTR(data, dataIndex[10]),
-      PARAM_INT32_PTR(data, dataIndex[11]));
+  uint32_t conv_size = PARAM_INT32(data, dataIndex[1]);
+  float *X = PARAM_FLOAT_PTR(data, dataIndex[2]);
+  int32_t *X_shape = PARAM_INT32_PTR(data, dataIndex[3]);
+  float *W = PARAM_FLOAT_PTR(data, dataIndex[4]);
+  int32_t *W_shape = PARAM_INT32_PTR(data, dataIndex[5]);
+  float *Y = PARAM_FLOAT_PTR(data, dataIndex[6]);
+  int32_t *Y_shape = PARAM_INT32_PTR(data, dataIndex[7]);
+  float *bias = PARAM_FLOAT_PTR(data, dataIndex[8]);
+  int32_t *dilations = PARAM_INT32_PTR(data, dataIndex[9]);
+  int32_t group = PARAM_INT32(data, dataIndex[10]);
+  int32_t *pads = PARAM_INT32_PTR(data, dataIndex[11]);
+  int32_t *strides = PARAM_INT32_PTR(data, dataIndex[12]);
+
+  switch (conv_size) {
+  case 0:
+    throw "Unsupported convolution size";
+  case 1:
+    conv1D_f32_imp(X, X_shape, W, W_shape, Y, Y_shape, bias, dilations, group,
+                   pads, strides);
+    break;
+  case 2:
+    conv2D_f32_imp(X, X_shape, W, W_shape, Y, Y_shape, bias, dilations, group,
+                   pads, strides,
+                   argc > 12 ? PARAM_INT32(data, dataIndex[13]) : 0);
+    break;
+  default:
+    convND_f32_imp(conv_size, X, X_shape, W, W_shape, Y, Y_shape, bias,
+                   dilations, group, pads, strides);
+    break;
+  }
 }
 
 // Core operator implementation
 void conv2D_f32_imp(float *X, int *X_shape, float *W, int *W_shape, float *Y,
                     int *Y_shape, float *bias, int *dilations, int group,
-                    int *pads, int *strides) {
+                    int *pads, int *strides, int batch_chunk) {
   const int input_num = X_shape[0];
   const int input_channels = X_shape[1];
   const int input_height = X_shape[2];
@@ -39,9 +64,7 @@ void conv2D_f32_imp(float *X, int *X_shape, float *W, int *W_shape, float *Y,
   const int filter_width = W_shape[3];
   const int filter_size =
       filter_num * filter_channels * filter_height * filter_width;
-  std::vector<int> kernel_shape;
-  kernel_shape.push_back(filter_height);
-  kernel_shape.push_back(filter_width);
+  const int kernel_shape[] = {filter_height, filter_width};
 
   const int output_num = Y_shape[0];
   const int output_channels = Y_shape[1];
@@ -59,6 +82,20 @@ void conv2D_f32_imp(float *X, int *X_shape, float *W, int *W_shape, float *Y,
   const int kernel_dim = input_channels / group * kernel_size;
   const int col_buffer_size = kernel_dim * output_image_size;
 
+  // Small outputs give skinny GEMMs, so several images are merged into one
+  // GEMM as long as their columns and outputs fit in the memory budget. A
+  // positive batch_chunk (chosen by the autotuner) overrides the heuristic
+  if (batch_chunk <= 0) {
+    batch_chunk = conv_batch_chunk_size(input_num, kernel_dim,
+                                        filter_num / group, output_image_size);
+  }
+  batch_chunk = std::min(batch_chunk, input_num);
+  if (batch_chunk > 1) {
+    conv2D_batched_f32_imp(X, X_shape, W, W_shape, Y, Y_shape, bias,
+                           dilations, group, pads, strides, batch_chunk);
+    return;
+  }
+
   float *col_buffer_data = new float[col_buffer_size]();
 
   for (int image_id = 0; image_id < input_num; ++image_id) {
@@ -89,7 +126,261 @@ void conv2D_f32_imp(float *X, int *X_shape, float *W, int *W_shape, float *Y,
   delete[] col_buffer_data;
 }
 
+// Runs the images of the batch in chunks of batch_chunk images. The im2col
+// columns of the images of a chunk are laid side by side, so each group runs a
+// single GEMM with N = batch_chunk * output_image_size, whose output is then
+// scattered back to the NCHW output.
+void conv2D_batched_f32_imp(float *X, int *X_shape, float *W, int *W_shape,
+                            float *Y, int *Y_shape, float *bias,
+                            int *dilations, int group, int *pads, int *strides,
+                            int batch_chunk) {
+  const int input_num = X_shape[0];
+  const int input_channels = X_shape[1];
+  const int input_height = X_shape[2];
+  const int input_width = X_shape[3];
+  const int filter_num = W_shape[0];
+  const int filter_height = W_shape[2];
+  const int filter_width = W_shape[3];
+  const int output_channels = Y_shape[1];
+  const int output_image_size = Y_shape[2] * Y_shape[3];
+
+  const int group_channels = input_channels / group;
+  const int group_filters = filter_num / group;
+  const int kernel_dim = group_channels * filter_height * filter_width;
+  const int X_image_size = input_channels * input_height * input_width;
+  const int X_group_size = group_channels * input_height * input_width;
+  const int Y_image_size = output_channels * output_image_size;
+  const int W_offset = group_filters * kernel_dim;
+
+  const int chunk_width = batch_chunk * output_image_size;
+  std::vector<float> image_col(static_cast<size_t>(kernel_dim) *
+                               output_image_size);
+  std::vector<float> col(static_cast<size_t>(kernel_dim) * chunk_width);
+  std::vector<float> out(static_cast<size_t>(group_filters) * chunk_width);
+
+  for (int first = 0; first < input_num; first += batch_chunk) {
+    const int images = std::min(batch_chunk, input_num - first);
+    const int width = images * output_image_size;
+    for (int group_id = 0; group_id < group; ++group_id) {
+      for (int i = 0; i < images; ++i) {
+        im2col_f32(X + static_cast<size_t>(first + i) * X_image_size +
+                       group_id * X_group_size,
+                   group_channels, input_height, input_width, filter_height,
+                   filter_width, dilations[0], dilations[1], pads[0], pads[1],
+                   pads[2], pads[3], strides[0], strides[1], image_col.data());
+        for (int k = 0; k < kernel_dim; ++k) {
+          memcpy(&col[static_cast<size_t>(k) * width +
+                      i * output_image_size],
+                 &image_col[static_cast<size_t>(k) * output_image_size],
+                 sizeof(float) * output_image_size);
+        }
+      }
+
+      gemm_f32_imp(false, false, group_filters, width, kernel_dim, 1,
+                   W + group_id * W_offset, col.data(), 0, out.data());
+
+      for (int i = 0; i < images; ++i) {
+        float *y = Y + static_cast<size_t>(first + i) * Y_image_size +
+                   group_id * group_filters * output_image_size;
+        for (int f = 0; f < group_filters; ++f) {
+          const float *o =
+              &out[static_cast<size_t>(f) * width + i * output_image_size];
+          const float b =
+              bias != nullptr ? bias[group_id * group_filters + f] : 0;
+          for (int j = 0; j < output_image_size; ++j) {
+            y[f * output_image_size + j] = o[j] + b;
+          }
+        }
+      }
+    }
+  }
+}
+
+// Convolution of 1-D images [N, C, L]. The columns of a pointwise convolution
+// (a kernel of 1 with a stride of 1 and no padding) are the image itself, so
+// its GEMM reads the input directly. The other convolutions run the 1-D
+// im2col, without going through the 2-D kernel with a height of 1.
+void conv1D_f32_imp(float *X, int *X_shape, float *W, int *W_shape, float *Y,
+                    int *Y_shape, float *bias, int *dilations, int group,
+                    int *pads, int *strides) {
+  const int input_num = X_shape[0];
+  const int input_channels = X_shape[1];
+  const int input_width = X_shape[2];
+  const int filter_num = W_shape[0];
+  const int kernel_width = W_shape[2];
+  const int output_width = Y_shape[2];
+
+  const int group_channels = input_channels / group;
+  const int group_filters = filter_num / group;
+  const int kernel_dim = group_channels * kernel_width;
+  const int X_offset = group_channels * input_width;
+  const int Y_offset = group_filters * output_width;
+  const int W_offset = group_filters * kernel_dim;
+  const bool pointwise =
+      kernel_width == 1 && strides[0] == 1 && pads[0] == 0 && pads[1] == 0;
+
+  std::vector<float> col(
+      pointwise ? 0 : static_cast<size_t>(kernel_dim) * output_width);
+  for (int image_id = 0; image_id < input_num; ++image_id) {
+    for (int group_id = 0; group_id < group; ++group_id) {
+      const float *x = X + group_id * X_offset;
+      if (!pointwise) {
+        im2col_1d_f32(x, group_channels, input_width, kernel_width,
+                      dilations[0], pads[0], strides[0], output_width,
+                      col.data());
+        x = col.data();
+      }
+      gemm_f32_imp(false, false, group_filters, output_width, kernel_dim, 1,
+                   W + group_id * W_offset, x, 0, Y + group_id * Y_offset);
+    }
+    conv_add_bias_f32(Y, bias, filter_num, output_width);
+
+    X += X_offset * group;
+    Y += Y_offset * group;
+  }
+}
+
+// Convolution of images of any rank [N, C, D1, ..., Dn], running the N-d
+// im2col and one GEMM per image and group. A pointwise convolution (kernels,
+// strides and dilations of 1 along every axis, no padding) skips the im2col.
+void convND_f32_imp(int conv_size, float *X, int *X_shape, float *W,
+                    int *W_shape, float *Y, int *Y_shape, float *bias,
+                    int *dilations, int group, int *pads, int *strides) {
+  const int *image_shape = X_shape + 2;
+  const int *kernel_shape = W_shape + 2;
+  const int *output_shape = Y_shape + 2;
+  int input_image_size = 1;
+  int kernel_size = 1;
+  int output_image_size = 1;
+  bool pointwise = true;
+  for (int i = 0; i < conv_size; ++i) {
+    input_image_size *= image_shape[i];
+    kernel_size *= kernel_shape[i];
+    output_image_size *= output_shape[i];
+    pointwise = pointwise && kernel_shape[i] == 1 && strides[i] == 1 &&
+                pads[i] == 0 && pads[i + conv_size] == 0;
+  }
+
+  const int input_num = X_shape[0];
+  const int filter_num = W_shape[0];
+  const int group_channels = X_shape[1] / group;
+  const int group_filters = filter_num / group;
+  const int kernel_dim = group_channels * kernel_size;
+  const int X_offset = group_channels * input_image_size;
+  const int Y_offset = group_filters * output_image_size;
+  const int W_offset = group_filters * kernel_dim;
+
+  std::vector<float> col(
+      pointwise ? 0 : static_cast<size_t>(kernel_dim) * output_image_size);
+  for (int image_id = 0; image_id < input_num; ++image_id) {
+    for (int group_id = 0; group_id < group; ++group_id) {
+      const float *x = X + group_id * X_offset;
+      if (!pointwise) {
+        im2col_nd_f32(x, conv_size, group_channels, image_shape, kernel_shape,
+                      dilations, pads, strides, output_shape, col.data());
+        x = col.data();
+      }
+      gemm_f32_imp(false, false, group_filters, output_image_size, kernel_dim,
+                   1, W + group_id * W_offset, x, 0, Y + group_id * Y_offset);
+    }
+    conv_add_bias_f32(Y, bias, filter_num, output_image_size);
+
+    X += X_offset * group;
+    Y += Y_offset * group;
+  }
+}
+
 // Some helpers specific to conv operator
+
+// The number of images whose im2col columns are merged into one GEMM. The
+// merged GEMM only pays off when one image gives a narrow GEMM, and the
+// columns and the output of a chunk must fit in the memory budget. Returns 1
+// when the images run one by one.
+int conv_batch_chunk_size(const int input_num, const int kernel_dim,
+                          const int group_filters,
+                          const int output_image_size) {
+  // GEMMs at least this wide are efficient enough on their own
+  const int min_gemm_width = 1024;
+  // bytes of the merged columns and outputs of a chunk
+  const size_t memory_budget = 8 << 20;
+
+  // empty outputs have nothing to merge
+  if (input_num <= 1 || output_image_size <= 0 ||
+      output_image_size >= min_gemm_width) {
+    return 1;
+  }
+  const size_t image_bytes = sizeof(float) * output_image_size *
+                             (static_cast<size_t>(kernel_dim) + group_filters);
+  const int budget_images = static_cast<int>(memory_budget / image_bytes);
+  const int wanted_images =
+      (min_gemm_width + output_image_size - 1) / output_image_size;
+  return std::max(1, std::min(input_num, std::min(budget_images,
+                                                  wanted_images)));
+}
+
+// im2col for a square kernel of KERNEL x KERNEL, the same STRIDE along both
+// axes and no dilation. The columns of every kernel offset are split into the
+// padding on the left, the pixels read from the image and the padding on the
+// right, so that the inner loops have no branch.
+template <int KERNEL, int STRIDE>
+void im2col_f32_specialized(const float *data_im, const int channels,
+                            const int height, const int width, const int pad_t,
+                            const int pad_l, const int output_h,
+                            const int output_w, float *data_col) {
+  for (int c = 0; c < channels; ++c, data_im += height * width) {
+    for (int kh = 0; kh < KERNEL; ++kh) {
+      for (int kw = 0; kw < KERNEL; ++kw) {
+        // the output columns [col_begin, col_end) read inside the image
+        const int first = kw - pad_l;
+        const int col_begin =
+            first >= 0 ? 0 : std::min(output_w, (STRIDE - 1 - first) / STRIDE);
+        const int col_end = std::max(
+            col_begin,
+            std::min(output_w, first >= width
+                                   ? 0
+                                   : (width - 1 - first) / STRIDE + 1));
+        for (int y = 0; y < output_h; ++y, data_col += output_w) {
+          const int iy = y * STRIDE - pad_t + kh;
+          if (!is_a_ge_zero_and_a_lt_b(iy, height)) {
+            std::fill(data_col, data_col + output_w, 0.0f);
+            continue;
+          }
+          const float *src = data_im + iy * width;
+          std::fill(data_col, data_col + col_begin, 0.0f);
+          for (int x = col_begin; x < col_end; ++x) {
+            data_col[x] = src[x * STRIDE + first];
+          }
+          std::fill(data_col + col_end, data_col + output_w, 0.0f);
+        }
+      }
+    }
+  }
+}
+
+typedef void (*Im2colFunction)(const float *, const int, const int, const int,
+                               const int, const int, const int, const int,
+                               float *);
+
+struct Im2colSpecialization {
+  int kernel;
+  int stride;
+  Im2colFunction function;
+};
+
+// The im2col instantiated for the most common convolutions (square kernels of
+// 1, 3, 5 and 7 with strides of 1 or 2, no dilation). The table ends with an
+// empty entry, and the other configurations run the generic im2col. Defining
+// WASM_NO_KERNEL_SPECIALIZATIONS leaves the table empty, to measure the code
+// size of the specializations (see docs/development.md)
+constexpr Im2colSpecialization im2col_specializations[] = {
+#ifndef WASM_NO_KERNEL_SPECIALIZATIONS
+    {1, 1, im2col_f32_specialized<1, 1>}, {1, 2, im2col_f32_specialized<1, 2>},
+    {3, 1, im2col_f32_specialized<3, 1>}, {3, 2, im2col_f32_specialized<3, 2>},
+    {5, 1, im2col_f32_specialized<5, 1>}, {5, 2, im2col_f32_specialized<5, 2>},
+    {7, 1, im2col_f32_specialized<7, 1>}, {7, 2, im2col_f32_specialized<7, 2>},
+#endif
+    {0, 0, nullptr}};
+
 void im2col_f32(const float *data_im, const int channels, const int height,
                 const int width, const int kernel_h, const int kernel_w,
                 const int dilation_h, const int dilation_w, const int pad_t,
@@ -102,6 +393,17 @@ void im2col_f32(const float *data_im, const int channels, const int height,
       (width + pad_l + pad_r - (dilation_w * (kernel_w - 1) + 1)) / stride_w +
       1;
 
+  if (dilation_h == 1 && dilation_w == 1 && kernel_h == kernel_w &&
+      stride_h == stride_w) {
+    for (auto s = im2col_specializations; s->function != nullptr; ++s) {
+      if (s->kernel == kernel_h && s->stride == stride_h) {
+        s->function(data_im, channels, height, width, pad_t, pad_l, output_h,
+                    output_w, data_col);
+        return;
+      }
+    }
+  }
+
   // Fast path for zero padding and no dilation
   // From Torch, THNN_(unfolded_copy)
   if (dilation_h == 1 && dilation_w == 1 && pad_l == 0 && pad_r == 0 &&
@@ -191,3 +493,120 @@ void im2col_f32(const float *data_im, const int channels, const int height,
     }
   }
 }
+
+// The output columns [begin, end) of a row of output_w columns that read
+// inside a row of width pixels, the first column reading the pixel first and
+// the next ones every stride pixels
+static inline void im2col_row_range(const int first, const int width,
+                                    const int stride, const int output_w,
+                                    int &begin, int &end) {
+  begin = first >= 0 ? 0 : std::min(output_w, (stride - 1 - first) / stride);
+  const int last = first >= width ? 0 : (width - 1 - first) / stride + 1;
+  end = std::max(begin, std::min(output_w, last));
+}
+
+// Copies the columns [begin, end) of an im2col row, and zeroes the padding
+// around them
+static inline void im2col_copy_row(const float *row, const int first,
+                                   const int stride, const int begin,
+                                   const int end, const int output_w,
+                                   float *data_col) {
+  std::fill(data_col, data_col + begin, 0.0f);
+  if (stride == 1 && end > begin) {
+    memcpy(data_col + begin, row + begin + first,
+           sizeof(float) * (end - begin));
+  } else {
+    for (int x = begin; x < end; ++x) {
+      data_col[x] = row[x * stride + first];
+    }
+  }
+  std::fill(data_col + end, data_col + output_w, 0.0f);
+}
+
+void im2col_1d_f32(const float *data_im, const int channels, const int width,
+                   const int kernel_w, const int dilation_w, const int pad_l,
+                   const int stride_w, const int output_w, float *data_col) {
+  for (int c = 0; c < channels; ++c, data_im += width) {
+    for (int kw = 0; kw < kernel_w; ++kw, data_col += output_w) {
+      const int first = kw * dilation_w - pad_l;
+      int begin, end;
+      im2col_row_range(first, width, stride_w, output_w, begin, end);
+      im2col_copy_row(data_im, first, stride_w, begin, end, output_w,
+                      data_col);
+    }
+  }
+}
+
+// im2col of images of any rank. The rows of the columns are the kernel
+// offsets of every channel, and each one is filled by rows of the last axis,
+// whose range read inside the image is computed once per kernel offset.
+void im2col_nd_f32(const float *data_im, const int rank, const int channels,
+                   const int *image_shape, const int *kernel_shape,
+                   const int *dilations, const int *pads, const int *strides,
+                   const int *output_shape, float *data_col) {
+  const int last = rank - 1;
+  const int width = image_shape[last];
+  const int output_w = output_shape[last];
+  int image_size = 1;
+  int kernel_size = 1;
+  int output_rows = 1;
+  for (int d = 0; d < rank; ++d) {
+    image_size *= image_shape[d];
+    kernel_size *= kernel_shape[d];
+    if (d < last) {
+      output_rows *= output_shape[d];
+    }
+  }
+
+  SmallShape kernel_index(rank);
+  SmallShape output_index(rank);
+  for (int c = 0; c < channels; ++c, data_im += image_size) {
+    for (int k = 0; k < kernel_size; ++k) {
+      for (int d = last, r = k; d >= 0; --d) {
+        kernel_index[d] = r % kernel_shape[d];
+        r /= kernel_shape[d];
+      }
+      const int first = kernel_index[last] * dilations[last] - pads[last];
+      int begin, end;
+      im2col_row_range(first, width, strides[last], output_w, begin, end);
+
+      std::fill(output_index.begin(), output_index.end(), 0);
+      for (int o = 0; o < output_rows; ++o, data_col += output_w) {
+        // the input row read by the output row, unless it is in the padding
+        int row = 0;
+        bool inside = true;
+        for (int d = 0; d < last && inside; ++d) {
+          const int i = output_index[d] * strides[d] - pads[d] +
+                        kernel_index[d] * dilations[d];
+          inside = is_a_ge_zero_and_a_lt_b(i, image_shape[d]);
+          row = row * image_shape[d] + i;
+        }
+        for (int d = last - 1; d >= 0 && ++output_index[d] == output_shape[d];
+             --d) {
+          output_index[d] = 0;
+        }
+
+        if (inside) {
+          im2col_copy_row(data_im + static_cast<size_t>(row) * width, first,
+                          strides[last], begin, end, output_w, data_col);
+        } else {
+          std::fill(data_col, data_col + output_w, 0.0f);
+        }
+      }
+    }
+  }
+}
+
+// Adds the bias of every output channel to an output image
+void conv_add_bias_f32(float *Y, const float *bias, const int channels,
+                       const int image_size) {
+  if (bias == nullptr) {
+    return;
+  }
+  for (int c = 0; c < channels; ++c, Y += image_size) {
+    const float b = bias[c];
+    for (int i = 0; i < image_size; ++i) {
+      Y[i] += b;
+    }
+  }
+}
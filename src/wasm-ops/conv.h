@@ -8,15 +8,32 @@
 extern "C" {
 void conv_f32(void *);
 
-// TODO: Support muti-dimensional convolution (1D and 3D atleast)
-void conv2D_f32_imp(float *, int32_t *, float *, int32_t *, float *, int32_t *,
+void conv1D_f32_imp(float *, int32_t *, float *, int32_t *, float *, int32_t *,
                     float *, int32_t *, int32_t, int32_t *, int32_t *);
+void conv2D_f32_imp(float *, int32_t *, float *, int32_t *, float *, int32_t *,
+                    float *, int32_t *, int32_t, int32_t *, int32_t *,
+                    int32_t);
+void conv2D_batched_f32_imp(float *, int32_t *, float *, int32_t *, float *,
+                            int32_t *, float *, int32_t *, int32_t, int32_t *,
+                            int32_t *, int32_t);
+void convND_f32_imp(int32_t, float *, int32_t *, float *, int32_t *, float *,
+                    int32_t *, float *, int32_t *, int32_t, int32_t *,
+                    int32_t *);
 void im2col_f32(const float *, const int32_t, const int32_t, const int32_t,
                 const int32_t, const int32_t, const int32_t, const int32_t,
                 const int32_t, const int32_t, const int32_t, const int32_t,
                 const int32_t, const int32_t, float *);
+void im2col_1d_f32(const float *, const int32_t, const int32_t, const int32_t,
+                   const int32_t, const int32_t, const int32_t, const int32_t,
+                   float *);
+void im2col_nd_f32(const float *, const int32_t, const int32_t,
+                   const int32_t *, const int32_t *, const int32_t *,
+                   const int32_t *, const int32_t *, const int32_t *, float *);
 
 // Helper functions
+int32_t conv_batch_chunk_size(const int32_t, const int32_t, const int32_t,
+                              const int32_t);
+void conv_add_bias_f32(float *, const float *, const int32_t, const int32_t);
 bool is_a_ge_zero_and_a_lt_b(int32_t a, int32_t b) {
   return static_cast<uint32_t>(a) < static_cast<uint32_t>(b);
 }
@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "gather.h"
+#include "common.h"
+#include <string.h>
+
+// Wasm interop method
+void gather_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  gather_f32_imp(
+      PARAM_FLOAT_PTR(data, dataIndex[1]), PARAM_INT32_PTR(data, dataIndex[2]),
+      PARAM_INT32(data, dataIndex[3]), PARAM_INT32(data, dataIndex[4]),
+      PARAM_INT32_PTR(data, dataIndex[5]), PARAM_INT32(data, dataIndex[6]),
+      PARAM_FLOAT_PTR(data, dataIndex[7]));
+}
+
+// Core operator implementation
+// 'axis' must already be normalized. Negative indices count from the end of
+// the gathered axis.
+void gather_f32_imp(const float *X, const int32_t *X_dims, const int32_t rank,
+                    const int32_t axis, const int32_t *indices,
+                    const int32_t num_indices, float *Y) {
+  size_t outer_size = 1;
+  for (int32_t i = 0; i < axis; ++i) {
+    outer_size *= X_dims[i];
+  }
+  size_t inner_size = 1;
+  for (int32_t i = axis + 1; i < rank; ++i) {
+    inner_size *= X_dims[i];
+  }
+  const int32_t axis_dim = X_dims[axis];
+
+  for (size_t o = 0; o < outer_size; ++o) {
+    const float *src = X + o * axis_dim * inner_size;
+    for (int32_t k = 0; k < num_indices; ++k) {
+      const int32_t index =
+          indices[k] < 0 ? indices[k] + axis_dim : indices[k];
+      memcpy(Y, src + index * inner_size, sizeof(float) * inner_size);
+      Y += inner_size;
+    }
+  }
+}
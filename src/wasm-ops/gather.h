@@ -0,0 +1,12 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <stdint.h>
+
+extern "C" {
+void gather_f32(void *);
+void gather_f32_imp(const float *, const int32_t *, const int32_t,
+                    const int32_t, const int32_t *, const int32_t, float *);
+}
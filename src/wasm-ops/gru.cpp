@@ -0,0 +1,155 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "gru.h"
+#include "common.h"
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+// Wasm interop methods
+void gru_create_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  GruKernel *kernel = gru_create_f32_imp(
+      PARAM_FLOAT_PTR(data, dataIndex[1]), PARAM_FLOAT_PTR(data, dataIndex[2]),
+      PARAM_FLOAT_PTR(data, dataIndex[3]), PARAM_INT32(data, dataIndex[4]),
+      PARAM_INT32(data, dataIndex[5]), PARAM_INT32(data, dataIndex[6]),
+      PARAM_FLOAT(data, dataIndex[7]), PARAM_BOOL(data, dataIndex[8]));
+  PARAM_INT32_PTR(data, dataIndex[9])[0] =
+      static_cast<int32_t>(reinterpret_cast<intptr_t>(kernel));
+}
+
+void gru_run_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  gru_run_f32_imp(*reinterpret_cast<GruKernel *>(
+                      static_cast<intptr_t>(PARAM_INT32(data, dataIndex[1]))),
+                  PARAM_FLOAT_PTR(data, dataIndex[2]),
+                  PARAM_INT32(data, dataIndex[3]),
+                  PARAM_INT32(data, dataIndex[4]),
+                  PARAM_INT32_PTR(data, dataIndex[5]),
+                  PARAM_FLOAT_PTR(data, dataIndex[6]),
+                  PARAM_BOOL(data, dataIndex[7]),
+                  PARAM_FLOAT_PTR(data, dataIndex[8]),
+                  PARAM_FLOAT_PTR(data, dataIndex[9]));
+}
+
+// Core operator implementation
+GruKernel *gru_create_f32_imp(const float *W, const float *R, const float *B,
+                              const int32_t direction,
+                              const int32_t hidden_size,
+                              const int32_t input_size, const float clip,
+                              const bool linear_before_reset) {
+  GruKernel *kernel = new GruKernel();
+  recurrent_init_f32(*kernel, direction, 3, hidden_size, input_size, clip, W,
+                     R);
+  kernel->linear_before_reset = linear_before_reset;
+  kernel->Rb_h.assign(kernel->num_directions * hidden_size, 0);
+
+  const int32_t gates_size = 3 * hidden_size;
+  if (B != nullptr) {
+    for (int32_t d = 0; d < kernel->num_directions; ++d) {
+      const float *b = B + 2 * d * gates_size;
+      float *bias = &kernel->bias[d * gates_size];
+      for (int32_t j = 0; j < gates_size; ++j) {
+        bias[j] = b[j];
+        if (j < 2 * hidden_size || !linear_before_reset) {
+          bias[j] += b[gates_size + j];
+        } else {
+          kernel->Rb_h[d * hidden_size + j - 2 * hidden_size] =
+              b[gates_size + j];
+        }
+      }
+    }
+  }
+  return kernel;
+}
+
+// Gates are stored in the order of the ONNX weights: update, reset and hidden
+void gru_run_f32_imp(GruKernel &kernel, const float *X,
+                     const int32_t seq_length, const int32_t batch_size,
+                     const int32_t *sequence_lens, const float *initial_h,
+                     const bool keep_state, float *Y, float *Y_h) {
+  recurrent_reset_state_f32(kernel, kernel.H, batch_size, initial_h,
+                            keep_state);
+
+  const int32_t num_directions = kernel.num_directions;
+  const int32_t hidden_size = kernel.hidden_size;
+  const int32_t gates_size = 3 * hidden_size;
+  const float clip = kernel.clip;
+  std::fill(Y,
+            Y + static_cast<size_t>(seq_length) * num_directions * batch_size *
+                    hidden_size,
+            0.0f);
+  const int32_t max_length =
+      recurrent_max_length(sequence_lens, batch_size, seq_length);
+
+  std::vector<float> gates_x(static_cast<size_t>(seq_length) * batch_size *
+                             gates_size);
+  std::vector<float> gates(gates_size);
+  std::vector<float> hidden(hidden_size);
+  for (int32_t d = 0; d < num_directions; ++d) {
+    recurrent_project_f32(kernel, d, X, seq_length, batch_size, &gates_x[0]);
+    const bool reverse = d == 1 || kernel.reverse;
+    const float *R = &kernel.R[static_cast<size_t>(d) * hidden_size *
+                               gates_size];
+    const float *Rb_h = &kernel.Rb_h[d * hidden_size];
+
+    for (int32_t s = 0; s < max_length; ++s) {
+      for (int32_t b = 0; b < batch_size; ++b) {
+        const int32_t length =
+            sequence_lens == nullptr ? seq_length
+                                     : std::min(sequence_lens[b], seq_length);
+        if (s >= length) {
+          continue;
+        }
+        const int32_t t = reverse ? length - 1 - s : s;
+        float *h =
+            &kernel.H[(static_cast<size_t>(d) * batch_size + b) * hidden_size];
+
+        const float *gx =
+            &gates_x[(static_cast<size_t>(t) * batch_size + b) * gates_size];
+        std::copy(gx, gx + gates_size, gates.begin());
+        float *z = &gates[0];
+        float *r = &gates[hidden_size];
+        float *gh = &gates[2 * hidden_size];
+
+        // update and reset gates
+        recurrent_gates_f32(h, R, hidden_size, 2 * hidden_size, gates_size,
+                            z);
+        for (int32_t j = 0; j < 2 * hidden_size; ++j) {
+          z[j] = recurrent_sigmoid(recurrent_clip(z[j], clip));
+        }
+
+        // hidden gate: the reset gate applies either to the recurrent product
+        // or to the previous hidden state
+        if (kernel.linear_before_reset) {
+          std::copy(Rb_h, Rb_h + hidden_size, hidden.begin());
+          recurrent_gates_f32(h, R + 2 * hidden_size, hidden_size, hidden_size,
+                              gates_size, &hidden[0]);
+          for (int32_t j = 0; j < hidden_size; ++j) {
+            gh[j] += r[j] * hidden[j];
+          }
+        } else {
+          for (int32_t j = 0; j < hidden_size; ++j) {
+            hidden[j] = r[j] * h[j];
+          }
+          recurrent_gates_f32(&hidden[0], R + 2 * hidden_size, hidden_size,
+                              hidden_size, gates_size, gh);
+        }
+        for (int32_t j = 0; j < hidden_size; ++j) {
+          const float candidate = tanh(recurrent_clip(gh[j], clip));
+          h[j] = (1.0f - z[j]) * candidate + z[j] * h[j];
+        }
+
+        const size_t y_row = (static_cast<size_t>(t) * num_directions + d) *
+                                 batch_size +
+                             b;
+        memcpy(Y + y_row * hidden_size, h, sizeof(float) * hidden_size);
+      }
+    }
+  }
+
+  std::copy(kernel.H.begin(), kernel.H.end(), Y_h);
+}
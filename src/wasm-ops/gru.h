@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "rnn.h"
+#include <stdint.h>
+#include <vector>
+
+extern "C" {
+void gru_create_f32(void *);
+void gru_run_f32(void *);
+}
+
+struct GruKernel : public RecurrentKernel {
+  bool linear_before_reset;
+  // [num_directions, hidden_size] recurrent bias of the hidden gate. It is
+  // scaled by the reset gate when 'linear_before_reset' is set, so it cannot
+  // be folded into the input projection.
+  std::vector<float> Rb_h;
+};
+
+GruKernel *gru_create_f32_imp(const float *, const float *, const float *,
+                              const int32_t, const int32_t, const int32_t,
+                              const float, const bool);
+void gru_run_f32_imp(GruKernel &, const float *, const int32_t, const int32_t,
+                     const int32_t *, const float *, const bool, float *,
+                     float *);
@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "image-preprocess.h"
+#include "common.h"
+#include <algorithm>
+#include <vector>
+
+// Wasm interop method
+void image_to_nchw_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  image_to_nchw_f32_imp(
+      PARAM_BOOL_PTR(data, dataIndex[1]), PARAM_INT32(data, dataIndex[2]),
+      PARAM_INT32(data, dataIndex[3]), PARAM_INT32(data, dataIndex[4]),
+      PARAM_INT32_PTR(data, dataIndex[5]), PARAM_INT32(data, dataIndex[6]),
+      PARAM_FLOAT_PTR(data, dataIndex[7]), PARAM_FLOAT_PTR(data, dataIndex[8]),
+      PARAM_FLOAT_PTR(data, dataIndex[9]), PARAM_INT32(data, dataIndex[10]),
+      PARAM_INT32(data, dataIndex[11]));
+}
+
+// The offsets of the two source pixels blended into each output pixel along an
+// axis, and the weight of the second one. The source coordinate of output
+// pixel j is (j + 0.5) * in_length / out_length - 0.5 (half pixel centers),
+// clamped to the image
+void image_resize_table(const int32_t in_length, const int32_t out_length,
+                        const int32_t stride, int32_t *offsets,
+                        float *weights) {
+  const float scale = static_cast<float>(in_length) / out_length;
+  const float last = static_cast<float>(in_length - 1);
+  for (int32_t j = 0; j < out_length; ++j) {
+    const float x = std::min(std::max((j + 0.5f) * scale - 0.5f, 0.0f), last);
+    const int32_t x1 = static_cast<int32_t>(x);
+    const int32_t x2 = std::min(x1 + 1, in_length - 1);
+    offsets[2 * j] = x1 * stride;
+    offsets[2 * j + 1] = x2 * stride;
+    weights[j] = x - x1;
+  }
+}
+
+// Core operator implementation
+// 'X' holds the pixels of an image of 'in_height' x 'in_width' pixels of
+// 'pixel_size' bytes (e.g. RGBA or RGB). Output channel c of 'Y' (NCHW) takes
+// the byte 'channels[c]' of every pixel, as multipliers[c] * value + biases[c].
+// The image is resized by bilinear interpolation when the size of the output
+// differs
+void image_to_nchw_f32_imp(const uint8_t *X, const int32_t in_height,
+                           const int32_t in_width, const int32_t pixel_size,
+                           const int32_t *channels, const int32_t out_channels,
+                           const float *multipliers, const float *biases,
+                           float *Y, const int32_t out_height,
+                           const int32_t out_width) {
+  if (out_height == 0 || out_width == 0) {
+    return;
+  }
+  const size_t plane_size = static_cast<size_t>(out_height) * out_width;
+  const size_t in_row_size = static_cast<size_t>(in_width) * pixel_size;
+  if (out_height == in_height && out_width == in_width) {
+    for (int32_t i = 0; i < out_height; ++i) {
+      const uint8_t *src = X + i * in_row_size;
+      float *dst = Y + static_cast<size_t>(i) * out_width;
+      if (pixel_size == 4) {
+        pixels_to_planes_f32<4>(src, out_width, channels, out_channels,
+                                multipliers, biases, dst, plane_size);
+      } else if (pixel_size == 3) {
+        pixels_to_planes_f32<3>(src, out_width, channels, out_channels,
+                                multipliers, biases, dst, plane_size);
+      } else {
+        for (int32_t c = 0; c < out_channels; ++c) {
+          for (int32_t j = 0; j < out_width; ++j) {
+            dst[c * plane_size + j] =
+                multipliers[c] * src[j * pixel_size + channels[c]] +
+                biases[c];
+          }
+        }
+      }
+    }
+    return;
+  }
+
+  std::vector<int32_t> x_offset(2 * out_width);
+  std::vector<float> x_weight(out_width);
+  image_resize_table(in_width, out_width, pixel_size, &x_offset[0],
+                     &x_weight[0]);
+  std::vector<int32_t> y_offset(2 * out_height);
+  std::vector<float> y_weight(out_height);
+  image_resize_table(in_height, out_height, static_cast<int32_t>(in_row_size),
+                     &y_offset[0], &y_weight[0]);
+
+  // every output row blends two source rows, which stay in the cache while
+  // the rows of all the output channels are computed
+  for (int32_t i = 0; i < out_height; ++i) {
+    const uint8_t *row1 = X + y_offset[2 * i];
+    const uint8_t *row2 = X + y_offset[2 * i + 1];
+    const float wy = y_weight[i];
+    for (int32_t c = 0; c < out_channels; ++c) {
+      const uint8_t *s1 = row1 + channels[c];
+      const uint8_t *s2 = row2 + channels[c];
+      const float a = multipliers[c];
+      const float b = biases[c];
+      float *d = Y + c * plane_size + static_cast<size_t>(i) * out_width;
+      for (int32_t j = 0; j < out_width; ++j) {
+        const int32_t x1 = x_offset[2 * j];
+        const int32_t x2 = x_offset[2 * j + 1];
+        const float wx = x_weight[j];
+        const float top = s1[x1] + wx * (s1[x2] - s1[x1]);
+        const float bottom = s2[x1] + wx * (s2[x2] - s2[x1]);
+        d[j] = a * (top + wy * (bottom - top)) + b;
+      }
+    }
+  }
+}
@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+extern "C" {
+void image_to_nchw_f32(void *);
+void image_to_nchw_f32_imp(const uint8_t *, const int32_t, const int32_t,
+                           const int32_t, const int32_t *, const int32_t,
+                           const float *, const float *, float *,
+                           const int32_t, const int32_t);
+}
+
+// Converts one row of pixels to the rows of the output channels, as
+// multiplier * value + bias. 'PixelSize' is a constant so that the strided
+// loads of every channel are unrolled and vectorized
+template <int32_t PixelSize>
+void pixels_to_planes_f32(const uint8_t *src, const int32_t width,
+                          const int32_t *channels, const int32_t out_channels,
+                          const float *multipliers, const float *biases,
+                          float *dst, const size_t plane_size) {
+  for (int32_t c = 0; c < out_channels; ++c) {
+    const uint8_t *s = src + channels[c];
+    float *d = dst + c * plane_size;
+    const float a = multipliers[c];
+    const float b = biases[c];
+    for (int32_t j = 0; j < width; ++j) {
+      d[j] = a * s[j * PixelSize] + b;
+    }
+  }
+}
@@ -0,0 +1,154 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "lstm.h"
+#include "common.h"
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+// Wasm interop methods
+void lstm_create_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  LstmKernel *kernel = lstm_create_f32_imp(
+      PARAM_FLOAT_PTR(data, dataIndex[1]), PARAM_FLOAT_PTR(data, dataIndex[2]),
+      PARAM_FLOAT_PTR(data, dataIndex[3]), PARAM_FLOAT_PTR(data, dataIndex[4]),
+      PARAM_INT32(data, dataIndex[5]), PARAM_INT32(data, dataIndex[6]),
+      PARAM_INT32(data, dataIndex[7]), PARAM_FLOAT(data, dataIndex[8]),
+      PARAM_BOOL(data, dataIndex[9]));
+  PARAM_INT32_PTR(data, dataIndex[10])[0] =
+      static_cast<int32_t>(reinterpret_cast<intptr_t>(kernel));
+}
+
+void lstm_run_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  lstm_run_f32_imp(
+      *reinterpret_cast<LstmKernel *>(
+          static_cast<intptr_t>(PARAM_INT32(data, dataIndex[1]))),
+      PARAM_FLOAT_PTR(data, dataIndex[2]), PARAM_INT32(data, dataIndex[3]),
+      PARAM_INT32(data, dataIndex[4]), PARAM_INT32_PTR(data, dataIndex[5]),
+      PARAM_FLOAT_PTR(data, dataIndex[6]), PARAM_FLOAT_PTR(data, dataIndex[7]),
+      PARAM_BOOL(data, dataIndex[8]), PARAM_FLOAT_PTR(data, dataIndex[9]),
+      PARAM_FLOAT_PTR(data, dataIndex[10]),
+      PARAM_FLOAT_PTR(data, dataIndex[11]));
+}
+
+// Core operator implementation
+LstmKernel *lstm_create_f32_imp(const float *W, const float *R, const float *B,
+                                const float *P, const int32_t direction,
+                                const int32_t hidden_size,
+                                const int32_t input_size, const float clip,
+                                const bool input_forget) {
+  LstmKernel *kernel = new LstmKernel();
+  recurrent_init_f32(*kernel, direction, 4, hidden_size, input_size, clip, W,
+                     R);
+  kernel->input_forget = input_forget;
+
+  // the input and recurrent biases are both added once per step
+  const int32_t gates_size = 4 * hidden_size;
+  if (B != nullptr) {
+    for (int32_t d = 0; d < kernel->num_directions; ++d) {
+      const float *b = B + 2 * d * gates_size;
+      for (int32_t j = 0; j < gates_size; ++j) {
+        kernel->bias[d * gates_size + j] = b[j] + b[gates_size + j];
+      }
+    }
+  }
+  if (P != nullptr) {
+    kernel->P.assign(P, P + kernel->num_directions * 3 * hidden_size);
+  }
+  return kernel;
+}
+
+// Gates are stored in the order of the ONNX weights: input, output, forget
+// and cell. Peephole weights are stored as input, output and forget.
+void lstm_run_f32_imp(LstmKernel &kernel, const float *X,
+                      const int32_t seq_length, const int32_t batch_size,
+                      const int32_t *sequence_lens, const float *initial_h,
+                      const float *initial_c, const bool keep_state, float *Y,
+                      float *Y_h, float *Y_c) {
+  recurrent_reset_state_f32(kernel, kernel.H, batch_size, initial_h,
+                            keep_state);
+  recurrent_reset_state_f32(kernel, kernel.C, batch_size, initial_c,
+                            keep_state);
+
+  const int32_t num_directions = kernel.num_directions;
+  const int32_t hidden_size = kernel.hidden_size;
+  const int32_t gates_size = 4 * hidden_size;
+  const float clip = kernel.clip;
+  std::fill(Y,
+            Y + static_cast<size_t>(seq_length) * num_directions * batch_size *
+                    hidden_size,
+            0.0f);
+  const int32_t max_length =
+      recurrent_max_length(sequence_lens, batch_size, seq_length);
+
+  std::vector<float> gates_x(static_cast<size_t>(seq_length) * batch_size *
+                             gates_size);
+  std::vector<float> gates(gates_size);
+  for (int32_t d = 0; d < num_directions; ++d) {
+    recurrent_project_f32(kernel, d, X, seq_length, batch_size, &gates_x[0]);
+    const bool reverse = d == 1 || kernel.reverse;
+    const float *R = &kernel.R[static_cast<size_t>(d) * hidden_size *
+                               gates_size];
+    const float *P =
+        kernel.P.empty() ? nullptr : &kernel.P[d * 3 * hidden_size];
+
+    for (int32_t s = 0; s < max_length; ++s) {
+      for (int32_t b = 0; b < batch_size; ++b) {
+        const int32_t length =
+            sequence_lens == nullptr ? seq_length
+                                     : std::min(sequence_lens[b], seq_length);
+        if (s >= length) {
+          continue;
+        }
+        const int32_t t = reverse ? length - 1 - s : s;
+        const size_t state_offset =
+            (static_cast<size_t>(d) * batch_size + b) * hidden_size;
+        float *h = &kernel.H[state_offset];
+        float *c = &kernel.C[state_offset];
+
+        // recurrent product of this batch row, immediately followed by the
+        // gate nonlinearities and the state update
+        const float *gx =
+            &gates_x[(static_cast<size_t>(t) * batch_size + b) * gates_size];
+        std::copy(gx, gx + gates_size, gates.begin());
+        recurrent_gates_f32(h, R, hidden_size, gates_size, gates_size,
+                            &gates[0]);
+
+        const float *gi = &gates[0];
+        const float *go = &gates[hidden_size];
+        const float *gf = &gates[2 * hidden_size];
+        const float *gc = &gates[3 * hidden_size];
+        for (int32_t j = 0; j < hidden_size; ++j) {
+          const float c_prev = c[j];
+          const float i = recurrent_sigmoid(recurrent_clip(
+              P == nullptr ? gi[j] : gi[j] + P[j] * c_prev, clip));
+          const float f =
+              kernel.input_forget
+                  ? 1.0f - i
+                  : recurrent_sigmoid(recurrent_clip(
+                        P == nullptr ? gf[j]
+                                     : gf[j] + P[2 * hidden_size + j] * c_prev,
+                        clip));
+          const float g = tanh(recurrent_clip(gc[j], clip));
+          const float c_next = f * c_prev + i * g;
+          const float o = recurrent_sigmoid(recurrent_clip(
+              P == nullptr ? go[j] : go[j] + P[hidden_size + j] * c_next,
+              clip));
+          c[j] = c_next;
+          h[j] = o * tanh(c_next);
+        }
+        const size_t y_row = (static_cast<size_t>(t) * num_directions + d) *
+                                 batch_size +
+                             b;
+        memcpy(Y + y_row * hidden_size, h, sizeof(float) * hidden_size);
+      }
+    }
+  }
+
+  std::copy(kernel.H.begin(), kernel.H.end(), Y_h);
+  std::copy(kernel.C.begin(), kernel.C.end(), Y_c);
+}
@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "rnn.h"
+#include <stdint.h>
+#include <vector>
+
+extern "C" {
+void lstm_create_f32(void *);
+void lstm_run_f32(void *);
+}
+
+struct LstmKernel : public RecurrentKernel {
+  bool input_forget;
+  // [num_directions, 3 * hidden_size] peephole weights, empty when unused
+  std::vector<float> P;
+  // [num_directions, batch_size, hidden_size]
+  std::vector<float> C;
+};
+
+LstmKernel *lstm_create_f32_imp(const float *, const float *, const float *,
+                                const float *, const int32_t, const int32_t,
+                                const int32_t, const float, const bool);
+void lstm_run_f32_imp(LstmKernel &, const float *, const int32_t,
+                      const int32_t, const int32_t *, const float *,
+                      const float *, const bool, float *, float *, float *);
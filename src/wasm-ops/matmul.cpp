@@ -48,28 +48,19 @@ void matmul_f32_imp(const float *input_1, const int32_t *dims_1,
     const float *input_1_traverse;
     const float *input_2_traverse;
 
-    std::vector<int32_t> dims_1_vector(rank_1);
-    for (int32_t r = 0; r < rank_1; ++r) {
-      dims_1_vector[r] = dims_1[r];
-    }
-    const std::vector<int32_t> strides_1 =
-        ShapeUtils::compute_strides(dims_1_vector);
+    const SmallShape dims_1_shape(dims_1, dims_1 + rank_1);
+    const SmallShape strides_1 = ShapeUtils::compute_strides(dims_1_shape);
 
-    std::vector<int32_t> dims_2_vector(rank_2);
-    for (int32_t r = 0; r < rank_2; ++r) {
-      dims_2_vector[r] = dims_2[r];
-    }
-    const std::vector<int32_t> strides_2 =
-        ShapeUtils::compute_strides(dims_2_vector);
+    const SmallShape dims_2_shape(dims_2, dims_2 + rank_2);
+    const SmallShape strides_2 = ShapeUtils::compute_strides(dims_2_shape);
 
-    std::vector<int32_t> broadcasted_indices =
-        std::vector<int32_t>(output_rank);
+    SmallShape broadcasted_indices(output_rank);
     broadcasted_indices[output_rank - 1] = 0;
     broadcasted_indices[output_rank - 2] = 0;
 
-    std::vector<int32_t> original_indices_1(rank_1);
+    SmallShape original_indices_1(rank_1);
     int32_t original_offset_1;
-    std::vector<int32_t> original_indices_2(rank_2);
+    SmallShape original_indices_2(rank_2);
     int32_t original_offset_2;
     int32_t offset_remainder;
 
@@ -88,7 +79,7 @@ void matmul_f32_imp(const float *input_1, const int32_t *dims_1,
       // This matrix is not 2D, so no need to find appropriate start_offset
       else {
         BroadcastUtils::broadcasted_to_original_indices(
-            broadcasted_indices, dims_1_vector, original_indices_1);
+            broadcasted_indices, dims_1_shape, original_indices_1);
         original_offset_1 =
             ShapeUtils::indices_to_offset(strides_1, original_indices_1);
         input_1_traverse = input_1 + original_offset_1;
@@ -101,7 +92,7 @@ void matmul_f32_imp(const float *input_1, const int32_t *dims_1,
       // This matrix is not 2D, so no need to find appropriate start_offset
       else {
         BroadcastUtils::broadcasted_to_original_indices(
-            broadcasted_indices, dims_2_vector, original_indices_2);
+            broadcasted_indices, dims_2_shape, original_indices_2);
         original_offset_2 =
             ShapeUtils::indices_to_offset(strides_2, original_indices_2);
         input_2_traverse = input_2 + original_offset_2;
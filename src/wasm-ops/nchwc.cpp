@@ -0,0 +1,303 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "nchwc.h"
+#include "common.h"
+#include "pool.h"
+#include <algorithm>
+#include <math.h>
+#include <vector>
+
+// the largest block of channels of the kernels without a specialization
+const int MAX_BLOCK = 64;
+
+// Wasm interop methods
+void reorder_to_nchwc_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  reorder_to_nchwc_f32_imp(
+      PARAM_FLOAT_PTR(data, dataIndex[1]), PARAM_INT32_PTR(data, dataIndex[2]),
+      PARAM_INT32(data, dataIndex[3]), PARAM_FLOAT_PTR(data, dataIndex[4]));
+}
+
+void reorder_from_nchwc_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  reorder_from_nchwc_f32_imp(
+      PARAM_FLOAT_PTR(data, dataIndex[1]), PARAM_INT32_PTR(data, dataIndex[2]),
+      PARAM_INT32(data, dataIndex[3]), PARAM_FLOAT_PTR(data, dataIndex[4]));
+}
+
+void conv_nchwc_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  conv2D_nchwc_f32_imp(
+      PARAM_FLOAT_PTR(data, dataIndex[1]), PARAM_INT32_PTR(data, dataIndex[2]),
+      PARAM_FLOAT_PTR(data, dataIndex[3]), PARAM_INT32_PTR(data, dataIndex[4]),
+      PARAM_FLOAT_PTR(data, dataIndex[5]), PARAM_FLOAT_PTR(data, dataIndex[6]),
+      PARAM_INT32_PTR(data, dataIndex[7]), PARAM_INT32_PTR(data, dataIndex[8]),
+      PARAM_INT32_PTR(data, dataIndex[9]),
+      PARAM_INT32_PTR(data, dataIndex[10]));
+}
+
+// Core operator implementations
+void reorder_to_nchwc_f32_imp(float *X, int *X_shape, int block, float *Y) {
+  const int batch_size = X_shape[0];
+  const int channels = X_shape[1];
+  const int image_size = X_shape[2] * X_shape[3];
+  const int blocks = (channels + block - 1) / block;
+
+  for (int n = 0; n < batch_size; ++n) {
+    for (int cb = 0; cb < blocks; ++cb) {
+      float *y = Y + (n * blocks + cb) * image_size * block;
+      const int block_channels = std::min(block, channels - cb * block);
+      // the padding channels are zeros
+      std::fill(y, y + image_size * block, 0.0f);
+      for (int c = 0; c < block_channels; ++c) {
+        const float *x = X + (n * channels + cb * block + c) * image_size;
+        for (int i = 0; i < image_size; ++i) {
+          y[i * block + c] = x[i];
+        }
+      }
+    }
+  }
+}
+
+void reorder_from_nchwc_f32_imp(float *X, int *X_shape, int channels,
+                                float *Y) {
+  const int batch_size = X_shape[0];
+  const int blocks = X_shape[1];
+  const int image_size = X_shape[2] * X_shape[3];
+  const int block = X_shape[4];
+
+  for (int n = 0; n < batch_size; ++n) {
+    for (int c = 0; c < channels; ++c) {
+      const float *x =
+          X + (n * blocks + c / block) * image_size * block + c % block;
+      float *y = Y + (n * channels + c) * image_size;
+      for (int i = 0; i < image_size; ++i) {
+        y[i] = x[i * block];
+      }
+    }
+  }
+}
+
+// BLOCK is the number of channels per block, or 0 for a block of any size
+template <int BLOCK>
+void conv2D_nchwc_f32(int block_size, float *X, int *X_shape,
+                      const float *packed, const float *bias, float *Y,
+                      int *Y_shape, int *kernel_shape, int *dilations,
+                      int *pads, int *strides) {
+  const int block = BLOCK > 0 ? BLOCK : block_size;
+  const int batch_size = X_shape[0];
+  const int input_blocks = X_shape[1];
+  const int input_height = X_shape[2];
+  const int input_width = X_shape[3];
+  const int output_blocks = Y_shape[1];
+  const int output_height = Y_shape[2];
+  const int output_width = Y_shape[3];
+  const int kernel_height = kernel_shape[0];
+  const int kernel_width = kernel_shape[1];
+  const int input_block_size = input_height * input_width * block;
+  const int weights_per_block = kernel_height * kernel_width * block * block;
+
+  float acc[BLOCK > 0 ? BLOCK : MAX_BLOCK];
+  for (int n = 0; n < batch_size; ++n) {
+    for (int ob = 0; ob < output_blocks; ++ob) {
+      for (int oh = 0; oh < output_height; ++oh) {
+        for (int ow = 0; ow < output_width; ++ow) {
+          for (int oc = 0; oc < block; ++oc) {
+            acc[oc] = bias[ob * block + oc];
+          }
+          for (int ib = 0; ib < input_blocks; ++ib) {
+            const float *x = X + (n * input_blocks + ib) * input_block_size;
+            const float *w =
+                packed + (ob * input_blocks + ib) * weights_per_block;
+            for (int kh = 0; kh < kernel_height; ++kh) {
+              const int ih = oh * strides[0] - pads[0] + kh * dilations[0];
+              if (ih < 0 || ih >= input_height) {
+                continue;
+              }
+              for (int kw = 0; kw < kernel_width; ++kw) {
+                const int iw = ow * strides[1] - pads[1] + kw * dilations[1];
+                if (iw < 0 || iw >= input_width) {
+                  continue;
+                }
+                const float *xp = x + (ih * input_width + iw) * block;
+                const float *wp = w + (kh * kernel_width + kw) * block * block;
+                for (int ic = 0; ic < block; ++ic) {
+                  const float xv = xp[ic];
+                  for (int oc = 0; oc < block; ++oc) {
+                    acc[oc] += xv * wp[ic * block + oc];
+                  }
+                }
+              }
+            }
+          }
+          float *y = Y + (((n * output_blocks + ob) * output_height + oh) *
+                              output_width +
+                          ow) *
+                             block;
+          for (int oc = 0; oc < block; ++oc) {
+            y[oc] = acc[oc];
+          }
+        }
+      }
+    }
+  }
+}
+
+// W holds the weights of dims W_shape [M, C, kH, kW], packed in blocks
+// [ceil(M / c), ceil(C / c), kH, kW, c (input channel), c (output channel)]
+// padded with zeros, so that the padding channels of the input do not
+// contribute to the output. they are packed once by the caller
+void conv2D_nchwc_f32_imp(float *X, int *X_shape, float *W, int *W_shape,
+                          float *B, float *Y, int *Y_shape, int *dilations,
+                          int *pads, int *strides) {
+  const int block = X_shape[4];
+  const int filters = W_shape[0];
+  const int output_blocks = Y_shape[1];
+  int kernel_shape[] = {W_shape[2], W_shape[3]};
+
+  std::vector<float> bias(output_blocks * block, 0.0f);
+  if (B != nullptr) {
+    std::copy(B, B + filters, bias.begin());
+  }
+
+  switch (block) {
+  case 4:
+    conv2D_nchwc_f32<4>(block, X, X_shape, W, bias.data(), Y, Y_shape,
+                        kernel_shape, dilations, pads, strides);
+    break;
+  case 8:
+    conv2D_nchwc_f32<8>(block, X, X_shape, W, bias.data(), Y, Y_shape,
+                        kernel_shape, dilations, pads, strides);
+    break;
+  case 16:
+    conv2D_nchwc_f32<16>(block, X, X_shape, W, bias.data(), Y, Y_shape,
+                         kernel_shape, dilations, pads, strides);
+    break;
+  default:
+    // the generic kernel accumulates a block in an array of MAX_BLOCK values
+    if (block < 1 || block > MAX_BLOCK) {
+      throw "Unsupported channel block size";
+    }
+    conv2D_nchwc_f32<0>(block, X, X_shape, W, bias.data(), Y, Y_shape,
+                        kernel_shape, dilations, pads, strides);
+  }
+}
+
+// Pool2D implementation on blocked tensors
+// isGlobalPool - true if GlobalMaxPool or GlobalAveragePool, false otherwise
+template <typename PoolType>
+void pool2D_nchwc_f32(bool isGlobalPool, float *X, int *X_shape, float *Y,
+                      int *Y_shape, int *kernel_shape, int *pads, int *strides,
+                      bool count_include_pad) {
+  const int planes = X_shape[0] * X_shape[1];
+  const int height = X_shape[2];
+  const int width = X_shape[3];
+  const int block = X_shape[4];
+  const int pooled_height = Y_shape[2];
+  const int pooled_width = Y_shape[3];
+  const int stride_h = isGlobalPool ? 1 : strides[0];
+  const int stride_w = isGlobalPool ? 1 : strides[1];
+
+  std::vector<float> acc(block);
+  for (int p = 0; p < planes; ++p) {
+    for (int ph = 0; ph < pooled_height; ++ph) {
+      int hstart = ph * stride_h - pads[0];
+      int hend = std::min(hstart + kernel_shape[0], height);
+      hstart = std::max(hstart, 0);
+      for (int pw = 0; pw < pooled_width; ++pw) {
+        int wstart = pw * stride_w - pads[1];
+        int wend = std::min(wstart + kernel_shape[1], width);
+        wstart = std::max(wstart, 0);
+        std::fill(acc.begin(), acc.end(), PoolType::Initialize());
+        for (int h = hstart; h < hend; ++h) {
+          for (int w = wstart; w < wend; ++w) {
+            const float *x = X + (h * width + w) * block;
+            for (int c = 0; c < block; ++c) {
+              PoolType::Process(x[c], acc[c]);
+            }
+          }
+        }
+        const int size = count_include_pad
+                             ? kernel_shape[0] * kernel_shape[1]
+                             : (hend - hstart) * (wend - wstart);
+        float *y = Y + (ph * pooled_width + pw) * block;
+        for (int c = 0; c < block; ++c) {
+          PoolType::Finalize(size, acc[c]);
+          y[c] = acc[c];
+        }
+      }
+    }
+    // Do offset.
+    X += height * width * block;
+    Y += pooled_height * pooled_width * block;
+  }
+}
+
+void average_pool_nchwc_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  pool2D_nchwc_f32<AveragePool>(
+      PARAM_BOOL(data, dataIndex[1]), PARAM_FLOAT_PTR(data, dataIndex[2]),
+      PARAM_INT32_PTR(data, dataIndex[3]), PARAM_FLOAT_PTR(data, dataIndex[4]),
+      PARAM_INT32_PTR(data, dataIndex[5]), PARAM_INT32_PTR(data, dataIndex[6]),
+      PARAM_INT32_PTR(data, dataIndex[7]), PARAM_INT32_PTR(data, dataIndex[8]),
+      PARAM_BOOL(data, dataIndex[9]));
+}
+
+void max_pool_nchwc_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  pool2D_nchwc_f32<MaxPool>(
+      PARAM_BOOL(data, dataIndex[1]), PARAM_FLOAT_PTR(data, dataIndex[2]),
+      PARAM_INT32_PTR(data, dataIndex[3]), PARAM_FLOAT_PTR(data, dataIndex[4]),
+      PARAM_INT32_PTR(data, dataIndex[5]), PARAM_INT32_PTR(data, dataIndex[6]),
+      PARAM_INT32_PTR(data, dataIndex[7]), PARAM_INT32_PTR(data, dataIndex[8]),
+      PARAM_BOOL(data, dataIndex[9]));
+}
+
+void batch_normalization_nchwc_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  batch_normalization_nchwc_f32_imp(
+      PARAM_FLOAT_PTR(data, dataIndex[1]), PARAM_INT32_PTR(data, dataIndex[2]),
+      PARAM_INT32(data, dataIndex[3]), PARAM_FLOAT_PTR(data, dataIndex[4]),
+      PARAM_FLOAT_PTR(data, dataIndex[5]), PARAM_FLOAT_PTR(data, dataIndex[6]),
+      PARAM_FLOAT_PTR(data, dataIndex[7]), PARAM_FLOAT(data, dataIndex[8]),
+      PARAM_FLOAT_PTR(data, dataIndex[9]));
+}
+
+void batch_normalization_nchwc_f32_imp(float *X, int *X_shape, int channels,
+                                       float *scale, float *bias, float *mean,
+                                       float *variance, float epsilon,
+                                       float *Y) {
+  const int batch_size = X_shape[0];
+  const int blocks = X_shape[1];
+  const int image_size = X_shape[2] * X_shape[3];
+  const int block = X_shape[4];
+
+  // y = x * a + b for every channel. the padding channels are zeros
+  std::vector<float> a(blocks * block, 0.0f);
+  std::vector<float> b(blocks * block, 0.0f);
+  for (int c = 0; c < channels; ++c) {
+    a[c] = scale[c] / sqrt(variance[c] + epsilon);
+    b[c] = bias[c] - mean[c] * a[c];
+  }
+
+  for (int n = 0; n < batch_size; ++n) {
+    for (int cb = 0; cb < blocks; ++cb) {
+      const float *ap = a.data() + cb * block;
+      const float *bp = b.data() + cb * block;
+      for (int i = 0; i < image_size; ++i) {
+        for (int c = 0; c < block; ++c) {
+          Y[c] = X[c] * ap[c] + bp[c];
+        }
+        X += block;
+        Y += block;
+      }
+    }
+  }
+}
@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <stdint.h>
+
+// The blocked NCHWc layout [N, ceil(C / c), H, W, c] groups the channels of
+// every pixel in blocks of c contiguous values, so that the kernels below
+// process a whole block of channels in their innermost loop. The channels
+// padding the last block hold unspecified (but finite) values.
+
+extern "C" {
+void reorder_to_nchwc_f32(void *);
+void reorder_from_nchwc_f32(void *);
+void conv_nchwc_f32(void *);
+void average_pool_nchwc_f32(void *);
+void max_pool_nchwc_f32(void *);
+void batch_normalization_nchwc_f32(void *);
+
+void reorder_to_nchwc_f32_imp(float *, int32_t *, int32_t, float *);
+void reorder_from_nchwc_f32_imp(float *, int32_t *, int32_t, float *);
+void conv2D_nchwc_f32_imp(float *, int32_t *, float *, int32_t *, float *,
+                          float *, int32_t *, int32_t *, int32_t *, int32_t *);
+void batch_normalization_nchwc_f32_imp(float *, int32_t *, int32_t, float *,
+                                       float *, float *, float *, float,
+                                       float *);
+}
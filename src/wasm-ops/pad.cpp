@@ -0,0 +1,120 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "pad.h"
+#include "common.h"
+#include "utils/small_shape.h"
+#include <algorithm>
+#include <string.h>
+
+// Wasm interop method
+void pad_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  pad_f32_imp(
+      PARAM_FLOAT_PTR(data, dataIndex[1]), PARAM_INT32_PTR(data, dataIndex[2]),
+      PARAM_INT32(data, dataIndex[3]), PARAM_FLOAT_PTR(data, dataIndex[4]),
+      PARAM_INT32_PTR(data, dataIndex[5]), PARAM_INT32_PTR(data, dataIndex[6]),
+      PARAM_INT32(data, dataIndex[7]), PARAM_FLOAT(data, dataIndex[8]));
+}
+
+// Maps an output coordinate along one axis to the input coordinate it reads
+// from. Returns -1 if the coordinate is filled with the constant value.
+int32_t pad_source_index(const int32_t output_index, const int32_t pad_begin,
+                         const int32_t size, const int32_t mode) {
+  int32_t i = output_index - pad_begin;
+  if (i >= 0 && i < size) {
+    return i;
+  }
+  switch (mode) {
+  case PAD_REFLECT: {
+    if (size == 1) {
+      return 0;
+    }
+    // reflection does not repeat the edge, so the pattern has period
+    // 2 * (size - 1)
+    const int32_t period = 2 * (size - 1);
+    i %= period;
+    if (i < 0) {
+      i += period;
+    }
+    return i < size ? i : period - i;
+  }
+  case PAD_EDGE:
+    return i < 0 ? 0 : size - 1;
+  default:
+    return -1;
+  }
+}
+
+// Core operator implementation
+// 'pads' is in the ONNX format [x1_begin, x2_begin, ..., x1_end, x2_end, ...]
+void pad_f32_imp(const float *X, const int32_t *X_dims, const int32_t rank,
+                 float *Y, const int32_t *Y_dims, const int32_t *pads,
+                 const int32_t mode, const float value) {
+  size_t output_size = 1;
+  for (int32_t i = 0; i < rank; ++i) {
+    output_size *= Y_dims[i];
+  }
+  if (output_size == 0) {
+    return;
+  }
+  if (rank == 0) {
+    Y[0] = X[0];
+    return;
+  }
+
+  SmallShape strides(rank);
+  strides[rank - 1] = 1;
+  for (int32_t i = rank - 2; i >= 0; --i) {
+    strides[i] = strides[i + 1] * X_dims[i + 1];
+  }
+
+  // every output row is [left padding | copy of an input row | right padding]
+  const int32_t inner = rank - 1;
+  const int32_t width = Y_dims[inner];
+  const int32_t left = std::min(std::max(pads[inner], 0), width);
+  const int32_t begin = std::max(-pads[inner], 0);
+  const int32_t middle =
+      std::max(std::min(X_dims[inner] - begin, width - left), 0);
+
+  SmallShape index(inner, 0);
+  float *row = Y;
+  for (size_t n = 0; n < output_size / width; ++n, row += width) {
+    bool inside = true;
+    size_t src_offset = 0;
+    for (int32_t j = 0; j < inner; ++j) {
+      const int32_t source =
+          pad_source_index(index[j], pads[j], X_dims[j], mode);
+      if (source < 0) {
+        inside = false;
+        break;
+      }
+      src_offset += source * strides[j];
+    }
+
+    if (!inside) {
+      std::fill(row, row + width, value);
+    } else {
+      const float *src = X + src_offset;
+      for (int32_t c = 0; c < left; ++c) {
+        const int32_t column =
+            pad_source_index(c, pads[inner], X_dims[inner], mode);
+        row[c] = column < 0 ? value : src[column];
+      }
+      memcpy(row + left, src + begin, sizeof(float) * middle);
+      for (int32_t c = left + middle; c < width; ++c) {
+        const int32_t column =
+            pad_source_index(c, pads[inner], X_dims[inner], mode);
+        row[c] = column < 0 ? value : src[column];
+      }
+    }
+
+    for (int32_t j = inner - 1; j >= 0; --j) {
+      if (++index[j] < Y_dims[j]) {
+        break;
+      }
+      index[j] = 0;
+    }
+  }
+}
@@ -0,0 +1,15 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <stdint.h>
+
+extern "C" {
+void pad_f32(void *);
+void pad_f32_imp(const float *, const int32_t *, const int32_t, float *,
+                 const int32_t *, const int32_t *, const int32_t, const float);
+}
+
+// Pad modes, must match the values passed by the Wasm backend
+enum PadMode { PAD_CONSTANT = 0, PAD_REFLECT = 1, PAD_EDGE = 2 };
@@ -4,85 +4,107 @@
 #include "pool.h"
 #include "common.h"
 
-// Wasm interop method
-void average_pool_f32(void *data) {
-  uint32_t *dataIndex = static_cast<uint32_t *>(data);
-  uint32_t const argc = dataIndex[0];
-  uint32_t pool_size = PARAM_INT32(data, dataIndex[1]);
+// The pooling kernels instantiated for the most common square kernels and
+// strides, so that their loops have a fixed number of iterations. The table
+// ends with an empty entry, and the other configurations run the generic
+// kernels. Defining WASM_NO_KERNEL_SPECIALIZATIONS leaves the tables empty, to
+// measure the code size of the specializations (see docs/development.md)
+struct PoolSpecialization {
+  int kernel;
+  int stride;
+  PoolFunction average_pool;
+  PoolFunction max_pool;
+};
 
-  switch (pool_size) {
-  case 1:
-    pool1D_f32<AveragePool>(
-        PARAM_BOOL(data, dataIndex[2]), PARAM_FLOAT_PTR(data, dataIndex[3]),
-        PARAM_INT32_PTR(data, dataIndex[4]),
-        PARAM_FLOAT_PTR(data, dataIndex[5]),
-        PARAM_INT32_PTR(data, dataIndex[6]),
-        PARAM_INT32_PTR(data, dataIndex[7]),
-        PARAM_INT32_PTR(data, dataIndex[8]),
-        PARAM_INT32_PTR(data, dataIndex[9]), PARAM_BOOL(data, dataIndex[10]));
-    break;
-  case 2:
-    pool2D_f32<AveragePool>(
-        PARAM_BOOL(data, dataIndex[2]), PARAM_FLOAT_PTR(data, dataIndex[3]),
-        PARAM_INT32_PTR(data, dataIndex[4]),
-        PARAM_FLOAT_PTR(data, dataIndex[5]),
-        PARAM_INT32_PTR(data, dataIndex[6]),
-        PARAM_INT32_PTR(data, dataIndex[7]),
-        PARAM_INT32_PTR(data, dataIndex[8]),
-        PARAM_INT32_PTR(data, dataIndex[9]), PARAM_BOOL(data, dataIndex[10]));
-    break;
-  case 3:
-    pool3D_f32<AveragePool>(
-        PARAM_BOOL(data, dataIndex[2]), PARAM_FLOAT_PTR(data, dataIndex[3]),
-        PARAM_INT32_PTR(data, dataIndex[4]),
-        PARAM_FLOAT_PTR(data, dataIndex[5]),
-        PARAM_INT32_PTR(data, dataIndex[6]),
-        PARAM_INT32_PTR(data, dataIndex[7]),
-        PARAM_INT32_PTR(data, dataIndex[8]),
-        PARAM_INT32_PTR(data, dataIndex[9]), PARAM_BOOL(data, dataIndex[10]));
-    break;
-  default:
-    throw "Unsupported pooling size";
+constexpr PoolSpecialization pool2D_specializations[] = {
+#ifndef WASM_NO_KERNEL_SPECIALIZATIONS
+    {2, 2, pool2D_f32<AveragePool, 2, 2>, pool2D_f32<MaxPool, 2, 2>},
+    {3, 1, pool2D_f32<AveragePool, 3, 1>, pool2D_f32<MaxPool, 3, 1>},
+    {3, 2, pool2D_f32<AveragePool, 3, 2>, pool2D_f32<MaxPool, 3, 2>},
+    {5, 1, pool2D_f32<AveragePool, 5, 1>, pool2D_f32<MaxPool, 5, 1>},
+#endif
+    {0, 0, nullptr, nullptr}};
+
+constexpr PoolSpecialization pool3D_specializations[] = {
+#ifndef WASM_NO_KERNEL_SPECIALIZATIONS
+    {2, 2, pool3D_f32<AveragePool, 2, 2>, pool3D_f32<MaxPool, 2, 2>},
+    {3, 1, pool3D_f32<AveragePool, 3, 1>, pool3D_f32<MaxPool, 3, 1>},
+    {3, 2, pool3D_f32<AveragePool, 3, 2>, pool3D_f32<MaxPool, 3, 2>},
+#endif
+    {0, 0, nullptr, nullptr}};
+
+// Find the specialization of a pooling operation with the same kernel size
+// and stride along every axis, or nullptr
+const PoolSpecialization *
+find_pool_specialization(const PoolSpecialization *specializations, int rank,
+                         bool isGlobalPool, const int *kernel_shape,
+                         const int *strides) {
+  if (isGlobalPool) {
+    return nullptr;
+  }
+  for (int i = 1; i < rank; ++i) {
+    if (kernel_shape[i] != kernel_shape[0] || strides[i] != strides[0]) {
+      return nullptr;
+    }
   }
+  for (auto s = specializations; s->average_pool != nullptr; ++s) {
+    if (s->kernel == kernel_shape[0] && s->stride == strides[0]) {
+      return s;
+    }
+  }
+  return nullptr;
+}
+
+template <typename PoolType>
+PoolFunction get_pool_function(const PoolSpecialization *s);
+template <>
+PoolFunction get_pool_function<AveragePool>(const PoolSpecialization *s) {
+  return s->average_pool;
+}
+template <>
+PoolFunction get_pool_function<MaxPool>(const PoolSpecialization *s) {
+  return s->max_pool;
 }
 
-void max_pool_f32(void *data) {
+template <typename PoolType> void pool_f32(void *data) {
   uint32_t *dataIndex = static_cast<uint32_t *>(data);
   uint32_t const argc = dataIndex[0];
   uint32_t pool_size = PARAM_INT32(data, dataIndex[1]);
+  bool isGlobalPool = PARAM_BOOL(data, dataIndex[2]);
+  int *kernel_shape = PARAM_INT32_PTR(data, dataIndex[7]);
+  int *strides = PARAM_INT32_PTR(data, dataIndex[9]);
 
+  PoolFunction pool = nullptr;
+  const PoolSpecialization *specialization = nullptr;
   switch (pool_size) {
   case 1:
-    pool1D_f32<MaxPool>(
-        PARAM_BOOL(data, dataIndex[2]), PARAM_FLOAT_PTR(data, dataIndex[3]),
-        PARAM_INT32_PTR(data, dataIndex[4]),
-        PARAM_FLOAT_PTR(data, dataIndex[5]),
-        PARAM_INT32_PTR(data, dataIndex[6]),
-        PARAM_INT32_PTR(data, dataIndex[7]),
-        PARAM_INT32_PTR(data, dataIndex[8]),
-        PARAM_INT32_PTR(data, dataIndex[9]), PARAM_BOOL(data, dataIndex[10]));
+    pool = pool1D_f32<PoolType>;
     break;
   case 2:
-    pool2D_f32<MaxPool>(
-        PARAM_BOOL(data, dataIndex[2]), PARAM_FLOAT_PTR(data, dataIndex[3]),
-        PARAM_INT32_PTR(data, dataIndex[4]),
-        PARAM_FLOAT_PTR(data, dataIndex[5]),
-        PARAM_INT32_PTR(data, dataIndex[6]),
-        PARAM_INT32_PTR(data, dataIndex[7]),
-        PARAM_INT32_PTR(data, dataIndex[8]),
-        PARAM_INT32_PTR(data, dataIndex[9]), PARAM_BOOL(data, dataIndex[10]));
+    specialization = find_pool_specialization(
+        pool2D_specializations, 2, isGlobalPool, kernel_shape, strides);
+    pool = pool2D_f32<PoolType>;
     break;
   case 3:
-    pool3D_f32<MaxPool>(
-        PARAM_BOOL(data, dataIndex[2]), PARAM_FLOAT_PTR(data, dataIndex[3]),
-        PARAM_INT32_PTR(data, dataIndex[4]),
-        PARAM_FLOAT_PTR(data, dataIndex[5]),
-        PARAM_INT32_PTR(data, dataIndex[6]),
-        PARAM_INT32_PTR(data, dataIndex[7]),
-        PARAM_INT32_PTR(data, dataIndex[8]),
-        PARAM_INT32_PTR(data, dataIndex[9]), PARAM_BOOL(data, dataIndex[10]));
+    specialization = find_pool_specialization(
+        pool3D_specializations, 3, isGlobalPool, kernel_shape, strides);
+    pool = pool3D_f32<PoolType>;
     break;
   default:
     throw "Unsupported pooling size";
   }
+  if (specialization != nullptr) {
+    pool = get_pool_function<PoolType>(specialization);
+  }
+
+  pool(isGlobalPool, PARAM_FLOAT_PTR(data, dataIndex[3]),
+       PARAM_INT32_PTR(data, dataIndex[4]), PARAM_FLOAT_PTR(data, dataIndex[5]),
+       PARAM_INT32_PTR(data, dataIndex[6]), kernel_shape,
+       PARAM_INT32_PTR(data, dataIndex[8]), strides,
+       PARAM_BOOL(data, dataIndex[10]));
 }
+
+// Wasm interop method
+void average_pool_f32(void *data) { pool_f32<AveragePool>(data); }
+
+void max_pool_f32(void *data) { pool_f32<MaxPool>(data); }
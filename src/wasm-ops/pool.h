@@ -51,7 +51,10 @@ void pool1D_f32(bool isGlobalPool, float *X, int *X_shape, float *Y,
 
 // Pool2D implementation
 // isGlobalPool - true if GlobalMaxPool or GlobalAveragePool, false otherwise
-template <typename PoolType>
+// KERNEL, STRIDE - the size of a square kernel and the strides along both
+// axes, if known at compile time (see pool2D_specializations in pool.cpp), or
+// 0 to read them from kernel_shape and strides
+template <typename PoolType, int KERNEL = 0, int STRIDE = 0>
 void pool2D_f32(bool isGlobalPool, float *X, int *X_shape, float *Y,
                 int *Y_shape, int *kernel_shape, int *pads, int *strides,
                 bool count_include_pad) {
@@ -61,29 +64,42 @@ void pool2D_f32(bool isGlobalPool, float *X, int *X_shape, float *Y,
   int width = X_shape[3];
   int pooled_height = Y_shape[2];
   int pooled_width = Y_shape[3];
-  int stride_h = isGlobalPool ? 1 : strides[0];
-  int stride_w = isGlobalPool ? 1 : strides[1];
+  const int kernel_h = KERNEL > 0 ? KERNEL : kernel_shape[0];
+  const int kernel_w = KERNEL > 0 ? KERNEL : kernel_shape[1];
+  const int stride_h = STRIDE > 0 ? STRIDE : isGlobalPool ? 1 : strides[0];
+  const int stride_w = STRIDE > 0 ? STRIDE : isGlobalPool ? 1 : strides[1];
 
   for (int n = 0; n < batch_size; ++n) {
     for (int c = 0; c < channels; ++c) {
       for (int ph = 0; ph < pooled_height; ++ph) {
         int hstart = ph * stride_h - pads[0];
-        int hend = std::min(hstart + kernel_shape[0], height);
+        int hend = std::min(hstart + kernel_h, height);
         hstart = std::max(hstart, 0);
         for (int pw = 0; pw < pooled_width; ++pw) {
           int wstart = pw * stride_w - pads[1];
-          int wend = std::min(wstart + kernel_shape[1], width);
+          int wend = std::min(wstart + kernel_w, width);
           wstart = std::max(wstart, 0);
           const int pool_index = ph * pooled_width + pw;
           float Yh = PoolType::Initialize();
-          for (int h = hstart; h < hend; ++h) {
-            for (int w = wstart; w < wend; ++w) {
-              const int input_index = h * width + w;
-              PoolType::Process(X[input_index], Yh);
+          if (hend - hstart == kernel_h && wend - wstart == kernel_w) {
+            // the window is inside the image, so the loops have a fixed
+            // number of iterations when the kernel is known at compile time
+            const float *x = X + hstart * width + wstart;
+            for (int h = 0; h < kernel_h; ++h) {
+              for (int w = 0; w < kernel_w; ++w) {
+                PoolType::Process(x[h * width + w], Yh);
+              }
+            }
+          } else {
+            for (int h = hstart; h < hend; ++h) {
+              for (int w = wstart; w < wend; ++w) {
+                const int input_index = h * width + w;
+                PoolType::Process(X[input_index], Yh);
+              }
             }
           }
           if (count_include_pad) {
-            PoolType::Finalize(kernel_shape[0] * kernel_shape[1], Yh);
+            PoolType::Finalize(kernel_h * kernel_w, Yh);
           } else {
             PoolType::Finalize((hend - hstart) * (wend - wstart), Yh);
           }
@@ -99,7 +115,10 @@ void pool2D_f32(bool isGlobalPool, float *X, int *X_shape, float *Y,
 
 // Pool3D - implementation
 // isGlobalPool - true if GlobalMaxPool or GlobalAveragePool, false otherwise
-template <typename PoolType>
+// KERNEL, STRIDE - the size of a cubic kernel and the strides along all the
+// axes, if known at compile time (see pool3D_specializations in pool.cpp), or
+// 0 to read them from kernel_shape and strides
+template <typename PoolType, int KERNEL = 0, int STRIDE = 0>
 void pool3D_f32(bool isGlobalPool, float *X, int *X_shape, float *Y,
                 int *Y_shape, int *kernel_shape, int *pads, int *strides,
                 bool count_include_pad) {
@@ -111,38 +130,56 @@ void pool3D_f32(bool isGlobalPool, float *X, int *X_shape, float *Y,
   int pooled_height = Y_shape[2];
   int pooled_width = Y_shape[3];
   int pooled_depth = Y_shape[4];
-  int stride_h = isGlobalPool ? 1 : strides[0];
-  int stride_w = isGlobalPool ? 1 : strides[1];
-  int stride_d = isGlobalPool ? 1 : strides[2];
+  const int kernel_h = KERNEL > 0 ? KERNEL : kernel_shape[0];
+  const int kernel_w = KERNEL > 0 ? KERNEL : kernel_shape[1];
+  const int kernel_d = KERNEL > 0 ? KERNEL : kernel_shape[2];
+  const int stride_h = STRIDE > 0 ? STRIDE : isGlobalPool ? 1 : strides[0];
+  const int stride_w = STRIDE > 0 ? STRIDE : isGlobalPool ? 1 : strides[1];
+  const int stride_d = STRIDE > 0 ? STRIDE : isGlobalPool ? 1 : strides[2];
 
   for (int n = 0; n < batch_size; ++n) {
     for (int c = 0; c < channels; ++c) {
       for (int ph = 0; ph < pooled_height; ++ph) {
         int hstart = ph * stride_h - pads[0];
-        int hend = std::min(hstart + kernel_shape[0], height);
+        int hend = std::min(hstart + kernel_h, height);
         hstart = std::max(hstart, 0);
         for (int pw = 0; pw < pooled_width; ++pw) {
           int wstart = pw * stride_w - pads[1];
-          int wend = std::min(wstart + kernel_shape[1], width);
+          int wend = std::min(wstart + kernel_w, width);
           wstart = std::max(wstart, 0);
           for (int pd = 0; pd < pooled_depth; ++pd) {
             int dstart = pd * stride_d - pads[2];
-            int dend = std::min(dstart + kernel_shape[2], depth);
+            int dend = std::min(dstart + kernel_d, depth);
             dstart = std::max(dstart, 0);
             const int pool_index =
                 ph * pooled_width * pooled_depth + pw * pooled_depth + pd;
             float Yh = PoolType::Initialize();
-            for (int h = hstart; h < hend; ++h) {
-              for (int w = wstart; w < wend; ++w) {
-                for (int d = dstart; d < dend; ++d) {
-                  const int input_index = h * width * depth + w * depth + d;
-                  PoolType::Process(X[input_index], Yh);
+            if (hend - hstart == kernel_h && wend - wstart == kernel_w &&
+                dend - dstart == kernel_d) {
+              // the window is inside the image, so the loops have a fixed
+              // number of iterations when the kernel is known at compile time
+              const float *x = X + hstart * width * depth + wstart * depth +
+                               dstart;
+              for (int h = 0; h < kernel_h; ++h) {
+                for (int w = 0; w < kernel_w; ++w) {
+                  for (int d = 0; d < kernel_d; ++d) {
+                    PoolType::Process(x[h * width * depth + w * depth + d],
+                                      Yh);
+                  }
+                }
+              }
+            } else {
+              for (int h = hstart; h < hend; ++h) {
+                for (int w = wstart; w < wend; ++w) {
+                  for (int d = dstart; d < dend; ++d) {
+                    const int input_index = h * width * depth + w * depth + d;
+                    PoolType::Process(X[input_index], Yh);
+                  }
                 }
               }
             }
             if (count_include_pad) {
-              PoolType::Finalize(
-                  kernel_shape[0] * kernel_shape[1] * kernel_shape[2], Yh);
+              PoolType::Finalize(kernel_h * kernel_w * kernel_d, Yh);
             } else {
               PoolType::Finalize(
                   (hend - hstart) * (wend - wstart) * (dend - dstart), Yh);
@@ -158,6 +195,10 @@ void pool3D_f32(bool isGlobalPool, float *X, int *X_shape, float *Y,
   }
 }
 
+// the signature of the pool2D_f32 and pool3D_f32 instantiations
+typedef void (*PoolFunction)(bool, float *, int *, float *, int *, int *,
+                             int *, int *, bool);
+
 // Core pool classes
 class AveragePool {
 public:
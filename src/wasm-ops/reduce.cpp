@@ -0,0 +1,160 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "reduce.h"
+#include "common.h"
+#include "transpose.h"
+#include "utils/small_shape.h"
+#include <math.h>
+#include <vector>
+
+template <typename ReduceType> void reduce_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  reduce_f32_imp<ReduceType>(
+      PARAM_FLOAT_PTR(data, dataIndex[1]), PARAM_INT32_PTR(data, dataIndex[2]),
+      PARAM_INT32(data, dataIndex[3]), PARAM_INT32_PTR(data, dataIndex[4]),
+      PARAM_INT32(data, dataIndex[5]), PARAM_FLOAT_PTR(data, dataIndex[6]));
+}
+
+template <typename CompareType> void arg_reduce_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  arg_reduce_f32_imp<CompareType>(
+      PARAM_FLOAT_PTR(data, dataIndex[1]), PARAM_INT32_PTR(data, dataIndex[2]),
+      PARAM_INT32(data, dataIndex[3]), PARAM_INT32(data, dataIndex[4]),
+      PARAM_INT32_PTR(data, dataIndex[5]));
+}
+
+// Wasm interop methods
+void reduce_sum_f32(void *data) { reduce_f32<ReduceSum>(data); }
+void reduce_sum_square_f32(void *data) {
+  reduce_f32<ReduceSumSquare>(data);
+}
+void reduce_mean_f32(void *data) { reduce_f32<ReduceMean>(data); }
+void reduce_max_f32(void *data) { reduce_f32<ReduceMax>(data); }
+void reduce_min_f32(void *data) { reduce_f32<ReduceMin>(data); }
+void reduce_prod_f32(void *data) { reduce_f32<ReduceProd>(data); }
+void reduce_log_sum_f32(void *data) { reduce_f32<ReduceLogSum>(data); }
+void reduce_log_sum_exp_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  reduce_log_sum_exp_f32_imp(
+      PARAM_FLOAT_PTR(data, dataIndex[1]), PARAM_INT32_PTR(data, dataIndex[2]),
+      PARAM_INT32(data, dataIndex[3]), PARAM_INT32_PTR(data, dataIndex[4]),
+      PARAM_INT32(data, dataIndex[5]), PARAM_FLOAT_PTR(data, dataIndex[6]));
+}
+void arg_max_f32(void *data) { arg_reduce_f32<ArgMaxCompare>(data); }
+void arg_min_f32(void *data) { arg_reduce_f32<ArgMinCompare>(data); }
+
+// Core operator implementation
+void reduce_plan_f32(const float *X, const int32_t *X_dims, const int32_t rank,
+                     const int32_t *axes, const int32_t num_axes,
+                     ReducePlan &plan) {
+  SmallVector<bool> reduced(rank, false);
+  for (int32_t i = 0; i < num_axes; ++i) {
+    reduced[axes[i]] = true;
+  }
+
+  // drop unit dimensions and merge adjacent axes that are either all reduced
+  // or all kept
+  SmallShape group_dims;
+  SmallVector<bool> group_reduced;
+  for (int32_t i = 0; i < rank; ++i) {
+    if (X_dims[i] == 1) {
+      continue;
+    }
+    if (!group_dims.empty() && group_reduced.back() == reduced[i]) {
+      group_dims.back() *= X_dims[i];
+    } else {
+      group_dims.push_back(X_dims[i]);
+      group_reduced.push_back(reduced[i]);
+    }
+  }
+
+  plan.X = X;
+  plan.outer = 1;
+  plan.reduce = 1;
+  plan.inner = 1;
+  int32_t num_reduced_groups = 0;
+  for (size_t k = 0; k < group_dims.size(); ++k) {
+    if (group_reduced[k]) {
+      ++num_reduced_groups;
+    }
+  }
+
+  // a single run of reduced axes maps directly onto [outer, reduce, inner]
+  if (num_reduced_groups <= 1) {
+    int32_t *current = &plan.outer;
+    for (size_t k = 0; k < group_dims.size(); ++k) {
+      if (group_reduced[k]) {
+        plan.reduce = group_dims[k];
+        current = &plan.inner;
+      } else {
+        *current *= group_dims[k];
+      }
+    }
+    return;
+  }
+
+  // otherwise move all the kept axes in front of the reduced ones, so the
+  // reduction becomes contiguous
+  SmallShape perm;
+  size_t size = 1;
+  for (size_t k = 0; k < group_dims.size(); ++k) {
+    size *= group_dims[k];
+    if (!group_reduced[k]) {
+      plan.outer *= group_dims[k];
+      perm.push_back(k);
+    }
+  }
+  for (size_t k = 0; k < group_dims.size(); ++k) {
+    if (group_reduced[k]) {
+      plan.reduce *= group_dims[k];
+      perm.push_back(k);
+    }
+  }
+  plan.scratch.resize(size);
+  transpose_f32_imp(X, group_dims.data(), group_dims.size(), perm.data(),
+                    &plan.scratch[0]);
+  plan.X = &plan.scratch[0];
+}
+
+void reduce_log_sum_exp_f32_imp(const float *X, const int32_t *X_dims,
+                                const int32_t rank, const int32_t *axes,
+                                const int32_t num_axes, float *Y) {
+  ReducePlan plan;
+  reduce_plan_f32(X, X_dims, rank, axes, num_axes, plan);
+
+  // subtract the maximum before exponentiating to avoid overflow
+  if (plan.inner == 1) {
+    for (int32_t o = 0; o < plan.outer; ++o) {
+      const float *x = plan.X + static_cast<size_t>(o) * plan.reduce;
+      const float max = reduce_contiguous_f32<ReduceMax>(x, plan.reduce);
+      float sum = 0;
+      for (int32_t r = 0; r < plan.reduce; ++r) {
+        sum += exp(x[r] - max);
+      }
+      Y[o] = max + log(sum);
+    }
+    return;
+  }
+
+  std::vector<float> partial;
+  std::vector<float> sum(plan.inner);
+  for (int32_t o = 0; o < plan.outer; ++o) {
+    const float *x = plan.X + static_cast<size_t>(o) * plan.reduce * plan.inner;
+    float *y = Y + static_cast<size_t>(o) * plan.inner;
+    reduce_rows_f32<ReduceMax>(x, plan.reduce, plan.inner, y, partial);
+    std::fill(sum.begin(), sum.end(), 0.0f);
+    for (int32_t r = 0; r < plan.reduce; ++r) {
+      const float *row = x + static_cast<size_t>(r) * plan.inner;
+      for (int32_t j = 0; j < plan.inner; ++j) {
+        sum[j] += exp(row[j] - y[j]);
+      }
+    }
+    for (int32_t j = 0; j < plan.inner; ++j) {
+      y[j] += log(sum[j]);
+    }
+  }
+}
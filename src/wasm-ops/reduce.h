@@ -0,0 +1,235 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+
+extern "C" {
+void reduce_sum_f32(void *);
+void reduce_sum_square_f32(void *);
+void reduce_mean_f32(void *);
+void reduce_max_f32(void *);
+void reduce_min_f32(void *);
+void reduce_prod_f32(void *);
+void reduce_log_sum_f32(void *);
+void reduce_log_sum_exp_f32(void *);
+void arg_max_f32(void *);
+void arg_min_f32(void *);
+}
+
+// A reduction over an arbitrary set of axes, expressed as a loop nest of
+// [outer, reduce, inner] over a buffer laid out contiguously in that order
+struct ReducePlan {
+  const float *X;
+  int32_t outer;
+  int32_t reduce;
+  int32_t inner;
+  // holds a transposed copy of the input when the reduced axes are not
+  // adjacent in memory
+  std::vector<float> scratch;
+};
+
+void reduce_plan_f32(const float *, const int32_t *, const int32_t,
+                     const int32_t *, const int32_t, ReducePlan &);
+void reduce_log_sum_exp_f32_imp(const float *, const int32_t *, const int32_t,
+                                const int32_t *, const int32_t, float *);
+
+// Number of lanes used to accumulate contiguous data, and the length below
+// which contiguous data is no longer split in halves
+const int32_t REDUCE_LANES = 4;
+const int32_t REDUCE_PAIRWISE_BLOCK = 64;
+
+// Pairwise reduction of n contiguous elements. Sums computed this way have an
+// error that grows with log(n) instead of n.
+template <typename ReduceType>
+float reduce_contiguous_f32(const float *X, const int32_t n) {
+  if (n > REDUCE_PAIRWISE_BLOCK) {
+    const int32_t half =
+        (n / 2 + REDUCE_LANES - 1) / REDUCE_LANES * REDUCE_LANES;
+    return ReduceType::Combine(reduce_contiguous_f32<ReduceType>(X, half),
+                               reduce_contiguous_f32<ReduceType>(X + half,
+                                                                 n - half));
+  }
+  float acc[REDUCE_LANES];
+  for (int32_t l = 0; l < REDUCE_LANES; ++l) {
+    acc[l] = ReduceType::Initialize();
+  }
+  int32_t i = 0;
+  for (; i + REDUCE_LANES <= n; i += REDUCE_LANES) {
+    for (int32_t l = 0; l < REDUCE_LANES; ++l) {
+      ReduceType::Process(X[i + l], acc[l]);
+    }
+  }
+  for (; i < n; ++i) {
+    ReduceType::Process(X[i], acc[0]);
+  }
+  return ReduceType::Combine(ReduceType::Combine(acc[0], acc[1]),
+                             ReduceType::Combine(acc[2], acc[3]));
+}
+
+// Reduction of 'reduce' rows of 'inner' contiguous elements each. The rows are
+// accumulated in blocks so the inner loop runs over contiguous memory and long
+// sums do not accumulate into a single running value.
+template <typename ReduceType>
+void reduce_rows_f32(const float *X, const int32_t reduce, const int32_t inner,
+                     float *Y, std::vector<float> &partial) {
+  std::fill(Y, Y + inner, ReduceType::Initialize());
+  partial.resize(inner);
+  for (int32_t r = 0; r < reduce; r += REDUCE_PAIRWISE_BLOCK) {
+    const int32_t end = std::min(r + REDUCE_PAIRWISE_BLOCK, reduce);
+    std::fill(partial.begin(), partial.end(), ReduceType::Initialize());
+    for (int32_t k = r; k < end; ++k) {
+      const float *row = X + static_cast<size_t>(k) * inner;
+      for (int32_t j = 0; j < inner; ++j) {
+        ReduceType::Process(row[j], partial[j]);
+      }
+    }
+    for (int32_t j = 0; j < inner; ++j) {
+      Y[j] = ReduceType::Combine(Y[j], partial[j]);
+    }
+  }
+}
+
+// Core reduce implementation
+template <typename ReduceType>
+void reduce_f32_imp(const float *X, const int32_t *X_dims, const int32_t rank,
+                    const int32_t *axes, const int32_t num_axes, float *Y) {
+  ReducePlan plan;
+  reduce_plan_f32(X, X_dims, rank, axes, num_axes, plan);
+
+  // the reduced axis is innermost: each output is a contiguous reduction
+  if (plan.inner == 1) {
+    for (int32_t o = 0; o < plan.outer; ++o) {
+      float result = reduce_contiguous_f32<ReduceType>(
+          plan.X + static_cast<size_t>(o) * plan.reduce, plan.reduce);
+      ReduceType::Finalize(plan.reduce, result);
+      Y[o] = result;
+    }
+    return;
+  }
+
+  // otherwise reduce whole rows at a time
+  std::vector<float> partial;
+  for (int32_t o = 0; o < plan.outer; ++o) {
+    const float *x = plan.X + static_cast<size_t>(o) * plan.reduce * plan.inner;
+    float *y = Y + static_cast<size_t>(o) * plan.inner;
+    reduce_rows_f32<ReduceType>(x, plan.reduce, plan.inner, y, partial);
+    for (int32_t j = 0; j < plan.inner; ++j) {
+      ReduceType::Finalize(plan.reduce, y[j]);
+    }
+  }
+}
+
+// Core ArgMax/ArgMin implementation. The first occurrence of the extreme
+// value wins.
+template <typename CompareType>
+void arg_reduce_f32_imp(const float *X, const int32_t *X_dims,
+                        const int32_t rank, const int32_t axis, int32_t *Y) {
+  ReducePlan plan;
+  reduce_plan_f32(X, X_dims, rank, &axis, 1, plan);
+
+  if (plan.inner == 1) {
+    for (int32_t o = 0; o < plan.outer; ++o) {
+      const float *x = plan.X + static_cast<size_t>(o) * plan.reduce;
+      float best = x[0];
+      int32_t index = 0;
+      for (int32_t r = 1; r < plan.reduce; ++r) {
+        if (CompareType::Better(x[r], best)) {
+          best = x[r];
+          index = r;
+        }
+      }
+      Y[o] = index;
+    }
+    return;
+  }
+
+  std::vector<float> best(plan.inner);
+  for (int32_t o = 0; o < plan.outer; ++o) {
+    const float *x = plan.X + static_cast<size_t>(o) * plan.reduce * plan.inner;
+    int32_t *y = Y + static_cast<size_t>(o) * plan.inner;
+    std::copy(x, x + plan.inner, best.begin());
+    std::fill(y, y + plan.inner, 0);
+    for (int32_t r = 1; r < plan.reduce; ++r) {
+      const float *row = x + static_cast<size_t>(r) * plan.inner;
+      for (int32_t j = 0; j < plan.inner; ++j) {
+        if (CompareType::Better(row[j], best[j])) {
+          best[j] = row[j];
+          y[j] = r;
+        }
+      }
+    }
+  }
+}
+
+// Core reduce classes
+class ReduceSum {
+public:
+  static float Initialize() { return 0; }
+  static void Process(const float x, float &y) { y += x; }
+  static float Combine(const float a, const float b) { return a + b; }
+  static void Finalize(const int32_t /*size*/, float & /*y*/) {}
+};
+
+class ReduceSumSquare {
+public:
+  static float Initialize() { return 0; }
+  static void Process(const float x, float &y) { y += x * x; }
+  static float Combine(const float a, const float b) { return a + b; }
+  static void Finalize(const int32_t /*size*/, float & /*y*/) {}
+};
+
+class ReduceMean {
+public:
+  static float Initialize() { return 0; }
+  static void Process(const float x, float &y) { y += x; }
+  static float Combine(const float a, const float b) { return a + b; }
+  static void Finalize(const int32_t size, float &y) { y /= size; }
+};
+
+class ReduceMax {
+public:
+  static float Initialize() { return std::numeric_limits<float>::lowest(); }
+  static void Process(const float x, float &y) { y = std::max(x, y); }
+  static float Combine(const float a, const float b) { return std::max(a, b); }
+  static void Finalize(const int32_t /*size*/, float & /*y*/) {}
+};
+
+class ReduceMin {
+public:
+  static float Initialize() { return std::numeric_limits<float>::max(); }
+  static void Process(const float x, float &y) { y = std::min(x, y); }
+  static float Combine(const float a, const float b) { return std::min(a, b); }
+  static void Finalize(const int32_t /*size*/, float & /*y*/) {}
+};
+
+class ReduceProd {
+public:
+  static float Initialize() { return 1; }
+  static void Process(const float x, float &y) { y *= x; }
+  static float Combine(const float a, const float b) { return a * b; }
+  static void Finalize(const int32_t /*size*/, float & /*y*/) {}
+};
+
+class ReduceLogSum {
+public:
+  static float Initialize() { return 0; }
+  static void Process(const float x, float &y) { y += x; }
+  static float Combine(const float a, const float b) { return a + b; }
+  static void Finalize(const int32_t /*size*/, float &y) { y = log(y); }
+};
+
+class ArgMaxCompare {
+public:
+  static bool Better(const float a, const float b) { return a > b; }
+};
+
+class ArgMinCompare {
+public:
+  static bool Better(const float a, const float b) { return a < b; }
+};
@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "rnn.h"
+#include "common.h"
+#include "gemm.h"
+#include <algorithm>
+
+// Wasm interop method
+void recurrent_release(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  delete reinterpret_cast<RecurrentKernel *>(
+      static_cast<intptr_t>(PARAM_INT32(data, dataIndex[1])));
+}
+
+// Copies the input weights and packs the recurrent weights
+void recurrent_init_f32(RecurrentKernel &kernel, const int32_t direction,
+                        const int32_t num_gates, const int32_t hidden_size,
+                        const int32_t input_size, const float clip,
+                        const float *W, const float *R) {
+  kernel.num_directions = direction == DIRECTION_BIDIRECTIONAL ? 2 : 1;
+  kernel.reverse = direction == DIRECTION_REVERSE;
+  kernel.num_gates = num_gates;
+  kernel.hidden_size = hidden_size;
+  kernel.input_size = input_size;
+  kernel.clip = clip;
+
+  const int32_t gates_size = num_gates * hidden_size;
+  kernel.W.assign(W, W + static_cast<size_t>(kernel.num_directions) *
+                             gates_size * input_size);
+  kernel.R.resize(static_cast<size_t>(kernel.num_directions) * gates_size *
+                  hidden_size);
+  for (int32_t d = 0; d < kernel.num_directions; ++d) {
+    const float *src = R + static_cast<size_t>(d) * gates_size * hidden_size;
+    float *dst = &kernel.R[static_cast<size_t>(d) * gates_size * hidden_size];
+    for (int32_t j = 0; j < gates_size; ++j) {
+      for (int32_t k = 0; k < hidden_size; ++k) {
+        dst[k * gates_size + j] = src[j * hidden_size + k];
+      }
+    }
+  }
+  kernel.bias.assign(kernel.num_directions * gates_size, 0);
+}
+
+// Sets a state buffer to the given initial value. Without one, the state of
+// the previous run is kept when 'keep' is set and the batch size is unchanged,
+// otherwise it is cleared.
+void recurrent_reset_state_f32(const RecurrentKernel &kernel,
+                               std::vector<float> &state,
+                               const int32_t batch_size, const float *initial,
+                               const bool keep) {
+  const size_t size =
+      static_cast<size_t>(kernel.num_directions) * batch_size *
+      kernel.hidden_size;
+  if (initial != nullptr) {
+    state.assign(initial, initial + size);
+  } else if (!keep || state.size() != size) {
+    state.assign(size, 0);
+  }
+}
+
+// Projects the inputs of all the timesteps of one direction at once:
+// gates_x[seq_length * batch_size, num_gates * hidden_size] = X * W^T + bias
+void recurrent_project_f32(const RecurrentKernel &kernel,
+                           const int32_t direction, const float *X,
+                           const int32_t seq_length, const int32_t batch_size,
+                           float *gates_x) {
+  const int32_t rows = seq_length * batch_size;
+  const int32_t gates_size = kernel.num_gates * kernel.hidden_size;
+  gemm_f32_imp(false, true, rows, gates_size, kernel.input_size, 1.0f, X,
+               &kernel.W[static_cast<size_t>(direction) * gates_size *
+                         kernel.input_size],
+               0.0f, gates_x);
+  const float *bias = &kernel.bias[direction * gates_size];
+  for (int32_t i = 0; i < rows; ++i) {
+    float *row = gates_x + static_cast<size_t>(i) * gates_size;
+    for (int32_t j = 0; j < gates_size; ++j) {
+      row[j] += bias[j];
+    }
+  }
+}
+
+// Number of timesteps any batch row goes through
+int32_t recurrent_max_length(const int32_t *sequence_lens,
+                             const int32_t batch_size,
+                             const int32_t seq_length) {
+  if (sequence_lens == nullptr) {
+    return seq_length;
+  }
+  int32_t length = 0;
+  for (int32_t b = 0; b < batch_size; ++b) {
+    length = std::max(length, std::min(sequence_lens[b], seq_length));
+  }
+  return length;
+}
@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+
+extern "C" {
+void recurrent_release(void *);
+}
+
+enum RecurrentDirection {
+  DIRECTION_FORWARD = 0,
+  DIRECTION_REVERSE = 1,
+  DIRECTION_BIDIRECTIONAL = 2
+};
+
+// A recurrent operator instance living in the wasm heap. It owns the
+// prepacked weights and the hidden state, so consecutive runs can continue a
+// sequence without passing the weights or the state again. JS holds it as an
+// opaque handle.
+struct RecurrentKernel {
+  virtual ~RecurrentKernel() {}
+
+  int32_t num_directions;
+  bool reverse;
+  int32_t num_gates;
+  int32_t hidden_size;
+  int32_t input_size;
+  float clip;
+  // [num_directions, num_gates * hidden_size, input_size], as in the model
+  std::vector<float> W;
+  // [num_directions, hidden_size, num_gates * hidden_size]: R transposed, so
+  // the recurrent product of one batch row is a series of contiguous axpys
+  std::vector<float> R;
+  // [num_directions, num_gates * hidden_size]: input and recurrent biases
+  // that can be folded into the input projection
+  std::vector<float> bias;
+  // [num_directions, batch_size, hidden_size]
+  std::vector<float> H;
+};
+
+void recurrent_init_f32(RecurrentKernel &, const int32_t, const int32_t,
+                        const int32_t, const int32_t, const float,
+                        const float *, const float *);
+void recurrent_reset_state_f32(const RecurrentKernel &, std::vector<float> &,
+                               const int32_t, const float *, const bool);
+void recurrent_project_f32(const RecurrentKernel &, const int32_t,
+                           const float *, const int32_t, const int32_t,
+                           float *);
+int32_t recurrent_max_length(const int32_t *, const int32_t, const int32_t);
+
+// Adds h * R to the gates of one batch row, R being a [rows, cols] slice of
+// the prepacked recurrent weights
+inline void recurrent_gates_f32(const float *h, const float *R,
+                                const int32_t rows, const int32_t cols,
+                                const int32_t ld, float *gates) {
+  for (int32_t k = 0; k < rows; ++k) {
+    const float hk = h[k];
+    if (hk == 0) {
+      continue;
+    }
+    const float *r = R + static_cast<size_t>(k) * ld;
+    for (int32_t j = 0; j < cols; ++j) {
+      gates[j] += hk * r[j];
+    }
+  }
+}
+
+inline float recurrent_clip(const float x, const float clip) {
+  return clip > 0 ? (x < -clip ? -clip : (x > clip ? clip : x)) : x;
+}
+
+inline float recurrent_sigmoid(const float x) {
+  return 1.0f / (1.0f + exp(-x));
+}
@@ -0,0 +1,69 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "slice.h"
+#include "common.h"
+#include "utils/small_shape.h"
+#include <string.h>
+
+// Wasm interop method
+void slice_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  slice_f32_imp(
+      PARAM_FLOAT_PTR(data, dataIndex[1]), PARAM_INT32_PTR(data, dataIndex[2]),
+      PARAM_INT32(data, dataIndex[3]), PARAM_INT32_PTR(data, dataIndex[4]),
+      PARAM_FLOAT_PTR(data, dataIndex[5]), PARAM_INT32_PTR(data, dataIndex[6]));
+}
+
+// Core operator implementation
+// 'starts' holds one normalized start per axis, 'Y_dims' the size of the
+// slice along every axis
+void slice_f32_imp(const float *X, const int32_t *X_dims, const int32_t rank,
+                   const int32_t *starts, float *Y, const int32_t *Y_dims) {
+  size_t output_size = 1;
+  for (int32_t i = 0; i < rank; ++i) {
+    output_size *= Y_dims[i];
+  }
+  if (output_size == 0) {
+    return;
+  }
+  if (rank == 0) {
+    Y[0] = X[0];
+    return;
+  }
+
+  SmallShape strides(rank);
+  strides[rank - 1] = 1;
+  for (int32_t i = rank - 2; i >= 0; --i) {
+    strides[i] = strides[i + 1] * X_dims[i + 1];
+  }
+
+  // the trailing axes that are not sliced are copied together with the
+  // innermost sliced axis as one contiguous run
+  int32_t inner_axis = rank - 1;
+  while (inner_axis > 0 && starts[inner_axis] == 0 &&
+         Y_dims[inner_axis] == X_dims[inner_axis]) {
+    --inner_axis;
+  }
+  const size_t run =
+      Y_dims[inner_axis] * static_cast<size_t>(strides[inner_axis]);
+
+  size_t src_offset = 0;
+  for (int32_t i = 0; i < rank; ++i) {
+    src_offset += starts[i] * strides[i];
+  }
+
+  SmallShape index(inner_axis, 0);
+  for (size_t dst_offset = 0; dst_offset < output_size; dst_offset += run) {
+    memcpy(Y + dst_offset, X + src_offset, sizeof(float) * run);
+    for (int32_t j = inner_axis - 1; j >= 0; --j) {
+      src_offset += strides[j];
+      if (++index[j] < Y_dims[j]) {
+        break;
+      }
+      src_offset -= strides[j] * Y_dims[j];
+      index[j] = 0;
+    }
+  }
+}
@@ -0,0 +1,156 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "sparse-gemm.h"
+#include "common.h"
+#include <algorithm>
+
+// Wasm interop method
+void sparse_gemm_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  sparse_gemm_f32_imp(
+      PARAM_INT32(data, dataIndex[1]), PARAM_INT32(data, dataIndex[2]),
+      PARAM_INT32(data, dataIndex[3]), PARAM_FLOAT(data, dataIndex[4]),
+      PARAM_FLOAT_PTR(data, dataIndex[5]), PARAM_INT32(data, dataIndex[6]),
+      PARAM_INT32_PTR(data, dataIndex[7]), PARAM_INT32_PTR(data, dataIndex[8]),
+      PARAM_FLOAT_PTR(data, dataIndex[9]), PARAM_FLOAT(data, dataIndex[10]),
+      PARAM_FLOAT_PTR(data, dataIndex[11]));
+}
+
+// Pointwise convolution (a kernel of 1 x 1, a stride of 1, no padding and no
+// group) whose weights [M, C] are sparse
+void sparse_conv_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  const float *X = PARAM_FLOAT_PTR(data, dataIndex[1]);
+  const int32_t *X_shape = PARAM_INT32_PTR(data, dataIndex[2]);
+  const int32_t block_size = PARAM_INT32(data, dataIndex[3]);
+  const int32_t *row_pointers = PARAM_INT32_PTR(data, dataIndex[4]);
+  const int32_t *block_columns = PARAM_INT32_PTR(data, dataIndex[5]);
+  const float *values = PARAM_FLOAT_PTR(data, dataIndex[6]);
+  float *Y = PARAM_FLOAT_PTR(data, dataIndex[7]);
+  const int32_t *Y_shape = PARAM_INT32_PTR(data, dataIndex[8]);
+  const float *bias = PARAM_FLOAT_PTR(data, dataIndex[9]);
+
+  const int32_t input_num = X_shape[0];
+  const int32_t input_channels = X_shape[1];
+  const int32_t output_channels = Y_shape[1];
+  const int32_t image_size = Y_shape[2] * Y_shape[3];
+  for (int32_t i = 0; i < input_num; ++i) {
+    float *y = Y + static_cast<size_t>(i) * output_channels * image_size;
+    sparse_dense_gemm_f32_imp(
+        output_channels, image_size, block_size, row_pointers, block_columns,
+        values, X + static_cast<size_t>(i) * input_channels * image_size, y);
+    if (bias != nullptr) {
+      for (int32_t c = 0; c < output_channels; ++c, y += image_size) {
+        for (int32_t j = 0; j < image_size; ++j) {
+          y[j] += bias[c];
+        }
+      }
+    }
+  }
+}
+
+// C[M, N] = alpha * A[M, K] * S[K, N] + beta * C, S being sparse. Every row
+// of A scatters its products with the blocks of the rows of S to a row of C.
+template <int BLOCK>
+void sparse_gemm_f32_block(const int32_t M, const int32_t N, const int32_t K,
+                           const float alpha, const float *A,
+                           const int32_t *row_pointers,
+                           const int32_t *block_columns, const float *values,
+                           const float beta, float *C) {
+  for (int32_t m = 0; m < M; ++m, A += K, C += N) {
+    if (beta == 0) {
+      std::fill(C, C + N, 0.0f);
+    } else if (beta != 1) {
+      for (int32_t n = 0; n < N; ++n) {
+        C[n] *= beta;
+      }
+    }
+    for (int32_t k = 0; k < K; ++k) {
+      const float a = alpha * A[k];
+      if (a == 0) {
+        continue;
+      }
+      for (int32_t b = row_pointers[k]; b < row_pointers[k + 1]; ++b) {
+        float *c = C + block_columns[b] * BLOCK;
+        const float *v = values + b * BLOCK;
+        for (int i = 0; i < BLOCK; ++i) {
+          c[i] += a * v[i];
+        }
+      }
+    }
+  }
+}
+
+// C[M, N] = S[M, K] * B[K, N], S being sparse. Every block of a row of S adds
+// its rows of B, scaled by its values, to a row of C.
+template <int BLOCK>
+void sparse_dense_gemm_f32_block(const int32_t M, const int32_t N,
+                                 const int32_t *row_pointers,
+                                 const int32_t *block_columns,
+                                 const float *values, const float *B,
+                                 float *C) {
+  for (int32_t m = 0; m < M; ++m, C += N) {
+    std::fill(C, C + N, 0.0f);
+    for (int32_t b = row_pointers[m]; b < row_pointers[m + 1]; ++b) {
+      const float *rows = B + static_cast<size_t>(block_columns[b]) * BLOCK * N;
+      const float *v = values + b * BLOCK;
+      if (BLOCK == 4) {
+        const float *r0 = rows;
+        const float *r1 = r0 + N;
+        const float *r2 = r1 + N;
+        const float *r3 = r2 + N;
+        for (int32_t n = 0; n < N; ++n) {
+          C[n] += v[0] * r0[n] + v[1] * r1[n] + v[2] * r2[n] + v[3] * r3[n];
+        }
+      } else {
+        for (int i = 0; i < BLOCK; ++i, rows += N) {
+          for (int32_t n = 0; n < N; ++n) {
+            C[n] += v[i] * rows[n];
+          }
+        }
+      }
+    }
+  }
+}
+
+// Core operator implementation
+void sparse_gemm_f32_imp(const int32_t M, const int32_t N, const int32_t K,
+                         const float alpha, const float *A,
+                         const int32_t block_size, const int32_t *row_pointers,
+                         const int32_t *block_columns, const float *values,
+                         const float beta, float *C) {
+  switch (block_size) {
+  case 1:
+    sparse_gemm_f32_block<1>(M, N, K, alpha, A, row_pointers, block_columns,
+                             values, beta, C);
+    break;
+  case 4:
+    sparse_gemm_f32_block<4>(M, N, K, alpha, A, row_pointers, block_columns,
+                             values, beta, C);
+    break;
+  default:
+    throw "Unsupported sparse block size";
+  }
+}
+
+void sparse_dense_gemm_f32_imp(const int32_t M, const int32_t N,
+                               const int32_t block_size,
+                               const int32_t *row_pointers,
+                               const int32_t *block_columns,
+                               const float *values, const float *B, float *C) {
+  switch (block_size) {
+  case 1:
+    sparse_dense_gemm_f32_block<1>(M, N, row_pointers, block_columns, values,
+                                   B, C);
+    break;
+  case 4:
+    sparse_dense_gemm_f32_block<4>(M, N, row_pointers, block_columns, values,
+                                   B, C);
+    break;
+  default:
+    throw "Unsupported sparse block size";
+  }
+}
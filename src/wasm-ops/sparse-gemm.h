@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <stdint.h>
+
+// The sparse weights are in the block compressed sparse row format (BSR) with
+// blocks of 1 x block_size, block_size being 1 (CSR) or 4. The blocks of row r
+// are [row_pointers[r], row_pointers[r + 1]), block b starts at the column
+// block_columns[b] * block_size and its values are
+// values[b * block_size, (b + 1) * block_size).
+extern "C" {
+void sparse_gemm_f32(void *);
+void sparse_conv_f32(void *);
+
+void sparse_gemm_f32_imp(const int32_t, const int32_t, const int32_t,
+                         const float, const float *, const int32_t,
+                         const int32_t *, const int32_t *, const float *,
+                         const float, float *);
+void sparse_dense_gemm_f32_imp(const int32_t, const int32_t, const int32_t,
+                               const int32_t *, const int32_t *,
+                               const float *, const float *, float *);
+}
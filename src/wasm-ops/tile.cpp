@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "tile.h"
+#include "common.h"
+#include "utils/small_shape.h"
+#include <string.h>
+
+// Wasm interop method
+void tile_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  tile_f32_imp(
+      PARAM_FLOAT_PTR(data, dataIndex[1]), PARAM_INT32_PTR(data, dataIndex[2]),
+      PARAM_INT32(data, dataIndex[3]), PARAM_INT32_PTR(data, dataIndex[4]),
+      PARAM_FLOAT_PTR(data, dataIndex[5]));
+}
+
+// Core operator implementation
+// Also used for Expand: broadcasting a dimension of size 1 is the same as
+// repeating it.
+void tile_f32_imp(const float *X, const int32_t *X_dims, const int32_t rank,
+                  const int32_t *repeats, float *Y) {
+  size_t input_size = 1;
+  for (int32_t i = 0; i < rank; ++i) {
+    input_size *= X_dims[i];
+    if (repeats[i] == 0) {
+      return;
+    }
+  }
+  if (rank == 0) {
+    Y[0] = X[0];
+    return;
+  }
+  if (input_size == 0) {
+    return;
+  }
+
+  SmallVector<size_t> output_strides(rank);
+  output_strides[rank - 1] = 1;
+  for (int32_t i = rank - 2; i >= 0; --i) {
+    output_strides[i] =
+        output_strides[i + 1] * X_dims[i + 1] * repeats[i + 1];
+  }
+
+  // place every input row at its first position in the output and repeat it
+  // along the innermost axis
+  const int32_t width = X_dims[rank - 1];
+  SmallShape index(rank - 1, 0);
+  size_t dst_offset = 0;
+  for (size_t src_offset = 0; src_offset < input_size; src_offset += width) {
+    float *dst = Y + dst_offset;
+    memcpy(dst, X + src_offset, sizeof(float) * width);
+    for (int32_t r = 1; r < repeats[rank - 1]; ++r) {
+      memcpy(dst + r * width, dst, sizeof(float) * width);
+    }
+    for (int32_t j = rank - 2; j >= 0; --j) {
+      dst_offset += output_strides[j];
+      if (++index[j] < X_dims[j]) {
+        break;
+      }
+      dst_offset -= output_strides[j] * X_dims[j];
+      index[j] = 0;
+    }
+  }
+
+  // then, from the inside out, every filled block along an axis is a
+  // contiguous span that is repeated right after itself
+  for (int32_t axis = rank - 2; axis >= 0; --axis) {
+    if (repeats[axis] == 1) {
+      continue;
+    }
+    const size_t span = X_dims[axis] * output_strides[axis];
+    SmallShape outer_index(axis, 0);
+    size_t outer_count = 1;
+    for (int32_t j = 0; j < axis; ++j) {
+      outer_count *= X_dims[j];
+    }
+    size_t offset = 0;
+    for (size_t n = 0; n < outer_count; ++n) {
+      float *dst = Y + offset;
+      for (int32_t r = 1; r < repeats[axis]; ++r) {
+        memcpy(dst + r * span, dst, sizeof(float) * span);
+      }
+      for (int32_t j = axis - 1; j >= 0; --j) {
+        offset += output_strides[j];
+        if (++outer_index[j] < X_dims[j]) {
+          break;
+        }
+        offset -= output_strides[j] * X_dims[j];
+        outer_index[j] = 0;
+      }
+    }
+  }
+}
@@ -0,0 +1,141 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "transpose.h"
+#include "common.h"
+#include "utils/small_shape.h"
+#include <string.h>
+
+// Wasm interop method
+void transpose_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  transpose_f32_imp(
+      PARAM_FLOAT_PTR(data, dataIndex[1]), PARAM_INT32_PTR(data, dataIndex[2]),
+      PARAM_INT32(data, dataIndex[3]), PARAM_INT32_PTR(data, dataIndex[4]),
+      PARAM_FLOAT_PTR(data, dataIndex[5]));
+}
+
+// Core operator implementation
+void transpose_f32_imp(const float *X, const int32_t *X_dims,
+                       const int32_t rank, const int32_t *perm, float *Y) {
+  // drop unit dimensions, they do not affect the memory order
+  SmallShape squeezed_axis(rank, -1);
+  SmallShape squeezed_dims;
+  size_t size = 1;
+  for (int32_t i = 0; i < rank; ++i) {
+    size *= X_dims[i];
+    if (X_dims[i] != 1) {
+      squeezed_axis[i] = squeezed_dims.size();
+      squeezed_dims.push_back(X_dims[i]);
+    }
+  }
+  if (size == 0) {
+    return;
+  }
+  SmallShape order;
+  for (int32_t i = 0; i < rank; ++i) {
+    if (squeezed_axis[perm[i]] >= 0) {
+      order.push_back(squeezed_axis[perm[i]]);
+    }
+  }
+
+  // merge input axes that remain adjacent (and in the same order) in the
+  // output. every group is a run of input axes [group_begin, group_end)
+  SmallShape group_begin;
+  SmallShape group_end;
+  for (size_t k = 0; k < order.size(); ++k) {
+    if (k > 0 && order[k] == group_end.back()) {
+      ++group_end.back();
+    } else {
+      group_begin.push_back(order[k]);
+      group_end.push_back(order[k] + 1);
+    }
+  }
+  const int32_t r = group_begin.size();
+  if (r <= 1) {
+    memcpy(Y, X, sizeof(float) * size);
+    return;
+  }
+
+  // merged input dims and the permutation between merged axes
+  SmallShape dims(r);
+  SmallShape merged_perm(r);
+  for (int32_t k = 0; k < r; ++k) {
+    int32_t input_axis = 0;
+    for (int32_t j = 0; j < r; ++j) {
+      if (group_begin[j] < group_begin[k]) {
+        ++input_axis;
+      }
+    }
+    merged_perm[k] = input_axis;
+    int32_t dim = 1;
+    for (int32_t j = group_begin[k]; j < group_end[k]; ++j) {
+      dim *= squeezed_dims[j];
+    }
+    dims[input_axis] = dim;
+  }
+
+  SmallShape input_strides(r);
+  SmallShape output_dims(r);
+  SmallShape output_strides(r);
+  input_strides[r - 1] = 1;
+  output_strides[r - 1] = 1;
+  for (int32_t k = r - 2; k >= 0; --k) {
+    input_strides[k] = input_strides[k + 1] * dims[k + 1];
+  }
+  for (int32_t k = 0; k < r; ++k) {
+    output_dims[k] = dims[merged_perm[k]];
+  }
+  for (int32_t k = r - 2; k >= 0; --k) {
+    output_strides[k] = output_strides[k + 1] * output_dims[k + 1];
+  }
+
+  // the innermost input axis is still innermost in the output: copy whole
+  // contiguous blocks. otherwise transpose the 2D plane made of the innermost
+  // input axis and the innermost output axis tile by tile
+  const bool block_copy = merged_perm[r - 1] == r - 1;
+  int32_t inner_output_axis = r - 1;
+  for (int32_t k = 0; k < r; ++k) {
+    if (merged_perm[k] == r - 1) {
+      inner_output_axis = k;
+    }
+  }
+  const int32_t block = output_dims[r - 1];
+  const int32_t rows = dims[merged_perm[r - 1]];
+  const int32_t src_ld = input_strides[merged_perm[r - 1]];
+  const int32_t dst_ld = output_strides[inner_output_axis];
+
+  // odometer over the remaining output axes
+  SmallShape outer_axes;
+  size_t count = 1;
+  for (int32_t k = 0; k < r - 1; ++k) {
+    if (k != inner_output_axis) {
+      outer_axes.push_back(k);
+      count *= output_dims[k];
+    }
+  }
+  SmallShape index(outer_axes.size(), 0);
+  size_t src_offset = 0;
+  size_t dst_offset = 0;
+  for (size_t n = 0; n < count; ++n) {
+    if (block_copy) {
+      memcpy(Y + dst_offset, X + src_offset, sizeof(float) * block);
+    } else {
+      transpose2D_imp<float>(X + src_offset, Y + dst_offset, rows,
+                             dims[r - 1], src_ld, dst_ld);
+    }
+    for (int32_t j = static_cast<int32_t>(outer_axes.size()) - 1; j >= 0;
+         --j) {
+      const int32_t axis = outer_axes[j];
+      src_offset += input_strides[merged_perm[axis]];
+      dst_offset += output_strides[axis];
+      if (++index[j] < output_dims[axis]) {
+        break;
+      }
+      src_offset -= input_strides[merged_perm[axis]] * output_dims[axis];
+      dst_offset -= output_strides[axis] * output_dims[axis];
+      index[j] = 0;
+    }
+  }
+}
@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <stdint.h>
+
+extern "C" {
+void transpose_f32(void *);
+void transpose_f32_imp(const float *, const int32_t *, const int32_t,
+                       const int32_t *, float *);
+}
+
+// Transposes a 2D block. src(i, j) lives at src[i * src_ld + j] and is written
+// to dst[j * dst_ld + i]. The block is split recursively along its larger side
+// until it fits a small tile, so it stays cache friendly without knowing the
+// cache size.
+template <typename T>
+void transpose2D_imp(const T *src, T *dst, const int32_t rows,
+                     const int32_t cols, const int32_t src_ld,
+                     const int32_t dst_ld) {
+  const int32_t tile = 16;
+  if (rows <= tile && cols <= tile) {
+    for (int32_t i = 0; i < rows; ++i) {
+      const T *s = src + i * src_ld;
+      T *d = dst + i;
+      for (int32_t j = 0; j < cols; ++j) {
+        d[j * dst_ld] = s[j];
+      }
+    }
+    return;
+  }
+  if (rows >= cols) {
+    const int32_t half = rows / 2;
+    transpose2D_imp(src, dst, half, cols, src_ld, dst_ld);
+    transpose2D_imp(src + half * src_ld, dst + half, rows - half, cols, src_ld,
+                    dst_ld);
+  } else {
+    const int32_t half = cols / 2;
+    transpose2D_imp(src, dst, rows, half, src_ld, dst_ld);
+    transpose2D_imp(src + half, dst + half * dst_ld, rows, cols - half, src_ld,
+                    dst_ld);
+  }
+}
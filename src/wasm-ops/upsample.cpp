@@ -0,0 +1,233 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "upsample.h"
+#include "common.h"
+#include "utils/small_shape.h"
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+// Wasm interop method
+void upsample_nearest_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  upsample_nearest_f32_imp(
+      PARAM_FLOAT_PTR(data, dataIndex[1]), PARAM_INT32_PTR(data, dataIndex[2]),
+      PARAM_INT32(data, dataIndex[3]), PARAM_FLOAT_PTR(data, dataIndex[4]),
+      PARAM_INT32_PTR(data, dataIndex[5]), PARAM_INT32_PTR(data, dataIndex[6]),
+      PARAM_FLOAT(data, dataIndex[7]));
+}
+
+void upsample_bilinear_f32(void *data) {
+  uint32_t *dataIndex = static_cast<uint32_t *>(data);
+  uint32_t const argc = dataIndex[0];
+  upsample_bilinear_f32_imp(
+      PARAM_FLOAT_PTR(data, dataIndex[1]), PARAM_INT32(data, dataIndex[2]),
+      PARAM_INT32(data, dataIndex[3]), PARAM_INT32(data, dataIndex[4]),
+      PARAM_FLOAT_PTR(data, dataIndex[5]), PARAM_INT32(data, dataIndex[6]),
+      PARAM_INT32(data, dataIndex[7]), PARAM_INT32_PTR(data, dataIndex[8]),
+      PARAM_FLOAT_PTR(data, dataIndex[9]), PARAM_INT32_PTR(data, dataIndex[10]),
+      PARAM_FLOAT_PTR(data, dataIndex[11]), PARAM_FLOAT(data, dataIndex[12]));
+}
+
+// Returns the factor 's' (1, 2 or 4) when the table maps output element j to
+// source element j / s, or 0 when it does not follow such a pattern
+int32_t nearest_integer_scale(const int32_t *table, const int32_t in_length,
+                              const int32_t out_length) {
+  const int32_t scales[] = {1, 2, 4};
+  for (int32_t s : scales) {
+    if (out_length != in_length * s) {
+      continue;
+    }
+    int32_t j = 0;
+    while (j < out_length && table[j] == j / s) {
+      ++j;
+    }
+    if (j == out_length) {
+      return s;
+    }
+  }
+  return 0;
+}
+
+// Returns the factor 's' (2 or 4) when output element j blends source elements
+// j / s and j / s + 1 with weights that only depend on j % s, or 0 otherwise.
+// The last source element is not checked, it is clamped at the border.
+int32_t linear_integer_scale(const int32_t *index, const float *weight,
+                             const int32_t in_length,
+                             const int32_t out_length) {
+  const int32_t scales[] = {2, 4};
+  for (int32_t s : scales) {
+    if (out_length != in_length * s || in_length < 2) {
+      continue;
+    }
+    const int32_t end = (in_length - 1) * s;
+    int32_t j = 0;
+    while (j < end && index[2 * j] == j / s && index[2 * j + 1] == j / s + 1 &&
+           weight[2 * j] == weight[2 * (j % s)] &&
+           weight[2 * j + 1] == weight[2 * (j % s) + 1]) {
+      ++j;
+    }
+    if (j == end) {
+      return s;
+    }
+  }
+  return 0;
+}
+
+// Linear interpolation of one source row along the width
+void upsample_linear_row_f32(const float *src, const int32_t in_width,
+                             float *dst, const int32_t out_width,
+                             const int32_t *x_index, const float *x_weight,
+                             const int32_t scale,
+                             const float extrapolation_value) {
+  int32_t start = 0;
+  if (scale == 2) {
+    upsample_linear_row_f32<2>(src, in_width, x_weight, dst);
+    start = (in_width - 1) * 2;
+  } else if (scale == 4) {
+    upsample_linear_row_f32<4>(src, in_width, x_weight, dst);
+    start = (in_width - 1) * 4;
+  }
+  for (int32_t j = start; j < out_width; ++j) {
+    const int32_t i1 = x_index[2 * j];
+    dst[j] = i1 < 0 ? extrapolation_value
+                    : x_weight[2 * j] * src[i1] +
+                          x_weight[2 * j + 1] * src[x_index[2 * j + 1]];
+  }
+}
+
+// Core operator implementation
+// 'offsets' holds, for every axis, the offset in X of the source element of
+// each output position along that axis (-1 where the extrapolation value is
+// used instead)
+void upsample_nearest_f32_imp(const float *X, const int32_t *X_dims,
+                              const int32_t rank, float *Y,
+                              const int32_t *Y_dims, const int32_t *offsets,
+                              const float extrapolation_value) {
+  SmallVector<const int32_t *> tables(rank);
+  size_t rows = 1;
+  for (int32_t d = 0; d < rank; ++d) {
+    tables[d] = offsets;
+    offsets += Y_dims[d];
+    if (d < rank - 1) {
+      rows *= Y_dims[d];
+    }
+  }
+  const int32_t in_width = X_dims[rank - 1];
+  const int32_t out_width = Y_dims[rank - 1];
+  if (rows == 0 || out_width == 0) {
+    return;
+  }
+  const int32_t *row_table = tables[rank - 1];
+  const int32_t scale = nearest_integer_scale(row_table, in_width, out_width);
+
+  // odometer over the output rows. consecutive output rows reading the same
+  // source row are copies of each other
+  SmallShape index(rank - 1, 0);
+  int32_t previous = 0;
+  for (size_t n = 0; n < rows; ++n) {
+    int32_t src_offset = 0;
+    for (int32_t d = 0; d < rank - 1 && src_offset >= 0; ++d) {
+      const int32_t offset = tables[d][index[d]];
+      src_offset = offset < 0 ? -1 : src_offset + offset;
+    }
+
+    float *y = Y + n * out_width;
+    if (n > 0 && src_offset == previous) {
+      memcpy(y, y - out_width, sizeof(float) * out_width);
+    } else if (src_offset < 0) {
+      std::fill(y, y + out_width, extrapolation_value);
+    } else {
+      const float *x = X + src_offset;
+      switch (scale) {
+      case 1:
+        memcpy(y, x, sizeof(float) * out_width);
+        break;
+      case 2:
+        upsample_nearest_row_f32<2>(x, in_width, y);
+        break;
+      case 4:
+        upsample_nearest_row_f32<4>(x, in_width, y);
+        break;
+      default:
+        for (int32_t j = 0; j < out_width; ++j) {
+          y[j] = row_table[j] < 0 ? extrapolation_value : x[row_table[j]];
+        }
+      }
+    }
+    previous = src_offset;
+
+    for (int32_t d = rank - 2; d >= 0; --d) {
+      if (++index[d] < Y_dims[d]) {
+        break;
+      }
+      index[d] = 0;
+    }
+  }
+}
+
+// 'y_offset' holds the offsets of the two source rows blended into each output
+// row (-1 where the extrapolation value is used instead) and 'y_weight' their
+// weights. 'x_index' and 'x_weight' do the same for the columns.
+void upsample_bilinear_f32_imp(const float *X, const int32_t planes,
+                               const int32_t in_height, const int32_t in_width,
+                               float *Y, const int32_t out_height,
+                               const int32_t out_width, const int32_t *y_offset,
+                               const float *y_weight, const int32_t *x_index,
+                               const float *x_weight,
+                               const float extrapolation_value) {
+  if (out_height == 0 || out_width == 0) {
+    return;
+  }
+  const int32_t scale =
+      linear_integer_scale(x_index, x_weight, in_width, out_width);
+
+  // source rows interpolated along the width, kept while consecutive output
+  // rows keep blending them
+  std::vector<float> buffer(2 * out_width);
+  for (int32_t p = 0; p < planes; ++p) {
+    const float *x = X + static_cast<size_t>(p) * in_height * in_width;
+    float *y = Y + static_cast<size_t>(p) * out_height * out_width;
+    float *row1 = &buffer[0];
+    float *row2 = &buffer[out_width];
+    int32_t cached1 = -1;
+    int32_t cached2 = -1;
+    for (int32_t i = 0; i < out_height; ++i) {
+      float *y_row = y + static_cast<size_t>(i) * out_width;
+      const int32_t offset1 = y_offset[2 * i];
+      const int32_t offset2 = y_offset[2 * i + 1];
+      if (offset1 < 0) {
+        std::fill(y_row, y_row + out_width, extrapolation_value);
+        continue;
+      }
+      if (offset1 != cached1) {
+        if (offset1 == cached2) {
+          std::swap(row1, row2);
+          std::swap(cached1, cached2);
+        } else {
+          upsample_linear_row_f32(x + offset1, in_width, row1, out_width,
+                                  x_index, x_weight, scale,
+                                  extrapolation_value);
+          cached1 = offset1;
+        }
+      }
+
+      const float w1 = y_weight[2 * i];
+      const float w2 = y_weight[2 * i + 1];
+      if (offset2 == offset1 || w2 == 0) {
+        memcpy(y_row, row1, sizeof(float) * out_width);
+        continue;
+      }
+      if (offset2 != cached2) {
+        upsample_linear_row_f32(x + offset2, in_width, row2, out_width, x_index,
+                                x_weight, scale, extrapolation_value);
+        cached2 = offset2;
+      }
+      for (int32_t j = 0; j < out_width; ++j) {
+        y_row[j] = w1 * row1[j] + w2 * row2[j];
+      }
+    }
+  }
+}
@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <stdint.h>
+
+extern "C" {
+void upsample_nearest_f32(void *);
+void upsample_nearest_f32_imp(const float *, const int32_t *, const int32_t,
+                              float *, const int32_t *, const int32_t *,
+                              const float);
+void upsample_bilinear_f32(void *);
+void upsample_bilinear_f32_imp(const float *, const int32_t, const int32_t,
+                               const int32_t, float *, const int32_t,
+                               const int32_t, const int32_t *, const float *,
+                               const int32_t *, const float *, const float);
+}
+
+// Nearest upsampling of one row by an integer factor: every source element is
+// repeated 'Scale' times
+template <int32_t Scale>
+void upsample_nearest_row_f32(const float *src, const int32_t src_length,
+                              float *dst) {
+  for (int32_t i = 0; i < src_length; ++i) {
+    const float v = src[i];
+    for (int32_t k = 0; k < Scale; ++k) {
+      dst[i * Scale + k] = v;
+    }
+  }
+}
+
+// Linear upsampling of one row by an integer factor. Output element
+// i * Scale + k blends src[i] and src[i + 1] with the weights of phase k, which
+// are the same for every i. The last source element has no right neighbour
+// and is left to the caller.
+template <int32_t Scale>
+void upsample_linear_row_f32(const float *src, const int32_t src_length,
+                             const float *weights, float *dst) {
+  for (int32_t i = 0; i + 1 < src_length; ++i) {
+    const float left = src[i];
+    const float right = src[i + 1];
+    for (int32_t k = 0; k < Scale; ++k) {
+      dst[i * Scale + k] = weights[2 * k] * left + weights[2 * k + 1] * right;
+    }
+  }
+}
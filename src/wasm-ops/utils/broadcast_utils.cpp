@@ -3,22 +3,21 @@
 
 #include "broadcast_utils.h"
 
-std::vector<int32_t> BroadcastUtils::broadcasted_to_original_indices(
-    const std::vector<int32_t> &broadcasted_indices,
-    const std::vector<int32_t> &dims) {
+SmallShape BroadcastUtils::broadcasted_to_original_indices(
+    const SmallShape &broadcasted_indices, const SmallShape &dims) {
   const auto rank = dims.size();
   if (rank == 0) {
-    return std::vector<int32_t>();
+    return SmallShape();
   }
-  std::vector<int32_t> original_indices(rank);
+  SmallShape original_indices(rank);
   BroadcastUtils::broadcasted_to_original_indices(broadcasted_indices, dims,
                                                   original_indices);
   return original_indices;
 }
 
 void BroadcastUtils::broadcasted_to_original_indices(
-    const std::vector<int32_t> &broadcasted_indices,
-    const std::vector<int32_t> &dims, std::vector<int32_t> &original_indices) {
+    const SmallShape &broadcasted_indices, const SmallShape &dims,
+    SmallShape &original_indices) {
   const auto rank = dims.size();
   if (rank == 0) {
     return;
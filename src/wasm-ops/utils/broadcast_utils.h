@@ -3,16 +3,16 @@
 
 #pragma once
 
-#include <vector>
+#include "small_shape.h"
 
 namespace BroadcastUtils {
-std::vector<int32_t>
-broadcasted_to_original_indices(const std::vector<int32_t> &broadcasted_indices,
-                                const std::vector<int32_t> &dims);
+SmallShape
+broadcasted_to_original_indices(const SmallShape &broadcasted_indices,
+                                const SmallShape &dims);
 
 // Fills in values in the original_indices vector. Assumes it is of the required
 // size.
-void broadcasted_to_original_indices(
-    const std::vector<int32_t> &broadcasted_indices,
-    const std::vector<int32_t> &dims, std::vector<int32_t> &original_indices);
+void broadcasted_to_original_indices(const SmallShape &broadcasted_indices,
+                                     const SmallShape &dims,
+                                     SmallShape &original_indices);
 }; // namespace BroadcastUtils
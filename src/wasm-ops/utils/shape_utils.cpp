@@ -2,37 +2,18 @@
 // Licensed under the MIT license.
 
 #include "shape_utils.h"
-#include <math.h>
 
-size_t ShapeUtils::size_from_dims(const std::vector<int32_t> &dims) {
-  auto rank = dims.size();
-  if (rank == 0) {
-    return 1;
-  }
-  if (rank == 1) {
-    return dims[0];
-  }
-  size_t size = 1;
-  for (auto &e : dims) {
-    size *= e;
-  }
-  return size;
-}
-
-std::vector<int32_t>
-ShapeUtils::compute_strides(const std::vector<int32_t> &dims) {
+SmallShape ShapeUtils::compute_strides(const SmallShape &dims) {
   auto rank = dims.size();
   if (rank == 0 || rank == 1) {
-    std::vector<int32_t> strides(1, 1);
-    return strides;
+    return SmallShape(1, 1);
   }
-  std::vector<int32_t> strides(rank);
+  SmallShape strides(rank);
   ShapeUtils::compute_strides(dims, strides);
   return strides;
 }
 
-void ShapeUtils::compute_strides(const std::vector<int32_t> &dims,
-                                 std::vector<int32_t> &strides) {
+void ShapeUtils::compute_strides(const SmallShape &dims, SmallShape &strides) {
   auto rank = dims.size();
   if (rank == 0 || rank == 1) {
     strides[0] = 1;
@@ -45,33 +26,22 @@ void ShapeUtils::compute_strides(const std::vector<int32_t> &dims,
   }
 }
 
-size_t ShapeUtils::indices_to_offset(const std::vector<int32_t> &strides,
-                                     const std::vector<int32_t> &indices) {
-  size_t offset = 0;
-  for (size_t i = 0; i < indices.size(); ++i) {
-    offset += strides[i] * indices[i];
-  }
-  return offset;
-}
-
-std::vector<int32_t>
-ShapeUtils::offset_to_indices(const std::vector<int32_t> &strides,
-                              size_t offset) {
+SmallShape ShapeUtils::offset_to_indices(const SmallShape &strides,
+                                         size_t offset) {
   auto rank = strides.size();
   if (rank == 0) {
-    return std::vector<int32_t>();
+    return SmallShape();
   }
   if (rank == 1) {
-    return std::vector<int32_t>(1, offset * strides[0]);
+    return SmallShape(1, offset * strides[0]);
   }
-  std::vector<int32_t> indices(rank);
+  SmallShape indices(rank);
   ShapeUtils::offset_to_indices(strides, offset, indices);
   return indices;
 }
 
-void ShapeUtils::offset_to_indices(const std::vector<int32_t> &strides,
-                                   size_t offset,
-                                   std::vector<int32_t> &indices) {
+void ShapeUtils::offset_to_indices(const SmallShape &strides, size_t offset,
+                                   SmallShape &indices) {
   auto rank = strides.size();
   if (rank == 0) {
     return;
@@ -81,7 +51,7 @@ void ShapeUtils::offset_to_indices(const std::vector<int32_t> &strides,
     return;
   }
   for (size_t i = 0; i < indices.size() - 1; ++i) {
-    indices[i] = floor(offset / strides[i]);
+    indices[i] = offset / strides[i];
     offset -= indices[i] * strides[i];
   }
   indices[indices.size() - 1] = offset;
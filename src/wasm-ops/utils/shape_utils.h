@@ -3,19 +3,35 @@
 
 #pragma once
 
-#include <vector>
+#include "small_shape.h"
 
 namespace ShapeUtils {
-size_t size_from_dims(const std::vector<int32_t> &dims);
-std::vector<int32_t> compute_strides(const std::vector<int32_t> &dims);
+// The number of elements of a tensor, and the offset of the element at the
+// given indices. They take arrays so that shapes known at compile time fold
+constexpr size_t size_from_dims(const int32_t *dims, size_t rank) {
+  return rank == 0 ? 1
+                   : static_cast<size_t>(dims[0]) *
+                         size_from_dims(dims + 1, rank - 1);
+}
+constexpr size_t indices_to_offset(const int32_t *strides,
+                                   const int32_t *indices, size_t rank) {
+  return rank == 0 ? 0
+                   : static_cast<size_t>(strides[0]) * indices[0] +
+                         indices_to_offset(strides + 1, indices + 1, rank - 1);
+}
+
+inline size_t size_from_dims(const SmallShape &dims) {
+  return size_from_dims(dims.data(), dims.size());
+}
+SmallShape compute_strides(const SmallShape &dims);
 // Fills in values in the strides vector. Assumes it is of the required size.
-void compute_strides(const std::vector<int32_t> &dims,
-                     std::vector<int32_t> &strides);
-size_t indices_to_offset(const std::vector<int32_t> &strides,
-                         const std::vector<int32_t> &indices);
-std::vector<int32_t> offset_to_indices(const std::vector<int32_t> &strides,
-                                       size_t offset);
+void compute_strides(const SmallShape &dims, SmallShape &strides);
+inline size_t indices_to_offset(const SmallShape &strides,
+                                const SmallShape &indices) {
+  return indices_to_offset(strides.data(), indices.data(), indices.size());
+}
+SmallShape offset_to_indices(const SmallShape &strides, size_t offset);
 // Fills in values in the indices vector. Assumes it is of the required size.
-void offset_to_indices(const std::vector<int32_t> &strides, size_t offset,
-                       std::vector<int32_t> &indices);
+void offset_to_indices(const SmallShape &strides, size_t offset,
+                       SmallShape &indices);
 }; // namespace ShapeUtils
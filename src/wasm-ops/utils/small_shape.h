@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include <utility>
+
+// The maximum rank of the tensors whose shapes are stored inline
+constexpr size_t MAX_TENSOR_RANK = 8;
+
+// A vector whose first N elements are stored inline, so that the dims,
+// strides and indices of a tensor live on the stack instead of the heap. A
+// vector growing beyond N elements moves them to the heap, so that the rare
+// tensors of a larger rank still run
+template <typename T, size_t N = MAX_TENSOR_RANK> class SmallVector {
+public:
+  SmallVector() : size_(0), capacity_(N), inline_{} {}
+  explicit SmallVector(size_t size, T value = T())
+      : size_(0), capacity_(N), inline_{} {
+    resize(size, value);
+  }
+  SmallVector(const T *begin, const T *end)
+      : size_(0), capacity_(N), inline_{} {
+    assign(begin, end);
+  }
+  SmallVector(const SmallVector &other) : size_(0), capacity_(N), inline_{} {
+    assign(other.begin(), other.end());
+  }
+  SmallVector &operator=(const SmallVector &other) {
+    if (this != &other) {
+      assign(other.begin(), other.end());
+    }
+    return *this;
+  }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  size_t capacity() const { return capacity_; }
+
+  T &operator[](size_t i) { return data()[i]; }
+  const T &operator[](size_t i) const { return data()[i]; }
+  T &back() { return data()[size_ - 1]; }
+  const T &back() const { return data()[size_ - 1]; }
+
+  T *data() { return heap_ ? heap_.get() : inline_; }
+  const T *data() const { return heap_ ? heap_.get() : inline_; }
+  T *begin() { return data(); }
+  T *end() { return data() + size_; }
+  const T *begin() const { return data(); }
+  const T *end() const { return data() + size_; }
+
+  void resize(size_t size, T value = T()) {
+    reserve(size);
+    T *p = data();
+    for (size_t i = size_; i < size; ++i) {
+      p[i] = value;
+    }
+    size_ = size;
+  }
+  void assign(const T *begin, const T *end) {
+    // the source is never the storage freed by reserve(), which only grows
+    // beyond the size of this vector
+    reserve(end - begin);
+    T *p = data();
+    for (const T *q = begin; q != end; ++q) {
+      *p++ = *q;
+    }
+    size_ = end - begin;
+  }
+  void push_back(T value) {
+    reserve(size_ + 1);
+    data()[size_++] = value;
+  }
+  void pop_back() { --size_; }
+  void clear() { size_ = 0; }
+
+private:
+  // make room for size elements, moving them to the heap beyond the capacity
+  void reserve(size_t size) {
+    if (size > capacity_) {
+      size_t capacity = size > 2 * capacity_ ? size : 2 * capacity_;
+      std::unique_ptr<T[]> heap(new T[capacity]());
+      for (size_t i = 0; i < size_; ++i) {
+        heap[i] = data()[i];
+      }
+      heap_ = std::move(heap);
+      capacity_ = capacity;
+    }
+  }
+
+  size_t size_;
+  size_t capacity_;
+  T inline_[N];
+  // the elements once they outgrow the inline storage
+  std::unique_ptr<T[]> heap_;
+};
+
+// The dims, strides or indices of a tensor
+typedef SmallVector<int32_t> SmallShape;
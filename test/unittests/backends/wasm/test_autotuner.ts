@@ -0,0 +1,83 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {expect} from 'chai';
+
+import {Backend as BackendInterface} from '../../../../lib/api/onnx';
+import {getTuningCache, MAX_TUNING_DECISIONS, runTuned, setTuningCache, tuningKey} from '../../../../lib/backends/wasm/autotuner';
+
+const sleep = (ms: number) => new Promise<void>(resolve => setTimeout(resolve, ms));
+
+describe('#UnitTest# - wasm - autotuner', () => {
+  let savedCache: BackendInterface.WasmTuningCache;
+  // the candidates are the times they take, in milliseconds
+  let runs: number[];
+  const run = (candidate: number) => {
+    runs.push(candidate);
+    return sleep(candidate);
+  };
+
+  before(() => {
+    savedCache = getTuningCache();
+  });
+  beforeEach(() => {
+    setTuningCache({version: 1, decisions: {}});
+    runs = [];
+  });
+  after(() => {
+    setTuningCache(savedCache);
+  });
+
+  it('runs the first candidate without autotuning', async () => {
+    await runTuned(false, () => 'op', [20, 1], run);
+    expect(runs).to.deep.equal([20]);
+    expect(getTuningCache().decisions).to.deep.equal({});
+  });
+
+  it('measures every candidate once and keeps the fastest one', async () => {
+    const key = tuningKey('Test', [[1, 2]], [3]);
+    await runTuned(true, () => key, [20, 1, 10], run);
+    // the first run warms up and is not measured
+    expect(runs).to.deep.equal([20, 20, 1, 10]);
+    expect(getTuningCache().decisions).to.deep.equal({[key]: '1'});
+
+    runs = [];
+    await runTuned(true, () => key, [20, 1, 10], run);
+    expect(runs).to.deep.equal([1]);
+  });
+
+  it('tunes again a decision that is not a candidate any more', async () => {
+    setTuningCache({version: 1, decisions: {op: '5'}});
+    await runTuned(true, () => 'op', [20, 1], run);
+    expect(runs).to.deep.equal([20, 20, 1]);
+    expect(getTuningCache().decisions).to.deep.equal({op: '1'});
+  });
+
+  it('loads the decisions of a saved cache', async () => {
+    await runTuned(true, () => 'op', [20, 1], run);
+    const cache = JSON.parse(JSON.stringify(getTuningCache())) as BackendInterface.WasmTuningCache;
+    setTuningCache({version: 1, decisions: {}});
+    setTuningCache(cache);
+    expect(getTuningCache()).to.deep.equal(cache);
+
+    runs = [];
+    await runTuned(true, () => 'op', [20, 1], run);
+    expect(runs).to.deep.equal([1]);
+  });
+
+  it('ignores a cache of another version', () => {
+    setTuningCache({version: 2, decisions: {op: '1'}});
+    expect(getTuningCache().decisions).to.deep.equal({});
+  });
+
+  it('drops the oldest decisions beyond the maximum', () => {
+    const decisions: {[key: string]: string} = {};
+    for (let i = 0; i <= MAX_TUNING_DECISIONS; i++) {
+      decisions[`op${i}`] = '0';
+    }
+    setTuningCache({version: 1, decisions});
+    const kept = Object.keys(getTuningCache().decisions);
+    expect(kept.length).to.equal(MAX_TUNING_DECISIONS);
+    expect(kept[0]).to.equal('op1');
+  });
+});
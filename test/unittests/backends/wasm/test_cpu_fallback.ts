@@ -0,0 +1,92 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {expect} from 'chai';
+
+import {WasmBackend} from '../../../../lib/backends/backend-wasm';
+import {WasmSessionHandler} from '../../../../lib/backends/wasm/session-handler';
+import {Profiler} from '../../../../lib/instrument';
+import {Tensor} from '../../../../lib/tensor';
+import {PerformanceData, WasmSessionBinding} from '../../../../lib/wasm-binding-core';
+import {createGraph, createIntAttribute, createIntsAttribute, TestNode} from '../../graph-utils';
+
+// a binding recording the kernels called, without running them
+class TestBinding implements WasmSessionBinding {
+  calls: string[] = [];
+  ccall(functionName: string): PerformanceData {
+    this.calls.push(functionName);
+    return {};
+  }
+  ccallRemote(): Promise<PerformanceData> {
+    throw new Error('the kernels run in the calling thread');
+  }
+  dispose(): void {}
+}
+
+const int32 = (dims: number[], data: number[]) => Tensor.fromData(new Int32Array(data), dims, 'int32');
+const float32 = (dims: number[], data: number[]) => Tensor.fromData(new Float32Array(data), dims, 'float32');
+
+describe('#UnitTest# - wasm - fallback to the CPU operators', () => {
+  let binding: TestBinding;
+  let handler: WasmSessionHandler;
+  const createHandler = (cpuFallback: boolean) => {
+    binding = new TestBinding();
+    handler = new WasmSessionHandler(
+        new WasmBackend(), {profiler: Profiler.create()},
+        {cpuFallback, streaming: false, autotune: false, channelBlock: 0, sparsity: 0, shareWeights: false}, binding);
+  };
+  afterEach(() => {
+    handler.dispose();
+  });
+
+  // resolve a node of the given inputs in the session handler, then run it if the operator accepts them
+  const run = async (node: TestNode, inputs: Tensor[]) => {
+    const graphInputs = node.inputs.map(name => [name, []] as [string, number[]]);
+    const graph = createGraph({inputs: graphInputs, outputs: node.outputs, nodes: [node]});
+    const op = handler.resolve(graph.getNodes()[0], [{domain: '', version: 11}], graph);
+    if (!op.checkInputs(inputs)) {
+      return undefined;
+    }
+    const outputs = await op.run(handler.createInferenceHandler(), inputs);
+    return Array.from(outputs[0].integerData);
+  };
+
+  it('runs the int32 tensors of a Concat, a Gather and a Slice with the CPU operators', async () => {
+    createHandler(true);
+    const concat = {opType: 'Concat', inputs: ['a', 'b'], outputs: ['y'], attributes: [createIntAttribute('axis', 0)]};
+    expect(await run(concat, [int32([2], [1, 2]), int32([1], [3])])).to.deep.equal([1, 2, 3]);
+
+    const gather = {opType: 'Gather', inputs: ['x', 'i'], outputs: ['y']};
+    expect(await run(gather, [int32([3], [4, 5, 6]), int32([2], [2, 0])])).to.deep.equal([6, 4]);
+
+    const slice = {opType: 'Slice', inputs: ['x', 'starts', 'ends'], outputs: ['y']};
+    expect(await run(slice, [int32([4], [7, 8, 9, 10]), int32([1], [1]), int32([1], [3])])).to.deep.equal([8, 9]);
+    expect(binding.calls).to.deep.equal([]);
+  });
+
+  it('runs the int32 tensors of the reductions with the CPU operators', async () => {
+    createHandler(true);
+    const x = int32([2, 3], [3, 1, 2, -1, 5, -1]);
+    const reduceSum =
+        {opType: 'ReduceSum', inputs: ['x'], outputs: ['y'], attributes: [createIntsAttribute('axes', [1])]};
+    expect(await run(reduceSum, [x])).to.deep.equal([6, 3]);
+    const argMin = {opType: 'ArgMin', inputs: ['x'], outputs: ['y'], attributes: [createIntAttribute('axis', 1)]};
+    expect(await run(argMin, [x])).to.deep.equal([1, 0]);
+    const argMax = {opType: 'ArgMax', inputs: ['x'], outputs: ['y'], attributes: [createIntAttribute('axis', 1)]};
+    expect(await run(argMax, [x])).to.deep.equal([0, 1]);
+    expect(binding.calls).to.deep.equal([]);
+  });
+
+  it('runs the float32 tensors with the wasm kernels', async () => {
+    createHandler(true);
+    const concat = {opType: 'Concat', inputs: ['a', 'b'], outputs: ['y'], attributes: [createIntAttribute('axis', 0)]};
+    await run(concat, [float32([2], [1, 2]), float32([1], [3])]);
+    expect(binding.calls).to.deep.equal(['_concat_f32']);
+  });
+
+  it('rejects the int32 tensors without the fallback', async () => {
+    createHandler(false);
+    const concat = {opType: 'Concat', inputs: ['a', 'b'], outputs: ['y'], attributes: [createIntAttribute('axis', 0)]};
+    expect(await run(concat, [int32([2], [1, 2]), int32([1], [3])])).to.equal(undefined);
+  });
+});
@@ -0,0 +1,130 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {expect} from 'chai';
+
+import {Backend as BackendInterface} from '../../../../lib/api/onnx';
+import {backend} from '../../../../lib/api/onnx-impl';
+import {preprocessImage} from '../../../../lib/backends/wasm/image-preprocess';
+import {PerformanceData, WasmCallArgument, WasmSessionBinding} from '../../../../lib/wasm-binding-core';
+
+// a binding running the kernel _image_to_nchw_f32 (src/wasm-ops/image-preprocess.cpp) in JavaScript, so that the
+// arguments the kernel gets are checked by their result
+class TestBinding implements WasmSessionBinding {
+  calls = 0;
+  ccall(functionName: string, ...params: WasmCallArgument[]): PerformanceData {
+    expect(functionName).to.equal('_image_to_nchw_f32');
+    this.calls++;
+    const [x, inHeight, inWidth, pixelSize, channels, outChannels, multipliers, biases, y, outHeight, outWidth] =
+        params.map(param => param[0]) as [
+          Uint8Array, number, number, number, number[], number, number[], number[], Float32Array, number, number
+        ];
+    // the two source pixels blended into every output pixel along an axis, with half pixel centers
+    const resizeTable = (inLength: number, outLength: number) => Array.from({length: outLength}, (_, j) => {
+      const source = Math.min(Math.max((j + 0.5) * inLength / outLength - 0.5, 0), inLength - 1);
+      const first = Math.floor(source);
+      return {first, second: Math.min(first + 1, inLength - 1), weight: source - first};
+    });
+    const rows = resizeTable(inHeight, outHeight);
+    const columns = resizeTable(inWidth, outWidth);
+    for (let c = 0; c < outChannels; c++) {
+      const value = (row: number, column: number) => x[(row * inWidth + column) * pixelSize + channels[c]];
+      const blend = (first: number, second: number, weight: number) => first + weight * (second - first);
+      rows.forEach((row, i) => columns.forEach((column, j) => {
+        const top = blend(value(row.first, column.first), value(row.first, column.second), column.weight);
+        const bottom = blend(value(row.second, column.first), value(row.second, column.second), column.weight);
+        y[(c * outHeight + i) * outWidth + j] = multipliers[c] * blend(top, bottom, row.weight) + biases[c];
+      }));
+    }
+    return {};
+  }
+  ccallRemote(): Promise<PerformanceData> {
+    throw new Error('the image is preprocessed in the calling thread');
+  }
+  dispose(): void {}
+}
+
+// an image of 2x1 pixels in RGBA
+const rgba = new Uint8Array([10, 20, 30, 255, 40, 50, 60, 255]);
+const rgb = new Uint8Array([10, 20, 30, 40, 50, 60]);
+
+const run = (pixels: Uint8Array, options: Partial<BackendInterface.WasmImageOptions>) =>
+    preprocessImage(new TestBinding(), pixels, {width: 2, height: 1, ...options});
+const expectClose = (actual: Float32Array, expected: number[]) => {
+  expect(actual.length).to.equal(expected.length);
+  expected.forEach((value, i) => expect(actual[i]).to.be.closeTo(value, 1e-5));
+};
+
+describe('#UnitTest# - wasm - preprocessImage', () => {
+  it('converts the RGBA pixels to NCHW, dropping the alpha channel', () => {
+    const y = run(rgba, {});
+    expect(y.dims).to.deep.equal([1, 3, 1, 2]);
+    expectClose(y.floatData as Float32Array, [10, 40, 20, 50, 30, 60]);
+  });
+
+  it('converts the RGB pixels', () => {
+    expectClose(run(rgb, {format: 'RGB'}).floatData as Float32Array, [10, 40, 20, 50, 30, 60]);
+  });
+
+  it('reorders the channels to BGR', () => {
+    expectClose(run(rgba, {channelOrder: 'BGR'}).floatData as Float32Array, [30, 60, 20, 50, 10, 40]);
+    expectClose(run(rgb, {format: 'RGB', channelOrder: 'BGR'}).floatData as Float32Array, [30, 60, 20, 50, 10, 40]);
+  });
+
+  it('normalizes the values as (scale * value - mean) / std', () => {
+    const y = run(rgba, {scale: 0.5, mean: [1, 2, 3], std: [2, 4, 5]});
+    expectClose(y.floatData as Float32Array, [2, 9.5, 2, 5.75, 2.4, 5.4]);
+    // the mean and the standard deviation follow the order of the channels of the tensor
+    const bgr = run(rgba, {channelOrder: 'BGR', scale: 0.5, mean: [3, 2, 1], std: [5, 4, 2]});
+    expectClose(bgr.floatData as Float32Array, [2.4, 5.4, 2, 5.75, 2, 9.5]);
+  });
+
+  it('resizes the image by bilinear interpolation', () => {
+    const upscaled = run(rgba, {outputWidth: 4, outputHeight: 2});
+    expect(upscaled.dims).to.deep.equal([1, 3, 2, 4]);
+    expectClose(upscaled.floatData.subarray(0, 8) as Float32Array, [10, 17.5, 32.5, 40, 10, 17.5, 32.5, 40]);
+
+    const downscaled = run(rgba, {outputWidth: 1});
+    expect(downscaled.dims).to.deep.equal([1, 3, 1, 1]);
+    expectClose(downscaled.floatData as Float32Array, [25, 35, 45]);
+  });
+
+  it('rejects pixels whose size does not match the image', () => {
+    expect(() => run(rgb, {})).to.throw('expecting 8 bytes of pixels for an image of 2x1 pixels in RGBA, got 6');
+    expect(() => run(rgba, {format: 'RGB'}))
+        .to.throw('expecting 6 bytes of pixels for an image of 2x1 pixels in RGB, got 8');
+  });
+
+  it('rejects an invalid format, order of channels or size', () => {
+    expect(() => run(rgba, {format: 'BGRA' as 'RGBA'}))
+        .to.throw(`BGRA is not a valid format of pixels, expecting 'RGBA' or 'RGB'`);
+    expect(() => run(rgba, {channelOrder: 'RBG' as 'RGB'}))
+        .to.throw(`RBG is not a valid order of channels, expecting 'RGB' or 'BGR'`);
+    expect(() => run(rgba, {outputWidth: 0})).to.throw('0 is not a valid size of image, expecting a positive integer');
+    expect(() => run(rgba, {width: 1.5})).to.throw('1.5 is not a valid size of image, expecting a positive integer');
+  });
+
+  it('rejects a zero standard deviation, or a mean or a standard deviation not given for 3 channels', () => {
+    const message = 'expecting a mean and a non-zero standard deviation for each of the 3 channels';
+    expect(() => run(rgba, {std: [1, 0, 1]})).to.throw(message);
+    expect(() => run(rgba, {mean: [0, 0]})).to.throw(message);
+    expect(() => run(rgba, {std: [1, 1, 1, 1]})).to.throw(message);
+  });
+
+  it('does not call the kernel when the options are invalid', () => {
+    const binding = new TestBinding();
+    expect(() => preprocessImage(binding, rgba, {width: 2, height: 1, std: [0, 0, 0]})).to.throw();
+    expect(binding.calls).to.equal(0);
+    preprocessImage(binding, rgba, {width: 2, height: 1});
+    expect(binding.calls).to.equal(1);
+  });
+});
+
+describe('#UnitTest# - wasm - preprocessImage of the backend', () => {
+  // the unit tests run before the op and model tests, so no session has initialized the backend yet
+  it('initializes the backend when no session has initialized it', async () => {
+    const y = await backend.wasm.preprocessImage!(rgba, {width: 2, height: 1});
+    expect(y.dims).to.deep.equal([1, 3, 1, 2]);
+    expectClose(y.data as Float32Array, [10, 40, 20, 50, 30, 60]);
+  });
+});
@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {expect} from 'chai';
+
+import {callPartitions, getInputRows, partition, partitionCandidates, PartitionAxis} from '../../../../lib/backends/wasm/partitioner';
+import {PerformanceData, WasmCallArgument, WasmSessionBinding} from '../../../../lib/wasm-binding-core';
+
+// a binding recording the calls, by worker (-1 for the calling thread)
+class TestBinding implements WasmSessionBinding {
+  calls: Array<[number, string, WasmCallArgument[]]> = [];
+  ccall(functionName: string, ...params: WasmCallArgument[]): PerformanceData {
+    this.calls.push([-1, functionName, params]);
+    return {};
+  }
+  ccallRemote(workerId: number, functionName: string, ...params: WasmCallArgument[]): Promise<PerformanceData> {
+    this.calls.push([workerId, functionName, params]);
+    return Promise.resolve({});
+  }
+  dispose(): void {}
+}
+
+const createAxis = (name: string, extent: number, flopsPerUnit: number, fixedBytes = 0, bytesPerUnit = 4):
+    PartitionAxis => ({name, extent, flopsPerUnit, fixedBytes, bytesPerUnit});
+
+describe('#UnitTest# - wasm - partitioner', () => {
+  it('splits an expensive operator among the workers and the calling thread', () => {
+    const parts = partition([createAxis('rows', 10, 1e7)], 3);
+    expect(parts.axis).to.equal('rows');
+    expect(parts.ranges).to.deep.equal([[0, 2], [2, 5], [5, 7], [7, 10]]);
+  });
+
+  it('does not split a cheap operator', () => {
+    expect(partition([createAxis('rows', 100, 10)], 3).ranges).to.deep.equal([[0, 100]]);
+  });
+
+  it('runs in one part without workers', () => {
+    expect(partition([createAxis('rows', 10, 1e7)], 0).ranges).to.deep.equal([[0, 10]]);
+  });
+
+  it('runs in one part without axes', () => {
+    expect(partition([], 3)).to.deep.equal({axis: '', ranges: [[0, 1]]});
+  });
+
+  it('does not split an axis in more parts than its units', () => {
+    expect(partition([createAxis('batch', 3, 1e7)], 8).ranges).to.deep.equal([[0, 1], [1, 2], [2, 3]]);
+  });
+
+  it('chooses the axis with the least transfers', () => {
+    const channels = createAxis('channels', 16, 1e7, 1e8);
+    const rows = createAxis('rows', 16, 1e7, 1e3);
+    const parts = partition([channels, rows], 3);
+    expect(parts.axis).to.equal('rows');
+    expect(parts.ranges.length).to.equal(4);
+  });
+
+  it('lists the candidate partitions of the autotuner, starting with the estimated best one', () => {
+    const rows = createAxis('rows', 16, 1e7);
+    const candidates = partitionCandidates([rows], 7);
+    expect(candidates[0]).to.deep.equal(partition([rows], 7));
+    expect(candidates.map(c => c.ranges.length).sort((a, b) => a - b)).to.deep.equal([1, 8]);
+
+    // a single part is measured once, whatever the axes
+    const batch = createAxis('batch', 2, 1e7);
+    const lengths = partitionCandidates([rows, batch], 7).map(c => c.ranges.length);
+    expect(lengths.filter(length => length === 1).length).to.equal(1);
+  });
+
+  it('gets the rows read by the output rows, with the halo and the padding at the edges', () => {
+    // 3x3 window, stride 1, 1 row of padding on each side of 8 rows
+    expect(getInputRows(0, 3, 8, 1, 1, 3)).to.deep.equal([0, 4, 1, 0]);
+    expect(getInputRows(3, 6, 8, 1, 1, 3)).to.deep.equal([2, 7, 0, 0]);
+    expect(getInputRows(6, 8, 8, 1, 1, 3)).to.deep.equal([5, 8, 0, 1]);
+    // stride 2: the output rows [1, 3) read the rows [1, 6)
+    expect(getInputRows(1, 3, 8, 2, 1, 3)).to.deep.equal([1, 6, 0, 0]);
+    // a window dilated to 5 rows, without padding
+    expect(getInputRows(0, 4, 8, 1, 0, 5)).to.deep.equal([0, 8, 0, 0]);
+  });
+
+  it('calls every part but the last one on a worker', async () => {
+    const binding = new TestBinding();
+    await callPartitions(
+        binding, {axis: 'rows', ranges: [[0, 3], [3, 6], [6, 8]]}, '_test',
+        (start, end) => [[start, 'int32'], [end, 'int32']]);
+    expect(binding.calls.map(([workerId, func, params]) => [workerId, func, params.map(param => param[0])]))
+        .to.deep.equal([[0, '_test', [0, 3]], [1, '_test', [3, 6]], [-1, '_test', [6, 8]]]);
+  });
+
+  it('calls a single part in the calling thread', async () => {
+    const binding = new TestBinding();
+    await callPartitions(binding, {axis: '', ranges: [[0, 4]]}, '_test', (start, end) => [[end - start, 'int32']]);
+    expect(binding.calls.map(call => call[0])).to.deep.equal([-1]);
+  });
+});
@@ -0,0 +1,130 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {expect} from 'chai';
+
+import {WasmBackend} from '../../../../lib/backends/backend-wasm';
+import {getThroughputMetrics, SessionWorkers, WasmPooledSession, WasmPooledSessionHandler} from '../../../../lib/backends/wasm/session-pool';
+import {Profiler} from '../../../../lib/instrument';
+import {Tensor} from '../../../../lib/tensor';
+import {SerializedTensor, WorkerSessionOptions, WorkerSessionRequest, WorkerSessionResponse} from '../../../../lib/worker/session-messages';
+
+interface PendingRun {
+  workerId: number;
+  inputs: SerializedTensor[];
+  resolve: (response: WorkerSessionResponse) => void;
+  reject: (reason: unknown) => void;
+}
+
+// workers answering the session requests on demand of the test
+class TestWorkers implements SessionWorkers {
+  requests: Array<[number, WorkerSessionRequest['command']]> = [];
+  runs: PendingRun[] = [];
+  constructor(readonly workerNumber: number, private failingWorker = -1) {}
+
+  sessionRemote(workerId: number, request: WorkerSessionRequest): Promise<WorkerSessionResponse> {
+    this.requests.push([workerId, request.command]);
+    if (request.command === 'run') {
+      const inputs = request.inputs;
+      return new Promise((resolve, reject) => this.runs.push({workerId, inputs, resolve, reject}));
+    }
+    return workerId === this.failingWorker ? Promise.reject(new Error(`worker-${workerId} failed`)) :
+                                             Promise.resolve({id: 0});
+  }
+
+  // the workers of the requests sent with the given command
+  sentTo(command: WorkerSessionRequest['command']): number[] {
+    return this.requests.filter(request => request[1] === command).map(request => request[0]);
+  }
+
+  // answer a run with its inputs
+  respond(run: PendingRun) {
+    run.resolve({id: 0, outputs: run.inputs});
+  }
+}
+
+const options: WorkerSessionOptions =
+    {cpuFallback: true, streaming: false, autotune: true, channelBlock: 0, sparsity: 0, shareWeights: false};
+const model = new Uint8Array(8);
+const createInput = (value: number) => new Tensor([1], 'float32', undefined, undefined, new Float32Array([value]));
+const settle = () => new Promise(resolve => setTimeout(resolve, 0));
+// the error a promise fails with, if any
+const getError = (promise: Promise<unknown>) => promise.then(() => undefined, (e: Error) => e);
+
+describe('#UnitTest# - wasm - WasmPooledSession', () => {
+  it('creates a copy of the session on every worker', () => {
+    const workers = new TestWorkers(3);
+    const session = new WasmPooledSession(model, options, workers);
+    expect(workers.sentTo('create')).to.deep.equal([0, 1, 2]);
+    session.dispose();
+  });
+
+  it('runs a request on the first idle worker and queues the others', async () => {
+    const workers = new TestWorkers(2);
+    const session = new WasmPooledSession(model, options, workers);
+    const completedRequests = getThroughputMetrics().completedRequests;
+
+    const results = [0, 1, 2].map(i => session.execute([createInput(i)]));
+    await settle();
+    expect(workers.runs.map(run => run.workerId)).to.deep.equal([0, 1]);
+    expect(getThroughputMetrics().queueDepth).to.equal(1);
+
+    // the waiting request goes to the first worker done with its request
+    workers.respond(workers.runs[1]);
+    await settle();
+    expect(workers.runs.map(run => run.workerId)).to.deep.equal([0, 1, 1]);
+    expect(getThroughputMetrics().queueDepth).to.equal(0);
+
+    workers.respond(workers.runs[0]);
+    workers.respond(workers.runs[2]);
+    const outputs = await Promise.all(results);
+    expect(outputs.map(output => output[0].floatData[0])).to.deep.equal([0, 1, 2]);
+    const metrics = getThroughputMetrics();
+    expect(metrics.completedRequests).to.equal(completedRequests + 3);
+    expect(metrics.maxQueueDepth).to.be.at.least(1);
+    expect(metrics.maxLatency).to.be.at.least(metrics.averageLatency);
+
+    session.dispose();
+    await settle();
+    expect(workers.sentTo('release')).to.deep.equal([0, 1]);
+  });
+
+  it('fails a request failing on its worker, and frees the worker', async () => {
+    const workers = new TestWorkers(1);
+    const session = new WasmPooledSession(model, options, workers);
+
+    const failing = session.execute([createInput(0)]);
+    const next = session.execute([createInput(1)]);
+    await settle();
+    workers.runs[0].reject(new Error('run failed'));
+    expect(await getError(failing)).to.have.property('message', 'run failed');
+
+    await settle();
+    expect(workers.runs.length).to.equal(2);
+    workers.respond(workers.runs[1]);
+    expect((await next)[0].floatData[0]).to.equal(1);
+    session.dispose();
+  });
+
+  it('releases the copies created when a worker fails to create its copy', async () => {
+    const workers = new TestWorkers(2, 1);
+    const session = new WasmPooledSession(model, options, workers);
+
+    session.dispose();
+    await settle();
+    expect(workers.sentTo('release')).to.deep.equal([0]);
+
+    expect(await getError(session.execute([createInput(0)]))).to.have.property('message', 'worker-1 failed');
+    expect(workers.sentTo('run')).to.deep.equal([]);
+  });
+});
+
+describe('#UnitTest# - wasm - throughput mode', () => {
+  it('creates the session handler of the throughput mode', () => {
+    const backend = new WasmBackend();
+    const context = {profiler: Profiler.create()};
+    expect(backend.createSessionHandler(context)).to.not.be.an.instanceOf(WasmPooledSessionHandler);
+    backend.throughput = true;
+    expect(backend.createSessionHandler(context)).to.be.an.instanceOf(WasmPooledSessionHandler);
+  });
+});
@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {expect} from 'chai';
+
+import {acquireSharedTensor, getSharedWeights, releaseSharedTensor} from '../../../../lib/backends/wasm/shared-weights';
+import {Tensor} from '../../../../lib/tensor';
+
+const createTensor = (dims: number[], data: number[], type: Tensor.DataType = 'float32') =>
+    Tensor.fromData(type === 'int32' ? new Int32Array(data) : new Float32Array(data), dims, type);
+
+// the 32-bit FNV-1a hash of the keys of the shared tensors
+const hashWords = (words: number[]) => words.reduce((hash, word) => Math.imul(hash ^ word, 0x01000193), 0x811c9dc5);
+
+describe('#UnitTest# - wasm - shared weights', () => {
+  // the tensors acquired by the test, released after it
+  let acquired: Tensor[];
+  const acquire = (tensor: Tensor) => {
+    const shared = acquireSharedTensor(tensor);
+    acquired.push(shared);
+    return shared;
+  };
+
+  beforeEach(() => {
+    acquired = [];
+  });
+  afterEach(() => {
+    acquired.forEach(releaseSharedTensor);
+  });
+
+  it('shares one tensor between the sessions with identical weights', () => {
+    const first = createTensor([2, 2], [1, 2, 3, 4]);
+    expect(acquire(first)).to.equal(first);
+    expect(acquire(createTensor([2, 2], [1, 2, 3, 4]))).to.equal(first);
+    expect(getSharedWeights()).to.deep.equal({tensors: 1, references: 2, bytes: 16, unsharedBytes: 32});
+  });
+
+  it('keeps apart the tensors of different dims or types', () => {
+    const tensors = [
+      createTensor([2, 2], [1, 2, 3, 4]), createTensor([4], [1, 2, 3, 4]),
+      // the same bits as float32 values
+      createTensor([2, 2], Array.from(new Int32Array(new Float32Array([1, 2, 3, 4]).buffer)), 'int32')
+    ];
+    expect(tensors.map(acquire)).to.deep.equal(tensors);
+    expect(getSharedWeights()).to.deep.equal({tensors: 3, references: 3, bytes: 48, unsharedBytes: 48});
+  });
+
+  it('keeps apart the tensors of the same key whose content differs', () => {
+    // the second word cancels the difference of the first one in the hash
+    const words = [1, 0];
+    const collision = [2, Math.imul(0x811c9dc5 ^ 1, 0x01000193) ^ Math.imul(0x811c9dc5 ^ 2, 0x01000193)];
+    expect(hashWords(collision)).to.equal(hashWords(words));
+
+    const first = createTensor([2], words, 'int32');
+    const second = createTensor([2], collision, 'int32');
+    expect(acquire(first)).to.equal(first);
+    expect(acquire(second)).to.equal(second);
+    expect(acquire(createTensor([2], collision, 'int32'))).to.equal(second);
+    expect(getSharedWeights()).to.deep.equal({tensors: 2, references: 3, bytes: 16, unsharedBytes: 24});
+  });
+
+  it('drops a tensor when its last reference is released', () => {
+    const first = createTensor([2], [1, 2]);
+    acquireSharedTensor(first);
+    acquireSharedTensor(createTensor([2], [1, 2]));
+    releaseSharedTensor(first);
+    expect(getSharedWeights()).to.deep.equal({tensors: 1, references: 1, bytes: 8, unsharedBytes: 8});
+    releaseSharedTensor(first);
+    expect(getSharedWeights()).to.deep.equal({tensors: 0, references: 0, bytes: 0, unsharedBytes: 0});
+
+    // the weights are stored again by the next session
+    const next = createTensor([2], [1, 2]);
+    expect(acquire(next)).to.equal(next);
+  });
+
+  it('copies the weights viewing a larger buffer', () => {
+    const file = new Float32Array([0, 1, 2, 3]);
+    const view = Tensor.fromData(file.subarray(1, 3), [2], 'float32');
+    const shared = acquire(view);
+    expect(shared).to.not.equal(view);
+    expect(shared.floatData.buffer).to.not.equal(file.buffer);
+    expect(Array.from(shared.floatData)).to.deep.equal([1, 2]);
+  });
+
+  it('does not share the string tensors', () => {
+    const strings = Tensor.fromData(['a'], [1], 'string');
+    expect(acquireSharedTensor(strings)).to.equal(strings);
+    expect(getSharedWeights().tensors).to.equal(0);
+  });
+});
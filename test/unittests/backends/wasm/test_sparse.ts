@@ -0,0 +1,75 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {expect} from 'chai';
+
+import {WasmBackend} from '../../../../lib/backends/backend-wasm';
+import {WasmSessionHandler} from '../../../../lib/backends/wasm/session-handler';
+import {getSparseReport, isSparseOperator, SparseWeights} from '../../../../lib/backends/wasm/sparse';
+import {Profiler} from '../../../../lib/instrument';
+import {PerformanceData, WasmSessionBinding} from '../../../../lib/wasm-binding-core';
+import {createGraph, createIntAttribute} from '../../graph-utils';
+
+// a binding for the sessions which never call a kernel
+class TestBinding implements WasmSessionBinding {
+  ccall(): PerformanceData {
+    throw new Error('no kernel is expected to run');
+  }
+  ccallRemote(): Promise<PerformanceData> {
+    throw new Error('no kernel is expected to run');
+  }
+  dispose(): void {}
+}
+
+const createHandler = (sparsity: number) => new WasmSessionHandler(
+    new WasmBackend(), {profiler: Profiler.create()},
+    {cpuFallback: false, streaming: false, autotune: false, channelBlock: 0, sparsity, shareWeights: false},
+    new TestBinding());
+
+// resolve the Gemm of a graph multiplying x by constant weights with 3 zeros out of 4
+const resolveGemm = (handler: WasmSessionHandler, transA: number): SparseWeights|undefined => {
+  const graph = createGraph({
+    inputs: [['x', transA ? [4, 1] : [1, 4]]],
+    outputs: ['y'],
+    initializers: [['w', [4, 2], [1, 0, 0, 0, 0, 0, 0, 2]]],
+    nodes: [{opType: 'Gemm', inputs: ['x', 'w'], outputs: ['y'], attributes: [createIntAttribute('transA', transA)]}]
+  });
+  const op = handler.resolve(graph.getNodes()[0], [{domain: '', version: 11}], graph);
+  return isSparseOperator(op) ? op.sparseWeights : undefined;
+};
+
+describe('#UnitTest# - wasm - sparse weights', () => {
+  it('packs the constant weights of a Gemm sparse enough', () => {
+    const handler = createHandler(0.5);
+    const weights = resolveGemm(handler, 0)!;
+    expect(weights.blockSize).to.equal(1);
+    expect(Array.from(weights.rowPointers)).to.deep.equal([0, 1, 1, 1, 2]);
+    expect(Array.from(weights.blockColumns)).to.deep.equal([0, 1]);
+    expect(Array.from(weights.values)).to.deep.equal([1, 2]);
+    handler.dispose();
+  });
+
+  it('keeps the dense weights below the threshold', () => {
+    const handler = createHandler(0.8);
+    expect(resolveGemm(handler, 0)).to.equal(undefined);
+    handler.dispose();
+  });
+
+  it('keeps the dense weights of a Gemm with a transposed A', () => {
+    const handler = createHandler(0.5);
+    expect(resolveGemm(handler, 1)).to.equal(undefined);
+    handler.dispose();
+  });
+
+  it('reports the layers of a session until it is disposed', () => {
+    const layers = getSparseReport().length;
+    const handler = createHandler(0.5);
+    resolveGemm(handler, 0);
+    const report = getSparseReport();
+    expect(report.length).to.equal(layers + 1);
+    expect(report[layers]).to.include({name: 'Gemm_0', opType: 'Gemm', sparsity: 0.75, blockSize: 1});
+
+    handler.dispose();
+    expect(getSparseReport().length).to.equal(layers);
+  });
+});
@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {expect} from 'chai';
+
+import {WasmBackend} from '../../../../lib/backends/backend-wasm';
+import {WasmSessionHandler} from '../../../../lib/backends/wasm/session-handler';
+import {Profiler} from '../../../../lib/instrument';
+import {Tensor} from '../../../../lib/tensor';
+import {PerformanceData, WasmCallArgument, WasmSessionBinding} from '../../../../lib/wasm-binding-core';
+import {createGraph, createIntAttribute} from '../../graph-utils';
+
+// a binding recording whether the runs of the LSTM kernels keep their state, without running them
+class TestBinding implements WasmSessionBinding {
+  keepStates: boolean[] = [];
+  ccall(functionName: string, ...params: WasmCallArgument[]): PerformanceData {
+    if (functionName === '_lstm_create_f32') {
+      (params[params.length - 1][0] as Int32Array)[0] = 1;
+    } else if (functionName === '_lstm_run_f32') {
+      this.keepStates.push(params[7][0] as boolean);
+    }
+    return {};
+  }
+  ccallRemote(): Promise<PerformanceData> {
+    throw new Error('the kernels run in the calling thread');
+  }
+  dispose(): void {}
+}
+
+const float32 = (dims: number[]) => new Tensor(dims, 'float32');
+
+describe('#UnitTest# - wasm - streaming', () => {
+  let binding: TestBinding;
+  let handler: WasmSessionHandler;
+  afterEach(() => {
+    handler.dispose();
+  });
+
+  // run an LSTM of hidden size 1 the given number of times, resetting the state of the session before the runs given
+  const runLSTM = (streaming: boolean, runs: number, resetBefore: number[] = []) => {
+    binding = new TestBinding();
+    handler = new WasmSessionHandler(
+        new WasmBackend(), {profiler: Profiler.create()},
+        {cpuFallback: false, streaming, autotune: false, channelBlock: 0, sparsity: 0, shareWeights: false}, binding);
+    const graph = createGraph({
+      inputs: [['x', [1, 1, 1]], ['w', [1, 4, 1]], ['r', [1, 4, 1]]],
+      outputs: ['y'],
+      nodes: [
+        {opType: 'LSTM', inputs: ['x', 'w', 'r'], outputs: ['y'], attributes: [createIntAttribute('hidden_size', 1)]}
+      ]
+    });
+    const op = handler.resolve(graph.getNodes()[0], [{domain: '', version: 11}], graph);
+    const inputs = [float32([1, 1, 1]), float32([1, 4, 1]), float32([1, 4, 1])];
+    for (let i = 0; i < runs; i++) {
+      if (resetBefore.indexOf(i) !== -1) {
+        handler.resetState();
+      }
+      op.run(handler.createInferenceHandler(), inputs);
+    }
+    return binding.keepStates;
+  };
+
+  it('carries the state over to the next runs in streaming mode', () => {
+    expect(runLSTM(true, 3)).to.deep.equal([false, true, true]);
+  });
+
+  it('starts from the initial state after the state of the session is reset', () => {
+    expect(runLSTM(true, 4, [2])).to.deep.equal([false, true, false, true]);
+  });
+
+  it('does not carry the state over without streaming', () => {
+    expect(runLSTM(false, 2)).to.deep.equal([false, false]);
+  });
+});
+
+describe('#UnitTest# - wasm - streaming option', () => {
+  // the session handlers are not disposed, as they have no binding initialized to release
+  it('takes the streaming option of the session over the one of the backend', () => {
+    const backend = new WasmBackend();
+    const isStreaming = (streaming?: boolean) =>
+        (backend.createSessionHandler({profiler: Profiler.create(), streaming}) as WasmSessionHandler).streaming;
+    expect(isStreaming(true)).to.equal(true);
+    expect(isStreaming()).to.equal(false);
+    backend.streaming = true;
+    expect(isStreaming(false)).to.equal(false);
+    expect(isStreaming()).to.equal(true);
+  });
+});
@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {expect} from 'chai';
+
+import {CpuBackend} from '../../lib/backends/backend-cpu';
+import {computeSchedule, ExecutionPlan} from '../../lib/execution-plan';
+import {Graph} from '../../lib/graph';
+import {Profiler} from '../../lib/instrument';
+import {Tensor} from '../../lib/tensor';
+
+import {createGraph} from './graph-utils';
+
+// three heads on a shared trunk: y1 = -(x + w), y2 = |sigmoid(x + w)| and y3 = relu(y1), which consumes the output y1
+const createMultiHeadGraph = () => createGraph({
+  inputs: [['x', [1, 2]]],
+  outputs: ['y1', 'y2', 'y3'],
+  initializers: [['w', [1, 2], [1, 1]]],
+  nodes: [
+    {opType: 'Add', inputs: ['x', 'w'], outputs: ['a']}, {opType: 'Neg', inputs: ['a'], outputs: ['y1']},
+    {opType: 'Sigmoid', inputs: ['a'], outputs: ['b']}, {opType: 'Abs', inputs: ['b'], outputs: ['y2']},
+    {opType: 'Relu', inputs: ['y1'], outputs: ['y3']}
+  ]
+});
+
+// the indices of the values of the multi-head graph, by name
+const getValueIndices = (graph: Graph) => {
+  const nodes = graph.getNodes();
+  const [y1, y2, y3] = graph.getOutputIndices();
+  const [x, w] = nodes[0].inputs;
+  return {x, w, a: nodes[0].outputs[0], b: nodes[2].outputs[0], y1, y2, y3};
+};
+
+describe('#UnitTest# - ExecutionPlan - schedule', () => {
+  it('runs every node for all the outputs', () => {
+    const graph = createMultiHeadGraph();
+    const {x, a, b} = getValueIndices(graph);
+    expect(computeSchedule(graph)).to.deep.equal({order: [0, 1, 2, 4, 3], releases: [[x], [], [a], [], [b]]});
+  });
+
+  it('runs only the nodes the requested outputs depend on', () => {
+    const graph = createMultiHeadGraph();
+    const {x, a, b, y1, y2, y3} = getValueIndices(graph);
+    expect(computeSchedule(graph, [y2])).to.deep.equal({order: [0, 2, 3], releases: [[x], [a], [b]]});
+    // an output which is not requested is released after its last consumer
+    expect(computeSchedule(graph, [y3])).to.deep.equal({order: [0, 1, 4], releases: [[x], [a], [y1]]});
+    expect(computeSchedule(graph, [y1])).to.deep.equal({order: [0, 1], releases: [[x], [a]]});
+  });
+
+  it('never releases the requested outputs or the initializers', () => {
+    const graph = createMultiHeadGraph();
+    const {w, y1, y2, y3} = getValueIndices(graph);
+    for (const outputs of [[y1, y2, y3], [y1, y3], [y3, y1], [y2, y3], [y1]]) {
+      const released = ([] as number[]).concat(...computeSchedule(graph, outputs).releases);
+      expect(released).to.not.include(w);
+      for (const output of outputs) {
+        expect(released).to.not.include(output);
+      }
+    }
+  });
+});
+
+describe('#UnitTest# - ExecutionPlan - execute', () => {
+  const profiler = Profiler.create();
+  const sessionHandler = new CpuBackend().createSessionHandler({profiler});
+  const input = new Tensor([1, 2], 'float32', undefined, undefined, new Float32Array([1, -3]));
+
+  const createPlan = (graph: Graph) => new ExecutionPlan(
+      graph, graph.getNodes().map(node => sessionHandler.resolve(node, [{domain: '', version: 11}], graph)),
+      profiler);
+  // the schedules the plan computed, by set of requested outputs
+  const getSchedules = (plan: ExecutionPlan) =>
+      (plan as unknown as {schedules: Map<string, ExecutionPlan.Schedule>}).schedules;
+
+  it('returns the requested outputs in the order they are requested', async () => {
+    const graph = createMultiHeadGraph();
+    const {y1, y3} = getValueIndices(graph);
+    const outputs = await createPlan(graph).execute(sessionHandler, [input], [y3, y1]);
+    expect(outputs.map(output => Array.from(output.floatData))).to.deep.equal([[0, 2], [-2, 2]]);
+  });
+
+  it('reuses the schedule of a set of outputs requested in another order', async () => {
+    const graph = createMultiHeadGraph();
+    const {y1, y2} = getValueIndices(graph);
+    const plan = createPlan(graph);
+    await plan.execute(sessionHandler, [input], [y2, y1]);
+    const schedules = getSchedules(plan);
+    const schedule = schedules.get(Array.from(schedules.keys())[0]);
+
+    const outputs = await plan.execute(sessionHandler, [input], [y1, y2]);
+    expect(schedules.size).to.equal(1);
+    expect(schedules.get(Array.from(schedules.keys())[0])).to.equal(schedule);
+    expect(Array.from(outputs[0].floatData)).to.deep.equal([-2, 2]);
+
+    await plan.execute(sessionHandler, [input], [y1]);
+    expect(schedules.size).to.equal(2);
+  });
+});
@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {onnx} from 'onnx-proto';
+
+import {Graph} from '../../lib/graph';
+
+export interface TestNode {
+  opType: string;
+  inputs: string[];
+  outputs: string[];
+  attributes?: onnx.IAttributeProto[];
+}
+
+export interface TestGraph {
+  // the names and the dims of the inputs of the graph
+  inputs: Array<[string, number[]]>;
+  outputs: string[];
+  // the names, the dims and the data of the initializers
+  initializers?: Array<[string, number[], number[]]>;
+  nodes: TestNode[];
+}
+
+/**
+ * build a graph of float tensors, transformed by the given function
+ */
+export function createGraph(graph: TestGraph, transform?: (transformer: Graph.Transformer) => void): Graph {
+  return Graph.from(createGraphProto(graph), transform ? {transformGraph: transform} : undefined);
+}
+
+/**
+ * build a serialized model of the graph, e.g. to load it in a session
+ */
+export function createModel(graph: TestGraph, opsetVersion = 11): Uint8Array {
+  const model = onnx.ModelProto.create(
+      {irVersion: 6, opsetImport: [{domain: '', version: opsetVersion}], graph: createGraphProto(graph)});
+  return onnx.ModelProto.encode(model).finish();
+}
+
+export function createIntAttribute(name: string, i: number): onnx.IAttributeProto {
+  return onnx.AttributeProto.create({name, type: onnx.AttributeProto.AttributeType.INT, i});
+}
+
+export function createIntsAttribute(name: string, ints: number[]): onnx.IAttributeProto {
+  return onnx.AttributeProto.create({name, type: onnx.AttributeProto.AttributeType.INTS, ints});
+}
+
+export function createFloatAttribute(name: string, f: number): onnx.IAttributeProto {
+  return onnx.AttributeProto.create({name, type: onnx.AttributeProto.AttributeType.FLOAT, f});
+}
+
+export function createFloatsAttribute(name: string, floats: number[]): onnx.IAttributeProto {
+  return onnx.AttributeProto.create({name, type: onnx.AttributeProto.AttributeType.FLOATS, floats});
+}
+
+export function createStringAttribute(name: string, s: string): onnx.IAttributeProto {
+  return onnx.AttributeProto.create({name, type: onnx.AttributeProto.AttributeType.STRING, s: Buffer.from(s, 'utf8')});
+}
+
+export function createTensorAttribute(name: string, dims: number[], floatData: number[]): onnx.IAttributeProto {
+  return onnx.AttributeProto.create(
+      {name, type: onnx.AttributeProto.AttributeType.TENSOR, t: createTensor(name, dims, floatData)});
+}
+
+/**
+ * get the operator types of the nodes of a graph, e.g. to check the result of a transformation
+ */
+export function getOpTypes(graph: Graph): string[] {
+  return graph.getNodes().map(node => node.opType);
+}
+
+function createGraphProto(graph: TestGraph): onnx.IGraphProto {
+  return onnx.GraphProto.create({
+    input: graph.inputs.map(([name, dims]) => createValueInfo(name, dims)),
+    output: graph.outputs.map(name => createValueInfo(name, [])),
+    initializer: (graph.initializers || []).map(([name, dims, data]) => createTensor(name, dims, data)),
+    node: graph.nodes.map((node, i) => onnx.NodeProto.create({
+      name: `${node.opType}_${i}`,
+      opType: node.opType,
+      input: node.inputs,
+      output: node.outputs,
+      attribute: node.attributes || []
+    }))
+  });
+}
+
+function createTensor(name: string, dims: number[], floatData: number[]): onnx.ITensorProto {
+  return onnx.TensorProto.create({name, dims, dataType: onnx.TensorProto.DataType.FLOAT, floatData});
+}
+
+function createValueInfo(name: string, dims: number[]): onnx.IValueInfoProto {
+  return onnx.ValueInfoProto.create({
+    name,
+    type: {tensorType: {elemType: onnx.TensorProto.DataType.FLOAT, shape: {dim: dims.map(dimValue => ({dimValue}))}}}
+  });
+}
@@ -0,0 +1,184 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {expect} from 'chai';
+
+import {Graph} from '../../lib/graph';
+
+import {createGraph, createIntAttribute, createIntsAttribute, getOpTypes, TestGraph, TestNode} from './graph-utils';
+
+describe('#UnitTest# - Graph - fuseAttentionNodes', () => {
+  // Softmax(Q * K_t / divisor + mask) * V
+  const createAttention = (axis = 3, divisorDims = [] as number[], extraNodes: TestNode[] = []): TestGraph => ({
+    inputs: [['q', [1, 2, 4, 8]], ['kT', [1, 2, 8, 4]], ['mask', [1, 1, 4, 4]], ['v', [1, 2, 4, 8]]],
+    outputs: ['y'].concat(...extraNodes.map(node => node.outputs)),
+    initializers: [['divisor', divisorDims, divisorDims.length === 0 ? [2.8] : new Array(divisorDims[0]).fill(2.8)]],
+    nodes: [
+      {opType: 'MatMul', inputs: ['q', 'kT'], outputs: ['scores']},
+      {opType: 'Div', inputs: ['scores', 'divisor'], outputs: ['scaled']},
+      {opType: 'Add', inputs: ['scaled', 'mask'], outputs: ['masked']},
+      {opType: 'Softmax', inputs: ['masked'], outputs: ['probs'], attributes: [createIntAttribute('axis', axis)]},
+      {opType: 'MatMul', inputs: ['probs', 'v'], outputs: ['y']},
+      ...extraNodes
+    ]
+  });
+  const fuse = (transformer: Graph.Transformer) => transformer.fuseAttentionNodes();
+
+  it('fuses the attention nodes', () => {
+    const graph = createGraph(createAttention(), fuse);
+    expect(getOpTypes(graph)).to.deep.equal(['FusedAttention']);
+
+    const node = graph.getNodes()[0];
+    const values = graph.getValues();
+    const input = (name: string) => graph.getInputIndices()[graph.getInputNames().indexOf(name)];
+    expect(node.inputs.length).to.equal(5);
+    expect([node.inputs[0], node.inputs[1], node.inputs[3], node.inputs[4]])
+        .to.deep.equal([input('q'), input('kT'), input('mask'), input('v')]);
+    expect(values[node.inputs[2]].tensor!.floatData[0]).to.be.closeTo(2.8, 1e-6);
+    expect(node.outputs).to.deep.equal(graph.getOutputIndices());
+    expect(node.attributes.getInt('axis')).to.equal(3);
+    // the inputs go to the fused node only
+    node.inputs.forEach(i => expect(values[i].to).to.deep.equal([0]));
+  });
+
+  it('fuses the attention nodes with the mask as the first input of Add', () => {
+    const attention = createAttention();
+    attention.nodes[2].inputs = ['mask', 'scaled'];
+    const graph = createGraph(attention, fuse);
+    expect(getOpTypes(graph)).to.deep.equal(['FusedAttention']);
+  });
+
+  it('fuses the attention nodes with a softmax over the axis -1', () => {
+    expect(getOpTypes(createGraph(createAttention(-1), fuse))).to.deep.equal(['FusedAttention']);
+  });
+
+  it('does not fuse a softmax over another axis than the last one', () => {
+    expect(getOpTypes(createGraph(createAttention(1), fuse))).to.deep.equal([
+      'MatMul', 'Div', 'Add', 'Softmax', 'MatMul'
+    ]);
+  });
+
+  it('does not fuse a divisor that is not a scalar', () => {
+    expect(getOpTypes(createGraph(createAttention(3, [4]), fuse))).to.deep.equal([
+      'MatMul', 'Div', 'Add', 'Softmax', 'MatMul'
+    ]);
+  });
+
+  it('does not fuse an intermediate value used by another node', () => {
+    const graph = createGraph(createAttention(3, [], [{opType: 'Relu', inputs: ['scaled'], outputs: ['relu']}]), fuse);
+    expect(getOpTypes(graph)).to.deep.equal(['MatMul', 'Div', 'Add', 'Softmax', 'MatMul', 'Relu']);
+  });
+
+  it('does not fuse an intermediate value that is a graph output', () => {
+    const attention = createAttention();
+    attention.outputs.push('probs');
+    const graph = createGraph(attention, fuse);
+    expect(getOpTypes(graph)).to.deep.equal(['MatMul', 'Div', 'Add', 'Softmax', 'MatMul']);
+  });
+});
+
+describe('#UnitTest# - Graph - convertToBlockedLayout', () => {
+  const convert = (transformer: Graph.Transformer) => transformer.convertToBlockedLayout(4);
+  const createWeights = (name: string, dims: number[]): [string, number[], number[]] =>
+      [name, dims, new Array(dims.reduce((a, b) => a * b)).fill(0.1)];
+  // the node producing a value, and the nodes consuming it
+  const producer = (graph: Graph, value: number) => graph.getNodes()[graph.getValues()[value].from];
+  const consumers = (graph: Graph, value: number) =>
+      graph.getValues()[value].to.map(node => graph.getNodes()[node].opType).sort();
+
+  it('converts a chain of convolutions, pools and activations', () => {
+    const graph = createGraph(
+        {
+          inputs: [['x', [1, 3, 8, 8]]],
+          outputs: ['y'],
+          initializers: [createWeights('w1', [8, 3, 3, 3]), createWeights('w2', [6, 8, 1, 1])],
+          nodes: [
+            {
+              opType: 'Conv',
+              inputs: ['x', 'w1'],
+              outputs: ['c1'],
+              attributes: [createIntsAttribute('pads', [1, 1, 1, 1])]
+            },
+            {opType: 'Relu', inputs: ['c1'], outputs: ['r1']},
+            {
+              opType: 'MaxPool',
+              inputs: ['r1'],
+              outputs: ['p1'],
+              attributes: [createIntsAttribute('kernel_shape', [2, 2])]
+            },
+            {opType: 'Conv', inputs: ['p1', 'w2'], outputs: ['y']}
+          ]
+        },
+        convert);
+    expect(getOpTypes(graph).sort()).to.deep.equal([
+      'ConvNCHWc', 'ConvNCHWc', 'MaxPoolNCHWc', 'ReorderFromNCHWc', 'ReorderToNCHWc', 'Relu'
+    ]);
+
+    // the input is reordered once, for the first convolution
+    const x = graph.getInputIndices()[0];
+    expect(consumers(graph, x)).to.deep.equal(['ReorderToNCHWc']);
+    const reorderTo = graph.getNodes()[graph.getValues()[x].to[0]];
+    expect(reorderTo.attributes.getInt('block')).to.equal(4);
+    expect(consumers(graph, reorderTo.outputs[0])).to.deep.equal(['ConvNCHWc']);
+
+    // the output is reordered back from the last convolution, with its channels
+    const reorderFrom = producer(graph, graph.getOutputIndices()[0]);
+    expect(reorderFrom.opType).to.equal('ReorderFromNCHWc');
+    expect(reorderFrom.attributes.getInt('channels')).to.equal(6);
+    expect(producer(graph, reorderFrom.inputs[0]).opType).to.equal('ConvNCHWc');
+  });
+
+  it('reorders a blocked value back for the nodes that are not converted', () => {
+    const graph = createGraph(
+        {
+          inputs: [['x', [1, 3, 8, 8]]],
+          outputs: ['y', 'r'],
+          initializers: [createWeights('w', [6, 3, 1, 1])],
+          nodes: [
+            {opType: 'Conv', inputs: ['x', 'w'], outputs: ['c']},
+            {opType: 'Relu', inputs: ['c'], outputs: ['r']},
+            {opType: 'Softmax', inputs: ['r'], outputs: ['y']}
+          ]
+        },
+        convert);
+    expect(getOpTypes(graph).sort()).to.deep.equal([
+      'ConvNCHWc', 'ReorderFromNCHWc', 'ReorderToNCHWc', 'Relu', 'Softmax'
+    ]);
+    // the value consumed by the softmax and the graph output are the one computed again in the plain layout
+    const r = graph.getOutputIndices()[1];
+    const reorderFrom = producer(graph, r);
+    expect(reorderFrom.opType).to.equal('ReorderFromNCHWc');
+    expect(reorderFrom.attributes.getInt('channels')).to.equal(6);
+    expect(consumers(graph, r)).to.deep.equal(['Softmax']);
+  });
+
+  it('does not convert a grouped convolution', () => {
+    const graph = createGraph(
+        {
+          inputs: [['x', [1, 4, 8, 8]]],
+          outputs: ['y'],
+          initializers: [createWeights('w', [4, 2, 3, 3])],
+          nodes: [{opType: 'Conv', inputs: ['x', 'w'], outputs: ['y'], attributes: [createIntAttribute('group', 2)]}]
+        },
+        convert);
+    expect(getOpTypes(graph)).to.deep.equal(['Conv']);
+  });
+
+  it('does not concatenate blocks that are not full', () => {
+    const graph = createGraph(
+        {
+          inputs: [['x', [1, 3, 8, 8]]],
+          outputs: ['y'],
+          initializers: [createWeights('w1', [6, 3, 1, 1]), createWeights('w2', [6, 3, 1, 1])],
+          nodes: [
+            {opType: 'Conv', inputs: ['x', 'w1'], outputs: ['c1']},
+            {opType: 'Conv', inputs: ['x', 'w2'], outputs: ['c2']},
+            {opType: 'Concat', inputs: ['c1', 'c2'], outputs: ['y'], attributes: [createIntAttribute('axis', 1)]}
+          ]
+        },
+        convert);
+    expect(getOpTypes(graph).sort()).to.deep.equal([
+      'Concat', 'ConvNCHWc', 'ConvNCHWc', 'ReorderFromNCHWc', 'ReorderFromNCHWc', 'ReorderToNCHWc'
+    ]);
+  });
+});
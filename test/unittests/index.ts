@@ -17,3 +17,17 @@ if (typeof window !== 'undefined' && !onnx.backend.webgl.disabled) {
 // require('./api/types');
 
 // require('./opset');
+
+require('./graph');
+require('./backends/wasm/test_session_pool');
+require('./request-batcher');
+require('./session');
+require('./backends/wasm/test_partitioner');
+require('./backends/wasm/test_autotuner');
+require('./backends/wasm/test_sparse');
+require('./prepacked-model');
+require('./backends/wasm/test_shared_weights');
+require('./execution-plan');
+require('./backends/wasm/test_image_preprocess');
+require('./backends/wasm/test_cpu_fallback');
+require('./backends/wasm/test_streaming');
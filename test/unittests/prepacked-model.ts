@@ -0,0 +1,198 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {expect} from 'chai';
+
+import {WasmBackend} from '../../lib/backends/backend-wasm';
+import {WasmSessionHandler} from '../../lib/backends/wasm/session-handler';
+import {packSparseWeights, releaseSparseWeights, SparseWeights} from '../../lib/backends/wasm/sparse';
+import {computeSchedule} from '../../lib/execution-plan';
+import {Graph} from '../../lib/graph';
+import {Logger, Profiler} from '../../lib/instrument';
+import {encodePrepackedModel, isPrepackedModel, PrepackedGraph, PrepackedModel, WEIGHTS_ALIGNMENT} from '../../lib/prepacked-model';
+import {PerformanceData, WasmSessionBinding} from '../../lib/wasm-binding-core';
+
+import {createFloatAttribute, createFloatsAttribute, createGraph, createIntsAttribute, createStringAttribute, createTensorAttribute} from './graph-utils';
+
+// a binding for the sessions which never call a kernel
+class TestBinding implements WasmSessionBinding {
+  ccall(): PerformanceData {
+    throw new Error('no kernel is expected to run');
+  }
+  ccallRemote(): Promise<PerformanceData> {
+    throw new Error('no kernel is expected to run');
+  }
+  dispose(): void {}
+}
+
+const options: PrepackedModel.Options = {cpuFallback: true, channelBlock: 0, sparsity: 0.5};
+
+// a Gemm with constant weights, 3 zeros out of 4, followed by a node of every kind of attribute
+const createTestGraph = () => createGraph({
+  inputs: [['x', [1, 4]]],
+  outputs: ['y'],
+  initializers: [['w', [4, 2], [1, 0, 0, 0, 0, 0, 0, 2]]],
+  nodes: [
+    {
+      opType: 'Gemm',
+      inputs: ['x', 'w'],
+      outputs: ['h'],
+      attributes: [createFloatAttribute('alpha', Infinity), createFloatAttribute('beta', NaN)]
+    },
+    {
+      opType: 'Custom',
+      inputs: ['h'],
+      outputs: ['y'],
+      attributes: [
+        createFloatsAttribute('floats', [-Infinity, 1.5]), createIntsAttribute('ints', [1, 2]),
+        createStringAttribute('mode', 'edge'), createTensorAttribute('value', [2], [3, 4])
+      ]
+    }
+  ]
+});
+
+// prepack the test graph, with the packed weights of its Gemm
+const prepack = (graph: Graph, packOptions = options): Uint8Array => {
+  const gemm = graph.getNodes()[0];
+  const weights = graph.getValues()[gemm.inputs[1]].tensor!;
+  const sparseWeights = packSparseWeights(gemm, weights, weights.floatData, 4, 2, packOptions.sparsity)!;
+  releaseSparseWeights(sparseWeights);
+  return encodePrepackedModel(
+      graph, [{domain: '', version: 11}], packOptions, computeSchedule(graph), new Map([[0, sparseWeights]]));
+};
+
+// the error a function throws, if any
+const getError = (func: () => unknown) => {
+  try {
+    func();
+    return undefined;
+  } catch (e) {
+    return e as Error;
+  }
+};
+
+describe('#UnitTest# - PrepackedModel', () => {
+  it('reads back the graph it was written from', () => {
+    const graph = createTestGraph();
+    const buf = prepack(graph);
+    expect(isPrepackedModel(buf)).to.equal(true);
+    const read = Graph.from(new PrepackedGraph(buf));
+
+    expect(read.getInputNames()).to.deep.equal(graph.getInputNames());
+    expect(read.getInputIndices()).to.deep.equal(graph.getInputIndices());
+    expect(read.getOutputNames()).to.deep.equal(graph.getOutputNames());
+    expect(read.getOutputIndices()).to.deep.equal(graph.getOutputIndices());
+    expect(read.getNodes().map(node => [node.name, node.opType, node.inputs, node.outputs]))
+        .to.deep.equal(graph.getNodes().map(node => [node.name, node.opType, node.inputs, node.outputs]));
+    expect(read.getValues().map(value => value.from)).to.deep.equal(graph.getValues().map(value => value.from));
+  });
+
+  it('reads back the attributes, including the non-finite floats and the tensors', () => {
+    const [gemm, custom] = Graph.from(new PrepackedGraph(prepack(createTestGraph()))).getNodes();
+    expect(gemm.attributes.getFloat('alpha')).to.equal(Infinity);
+    expect(isNaN(gemm.attributes.getFloat('beta'))).to.equal(true);
+    expect(custom.attributes.getFloats('floats')).to.deep.equal([-Infinity, 1.5]);
+    expect(custom.attributes.getInts('ints')).to.deep.equal([1, 2]);
+    expect(custom.attributes.getString('mode')).to.equal('edge');
+    const value = custom.attributes.getTensor('value');
+    expect(value.dims).to.deep.equal([2]);
+    expect(Array.from(value.floatData)).to.deep.equal([3, 4]);
+  });
+
+  it('reads the initializers as aligned views on the buffer', () => {
+    const buf = prepack(createTestGraph());
+    const read = Graph.from(new PrepackedGraph(buf));
+    const weights = read.getValues()[read.getNodes()[0].inputs[1]].tensor!;
+    expect(weights.dims).to.deep.equal([4, 2]);
+    expect(Array.from(weights.floatData)).to.deep.equal([1, 0, 0, 0, 0, 0, 0, 2]);
+    expect(weights.floatData.buffer).to.equal(buf.buffer);
+    expect(weights.floatData.byteOffset % WEIGHTS_ALIGNMENT).to.equal(0);
+  });
+
+  it('reads back the schedule and the packed weights', () => {
+    const graph = createTestGraph();
+    const prepacked = new PrepackedGraph(prepack(graph));
+    const schedule = computeSchedule(graph);
+    expect(prepacked.header.schedule).to.deep.equal({order: schedule.order, releases: schedule.releases});
+    expect(prepacked.header.options).to.deep.equal(options);
+
+    const [info] = prepacked.header.sparseWeights;
+    expect(info).to.include({node: 0, input: 1, blockSize: 1, sparsity: 0.75});
+    expect(Array.from(prepacked.readTensor(info.rowPointers).data)).to.deep.equal([0, 1, 1, 1, 2]);
+    expect(Array.from(prepacked.readTensor(info.blockColumns).data)).to.deep.equal([0, 1]);
+    expect(Array.from(prepacked.readTensor(info.values).data)).to.deep.equal([1, 2]);
+  });
+
+  it('rejects a buffer which is not a prepacked model', () => {
+    const buf = new Uint8Array(64);
+    expect(isPrepackedModel(buf)).to.equal(false);
+    expect(getError(() => new PrepackedGraph(buf))).to.have.property('message', 'not a prepacked model');
+  });
+
+  it('rejects another version of the format', () => {
+    const buf = prepack(createTestGraph());
+    new DataView(buf.buffer, buf.byteOffset).setUint32(8, 2, true);
+    expect(getError(() => new PrepackedGraph(buf)))
+        .to.have.property('message', 'unsupported version of the prepacked model format: 2');
+  });
+
+  it('rejects a truncated header', () => {
+    const buf = prepack(createTestGraph());
+    expect(getError(() => new PrepackedGraph(buf.subarray(0, 32))))
+        .to.have.property('message', 'invalid prepacked model: truncated header');
+  });
+
+  it('rejects a tensor out of the weights', () => {
+    const buf = prepack(createTestGraph());
+    const prepacked = new PrepackedGraph(buf);
+    expect(getError(() => prepacked.readTensor({type: 'float32', dims: [2], offset: buf.byteLength})))
+        .to.have.property('message', 'invalid prepacked model: tensor out of the weights');
+    expect(getError(() => prepacked.readTensor({type: 'float32', dims: [2]})))
+        .to.have.property('message', 'invalid prepacked model: tensor out of the weights');
+  });
+});
+
+describe('#UnitTest# - wasm - loading a prepacked model', () => {
+  const warning = Logger.warning;
+  let warnings: string[];
+
+  before(() => {
+    Logger.warning = (category: string, content?: string) => {
+      warnings.push(content === undefined ? category : content);
+    };
+  });
+  beforeEach(() => {
+    warnings = [];
+  });
+  after(() => {
+    Logger.warning = warning;
+  });
+
+  // load the test graph prepacked with the options in a session handler with the backend options
+  const load = (backendOptions: PrepackedModel.Options, packOptions: PrepackedModel.Options): SparseWeights => {
+    const handler = new WasmSessionHandler(
+        new WasmBackend(), {profiler: Profiler.create()},
+        {...backendOptions, streaming: false, autotune: false, shareWeights: false}, new TestBinding());
+    const prepacked = new PrepackedGraph(prepack(createTestGraph(), packOptions));
+    const graph = Graph.from(prepacked);
+    handler.loadPrepackedModel(prepacked, graph);
+    const op = handler.resolve(graph.getNodes()[0], prepacked.header.opsets, graph) as {sparseWeights?: SparseWeights};
+    handler.dispose();
+    return op.sparseWeights!;
+  };
+
+  it('takes the packed weights of the model', () => {
+    const weights = load(options, options);
+    expect(weights.source.dims).to.deep.equal([4, 2]);
+    expect(Array.from(weights.values)).to.deep.equal([1, 2]);
+    expect(warnings).to.deep.equal([]);
+  });
+
+  it('warns about the options of the backend replaced by the ones of the model', () => {
+    load({cpuFallback: false, channelBlock: 8, sparsity: 0}, options);
+    expect(warnings).to.deep.equal([
+      'the prepacked model was prepared with other options of the backend, using its cpuFallback=true, ' +
+      'channelBlock=0, sparsity=0.5'
+    ]);
+  });
+});
@@ -0,0 +1,128 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {expect} from 'chai';
+
+import {RequestBatcher} from '../../lib/request-batcher';
+import {Tensor} from '../../lib/tensor';
+
+// runs the requests with the first dimension of their inputs as their batch size, doubling the inputs
+class TestRunner {
+  calls: Array<ReadonlyArray<number>> = [];
+  constructor(private failBatches = false, private unbatchedOutputs = false) {}
+
+  execute = async (inputs: Tensor[]): Promise<Tensor[]> => {
+    const batchSize = inputs[0].dims[0];
+    this.calls.push(inputs[0].dims);
+    if (this.failBatches && batchSize > 1) {
+      throw new Error('batches are not supported');
+    }
+    if (this.unbatchedOutputs && batchSize > 1) {
+      return [new Tensor([], 'float32')];
+    }
+    return inputs.map(input => createTensor(input.dims, Array.from(input.floatData).map(value => 2 * value)));
+  };
+}
+
+const createTensor = (dims: ReadonlyArray<number>, data: number[]) =>
+    new Tensor(dims, 'float32', undefined, undefined, new Float32Array(data));
+// a configuration of a model computing the samples independently
+const createConfig = (maxBatchSize: number, maxWaitTime: number) =>
+    ({maxBatchSize, maxWaitTime, independentSamples: true});
+const sleep = (ms: number) => new Promise(resolve => setTimeout(resolve, ms));
+
+describe('#UnitTest# - RequestBatcher', () => {
+  it('merges the compatible requests waiting together', async () => {
+    const runner = new TestRunner();
+    const batcher = new RequestBatcher(runner.execute, createConfig(8, 5));
+    const results = [
+      batcher.run([createTensor([1, 2], [1, 2])]), batcher.run([createTensor([2, 2], [3, 4, 5, 6])]),
+      batcher.run([createTensor([1, 2], [7, 8])])
+    ];
+    expect(runner.calls).to.deep.equal([]);
+
+    const outputs = await Promise.all(results);
+    expect(runner.calls).to.deep.equal([[4, 2]]);
+    expect(outputs.map(output => output[0].dims)).to.deep.equal([[1, 2], [2, 2], [1, 2]]);
+    expect(outputs.map(output => Array.from(output[0].floatData))).to.deep.equal([[2, 4], [6, 8, 10, 12], [14, 16]]);
+  });
+
+  it('runs a request alone when no other one joins it in time', async () => {
+    const runner = new TestRunner();
+    const batcher = new RequestBatcher(runner.execute, createConfig(8, 5));
+    const result = batcher.run([createTensor([1, 2], [1, 2])]);
+    await sleep(1);
+    expect(runner.calls).to.deep.equal([]);
+
+    expect(Array.from((await result)[0].floatData)).to.deep.equal([2, 4]);
+    expect(runner.calls).to.deep.equal([[1, 2]]);
+  });
+
+  it('runs a batch as soon as it is full', async () => {
+    const runner = new TestRunner();
+    const batcher = new RequestBatcher(runner.execute, createConfig(3, 1000));
+    const results = [batcher.run([createTensor([1, 1], [1])]), batcher.run([createTensor([2, 1], [2, 3])])];
+    expect(runner.calls).to.deep.equal([[3, 1]]);
+    expect((await Promise.all(results)).map(output => Array.from(output[0].floatData))).to.deep.equal([[2], [4, 6]]);
+  });
+
+  it('does not merge requests beyond the maximum batch size', async () => {
+    const runner = new TestRunner();
+    const batcher = new RequestBatcher(runner.execute, createConfig(3, 5));
+    const results = [batcher.run([createTensor([2, 1], [1, 2])]), batcher.run([createTensor([2, 1], [3, 4])])];
+    // the first request runs alone when the second one does not fit in its batch
+    expect(runner.calls).to.deep.equal([[2, 1]]);
+    await Promise.all(results);
+    expect(runner.calls).to.deep.equal([[2, 1], [2, 1]]);
+
+    // a request as large as a batch runs at once
+    await batcher.run([createTensor([3, 1], [1, 2, 3])]);
+    expect(runner.calls[2]).to.deep.equal([3, 1]);
+  });
+
+  it('does not merge requests of different shapes', async () => {
+    const runner = new TestRunner();
+    const batcher = new RequestBatcher(runner.execute, createConfig(8, 5));
+    const results = [batcher.run([createTensor([1, 2], [1, 2])]), batcher.run([createTensor([1, 3], [1, 2, 3])])];
+    expect(runner.calls).to.deep.equal([[1, 2]]);
+    await Promise.all(results);
+    expect(runner.calls).to.deep.equal([[1, 2], [1, 3]]);
+
+    // a request without a batch axis is not batched
+    const scalar = new Tensor([], 'float32');
+    await batcher.run([scalar]);
+    expect(runner.calls[2]).to.deep.equal([]);
+  });
+
+  it('runs the requests one by one when the outputs of a batch are not batched', async () => {
+    const runner = new TestRunner(false, true);
+    const batcher = new RequestBatcher(runner.execute, createConfig(8, 5));
+    const outputs =
+        await Promise.all([batcher.run([createTensor([1, 1], [1])]), batcher.run([createTensor([1, 1], [2])])]);
+    expect(runner.calls).to.deep.equal([[2, 1], [1, 1], [1, 1]]);
+    expect(outputs.map(output => Array.from(output[0].floatData))).to.deep.equal([[2], [4]]);
+  });
+
+  it('runs the requests one by one when a batch fails', async () => {
+    const runner = new TestRunner(true);
+    const batcher = new RequestBatcher(runner.execute, createConfig(8, 5));
+    const outputs =
+        await Promise.all([batcher.run([createTensor([1, 1], [1])]), batcher.run([createTensor([1, 1], [2])])]);
+    expect(runner.calls).to.deep.equal([[2, 1], [1, 1], [1, 1]]);
+    expect(outputs.map(output => Array.from(output[0].floatData))).to.deep.equal([[2], [4]]);
+  });
+
+  it('rejects an invalid configuration', () => {
+    const runner = new TestRunner();
+    expect(() => new RequestBatcher(runner.execute, createConfig(0, 5))).to.throw(RangeError);
+    expect(() => new RequestBatcher(runner.execute, createConfig(4, -1))).to.throw(RangeError);
+  });
+
+  it('requires the configuration to declare that the samples are independent', () => {
+    const runner = new TestRunner();
+    expect(() => new RequestBatcher(runner.execute, {...createConfig(8, 5), independentSamples: false}))
+        .to.throw(TypeError);
+    expect(() => new RequestBatcher(runner.execute, {maxBatchSize: 8, maxWaitTime: 5} as RequestBatcher.Config))
+        .to.throw(TypeError);
+  });
+});
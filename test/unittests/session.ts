@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import {expect} from 'chai';
+
+import {InferenceSession} from '../../lib/api/inference-session-impl';
+import {Tensor as ApiTensor} from '../../lib/api/tensor-impl';
+import {SessionHandler} from '../../lib/backend';
+import {ExecutionPlan} from '../../lib/execution-plan';
+import {Session} from '../../lib/session';
+import {Tensor} from '../../lib/tensor';
+
+import {createModel} from './graph-utils';
+
+const createInput = (data: number[]) =>
+    new Tensor([data.length / 2, 2], 'float32', undefined, undefined, new Float32Array(data));
+// the error a promise fails with, if any
+const getError = (promise: Promise<unknown>) => promise.then(() => undefined, (e: Error) => e);
+
+// two heads on the same input: y1 = -x and y2 = |x|
+const twoHeadModel = createModel({
+  inputs: [['x', [1, 2]]],
+  outputs: ['y1', 'y2'],
+  nodes: [{opType: 'Neg', inputs: ['x'], outputs: ['y1']}, {opType: 'Abs', inputs: ['x'], outputs: ['y2']}]
+});
+
+describe('#UnitTest# - Session - batching', () => {
+  const execute = ExecutionPlan.prototype.execute;
+  let running = 0;
+  let maxRunning = 0;
+
+  before(() => {
+    // count the runs of the execution plans in progress
+    ExecutionPlan.prototype.execute = async function(
+        this: ExecutionPlan, sessionHandler: SessionHandler, inputs: Tensor[], outputs?: ReadonlyArray<number>) {
+      maxRunning = Math.max(maxRunning, ++running);
+      try {
+        await new Promise(resolve => setTimeout(resolve, 5));
+        return await execute.call(this, sessionHandler, inputs, outputs);
+      } finally {
+        running--;
+      }
+    };
+  });
+
+  after(() => {
+    ExecutionPlan.prototype.execute = execute;
+  });
+
+  it('runs the batches one at a time', async () => {
+    const batching = {maxBatchSize: 2, maxWaitTime: 0, independentSamples: true};
+    const session = new Session({backendHint: 'cpu', batching});
+    await session.loadModel(createModel({
+      inputs: [['x', [1, 2]]],
+      outputs: ['y'],
+      nodes: [{opType: 'Neg', inputs: ['x'], outputs: ['y']}]
+    }));
+
+    // the first two requests make a full batch, which is still running when the next two make another one
+    const results = [1, 2, 3, 4].map(i => session.run([createInput([i, -i])]));
+    const outputs = await Promise.all(results);
+    expect(maxRunning).to.equal(1);
+    expect(outputs.map(output => Array.from(output.get('y')!.floatData))).to.deep.equal([
+      [-1, 1], [-2, 2], [-3, 3], [-4, 4]
+    ]);
+  });
+});
+
+describe('#UnitTest# - Session - output names', () => {
+  let session: Session;
+
+  before(async () => {
+    session = new Session({backendHint: 'cpu'});
+    await session.loadModel(twoHeadModel);
+  });
+
+  it('returns the requested outputs only', async () => {
+    const outputs = await session.run([createInput([1, -3])], ['y2']);
+    expect(Array.from(outputs.keys())).to.deep.equal(['y2']);
+    expect(Array.from(outputs.get('y2')!.floatData)).to.deep.equal([1, 3]);
+  });
+
+  it('returns all the outputs when none is requested', async () => {
+    const outputs = await session.run([createInput([1, -3])]);
+    expect(Array.from(outputs.keys())).to.deep.equal(['y1', 'y2']);
+  });
+
+  it('rejects an unknown output', async () => {
+    expect(await getError(session.run([createInput([1, -3])], ['y3'])))
+        .to.have.property('message', `'y3' is not an output of the model`);
+  });
+
+  it('rejects an output requested twice', async () => {
+    expect(await getError(session.run([createInput([1, -3])], ['y1', 'y2', 'y1'])))
+        .to.have.property('message', `output 'y1' is requested more than once`);
+  });
+
+  it('runs the inputs of an object by name with the requested outputs of the run options', async () => {
+    const inferenceSession = new InferenceSession({backendHint: 'cpu'});
+    await inferenceSession.loadModel(twoHeadModel);
+    const outputs =
+        await inferenceSession.run({x: new ApiTensor([1, -3], 'float32', [1, 2])}, {outputNames: ['y2', 'y1']});
+    expect(Array.from(outputs.keys())).to.deep.equal(['y2', 'y1']);
+    expect(Array.from(outputs.get('y2')!.data as Float32Array)).to.deep.equal([1, 3]);
+    expect(Array.from(outputs.get('y1')!.data as Float32Array)).to.deep.equal([-1, 3]);
+  });
+});
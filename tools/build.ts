@@ -16,6 +16,8 @@ const buildWasm = process.argv.indexOf('--build-wasm') !== -1;
 const cleanInstall = process.argv.indexOf('--clean-install') !== -1;
 // To call webpack to generate the bundle .js file
 const buildBundle = process.argv.indexOf('--build-bundle') !== -1;
+// To build the WebAssembly kernels without their compile-time specializations (to measure their code size)
+const noKernelSpecializations = process.argv.indexOf('--no-kernel-specializations') !== -1;
 
 // tslint:disable: non-literal-fs-path
 
@@ -185,6 +187,9 @@ if (!buildWasm) {
   }
 
   BUILD_OPTIONS.push(`-s "EXPORTED_FUNCTIONS=[${exportedFunctions.map(f => `${f}`).join(',')}]"`);
+  if (noKernelSpecializations) {
+    BUILD_OPTIONS.push('-DWASM_NO_KERNEL_SPECIALIZATIONS');
+  }
 
   const cppFileNames = globby.sync(srcPatterns, {cwd: SRC});
   if (cppFileNames.length === 0) {
@@ -207,6 +212,9 @@ if (!buildWasm) {
     process.exit(emccBuild.status === null ? undefined : emccBuild.status);
   }
   npmlog.info('Build.Wasm', '(4/4) Building... DONE');
+  if (fs.existsSync(OUT_WASM)) {
+    npmlog.info('Build.Wasm', `Size of ${OUT_WASM}: ${fs.statSync(OUT_WASM).size} bytes`);
+  }
 }
 npmlog.info('Build', `Building WebAssembly sources... ${buildWasm ? 'DONE' : 'SKIPPED'}`);
 
@@ -0,0 +1,788 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+// kernel-regression
+//
+// this script runs the kernels of the WebAssembly backend (lib/backends/wasm/op-resolve-rules.ts) in Node.js on a
+// sweep of shapes and attributes (broadcast patterns, groups, padding, strides, layouts...), checks their outputs
+// against the reference implementations of the CPU backend and measures their latencies.
+// usage:
+// > npm run build:node && npm run build:wasm
+// > node tools/kernel-regression [--op=Conv,MatMul] [--iterations=20] [--seed=1] [--output=results.json]
+//       [--baseline=baseline.json] [--latency-tolerance=0.1] [--ulp-tolerance=16]
+//
+// the accuracy of every case is the maximum distance in ULPs, the maximum absolute error and the maximum relative
+// error of the outputs, and the number of elements whose absolute and relative errors both exceed the thresholds
+// (--absolute-error=1e-4, --relative-error=1e-5). a case whose operator has no reference implementation (e.g. GRU)
+// only gets its latency measured.
+// the results are written as JSON with '--output'. given the results of an earlier run with '--baseline', the cases
+// whose median latency grew by more than the tolerance, or whose accuracy got worse, are reported as regressions.
+// the script exits with 1 if any case has mismatches or regressions.
+
+// tslint:disable: non-literal-fs-path
+
+import * as fs from 'fs';
+import minimist from 'minimist';
+import npmlog from 'npmlog';
+
+import '../lib/api';
+import {Attribute} from '../lib/attribute';
+import {Backend, InferenceHandler, SessionHandler} from '../lib/backend';
+import {CpuBinaryOp} from '../lib/backends/cpu/ops/binary-op';
+import {CpuUpsample} from '../lib/backends/cpu/ops/upsample';
+import {WASM_OP_RESOLVE_RULES} from '../lib/backends/wasm/op-resolve-rules';
+import {now, Profiler} from '../lib/instrument';
+import {Operator} from '../lib/operators';
+import {OpSet, resolveOperator} from '../lib/opset';
+import {Tensor} from '../lib/tensor';
+import {BroadcastUtil, ShapeUtil} from '../lib/util';
+import {createMockGraph} from '../test/test-shared';
+
+type AttributeValue = [string, Attribute.DataType, Attribute.DataTypeMap[Attribute.DataType]];
+
+interface InputSpec {
+  dims: number[];
+  // float32 by default
+  type?: Tensor.DataType;
+  // the values of the input. otherwise the values are random in [min, max], and integers if 'integer' is set
+  data?: number[];
+  min?: number;
+  max?: number;
+  integer?: boolean;
+  // the input is generated with the dims [N, C, H, W], then reordered to the blocked layout with this block
+  block?: number;
+}
+
+interface KernelCase {
+  opType: string;
+  // 9 by default
+  opset?: number;
+  attributes?: AttributeValue[];
+  inputs: InputSpec[];
+  // the expected outputs when the CPU backend has no operator of the same type (or null if there is no reference)
+  reference?: ((cpu: CpuReference, inputs: Tensor[]) => Promise<Tensor[]>)|null;
+  // converts the outputs of the kernel before comparing them (e.g. from the blocked layout)
+  convertOutputs?: (outputs: Tensor[]) => Tensor[];
+}
+
+interface Accuracy {
+  maxUlp: number;
+  maxAbsoluteError: number;
+  maxRelativeError: number;
+  mismatches: number;
+}
+
+interface CaseResult {
+  name: string;
+  opType: string;
+  // in milliseconds
+  latency: {median: number; min: number; mean: number};
+  // undefined if the operator has no reference implementation
+  accuracy?: Accuracy;
+  error?: string;
+}
+
+interface Results {
+  date: string;
+  iterations: number;
+  seed: number;
+  cases: CaseResult[];
+}
+
+const args = minimist(process.argv.slice(2));
+const opFilter = args.op ? new Set(String(args.op).split(',')) : undefined;
+const iterations = Number(args.iterations ?? 20);
+const seed = Number(args.seed ?? 1);
+const absoluteError = Number(args['absolute-error'] ?? 1e-4);
+const relativeError = Number(args['relative-error'] ?? 1e-5);
+const latencyTolerance = Number(args['latency-tolerance'] ?? 0.1);
+const ulpTolerance = Number(args['ulp-tolerance'] ?? 16);
+// latency changes below this many milliseconds are noise
+const MIN_LATENCY_DELTA = 0.01;
+
+const profiler = Profiler.create();
+
+// runs the operators of the CPU backend
+class CpuReference {
+  constructor(private sessionHandler: SessionHandler, private inferenceHandler: InferenceHandler) {}
+
+  // runs the operator of the CPU backend of the given type
+  async run(opType: string, attributes: AttributeValue[], inputs: Tensor[], opset = 9): Promise<Tensor[]> {
+    const graph = createMockGraph(opType, createAttributes(attributes));
+    const op = this.sessionHandler.resolve(graph.getNodes()[0], [{domain: '', version: opset}], graph);
+    return runOperator(op, this.inferenceHandler, inputs);
+  }
+
+  // runs an operator of the CPU backend which is not registered for the given type
+  async runOperator(op: Operator, attributes: AttributeValue[], inputs: Tensor[]): Promise<Tensor[]> {
+    const graph = createMockGraph('', createAttributes(attributes));
+    const node = graph.getNodes()[0];
+    op.initialize(node.attributes, node, graph);
+    return runOperator(op, this.inferenceHandler, inputs);
+  }
+}
+
+function createAttributes(values: AttributeValue[]): Attribute {
+  const attributes = new Attribute(undefined);
+  for (const [name, type, value] of values) {
+    attributes.set(name, type, value);
+  }
+  return attributes;
+}
+
+async function runOperator(op: Operator, inferenceHandler: InferenceHandler, inputs: Tensor[]): Promise<Tensor[]> {
+  if (!op.checkInputs(inputs)) {
+    throw new Error('invalid inputs');
+  }
+  return op.run(inferenceHandler, inputs);
+}
+
+// a deterministic random generator (mulberry32), so that the inputs of a case do not depend on the other cases
+function createRandom(name: string): () => number {
+  let state = seed;
+  for (let i = 0; i < name.length; i++) {
+    state = Math.imul(state ^ name.charCodeAt(i), 0x9e3779b1);
+  }
+  return () => {
+    state = (state + 0x6d2b79f5) | 0;
+    let t = Math.imul(state ^ (state >>> 15), 1 | state);
+    t = (t + Math.imul(t ^ (t >>> 7), 61 | t)) ^ t;
+    return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+  };
+}
+
+function createInput(spec: InputSpec, random: () => number): Tensor {
+  const type = spec.type ?? 'float32';
+  const tensor = new Tensor(spec.dims, type);
+  const data = tensor.numberData;
+  const integer = spec.integer || type !== 'float32';
+  const min = spec.min ?? (type === 'bool' ? 0 : integer ? -10 : -1);
+  const max = spec.max ?? (type === 'bool' ? 1 : integer ? 10 : 1);
+  for (let i = 0; i < data.length; i++) {
+    const value = spec.data ? spec.data[i] : min + random() * (max - min + (integer ? 1 : 0));
+    data[i] = integer ? Math.floor(value) : value;
+  }
+  return spec.block ? toBlocked(tensor, spec.block) : tensor;
+}
+
+function describe(c: KernelCase): string {
+  const inputs =
+      c.inputs.map(input => `${input.type ?? 'float32'}[${input.dims}]${input.block ? `/${input.block}` : ''}`);
+  const attributes = (c.attributes ?? []).map(([name, , value]) => `${name}=${value}`);
+  return [c.opType + (c.opset ? `-${c.opset}` : '')].concat(inputs, attributes).join(' ');
+}
+
+//
+// comparison of the outputs
+//
+
+const floatView = new Float32Array(1);
+const intView = new Int32Array(floatView.buffer);
+
+// the float32 values in the order of their bits, so that consecutive floats differ by 1
+function orderedBits(value: number): number {
+  floatView[0] = value;
+  const bits = intView[0];
+  return bits >= 0 ? bits : -(bits & 0x7fffffff);
+}
+
+function compareOutputs(actual: Tensor[], expected: Tensor[]): Accuracy {
+  if (actual.length !== expected.length) {
+    throw new Error(`expected ${expected.length} outputs, got ${actual.length}`);
+  }
+  const accuracy: Accuracy = {maxUlp: 0, maxAbsoluteError: 0, maxRelativeError: 0, mismatches: 0};
+  actual.forEach((output, i) => {
+    if (!ShapeUtil.areEqual(output.dims, expected[i].dims)) {
+      throw new Error(`output ${i}: expected dims [${expected[i].dims}], got [${output.dims}]`);
+    }
+    const a = output.numberData;
+    const b = expected[i].numberData;
+    const isFloat = output.type === 'float32';
+    for (let j = 0; j < a.length; j++) {
+      if (Number.isNaN(a[j]) || Number.isNaN(b[j])) {
+        if (!(Number.isNaN(a[j]) && Number.isNaN(b[j]))) {
+          accuracy.mismatches++;
+          accuracy.maxUlp = Infinity;
+        }
+        continue;
+      }
+      const error = Math.abs(a[j] - b[j]);
+      const relative = b[j] !== 0 ? error / Math.abs(b[j]) : error === 0 ? 0 : Infinity;
+      accuracy.maxUlp = Math.max(accuracy.maxUlp, isFloat ? Math.abs(orderedBits(a[j]) - orderedBits(b[j])) : error);
+      accuracy.maxAbsoluteError = Math.max(accuracy.maxAbsoluteError, error);
+      accuracy.maxRelativeError = Math.max(accuracy.maxRelativeError, relative);
+      if (isFloat ? error > absoluteError && relative > relativeError : error !== 0) {
+        accuracy.mismatches++;
+      }
+    }
+  });
+  return accuracy;
+}
+
+//
+// reference implementations of the operators the CPU backend does not have
+//
+
+// [N, C, H, W] -> [N, ceil(C / block), H, W, block], the padding channels being zeros
+function toBlocked(x: Tensor, block: number): Tensor {
+  const [n, c, h, w] = x.dims;
+  const blocks = Math.ceil(c / block);
+  const y = new Tensor([n, blocks, h, w, block], x.type);
+  const X = x.floatData;
+  const Y = y.floatData;
+  for (let i = 0; i < n; i++) {
+    for (let j = 0; j < c; j++) {
+      for (let p = 0; p < h * w; p++) {
+        Y[((i * blocks + Math.floor(j / block)) * h * w + p) * block + j % block] = X[(i * c + j) * h * w + p];
+      }
+    }
+  }
+  return y;
+}
+
+// [N, ceil(C / block), H, W, block] -> [N, C, H, W]
+function fromBlocked(x: Tensor, channels: number): Tensor {
+  const [n, blocks, h, w, block] = x.dims;
+  const y = new Tensor([n, channels, h, w], x.type);
+  const X = x.floatData;
+  const Y = y.floatData;
+  for (let i = 0; i < n; i++) {
+    for (let j = 0; j < channels; j++) {
+      for (let p = 0; p < h * w; p++) {
+        Y[(i * channels + j) * h * w + p] = X[((i * blocks + Math.floor(j / block)) * h * w + p) * block + j % block];
+      }
+    }
+  }
+  return y;
+}
+
+function elementwise(x: Tensor, f: (value: number) => number): Tensor {
+  const y = new Tensor(x.dims, x.type);
+  x.floatData.forEach((value, i) => y.floatData[i] = f(value));
+  return y;
+}
+
+function where(condition: Tensor, x: Tensor, y: Tensor): Tensor {
+  const dims = BroadcastUtil.calcShape(BroadcastUtil.calcShape(condition.dims, x.dims)!, y.dims)!;
+  const output = new Tensor(dims, x.type);
+  const strides = ShapeUtil.computeStrides(dims);
+  const value = (t: Tensor, indices: ReadonlyArray<number>) =>
+      t.numberData[ShapeUtil.indicesToOffset(BroadcastUtil.index(indices, t.dims), ShapeUtil.computeStrides(t.dims))];
+  for (let i = 0; i < output.size; i++) {
+    const indices = ShapeUtil.offsetToIndices(i, strides);
+    output.numberData[i] = value(condition, indices) ? value(x, indices) : value(y, indices);
+  }
+  return output;
+}
+
+// the 2-D transposed convolution, directly from its definition
+function convTranspose(inputs: Tensor[], attributes: AttributeValue[]): Tensor {
+  const attribute = (name: string, defaultValue: number[]) => {
+    const entry = attributes.find(a => a[0] === name);
+    return entry ? ([] as number[]).concat(entry[2] as number | number[]) : defaultValue;
+  };
+  const [x, w, b] = inputs;
+  const group = attribute('group', [1])[0];
+  const strides = attribute('strides', [1, 1]);
+  const dilations = attribute('dilations', [1, 1]);
+  const pads = attribute('pads', [0, 0, 0, 0]);
+  const outputPadding = attribute('output_padding', [0, 0]);
+  const [n, c, h, wd] = x.dims;
+  const [, mg, kh, kw] = w.dims;
+  const m = mg * group;
+  const cg = c / group;
+  const oh = strides[0] * (h - 1) + outputPadding[0] + dilations[0] * (kh - 1) + 1 - pads[0] - pads[2];
+  const ow = strides[1] * (wd - 1) + outputPadding[1] + dilations[1] * (kw - 1) + 1 - pads[1] - pads[3];
+  const y = new Tensor([n, m, oh, ow], 'float32');
+  const X = x.floatData;
+  const W = w.floatData;
+  const Y = y.floatData;
+  for (let i = 0; i < Y.length; i++) {
+    Y[i] = b ? b.floatData[Math.floor(i / (oh * ow)) % m] : 0;
+  }
+  for (let img = 0; img < n; img++) {
+    for (let ch = 0; ch < c; ch++) {
+      const g = Math.floor(ch / cg);
+      for (let r = 0; r < h; r++) {
+        for (let col = 0; col < wd; col++) {
+          const value = X[((img * c + ch) * h + r) * wd + col];
+          for (let f = 0; f < mg; f++) {
+            for (let a = 0; a < kh; a++) {
+              for (let k = 0; k < kw; k++) {
+                const yr = r * strides[0] - pads[0] + a * dilations[0];
+                const yc = col * strides[1] - pads[1] + k * dilations[1];
+                if (yr >= 0 && yr < oh && yc >= 0 && yc < ow) {
+                  Y[((img * m + g * mg + f) * oh + yr) * ow + yc] += value * W[((ch * mg + f) * kh + a) * kw + k];
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  return y;
+}
+
+function pairwise(f: (a: number, b: number) => number, resultType?: Tensor.DataType) {
+  return (cpu: CpuReference, inputs: Tensor[]) => inputs.slice(1).reduce(
+             async (result, input) =>
+                 (await cpu.runOperator(
+                     new CpuBinaryOp(['float32', 'int32'], f, undefined, resultType), [], [(await result)[0], input])),
+             Promise.resolve([inputs[0]]));
+}
+
+//
+// the sweep
+//
+
+function sweep(): KernelCase[] {
+  const cases: KernelCase[] = [];
+  const add = (c: KernelCase) => cases.push(c);
+
+  // element-wise operators, across the broadcast patterns
+  const broadcastPatterns: Array<[number[], number[]]> = [
+    [[2, 16, 24, 24], [2, 16, 24, 24]], [[2, 16, 24, 24], [1]], [[2, 16, 24, 24], [16, 1, 1]], [[8, 64], [64]],
+    [[4, 1, 32], [1, 8, 1]], [[1], [4, 64]]
+  ];
+  for (const opType of ['Add', 'Sub', 'Mul', 'Div']) {
+    for (const [a, b] of broadcastPatterns) {
+      add({opType, inputs: [{dims: a}, {dims: b, min: opType === 'Div' ? 0.5 : -1}]});
+    }
+    for (const [a, b] of broadcastPatterns.slice(0, 3)) {
+      add({opType, inputs: [{dims: a, type: 'int32'}, {dims: b, type: 'int32', min: opType === 'Div' ? 1 : -10}]});
+    }
+  }
+  for (const [a, b] of broadcastPatterns) {
+    add({opType: 'Pow', inputs: [{dims: a, min: 0.5, max: 2}, {dims: b, min: -2, max: 2}]});
+  }
+  for (const [a, b] of broadcastPatterns.slice(0, 3)) {
+    add({opType: 'PRelu', inputs: [{dims: a}, {dims: b}]});
+  }
+  for (const [opType, f] of [['Equal', (a: number, b: number) => a === b ? 1 : 0],
+                             ['Greater', (a: number, b: number) => a > b ? 1 : 0]] as
+       Array<[string, (a: number, b: number) => number]>) {
+    for (const [a, b] of broadcastPatterns.slice(0, 4)) {
+      add({
+        opType,
+        inputs: [{dims: a, min: -3, max: 3, integer: true}, {dims: b, min: -3, max: 3, integer: true}],
+        reference: pairwise(f, 'bool')
+      });
+    }
+  }
+  for (const [a, b] of broadcastPatterns.slice(0, 4)) {
+    add({
+      opType: 'Less',
+      inputs: [{dims: a, min: -3, max: 3, integer: true}, {dims: b, min: -3, max: 3, integer: true}]
+    });
+  }
+  for (const opType of ['And', 'Or', 'Xor']) {
+    for (const [a, b] of broadcastPatterns.slice(0, 4)) {
+      add({opType, inputs: [{dims: a, type: 'bool'}, {dims: b, type: 'bool'}]});
+    }
+  }
+  for (const [opType, f] of [['Max', Math.max], ['Min', Math.min]] as
+       Array<[string, (a: number, b: number) => number]>) {
+    for (const [a, b] of broadcastPatterns.slice(0, 5)) {
+      add({opType, inputs: [{dims: a}, {dims: b}], reference: pairwise(f)});
+    }
+    add({opType, inputs: [{dims: [4, 256]}, {dims: [4, 256]}, {dims: [4, 256]}], reference: pairwise(f)});
+  }
+  add({opType: 'Sum', inputs: [{dims: [2, 16, 24, 24]}, {dims: [2, 16, 24, 24]}]});
+  add({opType: 'Sum', inputs: [{dims: [8, 1024]}, {dims: [8, 1024]}, {dims: [8, 1024]}]});
+  add({
+    opType: 'Where',
+    inputs: [{dims: [8, 1, 32], type: 'bool'}, {dims: [8, 16, 32]}, {dims: [32]}],
+    reference: async (cpu, [c, x, y]) => [where(c, x, y)]
+  });
+  add({opType: 'Clip', attributes: [['min', 'float', -0.5], ['max', 'float', 0.5]], inputs: [{dims: [4, 64, 32]}]});
+
+  // convolutions: kernels, strides, padding, dilations and groups
+  const convs: Array<[number[], number[], AttributeValue[]]> = [
+    [[1, 16, 28, 28], [32, 16, 1, 1], []],
+    [[1, 16, 28, 28], [32, 16, 3, 3], [['pads', 'ints', [1, 1, 1, 1]]]],
+    [[2, 16, 28, 28], [32, 16, 3, 3], [['pads', 'ints', [1, 1, 1, 1]], ['strides', 'ints', [2, 2]]]],
+    [[1, 8, 28, 28], [16, 8, 5, 5], [['pads', 'ints', [2, 2, 2, 2]]]],
+    [[1, 8, 28, 28], [16, 8, 3, 3], [['pads', 'ints', [2, 2, 2, 2]], ['dilations', 'ints', [2, 2]]]],
+    [[1, 8, 28, 28], [16, 8, 3, 3], [['pads', 'ints', [0, 1, 1, 0]]]],
+    [[1, 16, 28, 28], [16, 8, 3, 3], [['pads', 'ints', [1, 1, 1, 1]], ['group', 'int', 2]]],
+    [[1, 32, 28, 28], [32, 1, 3, 3], [['pads', 'ints', [1, 1, 1, 1]], ['group', 'int', 32]]],
+    [[1, 3, 56, 56], [16, 3, 7, 7], [['pads', 'ints', [3, 3, 3, 3]], ['strides', 'ints', [2, 2]]]],
+  ];
+  for (const [x, w, attributes] of convs) {
+    add({opType: 'Conv', attributes, inputs: [{dims: x}, {dims: w}, {dims: [w[0]]}]});
+  }
+  add({opType: 'Conv', attributes: convs[1][2], inputs: [{dims: convs[1][0]}, {dims: convs[1][1]}]});
+
+  const convTransposes: Array<[number[], number[], AttributeValue[]]> = [
+    [[1, 16, 14, 14], [16, 8, 3, 3], [['pads', 'ints', [1, 1, 1, 1]]]],
+    [[1, 16, 14, 14], [16, 8, 3, 3],
+     [['pads', 'ints', [1, 1, 1, 1]], ['strides', 'ints', [2, 2]], ['output_padding', 'ints', [1, 1]]]],
+    [[1, 16, 14, 14], [16, 8, 4, 4], [['pads', 'ints', [1, 1, 1, 1]], ['strides', 'ints', [2, 2]]]],
+    [[1, 16, 14, 14], [16, 4, 2, 2], [['group', 'int', 2], ['dilations', 'ints', [2, 2]]]],
+  ];
+  for (const [x, w, attributes] of convTransposes) {
+    const group = attributes.find(a => a[0] === 'group');
+    const channels = w[1] * (group ? group[2] as number : 1);
+    add({
+      opType: 'ConvTranspose',
+      attributes,
+      inputs: [{dims: x}, {dims: w}, {dims: [channels]}],
+      reference: async (cpu, inputs) => [convTranspose(inputs, attributes)]
+    });
+  }
+
+  // pooling
+  const pools: AttributeValue[][] = [
+    [['kernel_shape', 'ints', [2, 2]], ['strides', 'ints', [2, 2]]],
+    [['kernel_shape', 'ints', [3, 3]], ['pads', 'ints', [1, 1, 1, 1]]],
+    [['kernel_shape', 'ints', [3, 3]], ['strides', 'ints', [2, 2]], ['pads', 'ints', [1, 1, 1, 1]]],
+    [['kernel_shape', 'ints', [3, 2]], ['pads', 'ints', [0, 1, 1, 0]]],
+  ];
+  for (const attributes of pools) {
+    add({opType: 'MaxPool', attributes, inputs: [{dims: [1, 16, 28, 28]}]});
+    add({opType: 'AveragePool', attributes, inputs: [{dims: [1, 16, 28, 28]}]});
+  }
+  add({
+    opType: 'AveragePool',
+    attributes: pools[2].concat([['count_include_pad', 'int', 1]]),
+    inputs: [{dims: [1, 16, 28, 28]}]
+  });
+  add({opType: 'GlobalAveragePool', inputs: [{dims: [2, 32, 14, 14]}]});
+  add({opType: 'GlobalMaxPool', inputs: [{dims: [2, 32, 14, 14]}]});
+
+  // normalizations
+  add({
+    opType: 'BatchNormalization',
+    attributes: [['epsilon', 'float', 1e-5]],
+    inputs: [{dims: [2, 16, 14, 14]}, {dims: [16]}, {dims: [16]}, {dims: [16]}, {dims: [16], min: 0.1, max: 1}]
+  });
+  add({opType: 'InstanceNormalization', inputs: [{dims: [2, 8, 16, 16]}, {dims: [8]}, {dims: [8]}]});
+  add({opType: 'Softmax', attributes: [['axis', 'int', 1]], inputs: [{dims: [8, 128]}]});
+  add({opType: 'Softmax', attributes: [['axis', 'int', 3]], inputs: [{dims: [2, 4, 16, 32]}]});
+  add({opType: 'Softmax', attributes: [['axis', 'int', 1]], inputs: [{dims: [2, 4, 16, 32]}]});
+
+  // matrix products
+  add({opType: 'Gemm', inputs: [{dims: [32, 64]}, {dims: [64, 48]}, {dims: [48]}]});
+  add({opType: 'Gemm', attributes: [['transA', 'int', 1]], inputs: [{dims: [64, 32]}, {dims: [64, 48]}, {dims: [48]}]});
+  add({opType: 'Gemm', attributes: [['transB', 'int', 1]], inputs: [{dims: [32, 64]}, {dims: [48, 64]}, {dims: [48]}]});
+  add({
+    opType: 'Gemm',
+    attributes: [['alpha', 'float', 0.5], ['beta', 'float', 2]],
+    inputs: [{dims: [32, 64]}, {dims: [64, 48]}, {dims: [32, 1]}]
+  });
+  add({opType: 'Gemm', opset: 11, inputs: [{dims: [32, 64]}, {dims: [64, 48]}]});
+  add({opType: 'MatMul', inputs: [{dims: [64, 128]}, {dims: [128, 32]}]});
+  add({opType: 'MatMul', inputs: [{dims: [4, 32, 64]}, {dims: [4, 64, 16]}]});
+  add({opType: 'MatMul', inputs: [{dims: [2, 3, 16, 32]}, {dims: [32, 8]}]});
+  add({opType: 'MatMul', inputs: [{dims: [64]}, {dims: [64, 32]}]});
+  add({
+    opType: 'FusedAttention',
+    attributes: [['axis', 'int', 3]],
+    inputs: [
+      {dims: [2, 4, 16, 32]}, {dims: [2, 4, 32, 16]}, {dims: [1], data: [Math.sqrt(32)]}, {dims: [2, 1, 1, 16]},
+      {dims: [2, 4, 16, 32]}
+    ],
+    reference: async (cpu, [q, kT, divisor, mask, v]) => {
+      const [scores] = await cpu.run('MatMul', [], [q, kT]);
+      const [scaled] = await cpu.run('Div', [], [scores, divisor]);
+      const [masked] = await cpu.run('Add', [], [scaled, mask]);
+      const [probabilities] = await cpu.run('Softmax', [['axis', 'int', 3]], [masked]);
+      return cpu.run('MatMul', [], [probabilities, v]);
+    }
+  });
+
+  // data movement
+  add({
+    opType: 'Concat',
+    attributes: [['axis', 'int', 1]],
+    inputs: [{dims: [2, 8, 16, 16]}, {dims: [2, 4, 16, 16]}, {dims: [2, 12, 16, 16]}]
+  });
+  add({opType: 'Concat', attributes: [['axis', 'int', 0]], inputs: [{dims: [3, 64]}, {dims: [5, 64]}]});
+  add({opType: 'Concat', attributes: [['axis', 'int', 3]], inputs: [{dims: [2, 4, 8, 16]}, {dims: [2, 4, 8, 8]}]});
+  add({opType: 'Transpose', attributes: [['perm', 'ints', [0, 2, 3, 1]]], inputs: [{dims: [2, 3, 16, 32]}]});
+  add({opType: 'Transpose', inputs: [{dims: [64, 128]}]});
+  add({opType: 'Transpose', attributes: [['perm', 'ints', [3, 1, 2, 0]]], inputs: [{dims: [4, 8, 16, 2]}]});
+  add({
+    opType: 'Slice',
+    attributes: [['starts', 'ints', [1, 2]], ['ends', 'ints', [7, 30]], ['axes', 'ints', [1, 2]]],
+    inputs: [{dims: [8, 32, 32]}]
+  });
+  add({opType: 'Slice', attributes: [['starts', 'ints', [0]], ['ends', 'ints', [-3]]], inputs: [{dims: [16, 64]}]});
+  add({
+    opType: 'Slice',
+    opset: 10,
+    inputs: [
+      {dims: [8, 32, 32]}, {dims: [2], type: 'int32', data: [1, 2]}, {dims: [2], type: 'int32', data: [7, 30]},
+      {dims: [2], type: 'int32', data: [1, 2]}
+    ]
+  });
+  for (const mode of ['constant', 'reflect', 'edge']) {
+    add({
+      opType: 'Pad',
+      attributes: [['mode', 'string', mode], ['pads', 'ints', [0, 0, 2, 1, 0, 0, 1, 2]], ['value', 'float', 0.5]],
+      inputs: [{dims: [1, 8, 16, 16]}]
+    });
+  }
+  add({opType: 'Tile', inputs: [{dims: [4, 16, 8]}, {dims: [3], type: 'int32', data: [2, 1, 3]}]});
+  add({opType: 'Expand', inputs: [{dims: [8, 1, 16]}, {dims: [4], type: 'int32', data: [4, 8, 32, 16]}]});
+  add({opType: 'Gather', inputs: [{dims: [32, 16, 8]}, {dims: [10], type: 'int32', min: 0, max: 31}]});
+  add({
+    opType: 'Gather',
+    attributes: [['axis', 'int', 1]],
+    inputs: [{dims: [32, 16, 8]}, {dims: [4, 3], type: 'int32', min: 0, max: 15}]
+  });
+  add({
+    opType: 'Upsample',
+    opset: 7,
+    attributes: [['scales', 'floats', [1, 1, 2, 2]]],
+    inputs: [{dims: [1, 8, 16, 16]}]
+  });
+  for (const mode of ['nearest', 'linear']) {
+    add({
+      opType: 'Upsample',
+      attributes: [['mode', 'string', mode]],
+      inputs: [{dims: [1, 8, 16, 16]}, {dims: [4], data: [1, 1, 2, 3]}]
+    });
+    const attributes: AttributeValue[] = [['mode', 'string', mode]];
+    add({
+      opType: 'Resize',
+      opset: 11,
+      attributes,
+      inputs: [{dims: [1, 8, 16, 16]}, {dims: [8], data: [0, 0, 0, 0, 1, 1, 1, 1]}, {dims: [4], data: [1, 1, 2, 1.5]}],
+      reference: (cpu, inputs) => cpu.runOperator(new CpuUpsample(11), attributes, inputs)
+    });
+  }
+
+  // reductions
+  const reductions: AttributeValue[][] =
+      [[['axes', 'ints', [1]], ['keepdims', 'int', 1]], [['axes', 'ints', [0, 2]], ['keepdims', 'int', 0]], []];
+  for (const opType of ['ReduceMax', 'ReduceMean', 'ReduceMin', 'ReduceSum', 'ReduceSumSquare']) {
+    for (const attributes of reductions) {
+      add({opType, attributes, inputs: [{dims: [4, 16, 32]}]});
+    }
+  }
+  for (const attributes of reductions) {
+    add({opType: 'ReduceLogSum', attributes, inputs: [{dims: [4, 16, 32], min: 0.1}]});
+    add({opType: 'ReduceProd', attributes, inputs: [{dims: [4, 16, 32], min: 0.9, max: 1.1}]});
+    add({
+      opType: 'ReduceLogSumExp',
+      attributes,
+      inputs: [{dims: [4, 16, 32]}],
+      reference: async (cpu, [x]) => {
+        const [sum] = await cpu.run('ReduceSum', attributes, [elementwise(x, Math.exp)]);
+        return [elementwise(sum, Math.log)];
+      }
+    });
+  }
+  const argReductions: AttributeValue[][] =
+      [[['axis', 'int', 1], ['keepdims', 'int', 1]], [['axis', 'int', 2], ['keepdims', 'int', 0]]];
+  for (const attributes of argReductions) {
+    add({opType: 'ArgMax', attributes, inputs: [{dims: [8, 32, 16]}]});
+    add({
+      opType: 'ArgMin',
+      attributes,
+      inputs: [{dims: [8, 32, 16]}],
+      reference: (cpu, [x]) => cpu.run('ArgMax', attributes, [elementwise(x, value => -value)])
+    });
+  }
+
+  // recurrent operators, without a reference implementation
+  const hidden = 32;
+  add({
+    opType: 'GRU',
+    attributes: [['hidden_size', 'int', hidden]],
+    inputs: [{dims: [8, 2, 16]}, {dims: [1, 3 * hidden, 16]}, {dims: [1, 3 * hidden, hidden]}, {dims: [1, 6 * hidden]}],
+    reference: null
+  });
+  add({
+    opType: 'LSTM',
+    attributes: [['hidden_size', 'int', hidden]],
+    inputs: [{dims: [8, 2, 16]}, {dims: [1, 4 * hidden, 16]}, {dims: [1, 4 * hidden, hidden]}, {dims: [1, 8 * hidden]}],
+    reference: null
+  });
+
+  // the blocked NCHWc layout, against the operators of the CPU backend on the NCHW layout
+  const block = 8;
+  add({
+    opType: 'ReorderToNCHWc',
+    attributes: [['block', 'int', block]],
+    inputs: [{dims: [1, 20, 14, 14]}],
+    reference: async (cpu, [x]) => [x],
+    convertOutputs: ([y]) => [fromBlocked(y, 20)]
+  });
+  add({
+    opType: 'ReorderFromNCHWc',
+    attributes: [['channels', 'int', 20]],
+    inputs: [{dims: [1, 20, 14, 14], block}],
+    reference: async (cpu, [x]) => [fromBlocked(x, 20)]
+  });
+  for (const [x, w, attributes] of convs.slice(0, 3)) {
+    add({
+      opType: 'ConvNCHWc',
+      attributes,
+      inputs: [{dims: x, block}, {dims: w}, {dims: [w[0]]}],
+      reference: (cpu, [blocked, ...rest]) => cpu.run('Conv', attributes, [fromBlocked(blocked, x[1]), ...rest]),
+      convertOutputs: ([y]) => [fromBlocked(y, w[0])]
+    });
+  }
+  for (const [opType, attributes] of [
+         ['MaxPool', pools[2]], ['AveragePool', pools[2]], ['GlobalAveragePool', []], ['GlobalMaxPool', []]
+       ] as Array<[string, AttributeValue[]]>) {
+    add({
+      opType: `${opType}NCHWc`,
+      attributes,
+      inputs: [{dims: [1, 16, 28, 28], block}],
+      reference: (cpu, [x]) => cpu.run(opType, attributes, [fromBlocked(x, 16)]),
+      convertOutputs: ([y]) => [fromBlocked(y, 16)]
+    });
+  }
+  add({
+    opType: 'BatchNormalizationNCHWc',
+    attributes: [['epsilon', 'float', 1e-5]],
+    inputs: [{dims: [2, 12, 14, 14], block}, {dims: [12]}, {dims: [12]}, {dims: [12]}, {dims: [12], min: 0.1, max: 1}],
+    reference: (cpu, [x, ...rest]) =>
+        cpu.run('BatchNormalization', [['epsilon', 'float', 1e-5]], [fromBlocked(x, 12), ...rest]),
+    convertOutputs: ([y]) => [fromBlocked(y, 12)]
+  });
+
+  return cases;
+}
+
+//
+// running the sweep
+//
+
+async function measure(run: () => Promise<Tensor[]>): Promise<CaseResult['latency']> {
+  const times: number[] = [];
+  for (let i = 0; i < iterations; i++) {
+    const start = now();
+    await run();
+    times.push(now() - start);
+  }
+  times.sort((a, b) => a - b);
+  return {
+    median: times[Math.floor(times.length / 2)],
+    min: times[0],
+    mean: times.reduce((sum, time) => sum + time, 0) / times.length
+  };
+}
+
+async function runCase(c: KernelCase, name: string, wasm: InferenceHandler, cpu: CpuReference): Promise<CaseResult> {
+  const random = createRandom(name);
+  const inputs = c.inputs.map(spec => createInput(spec, random));
+  const opset = c.opset ?? 9;
+  const opsets: OpSet[] = [{domain: '', version: opset}];
+  // the kernel alone, without the fallback of the session handler to the CPU backend
+  const graph = createMockGraph(c.opType, createAttributes(c.attributes ?? []));
+  const node = graph.getNodes()[0];
+  const op = resolveOperator(node, opsets, WASM_OP_RESOLVE_RULES);
+  op.initialize(node.attributes, node, graph);
+  const run = () => runOperator(op, wasm, inputs);
+
+  const outputs = await run();
+  let accuracy: Accuracy|undefined;
+  if (c.reference !== null) {
+    const expected =
+        c.reference ? await c.reference(cpu, inputs) : await cpu.run(c.opType, c.attributes ?? [], inputs, opset);
+    accuracy = compareOutputs(c.convertOutputs ? c.convertOutputs(outputs) : outputs, expected);
+  }
+  const latency = await measure(run);
+  return {name, opType: c.opType, latency, accuracy};
+}
+
+function formatAccuracy(accuracy: Accuracy): string {
+  return `max ULP ${accuracy.maxUlp}, max abs ${accuracy.maxAbsoluteError.toExponential(2)}, max rel ${
+      accuracy.maxRelativeError.toExponential(2)}, mismatches ${accuracy.mismatches}`;
+}
+
+// the regressions of the results against the results of an earlier run
+function findRegressions(results: Results, baseline: Results): string[] {
+  const regressions: string[] = [];
+  const baselineCases = new Map(baseline.cases.map(c => [c.name, c] as [string, CaseResult]));
+  for (const c of results.cases) {
+    const base = baselineCases.get(c.name);
+    if (!base || c.error || base.error) {
+      continue;
+    }
+    const median = c.latency.median;
+    const baseMedian = base.latency.median;
+    if (median > baseMedian * (1 + latencyTolerance) && median - baseMedian > MIN_LATENCY_DELTA) {
+      regressions.push(`${c.name}: median latency ${baseMedian.toFixed(3)}ms -> ${median.toFixed(3)}ms (+${
+          ((median / baseMedian - 1) * 100).toFixed(1)}%)`);
+    }
+    if (c.accuracy && base.accuracy) {
+      if (c.accuracy.mismatches > base.accuracy.mismatches) {
+        regressions.push(`${c.name}: mismatches ${base.accuracy.mismatches} -> ${c.accuracy.mismatches}`);
+      }
+      if (c.accuracy.maxUlp > base.accuracy.maxUlp + ulpTolerance) {
+        regressions.push(`${c.name}: max ULP ${base.accuracy.maxUlp} -> ${c.accuracy.maxUlp}`);
+      }
+    }
+  }
+  return regressions;
+}
+
+async function main() {
+  const wasmBackend = await Backend('wasm');
+  const cpuBackend = await Backend('cpu');
+  const wasmSession = wasmBackend.createSessionHandler({profiler});
+  const cpuSession = cpuBackend.createSessionHandler({profiler});
+  const wasm = wasmSession.createInferenceHandler();
+  const cpu = new CpuReference(cpuSession, cpuSession.createInferenceHandler());
+
+  // every operator of the wasm backend should be covered by the sweep
+  const cases = sweep();
+  const covered = new Set(cases.map(c => c.opType));
+  const uncovered = WASM_OP_RESOLVE_RULES.map(rule => rule[0]).filter(opType => !covered.has(opType));
+  if (uncovered.length > 0) {
+    npmlog.warn('KernelRegression', `operators without cases: ${Array.from(new Set(uncovered)).join(', ')}`);
+  }
+
+  const results: Results = {date: new Date().toISOString(), iterations, seed, cases: []};
+  for (const c of cases) {
+    if (opFilter && !opFilter.has(c.opType)) {
+      continue;
+    }
+    const name = describe(c);
+    let result: CaseResult;
+    try {
+      result = await runCase(c, name, wasm, cpu);
+    } catch (e) {
+      result = {name, opType: c.opType, latency: {median: 0, min: 0, mean: 0}, error: `${e}`};
+    }
+    results.cases.push(result);
+
+    const accuracy = result.accuracy;
+    const status = result.error ? `ERROR ${result.error}` : accuracy ? formatAccuracy(accuracy) : 'no reference';
+    npmlog.info('KernelRegression', `${name}: ${result.latency.median.toFixed(3)}ms (min ${
+        result.latency.min.toFixed(3)}ms), ${status}`);
+  }
+  wasm.dispose();
+  wasmSession.dispose();
+
+  if (args.output) {
+    fs.writeFileSync(args.output, JSON.stringify(results, null, 2));
+  }
+
+  const failures = results.cases.filter(c => c.error || (c.accuracy && c.accuracy.mismatches > 0));
+  for (const c of failures) {
+    npmlog.error('KernelRegression', `FAILED ${c.name}: ${c.error ?? `${c.accuracy!.mismatches} mismatches`}`);
+  }
+  let regressions: string[] = [];
+  if (args.baseline) {
+    regressions = findRegressions(results, JSON.parse(fs.readFileSync(args.baseline).toString()) as Results);
+    for (const regression of regressions) {
+      npmlog.error('KernelRegression', `REGRESSION ${regression}`);
+    }
+  }
+  npmlog.info(
+      'KernelRegression',
+      `${results.cases.length} cases, ${failures.length} failures, ${regressions.length} regressions`);
+  process.exit(failures.length > 0 || regressions.length > 0 ? 1 : 0);
+}
+
+main().catch(e => {
+  npmlog.error('KernelRegression', `${e}`);
+  process.exit(1);
+});
@@ -9,15 +9,29 @@
 // > npm test -- model test/test-data/{path-to-my-model} --backend={cpu/webgl/wasm} --profile > profile.raw.log
 // STEP.2 - parse
 // > node tools/parse-profiler < profile.raw.log > profile.parsed.log
+//
+// the calls to WebAssembly functions are summarized after the events: the time of their phases, the marshalling of
+// their arguments (serialization, transfer to the workers, copies to the Wasm heap and back) versus the compute, and
+// the bytes of their arguments.
+// with '--trace', the events and the calls are written in the Chrome trace event format instead, to be opened in
+// chrome://tracing or https://ui.perfetto.dev:
+// > node tools/parse-profiler --trace < profile.raw.log > profile.trace.json
 
 // tslint:disable
 
 import * as readline from 'readline';
+import {createChromeTrace, Profiler} from '../lib/instrument';
 const int = readline.createInterface({input: process.stdin, output: process.stdout, terminal: false});
 
 const matcher = /Profiler\.([^\[\s\x1b]+)(\x1b\[0m)? (\d.+Z)\|([\d\.]+)ms on event '([^']+)' at (\d*\.*\d*)/;
+const callMatcher =
+    /Profiler\.wasm(\x1b\[0m)? (\d.+Z)\|([\d\.]+)ms on call '([^']+)' on (main|worker-(\d+)) \((\d+) bytes in, (\d+) bytes out\) at ([\d\.]+): (.*)$/;
+const phaseMatcher = /^([\w-]+) ([\d\.]+)-([\d\.]+)$/;
+
+const trace = process.argv.indexOf('--trace') !== -1;
 
 const allEvents: any[] = [];
+const allCalls: Profiler.WasmCall[] = [];
 int.on('line', input => {
   const matches = matcher.exec(input);
   if (matches) {
@@ -28,12 +42,103 @@ int.on('line', input => {
     const event = matches[5];
     const endTimeInNumber = matches[6];
     allEvents.push({event, ms, logTimeStamp, category, endTimeInNumber});
+    return;
+  }
+  const callMatches = callMatcher.exec(input);
+  if (callMatches) {
+    const phases: Profiler.WasmCallPhase[] = [];
+    for (const phase of callMatches[10].split(', ')) {
+      const phaseMatches = phaseMatcher.exec(phase);
+      if (phaseMatches) {
+        phases.push({
+          name: phaseMatches[1] as Profiler.WasmCallPhaseName,
+          startTime: Number.parseFloat(phaseMatches[2]),
+          endTime: Number.parseFloat(phaseMatches[3])
+        });
+      }
+    }
+    const endTime = Number.parseFloat(callMatches[9]);
+    allCalls.push({
+      name: callMatches[4],
+      worker: callMatches[6] === undefined ? -1 : Number.parseInt(callMatches[6]),
+      bytesIn: Number.parseInt(callMatches[7]),
+      bytesOut: Number.parseInt(callMatches[8]),
+      startTime: endTime - Number.parseFloat(callMatches[3]),
+      endTime,
+      phases
+    });
   }
 });
 
 int.on('close', () => {
+  if (trace) {
+    const events = allEvents.map(i => {
+      const endTime = Number.parseFloat(i.endTimeInNumber);
+      return {category: i.category, name: i.event, startTime: endTime - i.ms, endTime};
+    });
+    console.log(JSON.stringify(createChromeTrace(events, allCalls)));
+    return;
+  }
+
   for (const i of allEvents) {
     console.log(`${(i.category + '           ').substring(0, 12)} ${((i.ms) + '           ').substring(0, 12)} ${
         (i.event + '                                      ').substring(0, 40)} ${i.endTimeInNumber}`);
   }
+  if (allCalls.length > 0) {
+    printMarshallingSummary(allCalls);
+  }
 });
+
+// the columns of the summary, summing the time of the phases of the calls
+const columns: Array<[string, Profiler.WasmCallPhaseName[]]> = [
+  ['serialize', ['serialize']], ['transfer', ['transfer']], ['copy', ['copy-in', 'copy-out']],
+  ['compute', ['compute']], ['return', ['return']], ['deserialize', ['deserialize']]
+];
+
+interface CallSummary {
+  calls: number;
+  total: number;
+  phases: number[];
+  bytesIn: number;
+  bytesOut: number;
+}
+
+const newCallSummary = (): CallSummary => ({calls: 0, total: 0, phases: columns.map(() => 0), bytesIn: 0, bytesOut: 0});
+
+// the time spent marshalling the arguments of the calls to every WebAssembly function, versus the compute
+function printMarshallingSummary(calls: Profiler.WasmCall[]) {
+  const functions = new Map<string, CallSummary>();
+  const all = newCallSummary();
+  for (const call of calls) {
+    let summary = functions.get(call.name);
+    if (!summary) {
+      summary = newCallSummary();
+      functions.set(call.name, summary);
+    }
+    for (const s of [summary, all]) {
+      s.calls++;
+      s.total += call.endTime - call.startTime;
+      s.bytesIn += call.bytesIn;
+      s.bytesOut += call.bytesOut;
+      for (const phase of call.phases) {
+        const column = columns.findIndex(c => c[1].indexOf(phase.name) !== -1);
+        s.phases[column] += phase.endTime - phase.startTime;
+      }
+    }
+  }
+
+  const pad = (s: string|number, width: number) => (s + ' '.repeat(width)).substring(0, width);
+  const computeColumn = columns.findIndex(c => c[0] === 'compute');
+  console.log('');
+  console.log('marshalling overhead of the calls to WebAssembly functions (ms, KB):');
+  console.log(`${pad('function', 32)} ${pad('calls', 8)} ${pad('total', 10)} ${
+      columns.map(c => pad(c[0], 12)).join(' ')} ${pad('KB in', 10)} ${pad('KB out', 10)} overhead`);
+  const rows: Array<[string, CallSummary]> = Array.from(functions.entries()).sort((a, b) => b[1].total - a[1].total);
+  rows.push(['(all)', all]);
+  for (const [name, s] of rows) {
+    const overhead = s.total > 0 ? (s.total - s.phases[computeColumn]) / s.total * 100 : 0;
+    console.log(`${pad(name, 32)} ${pad(s.calls, 8)} ${pad(s.total.toFixed(3), 10)} ${
+        s.phases.map(t => pad(t.toFixed(3), 12)).join(' ')} ${pad((s.bytesIn / 1024).toFixed(1), 10)} ${
+        pad((s.bytesOut / 1024).toFixed(1), 10)} ${overhead.toFixed(1)}%`);
+  }
+}
@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+// prepack-model
+//
+// this script prepares an ONNX model (or an ORT model) ahead of time for the WebAssembly backend: it applies the
+// transformations of the graph of the backend, resolves the operators, packs their weights and schedules the nodes,
+// then writes the result as a prepacked model (see lib/prepacked-model.ts). sessions load a prepacked model like any
+// other model, without transforming its graph or packing its weights again.
+// usage:
+// > node tools/prepack-model <input.onnx> <output.prepacked> [--channel-block=<0|4|8|16>] [--sparsity=<0..1>]
+//       [--no-cpu-fallback]
+// the options are the ones of the WebAssembly backend (onnx.backend.wasm), which they replace for the prepacked model.
+
+import * as fs from 'fs-extra';
+import minimist from 'minimist';
+import npmlog from 'npmlog';
+
+import {WasmBackend} from '../lib/backends/backend-wasm';
+import {isSparseOperator, SparseWeights} from '../lib/backends/wasm/sparse';
+import {computeSchedule} from '../lib/execution-plan';
+import {Graph} from '../lib/graph';
+import {Profiler} from '../lib/instrument';
+import {Model} from '../lib/model';
+import {encodePrepackedModel} from '../lib/prepacked-model';
+
+const args = minimist(process.argv.slice(2));
+if (args._.length !== 2) {
+  npmlog.error(
+      'PrepackModel',
+      'usage: node tools/prepack-model <input.onnx> <output.prepacked> [--channel-block=N] [--sparsity=F] ' +
+          '[--no-cpu-fallback]');
+  process.exit(1);
+}
+const [input, output] = args._ as string[];
+
+const backend = new WasmBackend();
+backend.cpuFallback = args['cpu-fallback'] !== false;
+backend.channelBlock = Number(args['channel-block'] ?? 0);
+backend.sparsity = Number(args.sparsity ?? 0);
+// the session handler transforms the graph and resolves the operators, which does not need the wasm binding
+const sessionHandler = backend.createSessionHandler({profiler: Profiler.create()});
+
+// tslint:disable-next-line:non-literal-fs-path
+const modelBuffer = fs.readFileSync(input);
+const model = new Model();
+model.load(modelBuffer, sessionHandler as Graph.Initializer, input.slice(-4) === '.ort');
+const graph = model.graph;
+const ops = graph.getNodes().map(node => sessionHandler.resolve(node, model.opsets, graph));
+
+const sparseWeights = new Map<number, SparseWeights>();
+ops.forEach((op, i) => {
+  if (isSparseOperator(op) && op.sparseWeights) {
+    sparseWeights.set(i, op.sparseWeights);
+  }
+});
+
+const options = {cpuFallback: backend.cpuFallback, channelBlock: backend.channelBlock, sparsity: backend.sparsity};
+const prepacked = encodePrepackedModel(graph, model.opsets, options, computeSchedule(graph), sparseWeights);
+// tslint:disable-next-line:non-literal-fs-path
+fs.writeFileSync(output, prepacked);
+
+npmlog.info(
+    'PrepackModel',
+    `${input} (${modelBuffer.byteLength} bytes) -> ${output} (${prepacked.byteLength} bytes): ${
+        graph.getNodes().length} nodes, ${sparseWeights.size} packed weights`);